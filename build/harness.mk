@@ -1,6 +1,8 @@
 HARNESS_SOURCES = \
 	$(SRC)/Computer/FlyingComputer.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCFixReader.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Replay/IgcReplay.cpp \
 	$(SRC)/Replay/TaskAutoPilot.cpp \
 	$(SRC)/Replay/AircraftSim.cpp \
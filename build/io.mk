@@ -9,6 +9,7 @@ IO_SOURCES = \
 	$(IO_SRC_DIR)/LineSplitter.cpp \
 	$(IO_SRC_DIR)/ConvertLineReader.cpp \
 	$(IO_SRC_DIR)/FileLineReader.cpp \
+	$(IO_SRC_DIR)/MappedLineReader.cpp \
 	$(IO_SRC_DIR)/KeyValueFileReader.cpp \
 	$(IO_SRC_DIR)/KeyValueFileWriter.cpp \
 	$(IO_SRC_DIR)/ZipLineReader.cpp \
@@ -0,0 +1,4 @@
+TARGET = UNIX
+ENABLE_SDL = n
+WERROR = n
+CPPFLAGS += -DLIBCXX
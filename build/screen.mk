@@ -61,6 +61,10 @@ SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/OpenGL/Shapes.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/Surface.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
+ifneq ($(TARGET),ANDROID)
+SCREEN_SOURCES += \
+	$(SCREEN_SRC_DIR)/OpenGL/GlyphAtlas.cpp
+endif
 else
 SCREEN_SOURCES += \
 	$(SCREEN_SRC_DIR)/SDL/Bitmap.cpp \
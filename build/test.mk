@@ -65,16 +65,22 @@ TEST_NAMES = \
 	test_pressure \
 	test_task \
 	TestOverwritingRingBuffer \
+	TestJobPool \
+	TestSeqLock \
+	TestNMEAQueue \
+	TestNMEASentenceTable \
+	TestStageScheduler \
+	TestProfiler \
 	TestDateTime \
 	TestMathTables \
 	TestAngle TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestQuadTree TestGeoBounds TestGeoClip \
 	TestLogger TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	test_load_task TestFlarmNet \
 	TestColorRamp TestGeoPoint TestDiffFilter \
-	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
+	TestFileUtil TestPolars TestCSVLine TestLineReader TestDataCache TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
 	TestMacCready TestOrderedTask \
 	TestPlanes \
@@ -84,9 +90,14 @@ TEST_NAMES = \
 	TestAirspaceParser \
 	TestMETARParser \
 	TestIGCParser \
+	TestTrafficList \
+	TestTraceSync \
+	TestMD5 \
 	TestByteOrder \
 	TestByteOrder2 \
 	TestStrings \
+	TestUTF8 \
+	TestLabelBlock \
 	TestUnitsFormatter \
 	TestGeoPointFormatter \
 	TestHexColorFormatter \
@@ -103,13 +114,73 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_JOB_POOL_SOURCES = \
+	$(SRC)/Job/Pool.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestJobPool.cpp
+TEST_JOB_POOL_DEPENDS = UTIL
+$(eval $(call link-program,TestJobPool,TEST_JOB_POOL))
+
+TEST_SEQ_LOCK_SOURCES = \
+	$(SRC)/Thread/Thread.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSeqLock.cpp
+TEST_SEQ_LOCK_DEPENDS = UTIL
+$(eval $(call link-program,TestSeqLock,TEST_SEQ_LOCK))
+
+TEST_NMEA_QUEUE_SOURCES = \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Device/Port/LineSplitter.cpp \
+	$(SRC)/Device/Receiver.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/FlarmCalculations.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/Attitude.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/ClimbAverageCalculator.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/Geometry/GeoVector.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/TestNMEAQueue.cpp
+TEST_NMEA_QUEUE_DEPENDS = DRIVER IO MATH UTIL
+$(eval $(call link-program,TestNMEAQueue,TEST_NMEA_QUEUE))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCFixReader.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestIGCParser.cpp
-TEST_IGC_PARSER_DEPENDS = MATH UTIL
+TEST_IGC_PARSER_DEPENDS = IO ZZIP MATH UTIL
 $(eval $(call link-program,TestIGCParser,TEST_IGC_PARSER))
 
+TEST_MD5_SOURCES = \
+	$(SRC)/Logger/LoggerGRecord.cpp \
+	$(SRC)/Logger/MD5.cpp \
+	$(SRC)/Util/UTF8.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMD5.cpp
+TEST_MD5_DEPENDS = IO
+$(eval $(call link-program,TestMD5,TEST_MD5))
+
 TEST_BYTE_ORDER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestByteOrder.cpp
@@ -305,6 +376,39 @@ TEST_CSV_LINE_SOURCES = \
 TEST_CSV_LINE_DEPENDS = MATH
 $(eval $(call link-program,TestCSVLine,TEST_CSV_LINE))
 
+TEST_NMEA_SENTENCE_TABLE_SOURCES = \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestNMEASentenceTable.cpp
+TEST_NMEA_SENTENCE_TABLE_DEPENDS = MATH
+$(eval $(call link-program,TestNMEASentenceTable,TEST_NMEA_SENTENCE_TABLE))
+
+TEST_STAGE_SCHEDULER_SOURCES = \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Computer/StageScheduler.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestStageScheduler.cpp
+TEST_STAGE_SCHEDULER_DEPENDS = UTIL
+$(eval $(call link-program,TestStageScheduler,TEST_STAGE_SCHEDULER))
+
+TEST_PROFILER_SOURCES = \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Profiler.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestProfiler.cpp
+TEST_PROFILER_DEPENDS = IO ZZIP UTIL
+$(eval $(call link-program,TestProfiler,TEST_PROFILER))
+
+TEST_LINE_READER_SOURCES = \
+	$(SRC)/OS/FileMapping.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLineReader.cpp
+TEST_LINE_READER_DEPENDS = IO UTIL
+$(eval $(call link-program,TestLineReader,TEST_LINE_READER))
+
 TEST_GEO_BOUNDS_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoBounds.cpp
@@ -317,6 +421,9 @@ TEST_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/FlarmId.cpp \
 	$(SRC)/FLARM/Record.cpp \
 	$(SRC)/FLARM/Database.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestFlarmNet.cpp
 TEST_FLARM_NET_DEPENDS = MATH IO UTIL
@@ -413,6 +520,19 @@ TEST_STRINGS_SOURCES = \
 	$(TEST_SRC_DIR)/TestStrings.cpp
 $(eval $(call link-program,TestStrings,TEST_STRINGS))
 
+TEST_UTF8_SOURCES = \
+	$(SRC)/Util/UTF8.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestUTF8.cpp
+$(eval $(call link-program,TestUTF8,TEST_UTF8))
+
+TEST_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Screen/LabelBlock.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLabelBlock.cpp
+TEST_LABEL_BLOCK_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,TestLabelBlock,TEST_LABEL_BLOCK))
+
 TEST_POLARS_SOURCES = \
 	$(SRC)/Util/UTF8.cpp \
 	$(SRC)/Profile/ProfileKeys.cpp \
@@ -540,8 +660,20 @@ TEST_RADIX_TREE_SOURCES = \
 	$(TEST_SRC_DIR)/TestRadixTree.cpp
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_QUAD_TREE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestQuadTree.cpp
+$(eval $(call link-program,TestQuadTree,TEST_QUAD_TREE))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCWriter.cpp \
+	$(SRC)/IGC/IGCWriterThread.cpp \
+	$(SRC)/IGC/IGCRecovery.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/StandbyThread.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
 	$(SRC)/Logger/LoggerFRecord.cpp \
 	$(SRC)/Logger/LoggerGRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
@@ -557,6 +689,25 @@ TEST_LOGGER_SOURCES = \
 TEST_LOGGER_DEPENDS = IO MATH
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
+TEST_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Device/Port/Port.cpp \
+	$(SRC)/Device/Port/NullPort.cpp \
+	$(SRC)/Device/Port/LineSplitter.cpp \
+	$(SRC)/Device/Internal.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficList.cpp
+TEST_TRAFFIC_LIST_DEPENDS = DRIVER MATH IO UTIL
+$(eval $(call link-program,TestTrafficList,TEST_TRAFFIC_LIST))
+
 TEST_DRIVER_SOURCES = \
 	$(SRC)/Thread/Mutex.cpp \
 	$(SRC)/Device/Port/NullPort.cpp \
@@ -574,6 +725,7 @@ TEST_DRIVER_SOURCES = \
 	$(SRC)/NMEA/InputLine.cpp \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -607,6 +759,7 @@ TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Thread/Mutex.cpp \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
 	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
@@ -629,6 +782,38 @@ TEST_WAY_POINT_FILE_SOURCES = \
 TEST_WAY_POINT_FILE_DEPENDS = MATH IO UTIL ZZIP
 $(eval $(call link-program,TestWaypointReader,TEST_WAY_POINT_FILE))
 
+TEST_DATA_CACHE_SOURCES = \
+	$(SRC)/Waypoint/WaypointCache.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Geo/UTM.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDataCache.cpp
+TEST_DATA_CACHE_LDADD = $(FAKE_LIBS)
+TEST_DATA_CACHE_DEPENDS = ENGINE IO ZZIP MATH UTIL
+$(eval $(call link-program,TestDataCache,TEST_DATA_CACHE))
+
 TEST_TRACE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -638,6 +823,14 @@ TEST_TRACE_SOURCES = \
 TEST_TRACE_DEPENDS = IO ENGINE MATH UTIL
 $(eval $(call link-program,TestTrace,TEST_TRACE))
 
+TEST_TRACE_SYNC_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(TEST_SRC_DIR)/TestTraceSync.cpp
+TEST_TRACE_SYNC_DEPENDS = IO ENGINE MATH UTIL
+$(eval $(call link-program,TestTraceSync,TEST_TRACE_SYNC))
+
 FLIGHT_TABLE_SOURCES = \
 	$(SRC)/OS/FileUtil.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -663,6 +856,17 @@ DEBUG_PROGRAM_NAMES = \
 	RunOLCAnalysis \
 	FlightPath \
 	BenchmarkProjection \
+	BenchmarkWaypointFilter \
+	BenchmarkLabelBlock \
+	BenchmarkAirspaceRender \
+	BenchmarkWaypoints \
+	BenchmarkLineReader \
+	BenchmarkIGCParser \
+	BenchmarkGRecord \
+	BenchmarkFlarmNet \
+	BenchmarkDataCache \
+	BenchmarkBlackboard \
+	BenchmarkNMEAParser \
 	DumpTextFile DumpTextZip WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -694,6 +898,8 @@ DEBUG_PROGRAM_NAMES = \
 	RunProgressWindow \
 	RunJobDialog \
 	RunAnalysis \
+	RunGlideComputer \
+	BenchmarkReplay \
 	RunAirspaceWarningDialog \
 	TestNotify \
 	FeedNMEA \
@@ -709,6 +915,7 @@ DEBUG_PROGRAM_NAMES = \
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
+	BatchAnalyseFlights \
 	FeedTCP \
 	FeedFlyNetData
 endif
@@ -718,6 +925,10 @@ DEBUG_PROGRAM_NAMES += FeedTCP \
   FeedFlyNetData
 endif
 
+ifeq ($(OPENGL),y)
+DEBUG_PROGRAM_NAMES += BenchmarkText
+endif
+
 ifeq ($(HAVE_NET),y)
 DEBUG_PROGRAM_NAMES += DownloadFile RunDownloadToFile RunNOAADownloader RunLiveTrack24
 endif
@@ -774,6 +985,7 @@ DEBUG_REPLAY_SOURCES = \
 	$(SRC)/FLARM/FlarmId.cpp \
 	$(SRC)/FLARM/Traffic.cpp \
 	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
 	$(SRC)/Computer/BasicComputer.cpp \
 	$(SRC)/Computer/FlyingComputer.cpp \
 	$(SRC)/Engine/Util/Filter.cpp \
@@ -804,6 +1016,7 @@ DEBUG_REPLAY_LDADD = \
 	$(IO_LIBS)
 
 BENCHMARK_PROJECTION_SOURCES = \
+	$(SRC)/OS/Clock.cpp \
 	$(SRC)/Projection/Projection.cpp \
 	$(TEST_SRC_DIR)/BenchmarkProjection.cpp
 BENCHMARK_PROJECTION_DEPENDS = MATH
@@ -1068,6 +1281,7 @@ $(eval $(call link-program,RunInputParser,RUN_INPUT_PARSER))
 RUN_WAY_POINT_PARSER_SOURCES = \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
@@ -1091,6 +1305,163 @@ RUN_WAY_POINT_PARSER_LDADD = $(FAKE_LIBS)
 RUN_WAY_POINT_PARSER_DEPENDS = ENGINE IO ZZIP MATH UTIL
 $(eval $(call link-program,RunWaypointParser,RUN_WAY_POINT_PARSER))
 
+BENCHMARK_WAYPOINT_FILTER_SOURCES = \
+	$(SRC)/Geo/UTM.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Waypoint/WaypointList.cpp \
+	$(SRC)/Waypoint/WaypointListBuilder.cpp \
+	$(SRC)/Waypoint/WaypointFilter.cpp \
+	$(SRC)/Waypoint/WaypointFilterIndex.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkWaypointFilter.cpp
+BENCHMARK_WAYPOINT_FILTER_LDADD = $(FAKE_LIBS)
+BENCHMARK_WAYPOINT_FILTER_DEPENDS = ENGINE IO ZZIP MATH UTIL
+$(eval $(call link-program,BenchmarkWaypointFilter,BENCHMARK_WAYPOINT_FILTER))
+
+BENCHMARK_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Screen/LabelBlock.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(TEST_SRC_DIR)/BenchmarkLabelBlock.cpp
+BENCHMARK_LABEL_BLOCK_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkLabelBlock,BENCHMARK_LABEL_BLOCK))
+
+BENCHMARK_AIRSPACE_RENDER_SOURCES = \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Geo/GeoClip.cpp \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Renderer/AirspaceRenderCache.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceRender.cpp
+BENCHMARK_AIRSPACE_RENDER_DEPENDS = ENGINE MATH UTIL
+BENCHMARK_AIRSPACE_RENDER_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkAirspaceRender,BENCHMARK_AIRSPACE_RENDER))
+
+BENCHMARK_WAYPOINTS_SOURCES = \
+	$(SRC)/Geo/UTM.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkWaypoints.cpp
+BENCHMARK_WAYPOINTS_LDADD = $(FAKE_LIBS)
+BENCHMARK_WAYPOINTS_DEPENDS = ENGINE IO ZZIP MATH UTIL
+$(eval $(call link-program,BenchmarkWaypoints,BENCHMARK_WAYPOINTS))
+
+BENCHMARK_LINE_READER_SOURCES = \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(TEST_SRC_DIR)/BenchmarkLineReader.cpp
+BENCHMARK_LINE_READER_DEPENDS = IO UTIL
+$(eval $(call link-program,BenchmarkLineReader,BENCHMARK_LINE_READER))
+
+BENCHMARK_IGC_PARSER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCFixReader.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(TEST_SRC_DIR)/BenchmarkIGCParser.cpp
+BENCHMARK_IGC_PARSER_DEPENDS = IO ZZIP MATH UTIL
+$(eval $(call link-program,BenchmarkIGCParser,BENCHMARK_IGC_PARSER))
+
+BENCHMARK_GRECORD_SOURCES = \
+	$(SRC)/Logger/LoggerGRecord.cpp \
+	$(SRC)/Logger/MD5.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Util/UTF8.cpp \
+	$(TEST_SRC_DIR)/BenchmarkGRecord.cpp
+BENCHMARK_GRECORD_DEPENDS = IO
+$(eval $(call link-program,BenchmarkGRecord,BENCHMARK_GRECORD))
+
+BENCHMARK_FLARM_NET_SOURCES = \
+	$(SRC)/FLARM/FlarmNetReader.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Record.cpp \
+	$(SRC)/FLARM/Database.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(TEST_SRC_DIR)/BenchmarkFlarmNet.cpp
+BENCHMARK_FLARM_NET_DEPENDS = IO UTIL
+$(eval $(call link-program,BenchmarkFlarmNet,BENCHMARK_FLARM_NET))
+
+BENCHMARK_DATA_CACHE_SOURCES = \
+	$(SRC)/Waypoint/WaypointCache.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Geo/UTM.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkDataCache.cpp
+BENCHMARK_DATA_CACHE_LDADD = $(FAKE_LIBS)
+BENCHMARK_DATA_CACHE_DEPENDS = ENGINE IO ZZIP MATH UTIL
+$(eval $(call link-program,BenchmarkDataCache,BENCHMARK_DATA_CACHE))
+
+BENCHMARK_BLACKBOARD_SOURCES = \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(TEST_SRC_DIR)/BenchmarkBlackboard.cpp
+BENCHMARK_BLACKBOARD_DEPENDS = UTIL
+$(eval $(call link-program,BenchmarkBlackboard,BENCHMARK_BLACKBOARD))
+
 RUN_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -1161,6 +1532,7 @@ RUN_DEVICE_DRIVER_SOURCES = \
 	$(SRC)/Device/Internal.cpp \
 	$(SRC)/FLARM/Traffic.cpp \
 	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
 	$(SRC)/NMEA/Info.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
@@ -1183,6 +1555,42 @@ RUN_DEVICE_DRIVER_SOURCES = \
 RUN_DEVICE_DRIVER_DEPENDS = DRIVER MATH UTIL IO
 $(eval $(call link-program,RunDeviceDriver,RUN_DEVICE_DRIVER))
 
+BENCHMARK_NMEA_PARSER_SOURCES = \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Device/Port/Port.cpp \
+	$(SRC)/Device/Port/NullPort.cpp \
+	$(SRC)/Device/Driver.cpp \
+	$(SRC)/Device/Register.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/Device/Internal.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/Attitude.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/FLARM/FlarmCalculations.cpp \
+	$(SRC)/ClimbAverageCalculator.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Operation/ProxyOperationEnvironment.cpp \
+	$(SRC)/Operation/NoCancelOperationEnvironment.cpp \
+	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/FakeVega.cpp \
+	$(TEST_SRC_DIR)/BenchmarkNMEAParser.cpp
+BENCHMARK_NMEA_PARSER_DEPENDS = DRIVER MATH UTIL IO
+$(eval $(call link-program,BenchmarkNMEAParser,BENCHMARK_NMEA_PARSER))
+
 RUN_DECLARE_SOURCES = \
 	$(SRC)/Device/Port/ConfiguredPort.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -1360,8 +1768,14 @@ RUN_IGC_WRITER_SOURCES = \
 	$(SRC)/FLARM/FlarmCalculations.cpp \
 	$(SRC)/ClimbAverageCalculator.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
-	$(SRC)/Logger/LoggerFRecord.cpp \
-	$(SRC)/Logger/LoggerGRecord.cpp \
+	$(SRC)/IGC/IGCWriterThread.cpp \
+	$(SRC)/IGC/IGCRecovery.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/StandbyThread.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/Logger/LoggerFRecord.cpp \
+	$(SRC)/Logger/LoggerGRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
 	$(SRC)/Logger/MD5.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -1495,6 +1909,31 @@ ANALYSE_FLIGHT_LDADD = $(DEBUG_REPLAY_LDADD)
 ANALYSE_FLIGHT_DEPENDS = UTIL MATH
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
+BATCH_ANALYSE_FLIGHTS_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/Task/TaskFile.cpp \
+	$(SRC)/Task/TaskFileXCSoar.cpp \
+	$(SRC)/Task/TaskFileIGC.cpp \
+	$(SRC)/Task/TaskFileSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/IO/TextWriter.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BatchAnalyseFlights.cpp
+BATCH_ANALYSE_FLIGHTS_LDADD = $(DEBUG_REPLAY_LDADD)
+BATCH_ANALYSE_FLIGHTS_DEPENDS = ENGINE IO ZZIP UTIL MATH
+$(eval $(call link-program,BatchAnalyseFlights,BATCH_ANALYSE_FLIGHTS))
+
 FLIGHT_PATH_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -1528,6 +1967,23 @@ RUN_CANVAS_LDADD = $(FAKE_LIBS)
 RUN_CANVAS_DEPENDS = SCREEN MATH UTIL
 $(eval $(call link-program,RunCanvas,RUN_CANVAS))
 
+BENCHMARK_TEXT_SOURCES = \
+	$(SRC)/Hardware/Display.cpp \
+	$(SRC)/Screen/Layout.cpp \
+	$(SRC)/Thread/Debug.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Notify.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/ResourceLoader.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(TEST_SRC_DIR)/FakeAsset.cpp \
+	$(TEST_SRC_DIR)/FakeBlank.cpp \
+	$(TEST_SRC_DIR)/BenchmarkText.cpp
+BENCHMARK_TEXT_LDADD = $(FAKE_LIBS)
+BENCHMARK_TEXT_DEPENDS = SCREEN MATH UTIL
+$(eval $(call link-program,BenchmarkText,BENCHMARK_TEXT))
+
 RUN_MAP_WINDOW_SOURCES = \
 	$(IO_SRC_DIR)/DataFile.cpp \
 	$(IO_SRC_DIR)/ConfiguredFile.cpp \
@@ -1567,6 +2023,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Projection/CompareProjection.cpp \
 	$(SRC)/Geo/GeoClip.cpp \
 	$(SRC)/MapWindow/MapWindow.cpp \
+	$(SRC)/Profiler.cpp \
 	$(SRC)/MapWindow/MapWindowBlackboard.cpp \
 	$(SRC)/MapWindow/MapWindowEvents.cpp \
 	$(SRC)/MapWindow/MapWindowGlideRange.cpp \
@@ -1587,6 +2044,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/TaskPointRenderer.cpp \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
+	$(SRC)/Renderer/AirspaceRenderCache.cpp \
 	$(SRC)/Renderer/BestCruiseArrowRenderer.cpp \
 	$(SRC)/Renderer/CompassRenderer.cpp \
 	$(SRC)/Renderer/FinalGlideBarRenderer.cpp \
@@ -1674,8 +2132,10 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Waypoint/HomeGlue.cpp \
 	$(SRC)/Waypoint/LastUsed.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
@@ -1959,6 +2419,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/NMEA/ClimbHistory.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
 	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/OS/FileUtil.cpp \
 	$(SRC)/OS/Clock.cpp \
@@ -2076,6 +2537,8 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/TraceComputer.cpp \
 	$(SRC)/Computer/WarningComputer.cpp \
 	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/StageScheduler.cpp \
+	$(SRC)/Profiler.cpp \
 	$(SRC)/Computer/GlideComputerBlackboard.cpp \
 	$(SRC)/Computer/GlideComputerTask.cpp \
 	$(SRC)/Computer/GlideComputerRoute.cpp \
@@ -2102,6 +2565,8 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
@@ -2135,6 +2600,251 @@ RUN_ANALYSIS_LDADD = \
 RUN_ANALYSIS_DEPENDS = DRIVER PROFILE FORM SCREEN DATA_FIELD ENGINE JASPER IO ZZIP UTIL MATH
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+RUN_GLIDE_COMPUTER_SOURCES = \
+	$(SRC)/DateTime.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/MoreData.cpp \
+	$(SRC)/NMEA/Attitude.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/Derived.cpp \
+	$(SRC)/NMEA/VarioInfo.cpp \
+	$(SRC)/NMEA/ClimbInfo.cpp \
+	$(SRC)/NMEA/CirclingInfo.cpp \
+	$(SRC)/NMEA/ThermalBand.cpp \
+	$(SRC)/NMEA/ThermalLocator.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/NMEA/ClimbHistory.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Wind/CirclingWind.cpp \
+	$(SRC)/Wind/WindStore.cpp \
+	$(SRC)/Wind/WindMeasurementList.cpp \
+	$(SRC)/Wind/WindEKF.cpp \
+	$(SRC)/Wind/WindEKFGlue.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Units/Settings.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/LocalPath.cpp \
+	$(SRC)/Thread/Debug.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Terrain/TerrainSettings.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/ThermalBase.cpp \
+	$(SRC)/Computer/ThermalBandComputer.cpp \
+	$(SRC)/Computer/GlideRatioCalculator.cpp \
+	$(SRC)/Computer/AutoQNH.cpp \
+	$(SRC)/Computer/BasicComputer.cpp \
+	$(SRC)/Computer/FlyingComputer.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/WindComputer.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/StageScheduler.cpp \
+	$(SRC)/Profiler.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/GlideComputerTask.cpp \
+	$(SRC)/Computer/GlideComputerRoute.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/GlideComputerStats.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/Computer/CuComputer.cpp \
+	$(SRC)/ComputerSettings.cpp \
+	$(SRC)/TeamCodeSettings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Tracking/TrackingSettings.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/Audio/VegaVoice.cpp \
+	$(SRC)/TeamCode.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Operation/ProxyOperationEnvironment.cpp \
+	$(SRC)/Operation/NoCancelOperationEnvironment.cpp \
+	$(SRC)/Device/Port/Port.cpp \
+	$(SRC)/Device/Port/NullPort.cpp \
+	$(SRC)/Device/Register.cpp \
+	$(SRC)/Device/Driver.cpp \
+	$(SRC)/Device/Internal.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/DebugReplay.cpp \
+	$(TEST_SRC_DIR)/RunGlideComputer.cpp
+RUN_GLIDE_COMPUTER_DEPENDS = DRIVER ENGINE IO ZZIP UTIL MATH
+$(eval $(call link-program,RunGlideComputer,RUN_GLIDE_COMPUTER))
+
+BENCHMARK_REPLAY_SOURCES = \
+	$(SRC)/DateTime.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/MoreData.cpp \
+	$(SRC)/NMEA/Attitude.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/Derived.cpp \
+	$(SRC)/NMEA/VarioInfo.cpp \
+	$(SRC)/NMEA/ClimbInfo.cpp \
+	$(SRC)/NMEA/CirclingInfo.cpp \
+	$(SRC)/NMEA/ThermalBand.cpp \
+	$(SRC)/NMEA/ThermalLocator.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/NMEA/ClimbHistory.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/TrafficStore.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Wind/CirclingWind.cpp \
+	$(SRC)/Wind/WindStore.cpp \
+	$(SRC)/Wind/WindMeasurementList.cpp \
+	$(SRC)/Wind/WindEKF.cpp \
+	$(SRC)/Wind/WindEKFGlue.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Units/Settings.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/LocalPath.cpp \
+	$(SRC)/Thread/Debug.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Terrain/TerrainSettings.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/ThermalBase.cpp \
+	$(SRC)/Computer/ThermalBandComputer.cpp \
+	$(SRC)/Computer/GlideRatioCalculator.cpp \
+	$(SRC)/Computer/AutoQNH.cpp \
+	$(SRC)/Computer/BasicComputer.cpp \
+	$(SRC)/Computer/FlyingComputer.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/WindComputer.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/StageScheduler.cpp \
+	$(SRC)/Profiler.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/GlideComputerTask.cpp \
+	$(SRC)/Computer/GlideComputerRoute.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/GlideComputerStats.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/Computer/CuComputer.cpp \
+	$(SRC)/ComputerSettings.cpp \
+	$(SRC)/TeamCodeSettings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Tracking/TrackingSettings.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/Audio/VegaVoice.cpp \
+	$(SRC)/TeamCode.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Operation/ProxyOperationEnvironment.cpp \
+	$(SRC)/Operation/NoCancelOperationEnvironment.cpp \
+	$(SRC)/Device/Port/Port.cpp \
+	$(SRC)/Device/Port/NullPort.cpp \
+	$(SRC)/Device/Register.cpp \
+	$(SRC)/Device/Driver.cpp \
+	$(SRC)/Device/Internal.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(SRC)/Terrain/RasterProjection.cpp \
+	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileCache.cpp \
+	$(SRC)/Terrain/RasterMap.cpp \
+	$(SRC)/Terrain/RasterTerrain.cpp \
+	$(SRC)/Profile/Profile.cpp \
+	$(SRC)/Profile/ProfileKeys.cpp \
+	$(SRC)/Profile/ComputerProfile.cpp \
+	$(SRC)/Profile/TaskProfile.cpp \
+	$(SRC)/Profile/RouteProfile.cpp \
+	$(SRC)/Profile/AirspaceConfig.cpp \
+	$(SRC)/Profile/TrackingProfile.cpp \
+	$(SRC)/Profile/TerrainConfig.cpp \
+	$(SRC)/Waypoint/HomeGlue.cpp \
+	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Waypoint/WaypointWriter.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
+	$(SRC)/Waypoint/LastUsed.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
+	$(SRC)/Profile/Earth.cpp \
+	$(SRC)/Geo/UTM.cpp \
+	$(SRC)/Geo/GeoClip.cpp \
+	$(SRC)/Plane/PlaneGlue.cpp \
+	$(SRC)/Plane/PlaneFileGlue.cpp \
+	$(SRC)/Polar/Polar.cpp \
+	$(SRC)/Polar/PolarGlue.cpp \
+	$(SRC)/Polar/PolarFileGlue.cpp \
+	$(SRC)/Polar/PolarStore.cpp \
+	$(SRC)/Task/TaskFile.cpp \
+	$(SRC)/Task/TaskFileXCSoar.cpp \
+	$(SRC)/Task/TaskFileIGC.cpp \
+	$(SRC)/Task/TaskFileSeeYou.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(IO_SRC_DIR)/ConfiguredFile.cpp \
+	$(IO_SRC_DIR)/DataFile.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/DebugReplay.cpp \
+	$(TEST_SRC_DIR)/BenchmarkReplay.cpp
+BENCHMARK_REPLAY_DEPENDS = PROFILE DRIVER ENGINE JASPER IO ZZIP UTIL MATH
+$(eval $(call link-program,BenchmarkReplay,BENCHMARK_REPLAY))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Poco/RWLock.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
@@ -2250,7 +2960,9 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Formatter/Units.cpp \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
@@ -2386,6 +3098,7 @@ DUMP_TASK_FILE_SOURCES = \
 	$(SRC)/Task/TaskFileIGC.cpp \
 	$(SRC)/Task/TaskFileSeeYou.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
 	$(SRC)/Operation/Operation.cpp \
 	$(SRC)/RadioFrequency.cpp \
@@ -2399,6 +3112,7 @@ DUMP_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/FlarmId.cpp \
 	$(SRC)/FLARM/Record.cpp \
 	$(SRC)/FLARM/Database.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(TEST_SRC_DIR)/DumpFlarmNet.cpp
 DUMP_FLARM_NET_DEPENDS = MATH IO UTIL
 $(eval $(call link-program,DumpFlarmNet,DUMP_FLARM_NET))
@@ -2406,6 +3120,8 @@ $(eval $(call link-program,DumpFlarmNet,DUMP_FLARM_NET))
 IGC2NMEA_SOURCES = \
 	$(SRC)/Replay/IgcReplay.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCFixReader.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Units/Descriptor.cpp \
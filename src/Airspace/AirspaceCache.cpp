@@ -0,0 +1,243 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceCache.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Airspace/AirspaceCircle.hpp"
+
+#include <vector>
+
+#include <assert.h>
+
+struct AirspaceCacheHeader {
+  enum {
+#ifdef FIXED_MATH
+    VERSION = 0x10,
+#else
+    VERSION = 0x11,
+#endif
+  };
+
+  unsigned version;
+
+  /** sizeof(TCHAR) and sizeof(AirspaceCacheRecord), to detect
+      incompatible builds */
+  unsigned char_size, record_size;
+
+  unsigned num_airspaces, num_points, num_characters;
+};
+
+struct AirspaceCacheRecord {
+  AbstractAirspace::Shape shape;
+  AirspaceClass type;
+  AirspaceActivity days;
+  bool is_convex;
+
+  AirspaceAltitude base, top;
+
+  /**
+   * CIRCLE: the center; POLYGON: the range of the border in the
+   * point array.
+   */
+  unsigned first_point, num_points;
+
+  /** the radius of a CIRCLE */
+  fixed radius;
+};
+
+/**
+ * Append a string including the null terminator.
+ */
+static void
+AppendString(std::vector<TCHAR> &characters, const TCHAR *s)
+{
+  characters.insert(characters.end(), s, s + _tcslen(s) + 1);
+}
+
+bool
+SaveAirspaceCache(FILE *file, const Airspaces &airspaces, unsigned first)
+{
+  assert(first <= airspaces.GetPendingCount());
+
+  std::vector<AirspaceCacheRecord> records;
+  std::vector<GeoPoint> points;
+  std::vector<TCHAR> characters;
+
+  records.reserve(airspaces.GetPendingCount() - first);
+
+  for (unsigned i = first, n = airspaces.GetPendingCount(); i < n; ++i) {
+    const AbstractAirspace &airspace = airspaces.GetPending(i);
+
+    AirspaceCacheRecord record;
+    record.shape = airspace.GetShape();
+    record.type = airspace.GetType();
+    record.days = airspace.GetDays();
+    record.is_convex = airspace.IsConvex();
+    record.base = airspace.GetBase();
+    record.top = airspace.GetTop();
+    record.first_point = points.size();
+
+    switch (airspace.GetShape()) {
+    case AbstractAirspace::Shape::CIRCLE: {
+      const AirspaceCircle &circle = (const AirspaceCircle &)airspace;
+      points.push_back(circle.GetCenter());
+      record.num_points = 1;
+      record.radius = circle.GetRadius();
+      break;
+    }
+
+    case AbstractAirspace::Shape::POLYGON: {
+      const SearchPointVector &border = airspace.GetPoints();
+      for (auto j = border.begin(), end = border.end(); j != end; ++j)
+        points.push_back(j->get_location());
+      record.num_points = border.size();
+      record.radius = fixed_zero;
+      break;
+    }
+    }
+
+    records.push_back(record);
+
+    AppendString(characters, airspace.GetName());
+    AppendString(characters, airspace.GetRadioText().c_str());
+  }
+
+  AirspaceCacheHeader header;
+  header.version = AirspaceCacheHeader::VERSION;
+  header.char_size = sizeof(TCHAR);
+  header.record_size = sizeof(AirspaceCacheRecord);
+  header.num_airspaces = records.size();
+  header.num_points = points.size();
+  header.num_characters = characters.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fwrite(records.data(), sizeof(records.front()), records.size(),
+           file) == records.size() &&
+    fwrite(points.data(), sizeof(points.front()), points.size(),
+           file) == points.size() &&
+    fwrite(characters.data(), sizeof(characters.front()), characters.size(),
+           file) == characters.size();
+}
+
+/**
+ * Returns the next null-terminated string from the character array,
+ * or NULL if the array is exhausted.
+ */
+static const TCHAR *
+NextString(const TCHAR *&p, const TCHAR *end)
+{
+  const TCHAR *s = p;
+  while (p < end)
+    if (*p++ == _T('\0'))
+      return s;
+
+  return NULL;
+}
+
+static AbstractAirspace *
+CreateAirspace(const AirspaceCacheRecord &record,
+               const std::vector<GeoPoint> &points,
+               const TCHAR *name, const TCHAR *radio)
+{
+  if (record.first_point > points.size() ||
+      record.num_points > points.size() - record.first_point)
+    return NULL;
+
+  const GeoPoint *begin = points.data() + record.first_point;
+
+  AbstractAirspace *airspace;
+  switch (record.shape) {
+  case AbstractAirspace::Shape::CIRCLE:
+    if (record.num_points != 1)
+      return NULL;
+
+    airspace = new AirspaceCircle(*begin, record.radius);
+    break;
+
+  case AbstractAirspace::Shape::POLYGON:
+    airspace = new AirspacePolygon(begin, begin + record.num_points,
+                                   record.is_convex);
+    break;
+
+  default:
+    return NULL;
+  }
+
+  airspace->SetProperties(name, record.type, record.base, record.top);
+  airspace->SetRadio(radio);
+  airspace->SetDays(record.days);
+  return airspace;
+}
+
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces)
+{
+  AirspaceCacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != AirspaceCacheHeader::VERSION ||
+      header.char_size != sizeof(TCHAR) ||
+      header.record_size != sizeof(AirspaceCacheRecord) ||
+      header.num_airspaces > 1000000 ||
+      header.num_points > 100000000 ||
+      header.num_characters > 100000000)
+    return false;
+
+  std::vector<AirspaceCacheRecord> records(header.num_airspaces);
+  std::vector<GeoPoint> points(header.num_points);
+  std::vector<TCHAR> characters(header.num_characters);
+
+  if (fread(records.data(), sizeof(records.front()), records.size(),
+            file) != records.size() ||
+      fread(points.data(), sizeof(points.front()), points.size(),
+            file) != points.size() ||
+      fread(characters.data(), sizeof(characters.front()), characters.size(),
+            file) != characters.size())
+    return false;
+
+  /* create all airspaces first, and add them only if the whole file
+     is valid */
+  std::vector<AbstractAirspace *> result;
+  result.reserve(records.size());
+
+  const TCHAR *p = characters.data(), *end = p + characters.size();
+  for (auto i = records.begin(); i != records.end(); ++i) {
+    const TCHAR *name = NextString(p, end);
+    const TCHAR *radio = name != NULL ? NextString(p, end) : NULL;
+    AbstractAirspace *airspace = radio != NULL
+      ? CreateAirspace(*i, points, name, radio)
+      : NULL;
+    if (airspace == NULL) {
+      for (auto j = result.begin(); j != result.end(); ++j)
+        delete *j;
+      return false;
+    }
+
+    result.push_back(airspace);
+  }
+
+  for (auto i = result.begin(); i != result.end(); ++i)
+    airspaces.Add(*i);
+
+  return true;
+}
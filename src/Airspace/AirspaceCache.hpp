@@ -0,0 +1,55 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include <stdio.h>
+
+class Airspaces;
+
+/**
+ * Write the airspaces which were added to the #Airspaces object
+ * since the last Airspaces::Optimise() call (beginning with the
+ * specified index) to a cache file opened by FileCache::Save().
+ *
+ * The cache contains what the parser has produced, i.e. the
+ * geometry, altitudes and attributes; the projection, the search
+ * tree, the ground levels and flight levels are derived data and get
+ * rebuilt by the caller, just like after parsing.
+ *
+ * @param first the index of the first pending airspace, see
+ * Airspaces::GetPendingCount()
+ */
+bool
+SaveAirspaceCache(FILE *file, const Airspaces &airspaces, unsigned first);
+
+/**
+ * Load a cache file opened by FileCache::Load(), and add all of its
+ * airspaces to the #Airspaces object.  On error, the #Airspaces
+ * object is not modified.
+ */
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces);
+
+#endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Terrain/RasterTerrain.hpp"
@@ -30,7 +31,11 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "LogFile.hpp"
 #include "IO/FileLineReader.hpp"
+#include "IO/MappedLineReader.hpp"
 #include "IO/ZipLineReader.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/PathName.hpp"
+#include "Util/StaticString.hpp"
 #include "Profile/Profile.hpp"
 
 #include <windef.h> /* for MAX_PATH */
@@ -50,6 +55,10 @@ static bool
 ParseAirspaceFile(AirspaceParser &parser, const TCHAR *path,
                   OperationEnvironment &operation)
 {
+  MappedLineReader mapped_reader(path, ConvertLineReader::AUTO);
+  if (!mapped_reader.error())
+    return ParseAirspaceFile(parser, path, mapped_reader, operation);
+
   FileLineReader reader(path, ConvertLineReader::AUTO);
   if (!reader.error())
     return ParseAirspaceFile(parser, path, reader, operation);
@@ -62,10 +71,83 @@ ParseAirspaceFile(AirspaceParser &parser, const TCHAR *path,
   return false;
 }
 
-void
+/**
+ * Generate a cache file name which is unique for each configured
+ * airspace file.
+ */
+static void
+MakeCacheName(StaticString<64> &buffer, const TCHAR *path, unsigned index)
+{
+  const TCHAR *base = BaseName(path);
+  buffer.Format(_T("airspace%u-%s"), index, base != NULL ? base : _T(""));
+}
+
+static bool
+LoadAirspaceCacheFile(Airspaces &airspaces, const TCHAR *path,
+                      unsigned index, FileCache &cache)
+{
+  StaticString<64> name;
+  MakeCacheName(name, path, index);
+
+  FILE *file = cache.Load(name, path);
+  if (file == NULL)
+    return false;
+
+  bool success = LoadAirspaceCache(file, airspaces);
+  fclose(file);
+  if (!success)
+    cache.Flush(name);
+
+  return success;
+}
+
+static void
+SaveAirspaceCacheFile(const Airspaces &airspaces, unsigned first,
+                      const TCHAR *path, unsigned index, FileCache &cache)
+{
+  StaticString<64> name;
+  MakeCacheName(name, path, index);
+
+  FILE *file = cache.Save(name, path);
+  if (file == NULL)
+    return;
+
+  if (SaveAirspaceCache(file, airspaces, first))
+    cache.Commit(name, file);
+  else
+    cache.Cancel(name, file);
+}
+
+/**
+ * Load an airspace file from the cache, or parse it and update the
+ * cache.
+ *
+ * @param index a number identifying the profile setting the path
+ * was obtained from
+ */
+static bool
+ReadAirspaceFile(Airspaces &airspaces, AirspaceParser &parser,
+                 const TCHAR *path, unsigned index,
+                 FileCache *cache, OperationEnvironment &operation)
+{
+  if (cache != NULL &&
+      LoadAirspaceCacheFile(airspaces, path, index, *cache))
+    return true;
+
+  const unsigned first = airspaces.GetPendingCount();
+  if (!ParseAirspaceFile(parser, path, operation))
+    return false;
+
+  if (cache != NULL)
+    SaveAirspaceCacheFile(airspaces, first, path, index, *cache);
+
+  return true;
+}
+
+bool
 ReadAirspace(Airspaces &airspaces,
-             RasterTerrain *terrain,
              const AtmosphericPressure &press,
+             FileCache *cache,
              OperationEnvironment &operation)
 {
   LogStartUp(_T("ReadAirspace"));
@@ -78,23 +160,36 @@ ReadAirspace(Airspaces &airspaces,
   // Read the airspace filenames from the registry
   TCHAR path[MAX_PATH];
   if (Profile::GetPath(szProfileAirspaceFile, path))
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= ReadAirspaceFile(airspaces, parser, path, 1,
+                                    cache, operation);
 
   if (Profile::GetPath(szProfileAdditionalAirspaceFile, path))
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= ReadAirspaceFile(airspaces, parser, path, 2,
+                                    cache, operation);
 
   if (Profile::GetPath(szProfileMapFile, path)) {
     _tcscat(path, _T("/airspace.txt"));
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= ReadAirspaceFile(airspaces, parser, path, 0,
+                                    cache, operation);
   }
 
   if (airspace_ok) {
     airspaces.Optimise();
     airspaces.SetFlightLevels(press);
-
-    if (terrain != NULL)
-      airspaces.SetGroundLevels(*terrain);
   } else
     // there was a problem
     airspaces.clear();
+
+  return airspace_ok;
+}
+
+void
+ReadAirspace(Airspaces &airspaces,
+             RasterTerrain *terrain,
+             const AtmosphericPressure &press,
+             FileCache *cache,
+             OperationEnvironment &operation)
+{
+  if (ReadAirspace(airspaces, press, cache, operation) && terrain != NULL)
+    airspaces.SetGroundLevels(*terrain);
 }
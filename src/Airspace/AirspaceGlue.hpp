@@ -27,8 +27,24 @@ Copyright_License {
 class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
+class FileCache;
 class OperationEnvironment;
 
+/**
+ * Reads the airspace files into the memory, without looking up the
+ * terrain ground levels (see Airspaces::SetGroundLevels()).  This
+ * does not need the terrain, and may run in any thread.
+ *
+ * @param cache if not NULL, then the parsed airspaces of each file
+ * are cached, and the file is not parsed again until it is modified
+ * @return true if at least one airspace file was loaded
+ */
+bool
+ReadAirspace(Airspaces &airspaces,
+             const AtmosphericPressure &press,
+             FileCache *cache,
+             OperationEnvironment &operation);
+
 /**
  * Reads the airspace files into the memory
  */
@@ -36,6 +52,7 @@ void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
+             FileCache *cache,
              OperationEnvironment &operation);
 
 #endif
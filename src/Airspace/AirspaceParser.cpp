@@ -26,7 +26,6 @@ Copyright_License {
 #include "Airspace/Airspaces.hpp"
 #include "Operation/Operation.hpp"
 #include "Units/System.hpp"
-#include "Dialogs/Message.hpp"
 #include "Language/Language.hpp"
 #include "Util/CharUtil.hpp"
 #include "Util/StringUtil.hpp"
@@ -232,14 +231,18 @@ struct TempAirspaceType
   }
 };
 
-static bool
-ShowParseWarning(int line, const TCHAR* str)
+/**
+ * Report a malformed line to the #OperationEnvironment.  Unlike a
+ * modal message box, this does not block, so it is safe to parse in
+ * any thread.
+ */
+static void
+ShowParseWarning(int line, const TCHAR* str, OperationEnvironment &operation)
 {
   StaticString<256> buffer;
   buffer.Format(_T("%s: %d\r\n\"%s\"\r\n%s."),
                 _("Parse Error at Line"), line, str, _("Line skipped."));
-  return (ShowMessageBox(buffer, _("Airspace"), MB_OKCANCEL) == IDOK);
-
+  operation.SetErrorMessage(buffer);
 }
 
 static void
@@ -836,6 +839,7 @@ bool
 AirspaceParser::Parse(TLineReader &reader, OperationEnvironment &operation)
 {
   bool ignore = false;
+  bool warned = false;
 
   // Create and init ProgressDialog
   operation.SetProgressRange(1024);
@@ -860,15 +864,19 @@ AirspaceParser::Parse(TLineReader &reader, OperationEnvironment &operation)
     }
 
     // Parse the line
+    bool valid = true;
     if (filetype == AFT_OPENAIR)
-      if (!ParseLine(airspaces, line, temp_area) &&
-          !ShowParseWarning(line_num, line))
-        return false;
+      valid = ParseLine(airspaces, line, temp_area);
 
     if (filetype == AFT_TNP)
-      if (!ParseLineTNP(airspaces, line, temp_area, ignore) &&
-          !ShowParseWarning(line_num, line))
-        return false;
+      valid = ParseLineTNP(airspaces, line, temp_area, ignore);
+
+    /* report only the first error, the following lines are skipped
+       silently */
+    if (!valid && !warned) {
+      ShowParseWarning(line_num, line, operation);
+      warned = true;
+    }
 
     // Update the ProgressDialog
     if ((line_num & 0xff) == 0)
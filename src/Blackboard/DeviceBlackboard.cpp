@@ -42,6 +42,7 @@ Copyright_License {
  * Initializes the DeviceBlackboard
  */
 DeviceBlackboard::DeviceBlackboard()
+  :calculated_sequence(0)
 {
   // Clear the gps_info and calculated_info
   gps_info.Reset();
@@ -57,6 +58,9 @@ DeviceBlackboard::DeviceBlackboard()
 
   real_data = simulator_data = replay_data = gps_info;
 
+  PublishBasic();
+  PublishCalculated(calculated_info);
+
   simulator.Init(simulator_data);
 }
 
@@ -216,7 +220,9 @@ DeviceBlackboard::SetAltitude(fixed val)
 
 /**
  * Reads the given derived_info usually provided by the
- * GlideComputerBlackboard and saves it to the own Blackboard
+ * GlideComputerBlackboard and saves it to the own Blackboard, and
+ * publishes it.  The CalculationThread uses PublishCalculated()
+ * instead.
  * @param derived_info Calculated information usually provided
  * by the GlideComputerBlackboard
  */
@@ -224,6 +230,7 @@ void
 DeviceBlackboard::ReadBlackboard(const DerivedInfo &derived_info)
 {
   calculated_info = derived_info;
+  PublishCalculated(derived_info);
 }
 
 /**
@@ -272,6 +279,13 @@ DeviceBlackboard::Merge()
 {
   real_data.Reset();
   for (unsigned i = 0; i < NUMDEV; ++i) {
+    SPSCQueue<NMEAInfo, 4> &queue = device_queues[i];
+    const NMEAInfo *state;
+    while ((state = queue.Peek()) != NULL) {
+      per_device_data[i] = *state;
+      queue.Shift();
+    }
+
     if (!per_device_data[i].alive)
       continue;
 
@@ -28,7 +28,10 @@ Copyright_License {
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
 #include "Device/Simulator.hpp"
 #include "Device/List.hpp"
+#include "FLARM/ProtectedTrafficStore.hpp"
 #include "Thread/Mutex.hpp"
+#include "Thread/SeqLock.hpp"
+#include "Thread/SPSCQueue.hpp"
 
 #include <cassert>
 
@@ -41,6 +44,12 @@ class OperationEnvironment;
  * 
  * The DeviceBlackboard is used as the global ground truth-state
  * since it is accessed quickly with only one mutex
+ *
+ * The merged NMEA data and the results of the CalculationThread are
+ * additionally published with a #SeqLock, so the threads which only
+ * need a snapshot of them (CalculationThread, DrawThread, main
+ * thread) never lock the mutex, and never make device input wait
+ * while they copy.
  */
 class DeviceBlackboard:
   public BaseBlackboard,
@@ -55,6 +64,15 @@ class DeviceBlackboard:
    */
   NMEAInfo per_device_data[NUMDEV];
 
+  /**
+   * New states of each physical device, submitted by the device's
+   * receive thread without locking the mutex.  Merge() applies them
+   * to #per_device_data in order.  Each item is a complete
+   * NMEAInfo, so a few slots are enough: when the queue is full, the
+   * device simply submits its next (newer) state later.
+   */
+  SPSCQueue<NMEAInfo, 4> device_queues[NUMDEV];
+
   /**
    * Merged data from the physical devices.
    */
@@ -70,6 +88,31 @@ class DeviceBlackboard:
    */
   NMEAInfo replay_data;
 
+  /**
+   * A copy of gps_info, published by the MergeThread.
+   */
+  SeqLocked<MoreData> published_basic;
+
+  /**
+   * The most recent DerivedInfo, published by the
+   * CalculationThread.  FetchCalculated() copies it to
+   * calculated_info.
+   */
+  SeqLocked<DerivedInfo> published_calculated;
+
+  /**
+   * The sequence number of #published_calculated which was last
+   * copied to calculated_info.
+   */
+  unsigned calculated_sequence;
+
+  /**
+   * All FLARM targets received by the devices and by the replay.  It
+   * has its own lock, and is not copied with the NMEAInfo objects,
+   * which carry only the nearest targets.
+   */
+  ProtectedTrafficStore traffic_store;
+
 public:
   Mutex mutex;
 
@@ -93,12 +136,48 @@ public:
     return per_device_data[i];
   }
 
+  /**
+   * Submit a new state of the specified physical device.  This
+   * method does not lock the mutex; it may only be called by the one
+   * thread which feeds this device (usually its receive thread).
+   * Call ScheduleMerge() afterwards.
+   *
+   * @return false if the queue is full; the caller should submit
+   * again later
+   */
+  bool SubmitRealState(unsigned i, const NMEAInfo &state) {
+    assert(i < NUMDEV);
+    return device_queues[i].Push(state);
+  }
+
+  /**
+   * Discard all states which were submitted by the specified device
+   * but not yet applied by Merge().  The caller must lock the mutex,
+   * and must ensure that the device does not submit concurrently.
+   */
+  void ClearRealStateQueue(unsigned i) {
+    assert(i < NUMDEV);
+    device_queues[i].Clear();
+  }
+
   NMEAInfo &SetSimulatorState() { return simulator_data; }
   NMEAInfo &SetReplayState() { return replay_data; }
 
 public:
   const NMEAInfo &RealState() const { return real_data; }
 
+  /**
+   * This method does not lock the blackboard; the returned object has
+   * its own lock.
+   */
+  ProtectedTrafficStore &GetTrafficStore() {
+    return traffic_store;
+  }
+
+  const ProtectedTrafficStore &GetTrafficStore() const {
+    return traffic_store;
+  }
+
   /**
    * Is the specified device a FLARM?
    *
@@ -143,10 +222,53 @@ public:
   void ScheduleMerge();
 
   /**
-   * Copy real_data or simulator_data or replay_data to gps_info.
+   * Apply the states submitted with SubmitRealState(), and copy
+   * real_data or simulator_data or replay_data to gps_info.
    * Caller must lock the blackboard.
    */
   void Merge();
+
+  /**
+   * Publish the current gps_info, to be obtained with ReadBasic().
+   * Caller must lock the blackboard.
+   */
+  void PublishBasic() {
+    published_basic.Write(gps_info);
+  }
+
+  /**
+   * Publish new results of the CalculationThread.  This does not
+   * lock the blackboard; it may be called only by the
+   * CalculationThread (or before it was started).  The next
+   * MergeThread iteration copies the data to calculated_info.
+   */
+  void PublishCalculated(const DerivedInfo &derived_info) {
+    published_calculated.Write(derived_info);
+  }
+
+  /**
+   * Update calculated_info with the data passed to
+   * PublishCalculated().  Caller must lock the blackboard.
+   */
+  void FetchCalculated() {
+    published_calculated.ReadIfModified(calculated_info, calculated_sequence);
+  }
+
+  /**
+   * Copy a consistent snapshot of the merged NMEA data, without
+   * locking the blackboard.
+   */
+  void ReadBasic(MoreData &dest) const {
+    published_basic.Read(dest);
+  }
+
+  /**
+   * Copy a consistent snapshot of the calculated data, without
+   * locking the blackboard.
+   */
+  void ReadCalculated(DerivedInfo &dest) const {
+    published_calculated.Read(dest);
+  }
 };
 
 #endif
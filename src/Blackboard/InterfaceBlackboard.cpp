@@ -21,6 +21,7 @@ Copyright_License {
 }
 */
 #include "InterfaceBlackboard.hpp"
+#include "DeviceBlackboard.hpp"
 
 void
 InterfaceBlackboard::ReadBlackboardCalculated(const DerivedInfo &derived_info)
@@ -34,6 +35,18 @@ InterfaceBlackboard::ReadBlackboardBasic(const MoreData &nmea_info)
   gps_info = nmea_info;
 }
 
+void
+InterfaceBlackboard::ReadPublishedBasic(const DeviceBlackboard &device_blackboard)
+{
+  device_blackboard.ReadBasic(gps_info);
+}
+
+void
+InterfaceBlackboard::ReadPublishedCalculated(const DeviceBlackboard &device_blackboard)
+{
+  device_blackboard.ReadCalculated(calculated_info);
+}
+
 void
 InterfaceBlackboard::ReadComputerSettings(const ComputerSettings
 					  &settings)
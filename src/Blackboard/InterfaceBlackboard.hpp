@@ -27,12 +27,26 @@ Copyright_License {
 #include "LiveBlackboard.hpp"
 #include "Compiler.h"
 
+class DeviceBlackboard;
+
 class InterfaceBlackboard : public LiveBlackboard
 {
 public:
   void ReadBlackboardBasic(const MoreData &nmea_info);
   void ReadBlackboardCalculated(const DerivedInfo &derived_info);
 
+  /**
+   * Copy the NMEA data published by the DeviceBlackboard.  The
+   * DeviceBlackboard does not need to be locked.
+   */
+  void ReadPublishedBasic(const DeviceBlackboard &device_blackboard);
+
+  /**
+   * Copy the calculated data published by the DeviceBlackboard.  The
+   * DeviceBlackboard does not need to be locked.
+   */
+  void ReadPublishedCalculated(const DeviceBlackboard &device_blackboard);
+
   gcc_const
   SystemSettings &SetSystemSettings() {
     return system_settings;
@@ -28,6 +28,7 @@ Copyright_License {
 #include "Blackboard/DeviceBlackboard.hpp"
 #include "Components.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "Profiler.hpp"
 
 /**
  * Constructor of the CalculationThread class
@@ -57,20 +58,20 @@ CalculationThread::SetScreenDistanceMeters(fixed new_value)
 void
 CalculationThread::Tick()
 {
+  ScopeProfile profile(Profiler::CALCULATION_TICK);
+
   const Validity previous_warning =
     glide_computer.Calculated().airspace_warnings.latest;
 
   bool gps_updated;
 
   // update and transfer master info to glide computer
-  {
-    ScopeLock protect(device_blackboard->mutex);
+  device_blackboard->ReadBasic(basic);
 
-    gps_updated = device_blackboard->Basic().location_available.Modified(glide_computer.Basic().location_available);
+  gps_updated = basic.location_available.Modified(glide_computer.Basic().location_available);
 
-    // Copy data from DeviceBlackboard to GlideComputerBlackboard
-    glide_computer.ReadBlackboard(device_blackboard->Basic());
-  }
+  // Copy data from DeviceBlackboard to GlideComputerBlackboard
+  glide_computer.ReadBlackboard(basic);
 
   {
     ScopeLock protect(mutex);
@@ -90,30 +91,19 @@ CalculationThread::Tick()
   // values changed, so copy them back now: ONLY CALCULATED INFO
   // should be changed in DoCalculations, so we only need to write
   // that one back (otherwise we may write over new data)
-  {
-    ScopeLock protect(device_blackboard->mutex);
-    device_blackboard->ReadBlackboard(glide_computer.Calculated());
-  }
+  device_blackboard->PublishCalculated(glide_computer.Calculated());
 
   // if (new GPS data)
   if (gps_updated) {
     // inform map new data is ready
     TriggerCalculatedUpdate();
-  }
 
-  if (do_idle) {
-    // do slow calculations last, to minimise latency
-    glide_computer.ProcessIdle();
-
-    if (glide_computer.Calculated().airspace_warnings.latest != previous_warning) {
+    if (glide_computer.Calculated().airspace_warnings.latest != previous_warning)
       /* there's a new airspace warning */
-
-      {
-        ScopeLock protect(device_blackboard->mutex);
-        device_blackboard->ReadBlackboard(glide_computer.Calculated());
-      }
-
       TriggerAirspaceWarning();
-    }
   }
+
+  if (do_idle)
+    // do slow calculations last, to minimise latency
+    glide_computer.ProcessScheduled();
 }
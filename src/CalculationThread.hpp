@@ -27,6 +27,7 @@ Copyright_License {
 #include "Thread/WorkerThread.hpp"
 #include "Thread/Mutex.hpp"
 #include "ComputerSettings.hpp"
+#include "NMEA/MoreData.hpp"
 
 class GlideComputer;
 
@@ -49,6 +50,12 @@ class CalculationThread : public WorkerThread {
   /** Pointer to the GlideComputer that should be used */
   GlideComputer &glide_computer;
 
+  /**
+   * The snapshot of the DeviceBlackboard's NMEA data, obtained by
+   * Tick().  This is an attribute only to keep it off the stack.
+   */
+  MoreData basic;
+
 public:
   CalculationThread(GlideComputer &_glide_computer);
 
@@ -77,3 +77,16 @@ ClimbAverageCalculator::GetAverage(fixed time, fixed altitude, fixed average_tim
 
   return fixed_zero;
 }
+
+bool
+ClimbAverageCalculator::Expired(fixed now, fixed max_age) const
+{
+  if (newestValIndex < 0)
+    return true;
+
+  const HistoryItem &newest = history[newestValIndex];
+  return !newest.valid ||
+    /* time warp? */
+    now < newest.time ||
+    now > newest.time + max_age;
+}
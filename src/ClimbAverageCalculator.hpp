@@ -45,6 +45,12 @@ public:
   ClimbAverageCalculator();
   fixed GetAverage(fixed time, fixed altitude, fixed average_time);
   void Reset();
+
+  /**
+   * Returns true if the newest sample is older than the specified
+   * age (or if there is none).
+   */
+  bool Expired(fixed now, fixed max_age) const;
 };
 
 #endif
@@ -93,12 +93,17 @@ Copyright_License {
 #include "Task/ProtectedTaskManager.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Operation/VerboseOperationEnvironment.hpp"
+#include "Job/Job.hpp"
+#include "Job/Pool.hpp"
+#include "FLARM/Glue.hpp"
+#include "OS/Clock.hpp"
 #include "Pages.hpp"
 #include "Weather/NOAAGlue.hpp"
 #include "Weather/NOAAStore.hpp"
 #include "Plane/PlaneGlue.hpp"
 #include "UIState.hpp"
 #include "Net/Features.hpp"
+#include "Profiler.hpp"
 #include "Tracking/TrackingGlue.hpp"
 #include "Units/Units.hpp"
 
@@ -204,6 +209,121 @@ XCSoarInterface::AfterStartup()
   status_messages.Startup(false);
 }
 
+/**
+ * The maximum number of data files which are loaded concurrently by
+ * LoadDataFiles().  The jobs are mostly I/O bound, and more threads
+ * would only compete for the storage card.
+ */
+static const unsigned LOAD_THREADS = 4;
+
+class TerrainLoadJob : public Job {
+public:
+  virtual void Run(OperationEnvironment &env) {
+    env.SetText(_("Loading Terrain File..."));
+    LogStartUp(_T("OpenTerrain"));
+    terrain = RasterTerrain::OpenTerrain(file_cache, env);
+  }
+};
+
+class TopographyLoadJob : public Job {
+public:
+  virtual void Run(OperationEnvironment &env) {
+    LoadConfiguredTopography(*topography, env);
+  }
+};
+
+/**
+ * Load the waypoint files and the airfield details.  Depends on
+ * #TerrainLoadJob, because waypoints without elevation get it from
+ * the terrain.
+ */
+class WaypointLoadJob : public Job {
+public:
+  virtual void Run(OperationEnvironment &env) {
+    WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, env);
+    WaypointDetails::ReadFileFromProfile(way_points, env);
+  }
+};
+
+class AirspaceLoadJob : public Job {
+  const AtmosphericPressure &pressure;
+
+public:
+  bool loaded;
+
+  AirspaceLoadJob(const AtmosphericPressure &_pressure)
+    :pressure(_pressure), loaded(false) {}
+
+  virtual void Run(OperationEnvironment &env) {
+    loaded = ReadAirspace(airspace_database, pressure, file_cache, env);
+  }
+};
+
+/**
+ * Apply the terrain ground levels to the airspaces.  Depends on
+ * #TerrainLoadJob and #AirspaceLoadJob.
+ */
+class AirspaceGroundLevelJob : public Job {
+  const AirspaceLoadJob &airspace_job;
+
+public:
+  AirspaceGroundLevelJob(const AirspaceLoadJob &_airspace_job)
+    :airspace_job(_airspace_job) {}
+
+  virtual void Run(OperationEnvironment &env) {
+    if (airspace_job.loaded && terrain != NULL)
+      airspace_database.SetGroundLevels(*terrain);
+  }
+};
+
+class FlarmLoadJob : public Job {
+public:
+  virtual void Run(OperationEnvironment &env) {
+    PreloadFlarmDatabases();
+  }
+};
+
+/**
+ * Load terrain, topography, waypoints, airspaces and the FLARM
+ * databases.  These are independent of each other (except where
+ * noted), and are loaded concurrently.  The duration of each one is
+ * written to the log.
+ */
+static void
+LoadDataFiles(OperationEnvironment &operation)
+{
+  TerrainLoadJob terrain_job;
+  TopographyLoadJob topography_job;
+  WaypointLoadJob waypoint_job;
+  AirspaceLoadJob airspace_job(CommonInterface::GetComputerSettings().pressure);
+  AirspaceGroundLevelJob airspace_ground_level_job(airspace_job);
+  FlarmLoadJob flarm_job;
+
+  JobPool pool;
+  const unsigned terrain_id = pool.Add(terrain_job, _T("terrain"));
+  pool.Add(topography_job, _T("topography"));
+  const unsigned airspace_id = pool.Add(airspace_job, _T("airspace"));
+  pool.Add(flarm_job, _T("FLARM databases"));
+
+  const unsigned waypoint_id = pool.Add(waypoint_job, _T("waypoints"));
+  pool.Depend(waypoint_id, terrain_id);
+
+  const unsigned ground_level_id =
+    pool.Add(airspace_ground_level_job, _T("airspace ground levels"));
+  pool.Depend(ground_level_id, terrain_id);
+  pool.Depend(ground_level_id, airspace_id);
+
+  const uint64_t start_time = MonotonicClockUS();
+  pool.Run(operation, LOAD_THREADS);
+
+  for (unsigned i = 0; i < pool.GetCount(); ++i)
+    LogStartUp(_T("Loading %s took %u ms"), pool.GetName(i),
+               (unsigned)(pool.GetDuration(i) / 1000));
+
+  LogStartUp(_T("Loading data files took %u ms"),
+             (unsigned)((MonotonicClockUS() - start_time) / 1000));
+}
+
 /**
  * "Boots" up XCSoar
  * @param hInstance Instance handle
@@ -325,10 +445,13 @@ XCSoarInterface::Startup()
     new ProtectedTaskManager(*task_manager,
                              XCSoarInterface::GetComputerSettings().task);
 
-  // Read the terrain file
-  operation.SetText(_("Loading Terrain File..."));
-  LogStartUp(_T("OpenTerrain"));
-  terrain = RasterTerrain::OpenTerrain(file_cache, operation);
+  // Read terrain, topography, waypoints and airspaces
+  topography = new TopographyStore();
+  LoadDataFiles(operation);
+
+  bool profiler_enabled = false;
+  Profile::Get(szProfileEnableProfiler, profiler_enabled);
+  Profiler::SetEnabled(profiler_enabled);
 
   glide_computer = new GlideComputer(way_points, airspace_database,
                                      *protected_task_manager,
@@ -351,16 +474,6 @@ XCSoarInterface::Startup()
   PlaneGlue::Synchronize(GetComputerSettings().plane, SetComputerSettings(), gp);
   task_manager->SetGlidePolar(gp);
 
-  // Read the topography file(s)
-  topography = new TopographyStore();
-  LoadConfiguredTopography(*topography, operation);
-
-  // Read the waypoint files
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
-
-  // Read and parse the airfield info file
-  WaypointDetails::ReadFileFromProfile(way_points, operation);
-
   // Set the home waypoint
   WaypointGlue::SetHome(way_points, terrain, SetComputerSettings(),
                         device_blackboard, false);
@@ -373,10 +486,6 @@ XCSoarInterface::Startup()
   LogStartUp(_T("RASP load"));
   RASP.ScanAll(Basic().location, operation);
 
-  // Reads the airspace files
-  ReadAirspace(airspace_database, terrain, GetComputerSettings().pressure,
-               operation);
-
   {
     const AircraftState aircraft_state =
       ToAircraftState(device_blackboard->Basic(),
@@ -420,6 +529,7 @@ XCSoarInterface::Startup()
     map_window->SetTerrain(terrain);
     map_window->SetWeather(&RASP);
     map_window->SetMarks(protected_marks);
+    map_window->SetTrafficStore(&device_blackboard->GetTrafficStore());
     map_window->SetLogger(&logger);
 
     /* show map at home waypoint until GPS fix becomes available */
@@ -447,6 +557,8 @@ XCSoarInterface::Startup()
   // Find unique ID of this PDA
   ReadAssetNumber();
 
+  logger.RecoverPartialFiles();
+
   glide_computer_events.Reset();
   GetLiveBlackboard().AddListener(glide_computer_events);
 
@@ -547,6 +659,8 @@ XCSoarInterface::Shutdown()
   delete calculation_thread;
   calculation_thread = NULL;
 
+  glide_computer->GetScheduler().LogStatistics();
+
   //  Wait for the drawing thread to finish
 #ifndef ENABLE_OPENGL
   LogStartUp(_T("Waiting for draw thread"));
@@ -558,6 +672,13 @@ XCSoarInterface::Shutdown()
   LogStartUp(_T("delete MapWindow"));
   main_window.Deinitialise();
 
+  if (Profiler::IsEnabled()) {
+    LogStartUp(_T("Write profiler results"));
+    TCHAR path[MAX_PATH];
+    LocalPath(path, _T("xcsoar-profile.txt"));
+    Profiler::Dump(path);
+  }
+
   // Save the task for the next time
   operation.SetText(_("Shutdown, saving task..."));
 
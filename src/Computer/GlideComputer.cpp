@@ -34,9 +34,17 @@ Copyright_License {
 #include "Logger/Logger.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "LocalTime.hpp"
+#include "Profiler.hpp"
+
+#include <assert.h>
 
 static PeriodClock last_team_code_update;
 
+/**
+ * The time budget of one ProcessScheduled() call [us].
+ */
+static const unsigned IDLE_BUDGET = 100000;
+
 /**
  * Constructor of the GlideComputer class
  * @return
@@ -49,10 +57,25 @@ GlideComputer::GlideComputer(const Waypoints &_way_points,
   task_computer(task, _airspace_database),
   warning_computer(_airspace_database),
   waypoints(_way_points),
-  team_code_ref_id(-1)
+  team_code_ref_id(-1),
+  task_clock(fixed_zero),
+  save_task_state(false),
+  fix_valid(false), exhaustive(false)
 {
   events.SetComputer(*this);
-  idle_clock.Update();
+
+  last_task_basic.Reset();
+  last_task_calculated.Reset();
+
+  /* budgets in microseconds; the periodic stages get their period
+     from ComputationRateSettings in ProcessGPS() */
+  scheduler.Add(_T("Warnings"), 0, 5000);
+  scheduler.Add(_T("Fast"), 0, 5000);
+  scheduler.Add(_T("Task"), 0, 20000);
+  scheduler.Add(_T("Statistics"), 500, 5000);
+  scheduler.Add(_T("Task idle"), 500, 20000);
+  scheduler.Add(_T("Contest"), 500, 50000);
+  assert(scheduler.size() == N_STAGES);
 }
 
 /**
@@ -69,6 +92,11 @@ GlideComputer::ResetFlight(const bool full)
 
   cu_computer.Reset();
   warning_computer.Reset(Basic(), Calculated());
+
+  task_clock.Reset();
+  last_task_basic.Reset();
+  last_task_calculated.Reset();
+  save_task_state = false;
 }
 
 /**
@@ -85,6 +113,53 @@ GlideComputer::Initialise()
  */
 bool
 GlideComputer::ProcessGPS()
+{
+  const unsigned idle_period = GetComputerSettings().rate.idle_period;
+  scheduler.SetPeriod(STAGE_STATS, idle_period);
+  scheduler.SetPeriod(STAGE_TASK_IDLE, idle_period);
+  scheduler.SetPeriod(STAGE_CONTEST, idle_period);
+
+  scheduler.RunStage(*this, STAGE_FAST);
+
+  /* the airspace warnings need the fully processed fix (expiry, air
+     data), but are still ahead of the slow periodic stages */
+  scheduler.RunStage(*this, STAGE_WARNINGS);
+
+  if (save_task_state) {
+    last_task_basic = Basic();
+    last_task_calculated = Calculated();
+    save_task_state = false;
+  }
+
+  return fix_valid && scheduler.IsDue();
+}
+
+bool
+GlideComputer::IsTaskDecimated() const
+{
+  const ComputationRateSettings &rate = GetComputerSettings().rate;
+  return rate.high_rate_enabled && rate.task_period > 0;
+}
+
+void
+GlideComputer::ProcessTask(const MoreData &last_basic,
+                           const DerivedInfo &last_calculated)
+{
+  const MoreData &basic = Basic();
+  DerivedInfo &calculated = SetCalculated();
+
+  task_computer.ProcessBasicTask(basic, last_basic,
+                                 calculated, last_calculated,
+                                 GetComputerSettings());
+  task_computer.ProcessMoreTask(basic, calculated, last_calculated,
+                                GetComputerSettings());
+}
+
+/**
+ * Process one fix; the task stage is skipped unless it is due.
+ */
+bool
+GlideComputer::ProcessFix()
 {
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
@@ -98,11 +173,12 @@ GlideComputer::ProcessGPS()
                                  GetComputerSettings());
 
   // Process basic task information
-  task_computer.ProcessBasicTask(basic, LastBasic(),
-                                 calculated, LastCalculated(),
-                                 GetComputerSettings());
-  task_computer.ProcessMoreTask(basic, calculated, LastCalculated(),
-                                GetComputerSettings());
+  if (!IsTaskDecimated() ||
+      !basic.time_available ||
+      task_clock.CheckAdvance(basic.time,
+                              fixed(GetComputerSettings().rate.task_period)
+                              / 1000))
+    scheduler.RunStage(*this, STAGE_TASK);
 
   // Check if everything is okay with the gps time and process it
   if (!air_data_computer.FlightTimes(Basic(), LastBasic(), SetCalculated(),
@@ -137,26 +213,92 @@ GlideComputer::ProcessGPS()
   // Update the ConditionMonitors
   ConditionMonitorsUpdate(*this);
 
-  return idle_clock.CheckUpdate(500);
+  return true;
+}
+
+void
+GlideComputer::ProcessScheduled()
+{
+  scheduler.Run(*this, IDLE_BUDGET);
 }
 
 /**
- * Process slow calculations. Called by the CalculationThread.
+ * Process slow calculations.
  */
 void
-GlideComputer::ProcessIdle(bool exhaustive)
+GlideComputer::ProcessIdle(bool _exhaustive)
 {
-  // Log GPS fixes for internal usage
-  // (snail trail, stats, olc, ...)
-  stats_computer.DoLogging(Basic(), LastBasic(), Calculated(),
-                           GetComputerSettings().logger);
+  exhaustive = _exhaustive;
+  scheduler.Run(*this, IDLE_BUDGET, true);
+  exhaustive = false;
+}
 
-  task_computer.ProcessIdle(Basic(), SetCalculated(), GetComputerSettings(),
-                            exhaustive);
+/* the profiler points of the stages are derived from the stage
+   number; both enums must list them in the same order */
+static_assert(GlideComputer::STAGE_WARNINGS == 0 &&
+              Profiler::STAGE_FAST - Profiler::STAGE_WARNINGS ==
+              GlideComputer::STAGE_FAST &&
+              Profiler::STAGE_TASK - Profiler::STAGE_WARNINGS ==
+              GlideComputer::STAGE_TASK &&
+              Profiler::STAGE_STATS - Profiler::STAGE_WARNINGS ==
+              GlideComputer::STAGE_STATS &&
+              Profiler::STAGE_TASK_IDLE - Profiler::STAGE_WARNINGS ==
+              GlideComputer::STAGE_TASK_IDLE &&
+              Profiler::STAGE_CONTEST - Profiler::STAGE_WARNINGS ==
+              GlideComputer::STAGE_CONTEST &&
+              GlideComputer::N_STAGES == GlideComputer::STAGE_CONTEST + 1,
+              "Profiler stage points do not match GlideComputer::Stage");
 
-  if (time_advanced())
-    warning_computer.Update(GetComputerSettings(), Basic(), LastBasic(),
-                            Calculated(), SetCalculated().airspace_warnings);
+void
+GlideComputer::RunStage(unsigned stage)
+{
+  /* unlike the scheduler statistics, this includes the nested
+     STAGE_TASK in STAGE_FAST */
+  ScopeProfile profile(Profiler::Point(Profiler::STAGE_WARNINGS + stage));
+
+  switch ((Stage)stage) {
+  case STAGE_WARNINGS:
+    if (time_advanced())
+      warning_computer.Update(GetComputerSettings(), Basic(), LastBasic(),
+                              Calculated(), SetCalculated().airspace_warnings);
+    break;
+
+  case STAGE_FAST:
+    fix_valid = ProcessFix();
+    break;
+
+  case STAGE_TASK:
+    if (IsTaskDecimated()) {
+      /* in high rate mode, the "last" state of the task stage is the
+         one it has seen last, not the previous fix */
+      ProcessTask(last_task_basic, last_task_calculated);
+      save_task_state = true;
+    } else
+      ProcessTask(LastBasic(), LastCalculated());
+    break;
+
+  case STAGE_STATS:
+    // Log GPS fixes for internal usage
+    // (snail trail, stats, olc, ...)
+    stats_computer.DoLogging(Basic(), LastBasic(), Calculated(),
+                             GetComputerSettings().logger);
+    break;
+
+  case STAGE_TASK_IDLE:
+    task_computer.ProcessIdle(Basic(), Calculated());
+    break;
+
+  case STAGE_CONTEST:
+    /* the contest solver is incremental; each call performs a fixed
+       number of iterations */
+    task_computer.ProcessContest(SetCalculated(), GetComputerSettings(),
+                                 exhaustive);
+    break;
+
+  case N_STAGES:
+    assert(false);
+    break;
+  }
 }
 
 bool
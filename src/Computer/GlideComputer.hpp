@@ -33,6 +33,7 @@ Copyright_License {
 #include "GlideComputerTask.hpp"
 #include "WarningComputer.hpp"
 #include "CuComputer.hpp"
+#include "StageScheduler.hpp"
 #include "Compiler.h"
 
 class Waypoints;
@@ -44,8 +45,51 @@ class RasterTerrain;
 // do not replicate the large items or items that should be singletons
 // OR: just make them static?
 
-class GlideComputer : public GlideComputerBlackboard
+class GlideComputer : public GlideComputerBlackboard,
+                      private StageScheduler::Handler
 {
+public:
+  /**
+   * The stages of the calculation, ordered by priority.
+   */
+  enum Stage {
+    /**
+     * Airspace warnings; checked on every fix, right after
+     * #STAGE_FAST (which includes #STAGE_TASK).
+     */
+    STAGE_WARNINGS,
+
+    /**
+     * Air data, flight state, circling and vario averages; runs for
+     * every fix.
+     */
+    STAGE_FAST,
+
+    /**
+     * Task, final glide, route and terrain warning; decimated in
+     * high rate mode.
+     */
+    STAGE_TASK,
+
+    /**
+     * Snail trail and flight statistics.
+     */
+    STAGE_STATS,
+
+    /**
+     * Task housekeeping, e.g. the AAT optimisation.
+     */
+    STAGE_TASK_IDLE,
+
+    /**
+     * The incremental contest optimisation.
+     */
+    STAGE_CONTEST,
+
+    N_STAGES,
+  };
+
+private:
   GlideComputerAirData air_data_computer;
   GlideComputerTask task_computer;
   GlideComputerStats stats_computer;
@@ -58,9 +102,39 @@ class GlideComputer : public GlideComputerBlackboard
   bool team_code_ref_found;
   GeoPoint team_code_ref_location;
 
-  PeriodClock idle_clock;
   VegaVoice vegavoice;
 
+  /**
+   * Decimates the task stage in high rate mode.
+   */
+  GPSClock task_clock;
+
+  /**
+   * The state after the most recent task stage, which is the "last"
+   * state for the next one when the task stage is decimated.
+   */
+  MoreData last_task_basic;
+  DerivedInfo last_task_calculated;
+
+  /**
+   * Copy the current state to #last_task_basic and
+   * #last_task_calculated at the end of this ProcessGPS() call?
+   */
+  bool save_task_state;
+
+  StageScheduler scheduler;
+
+  /**
+   * The result of the #STAGE_FAST stage: false if the GPS time was
+   * not plausible.
+   */
+  bool fix_valid;
+
+  /**
+   * Shall the #STAGE_CONTEST stage search for the final solution?
+   */
+  bool exhaustive;
+
 public:
   GlideComputer(const Waypoints &_way_points,
                 Airspaces &_airspace_database,
@@ -81,7 +155,23 @@ public:
     SetCalculated().Expire(Basic().clock);
   }
 
-  bool ProcessGPS(); // returns true if idle needs processing
+  /**
+   * Process a new fix: runs the #STAGE_FAST (with #STAGE_TASK) and
+   * #STAGE_WARNINGS stages.
+   *
+   * @return true if ProcessScheduled() has work to do
+   */
+  bool ProcessGPS();
+
+  /**
+   * Run the periodic stages which are due, within the idle time
+   * budget.  Called by the CalculationThread.
+   */
+  void ProcessScheduled();
+
+  /**
+   * Run all periodic stages now, regardless of their period.
+   */
   void ProcessIdle(bool exhaustive=false);
 
   void ProcessExhaustive() {
@@ -124,6 +214,14 @@ public:
     return stats_computer.GetFlightStats();
   }
 
+  /**
+   * Returns the scheduler, for its timing statistics.  This may be
+   * called from any thread.
+   */
+  const StageScheduler &GetScheduler() const {
+    return scheduler;
+  }
+
 protected:
   void OnTakeoff();
   void OnLanding();
@@ -134,6 +232,19 @@ protected:
   void TakeoffLanding();
 
 private:
+  /**
+   * Is the task stage decimated to ComputationRateSettings::task_period?
+   */
+  gcc_pure
+  bool IsTaskDecimated() const;
+
+  bool ProcessFix();
+
+  void ProcessTask(const MoreData &last_basic,
+                   const DerivedInfo &last_calculated);
+
+  /* virtual methods from class StageScheduler::Handler */
+  virtual void RunStage(unsigned stage);
 
   /**
    * Fill the cache variable TeamCodeRefLocation.
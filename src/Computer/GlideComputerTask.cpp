@@ -115,15 +115,20 @@ GlideComputerTask::ProcessMoreTask(const MoreData &basic,
 }
 
 void
-GlideComputerTask::ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
-                               const ComputerSettings &settings_computer,
-                               bool exhaustive)
+GlideComputerTask::ProcessContest(DerivedInfo &calculated,
+                                  const ComputerSettings &settings_computer,
+                                  bool exhaustive)
 {
   if (exhaustive)
     contest.SolveExhaustive(settings_computer, calculated);
   else
     contest.Solve(settings_computer, calculated);
+}
 
+void
+GlideComputerTask::ProcessIdle(const MoreData &basic,
+                               const DerivedInfo &calculated)
+{
   const AircraftState as = ToAircraftState(basic, calculated);
 
   ProtectedTaskManager::ExclusiveLease _task(task);
@@ -84,9 +84,14 @@ public:
   void ProcessAutoTask(const NMEAInfo &basic, const DerivedInfo &calculated,
                        const DerivedInfo &last_calculated);
 
-  void ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
-                   const ComputerSettings &settings_computer,
-                   bool exhaustive=false);
+  /**
+   * Continue the (incremental) contest optimisation.
+   */
+  void ProcessContest(DerivedInfo &calculated,
+                      const ComputerSettings &settings_computer,
+                      bool exhaustive=false);
+
+  void ProcessIdle(const MoreData &basic, const DerivedInfo &calculated);
 };
 
 #endif
@@ -0,0 +1,163 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "StageScheduler.hpp"
+#include "OS/Clock.hpp"
+#include "LogFile.hpp"
+
+StageScheduler::StageScheduler()
+  :n_stages(0), nested_us(0), statistics_start(MonotonicClockMS())
+{
+}
+
+unsigned
+StageScheduler::Add(const TCHAR *name, unsigned period, unsigned budget)
+{
+  assert(n_stages < MAX_STAGES);
+
+  Stage &stage = stages[n_stages];
+  stage.name = name;
+  stage.period = period;
+  stage.budget = budget;
+  stage.last_run = MonotonicClockMS() - period;
+  stage.statistics.Reset();
+
+  return n_stages++;
+}
+
+void
+StageScheduler::RunStage(Handler &handler, unsigned i)
+{
+  assert(i < n_stages);
+
+  Stage &stage = stages[i];
+
+  const uint64_t outer_nested_us = nested_us;
+  nested_us = 0;
+
+  stage.last_run = MonotonicClockMS();
+
+  const uint64_t start_us = MonotonicClockUS();
+  handler.RunStage(i);
+  const uint64_t duration_us = MonotonicClockUS() - start_us;
+
+  const uint64_t own_us = duration_us - nested_us;
+  nested_us = outer_nested_us + duration_us;
+
+  ScopeLock protect(mutex);
+  stage.statistics.Add(own_us, stage.budget);
+}
+
+bool
+StageScheduler::IsDue() const
+{
+  const unsigned now = MonotonicClockMS();
+
+  for (unsigned i = 0; i < n_stages; ++i)
+    if (IsDue(stages[i], now))
+      return true;
+
+  return false;
+}
+
+bool
+StageScheduler::Run(Handler &handler, unsigned budget, bool force)
+{
+  const uint64_t start_us = MonotonicClockUS();
+  bool executed = false, deferred = false;
+
+  for (unsigned i = 0; i < n_stages; ++i) {
+    Stage &stage = stages[i];
+    if (stage.period == 0 ||
+        (!force && !IsDue(stage, MonotonicClockMS())))
+      continue;
+
+    if (!force && executed &&
+        MonotonicClockUS() - start_us + stage.budget > budget) {
+      /* not enough time left in this pass; try again next time */
+      deferred = true;
+
+      ScopeLock protect(mutex);
+      ++stage.statistics.deferred;
+      continue;
+    }
+
+    RunStage(handler, i);
+    executed = true;
+  }
+
+  return deferred;
+}
+
+StageScheduler::Statistics
+StageScheduler::GetStatistics(unsigned i) const
+{
+  assert(i < n_stages);
+
+  ScopeLock protect(mutex);
+  return stages[i].statistics;
+}
+
+double
+StageScheduler::GetLoad() const
+{
+  uint64_t total_us = 0;
+  unsigned start;
+
+  {
+    ScopeLock protect(mutex);
+    for (unsigned i = 0; i < n_stages; ++i)
+      total_us += stages[i].statistics.total_us;
+
+    start = statistics_start;
+  }
+
+  const unsigned elapsed = MonotonicClockMS() - start;
+  return elapsed > 0 ? total_us / (elapsed * 10.) : 0.;
+}
+
+void
+StageScheduler::ResetStatistics()
+{
+  ScopeLock protect(mutex);
+
+  for (unsigned i = 0; i < n_stages; ++i)
+    stages[i].statistics.Reset();
+
+  statistics_start = MonotonicClockMS();
+}
+
+void
+StageScheduler::LogStatistics() const
+{
+  LogStartUp(_T("Calculation load %.2f%%"), GetLoad());
+
+  for (unsigned i = 0; i < n_stages; ++i) {
+    const Statistics statistics = GetStatistics(i);
+    LogStartUp(_T("Stage %s: %u runs, avg %u us, max %u us, "
+                  "%u overruns, %u deferred"),
+               stages[i].name, statistics.count,
+               statistics.GetAverageUS(), (unsigned)statistics.max_us,
+               statistics.overruns, statistics.deferred);
+  }
+}
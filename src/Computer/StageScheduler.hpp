@@ -0,0 +1,210 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_STAGE_SCHEDULER_HPP
+#define XCSOAR_STAGE_SCHEDULER_HPP
+
+#include "Thread/Mutex.hpp"
+#include "Util/NonCopyable.hpp"
+#include "Compiler.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <tchar.h>
+
+/**
+ * A small cooperative scheduler for the stages of the calculation
+ * thread.  Each stage declares a minimum period and a time budget.
+ * The budget is an estimate of one execution's duration, used for
+ * admission and for the statistics; stages are never interrupted,
+ * and a stage which takes longer is only counted as an overrun.
+ *
+ * Stages with a period of zero are not scheduled by Run(); their
+ * owner executes them with RunStage() whenever they are needed (e.g.
+ * on every GPS fix).  Run() executes all periodic stages which are
+ * due, in the order they were added (i.e. by priority).  When the
+ * budget of one Run() call is used up, the remaining stages are
+ * deferred to the next call, instead of delaying everything else.
+ *
+ * The scheduler keeps timing statistics for each stage.  They may
+ * be read from any thread.
+ */
+class StageScheduler : private NonCopyable {
+public:
+  static const unsigned MAX_STAGES = 8;
+
+  struct Statistics {
+    /** the number of executions */
+    unsigned count;
+
+    /** the number of times the stage was postponed by Run() */
+    unsigned deferred;
+
+    /** the number of executions which exceeded the budget */
+    unsigned overruns;
+
+    /** the accumulated and the maximum duration [us] */
+    uint64_t total_us, max_us;
+
+    void Reset() {
+      count = deferred = overruns = 0;
+      total_us = max_us = 0;
+    }
+
+    void Add(uint64_t duration_us, unsigned budget_us) {
+      ++count;
+      total_us += duration_us;
+      if (duration_us > max_us)
+        max_us = duration_us;
+      if (duration_us > budget_us)
+        ++overruns;
+    }
+
+    unsigned GetAverageUS() const {
+      return count > 0 ? unsigned(total_us / count) : 0;
+    }
+  };
+
+  class Handler {
+  public:
+    /**
+     * Execute the specified stage.
+     */
+    virtual void RunStage(unsigned stage) = 0;
+  };
+
+private:
+  struct Stage {
+    const TCHAR *name;
+
+    /** the minimum period [ms]; 0 means "not periodic" */
+    unsigned period;
+
+    /** the time budget of one execution [us] */
+    unsigned budget;
+
+    /** the MonotonicClockMS() of the last execution */
+    unsigned last_run;
+
+    Statistics statistics;
+  };
+
+  Stage stages[MAX_STAGES];
+  unsigned n_stages;
+
+  /**
+   * The duration of the stages which were executed inside the
+   * current RunStage() call, to be subtracted from the outer
+   * stage's duration.
+   */
+  uint64_t nested_us;
+
+  /** the MonotonicClockMS() of the last ResetStatistics() call */
+  unsigned statistics_start;
+
+  /** protects all #Statistics objects and #statistics_start */
+  mutable Mutex mutex;
+
+public:
+  StageScheduler();
+
+  /**
+   * Add a stage.  Stages must be added in the order of their
+   * priority.
+   *
+   * @param period the minimum period [ms]; 0 means the stage is only
+   * executed by RunStage()
+   * @param budget the time budget of one execution [us]
+   * @return the index of the new stage
+   */
+  unsigned Add(const TCHAR *name, unsigned period, unsigned budget);
+
+  unsigned size() const {
+    return n_stages;
+  }
+
+  const TCHAR *GetName(unsigned i) const {
+    assert(i < n_stages);
+
+    return stages[i].name;
+  }
+
+  void SetPeriod(unsigned i, unsigned period) {
+    assert(i < n_stages);
+
+    stages[i].period = period;
+  }
+
+  /**
+   * Execute the specified stage now, regardless of its period.  This
+   * may be called recursively from within Handler::RunStage(); the
+   * time of the inner stage is not accounted to the outer one.
+   */
+  void RunStage(Handler &handler, unsigned i);
+
+  /**
+   * Is at least one periodic stage due?
+   */
+  gcc_pure
+  bool IsDue() const;
+
+  /**
+   * Execute the periodic stages which are due, by priority.  A stage
+   * is deferred if its budget would exceed the remaining budget of
+   * this call; the first due stage is always executed.
+   *
+   * @param budget the time budget of this call [us]
+   * @param force execute all periodic stages, regardless of their
+   * period and of the budget
+   * @return true if at least one stage was deferred
+   */
+  bool Run(Handler &handler, unsigned budget, bool force=false);
+
+  /**
+   * Returns a copy of the statistics of one stage.
+   */
+  gcc_pure
+  Statistics GetStatistics(unsigned i) const;
+
+  /**
+   * Returns the share of the elapsed time since the last
+   * ResetStatistics() call spent in all stages [percent].
+   */
+  gcc_pure
+  double GetLoad() const;
+
+  void ResetStatistics();
+
+  /**
+   * Write the statistics of all stages to the log file.
+   */
+  void LogStatistics() const;
+
+private:
+  gcc_pure
+  bool IsDue(const Stage &stage, unsigned now) const {
+    return stage.period > 0 && now - stage.last_run >= stage.period;
+  }
+};
+
+#endif
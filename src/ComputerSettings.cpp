@@ -91,6 +91,15 @@ FeaturesSettings::SetDefaults()
   nav_baro_altitude_enabled = true;
 }
 
+void
+ComputationRateSettings::SetDefaults()
+{
+  high_rate_enabled = false;
+  calculation_period = 50;
+  task_period = 1000;
+  idle_period = 500;
+}
+
 void
 ComputerSettings::SetDefaults()
 {
@@ -101,6 +110,7 @@ ComputerSettings::SetDefaults()
   voice.SetDefaults();
   poi.SetDefaults();
   features.SetDefaults();
+  rate.SetDefaults();
 
   external_trigger_cruise_enabled =false;
   average_eff_time = ae30seconds;
@@ -220,6 +220,39 @@ struct FeaturesSettings {
   void SetDefaults();
 };
 
+/**
+ * Options for the scheduling of the calculations, which matter for
+ * devices delivering fixes much faster than 1 Hz.
+ */
+struct ComputationRateSettings {
+  /**
+   * Process every fix of a high-rate (5-20 Hz) device?  If enabled,
+   * the merge and calculation threads run with #calculation_period,
+   * and the task/route calculations are decimated to #task_period.
+   */
+  bool high_rate_enabled;
+
+  /**
+   * The minimum duration of one calculation thread period in high
+   * rate mode [ms].
+   */
+  unsigned calculation_period;
+
+  /**
+   * The minimum GPS time between two task and route updates in high
+   * rate mode [ms].
+   */
+  unsigned task_period;
+
+  /**
+   * The minimum duration between two "idle" calculations (contest,
+   * airspace warnings) [ms].
+   */
+  unsigned idle_period;
+
+  void SetDefaults();
+};
+
 enum AverageEffTime {
   ae15seconds,
   ae30seconds,
@@ -244,6 +277,8 @@ struct ComputerSettings {
 
   FeaturesSettings features;
 
+  ComputationRateSettings rate;
+
   bool external_trigger_cruise_enabled;
 
   AverageEffTime average_eff_time;
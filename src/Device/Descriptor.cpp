@@ -42,6 +42,7 @@ Copyright_License {
 #include "Input/InputQueue.hpp"
 #include "LogFile.hpp"
 #include "Job/Job.hpp"
+#include "Profiler.hpp"
 
 #ifdef ANDROID
 #include "Java/Object.hpp"
@@ -92,6 +93,7 @@ DeviceDescriptor::DeviceDescriptor(unsigned _index)
 #ifdef ANDROID
    internal_sensors(NULL),
 #endif
+   receiver(*this),
    ticker(false), borrowed(false)
 {
   config.Clear();
@@ -157,10 +159,7 @@ DeviceDescriptor::Open(Port &_port, OperationEnvironment &env)
 
   reopen_clock.Update();
 
-  device_blackboard->mutex.Lock();
-  device_blackboard->SetRealState(index).Reset();
-  device_blackboard->ScheduleMerge();
-  device_blackboard->mutex.Unlock();
+  ResetState();
 
   settings_sent.Clear();
   settings_received.Clear();
@@ -186,6 +185,7 @@ DeviceDescriptor::Open(Port &_port, OperationEnvironment &env)
   parser.SetIgnoreChecksum(config.ignore_checksum);
   if (config.IsDriver(_T("Condor")))
     parser.DisableGeoid();
+  parser.SetTrafficStore(&device_blackboard->GetTrafficStore());
 
   device = driver->CreateOnPort(config, *port);
   EnableNMEA(env);
@@ -283,10 +283,7 @@ DeviceDescriptor::Close()
 
   ticker = false;
 
-  device_blackboard->mutex.Lock();
-  device_blackboard->SetRealState(index).Reset();
-  device_blackboard->ScheduleMerge();
-  device_blackboard->mutex.Unlock();
+  ResetState();
 
   settings_sent.Clear();
   settings_received.Clear();
@@ -426,7 +423,12 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
        sent to the device */
     const ExternalSettings old_received = settings_received;
     settings_received = info.settings;
-    info.settings.EliminateRedundant(settings_sent, old_received);
+
+    settings_mutex.Lock();
+    const ExternalSettings sent = settings_sent;
+    settings_mutex.Unlock();
+
+    info.settings.EliminateRedundant(sent, old_received);
 
     return true;
   }
@@ -497,10 +499,9 @@ DeviceDescriptor::PutMacCready(fixed value, OperationEnvironment &env)
   if (!device->PutMacCready(value, env))
     return false;
 
-  ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  ScopeLock protect(settings_mutex);
   settings_sent.mac_cready = value;
-  settings_sent.mac_cready_available.Update(basic.clock);
+  settings_sent.mac_cready_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -520,10 +521,9 @@ DeviceDescriptor::PutBugs(fixed value, OperationEnvironment &env)
   if (!device->PutBugs(value, env))
     return false;
 
-  ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  ScopeLock protect(settings_mutex);
   settings_sent.bugs = value;
-  settings_sent.bugs_available.Update(basic.clock);
+  settings_sent.bugs_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -545,12 +545,13 @@ DeviceDescriptor::PutBallast(fixed fraction, fixed overload,
   if (!device->PutBallast(fraction, overload, env))
     return false;
 
-  ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const fixed clock = fixed(MonotonicClockMS()) / 1000;
+
+  ScopeLock protect(settings_mutex);
   settings_sent.ballast_fraction = fraction;
-  settings_sent.ballast_fraction_available.Update(basic.clock);
+  settings_sent.ballast_fraction_available.Update(clock);
   settings_sent.ballast_overload = overload;
-  settings_sent.ballast_overload_available.Update(basic.clock);
+  settings_sent.ballast_overload_available.Update(clock);
 
   return true;
 }
@@ -615,10 +616,9 @@ DeviceDescriptor::PutQNH(const AtmosphericPressure &value,
   if (!device->PutQNH(value, env))
     return false;
 
-  ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  ScopeLock protect(settings_mutex);
   settings_sent.qnh = value;
-  settings_sent.qnh_available.Update(basic.clock);
+  settings_sent.qnh_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -748,13 +748,15 @@ DeviceDescriptor::OnSysTicker(const DerivedInfo &calculated)
   }
 }
 
-bool
-DeviceDescriptor::ParseLine(const char *line)
+void
+DeviceDescriptor::ResetState()
 {
+  receiver.Reset();
+
   ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
-  basic.UpdateClock();
-  return ParseNMEA(line, basic);
+  device_blackboard->ClearRealStateQueue(index);
+  device_blackboard->SetRealState(index).Reset();
+  device_blackboard->ScheduleMerge();
 }
 
 #if defined(__clang__) || GCC_VERSION >= 40700
@@ -790,36 +792,49 @@ DeviceDescriptor::DataReceived(const void *data, size_t length)
   if (monitor != NULL)
     monitor->DataReceived(data, length);
 
+  if (IsNMEAOut())
+    return;
+
   // Pass data directly to drivers that use binary data protocols
   if (driver != NULL && device != NULL && driver->UsesRawData()) {
-    ScopeLock protect(device_blackboard->mutex);
-    NMEAInfo &basic = device_blackboard->SetRealState(index);
-    basic.UpdateClock();
+    NMEAInfo &state = receiver.BeginUpdate();
 
-    const ExternalSettings old_settings = basic.settings;
+    const ExternalSettings old_settings = state.settings;
 
-    if (device->DataReceived(data, length, basic)) {
+    if (device->DataReceived(data, length, state)) {
       if (!config.sync_from_device)
-        basic.settings = old_settings;
+        state.settings = old_settings;
 
-      device_blackboard->ScheduleMerge();
+      receiver.SetModified();
     }
 
-    return;
-  }
-
-  if (!IsNMEAOut())
-    PortLineSplitter::DataReceived(data, length);
+    receiver.Submit();
+  } else
+    /* parse all lines, and submit only once */
+    receiver.DataReceived(data, length);
 }
 
-void
-DeviceDescriptor::LineReceived(const char *line)
+bool
+DeviceDescriptor::ParseReceivedLine(const char *line, NMEAInfo &state)
 {
   NMEALogger::Log(line);
 
   if (dispatcher != NULL)
     dispatcher->LineReceived(line);
 
-  if (ParseLine(line))
-    device_blackboard->ScheduleMerge();
+  ScopeProfile profile(Profiler::DEVICE_PARSE);
+
+  return ParseNMEA(line, state);
+}
+
+bool
+DeviceDescriptor::SubmitReceivedState(const NMEAInfo &state)
+{
+  const bool submitted = device_blackboard->SubmitRealState(index, state);
+
+  /* trigger the MergeThread even if the queue was full, to make room
+     for the next submission */
+  device_blackboard->ScheduleMerge();
+
+  return submitted;
 }
@@ -25,20 +25,21 @@ Copyright_License {
 #define XCSOAR_DEVICE_DESCRIPTOR_HPP
 
 #include "Port/Port.hpp"
-#include "Port/LineSplitter.hpp"
+#include "Receiver.hpp"
 #include "Device/Parser.hpp"
 #include "Profile/DeviceConfig.hpp"
 #include "RadioFrequency.hpp"
+#include "NMEA/Info.hpp"
 #include "NMEA/ExternalSettings.hpp"
 #include "PeriodClock.hpp"
 #include "Job/Async.hpp"
 #include "Thread/Notify.hpp"
+#include "Thread/Mutex.hpp"
 
 #include <assert.h>
 #include <tchar.h>
 #include <stdio.h>
 
-struct NMEAInfo;
 struct DerivedInfo;
 struct Declaration;
 struct Waypoint;
@@ -52,7 +53,8 @@ struct RecordedFlightInfo;
 class OperationEnvironment;
 class OpenDeviceJob;
 
-class DeviceDescriptor : private Notify, private PortLineSplitter {
+class DeviceDescriptor : private Notify, private Port::Handler,
+                         private DeviceReceiver::Handler {
   /** the index of this device in the global list */
   const unsigned index;
 
@@ -124,6 +126,18 @@ class DeviceDescriptor : private Notify, private PortLineSplitter {
    */
   NMEAParser parser;
 
+  /**
+   * Holds this device's private copy of its #NMEAInfo, and submits
+   * it to the #DeviceBlackboard.
+   */
+  DeviceReceiver receiver;
+
+  /**
+   * Protects #settings_sent, which is written by the main thread and
+   * read by the receive thread.
+   */
+  Mutex settings_mutex;
+
   /**
    * The settings that were sent to the device.  This is used to check
    * if the device is sending back the new configuration; then the
@@ -410,7 +424,11 @@ public:
   void OnSysTicker(const DerivedInfo &calculated);
 
 private:
-  bool ParseLine(const char *line);
+  /**
+   * Reset #receiver and this device's slot in the #DeviceBlackboard.
+   * The receive thread must not be running.
+   */
+  void ResetState();
 
   /* virtual methods from class Notify */
   virtual void OnNotification();
@@ -418,8 +436,9 @@ private:
   /* virtual methods from Port::Handler */
   virtual void DataReceived(const void *data, size_t length);
 
-  /* virtual methods from PortLineHandler */
-  virtual void LineReceived(const char *line);
+  /* virtual methods from DeviceReceiver::Handler */
+  virtual bool ParseReceivedLine(const char *line, NMEAInfo &state);
+  virtual bool SubmitReceivedState(const NMEAInfo &state);
 };
 
 #endif
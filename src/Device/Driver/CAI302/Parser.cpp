@@ -26,6 +26,7 @@ Copyright_License {
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
+#include "NMEA/SentenceTable.hpp"
 
 static bool
 ReadSpeedVector(NMEAInputLine &line, SpeedVector &value_r)
@@ -139,6 +140,21 @@ cai_w(NMEAInputLine &line, NMEAInfo &info)
   return true;
 }
 
+enum {
+  CAI_PCAIB = 1,
+  CAI_PCAID,
+  CAI_W,
+};
+
+static const NMEASentenceTable::Entry sentence_entries[] = {
+  { "$PCAIB", CAI_PCAIB },
+  { "$PCAID", CAI_PCAID },
+  { "!w", CAI_W },
+  { NULL, 0 }
+};
+
+static const NMEASentenceTable sentence_table(sentence_entries);
+
 bool
 CAI302Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
@@ -146,17 +162,19 @@ CAI302Device::ParseNMEA(const char *String, NMEAInfo &info)
     return false;
 
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  size_t length;
+  const char *type = line.ReadView(length);
 
-  if (StringIsEqual(type, "$PCAIB"))
+  switch (sentence_table.Find(type, length)) {
+  case CAI_PCAIB:
     return cai_PCAIB(line, info);
 
-  if (StringIsEqual(type, "$PCAID"))
+  case CAI_PCAID:
     return cai_PCAID(line, info);
 
-  if (StringIsEqual(type, "!w"))
+  case CAI_W:
     return cai_w(line, info);
+  }
 
   return false;
 }
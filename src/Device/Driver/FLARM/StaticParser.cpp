@@ -84,12 +84,11 @@ ParsePFLAU(NMEAInputLine &line, FlarmStatus &flarm, fixed clock)
     line.Read((int)FlarmTraffic::AlarmType::NONE);
 }
 
-void
-ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, fixed clock)
+bool
+ParsePFLAA(NMEAInputLine &line, FlarmTraffic &traffic)
 {
   // PFLAA,<AlarmLevel>,<RelativeNorth>,<RelativeEast>,<RelativeVertical>,
   //   <IDType>,<ID>,<Track>,<TurnRate>,<GroundSpeed>,<ClimbRate>,<AcftType>
-  FlarmTraffic traffic;
   traffic.alarm_level = (FlarmTraffic::AlarmType)
     line.Read((int)FlarmTraffic::AlarmType::NONE);
 
@@ -98,17 +97,17 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, fixed clock)
 
   if (!line.ReadChecked(value))
     // Relative North is required !
-    return;
+    return false;
   traffic.relative_north = value;
 
   if (!line.ReadChecked(value))
     // Relative East is required !
-    return;
+    return false;
   traffic.relative_east = value;
 
   if (!line.ReadChecked(value))
     // Relative Altitude is required !
-    return;
+    return false;
   traffic.relative_altitude = value;
 
   line.Skip(); /* id type */
@@ -157,21 +156,13 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, fixed clock)
   else
     traffic.type = (FlarmTraffic::AircraftType)type;
 
-  FlarmTraffic *flarm_slot = flarm.FindTraffic(traffic.id);
-  if (flarm_slot == NULL) {
-    flarm_slot = flarm.AllocateTraffic();
-    if (flarm_slot == NULL)
-      // no more slots available
-      return;
-
-    flarm_slot->Clear();
-    flarm_slot->id = traffic.id;
-
-    flarm.new_traffic.Update(clock);
-  }
-
-  // set time of fix to current time
-  flarm_slot->valid.Update(clock);
+  return true;
+}
 
-  flarm_slot->Update(traffic);
+void
+ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, fixed clock)
+{
+  FlarmTraffic traffic;
+  if (ParsePFLAA(line, traffic))
+    flarm.Update(traffic, clock);
 }
@@ -30,6 +30,7 @@ class NMEAInputLine;
 struct FlarmError;
 struct FlarmVersion;
 struct FlarmStatus;
+struct FlarmTraffic;
 struct TrafficList;
 
 /**
@@ -59,8 +60,17 @@ ParsePFLAU(NMEAInputLine &line, FlarmStatus &flarm, fixed clock);
  * (Data on other moving objects around)
  *
  * @param line A NMEAInputLine instance that can be used for parsing
+ * @param traffic receives the attributes of the target; the time
+ * stamp and the derived attributes are not touched
+ * @return false if a mandatory field is missing
  * @see http://flarm.com/support/manual/FLARM_DataportManual_v5.00E.pdf
  */
+bool
+ParsePFLAA(NMEAInputLine &line, FlarmTraffic &traffic);
+
+/**
+ * Parses a PFLAA sentence and adds the target to the list.
+ */
 void
 ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, fixed clock);
 
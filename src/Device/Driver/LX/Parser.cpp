@@ -24,6 +24,7 @@ Copyright_License {
 #include "Internal.hpp"
 #include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "NMEA/Info.hpp"
 #include "Engine/Navigation/SpeedVector.hpp"
 #include "Units/System.hpp"
@@ -223,6 +224,27 @@ PLXVS(NMEAInputLine &line, NMEAInfo &info)
   return true;
 }
 
+enum {
+  LX_LXWP0 = 1,
+  LX_LXWP1,
+  LX_LXWP2,
+  LX_LXWP3,
+  LX_PLXVF,
+  LX_PLXVS,
+};
+
+static const NMEASentenceTable::Entry sentence_entries[] = {
+  { "$LXWP0", LX_LXWP0 },
+  { "$LXWP1", LX_LXWP1 },
+  { "$LXWP2", LX_LXWP2 },
+  { "$LXWP3", LX_LXWP3 },
+  { "$PLXVF", LX_PLXVF },
+  { "$PLXVS", LX_PLXVS },
+  { NULL, 0 }
+};
+
+static const NMEASentenceTable sentence_table(sentence_entries);
+
 bool
 LXDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
@@ -230,26 +252,28 @@ LXDevice::ParseNMEA(const char *String, NMEAInfo &info)
     return false;
 
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  size_t length;
+  const char *type = line.ReadView(length);
 
-  if (StringIsEqual(type, "$LXWP0"))
+  switch (sentence_table.Find(type, length)) {
+  case LX_LXWP0:
     return LXWP0(line, info);
 
-  if (StringIsEqual(type, "$LXWP1"))
+  case LX_LXWP1:
     return LXWP1(line, info);
 
-  if (StringIsEqual(type, "$LXWP2"))
+  case LX_LXWP2:
     return LXWP2(line, info);
 
-  if (StringIsEqual(type, "$LXWP3"))
+  case LX_LXWP3:
     return LXWP3(line, info);
 
-  if (StringIsEqual(type, "$PLXVF"))
+  case LX_PLXVF:
     return PLXVF(line, info);
 
-  if (StringIsEqual(type, "$PLXVS"))
+  case LX_PLXVS:
     return PLXVS(line, info);
+  }
 
   return false;
 }
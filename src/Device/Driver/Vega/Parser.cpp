@@ -26,6 +26,7 @@ Copyright_License {
 #include "Input/InputQueue.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Compiler.h"
 #include "Util/Macros.hpp"
 
@@ -275,29 +276,61 @@ PDTSM(NMEAInputLine &line, gcc_unused NMEAInfo &info)
   return true;
 }
 
+enum {
+  VEGA_PDSWC = 1,
+  VEGA_PDAAV,
+  VEGA_PDVSC,
+  VEGA_PDVDV,
+  VEGA_PDVDS,
+  VEGA_PDVVT,
+  VEGA_PDVSD,
+  VEGA_PDTSM,
+};
+
+static const NMEASentenceTable::Entry sentence_entries[] = {
+  { "$PDSWC", VEGA_PDSWC },
+  { "$PDAAV", VEGA_PDAAV },
+  { "$PDVSC", VEGA_PDVSC },
+  { "$PDVDV", VEGA_PDVDV },
+  { "$PDVDS", VEGA_PDVDS },
+  { "$PDVVT", VEGA_PDVVT },
+  { "$PDVSD", VEGA_PDVSD },
+  { "$PDTSM", VEGA_PDTSM },
+  { NULL, 0 }
+};
+
+static const NMEASentenceTable sentence_table(sentence_entries);
+
 bool
 VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  size_t length;
+  const char *type = line.ReadView(length);
 
-  if (memcmp(type, "$PD", 3) == 0)
+  if (length >= 3 && memcmp(type, "$PD", 3) == 0)
     detected = true;
 
-  if (strcmp(type, "$PDSWC") == 0)
+  switch (sentence_table.Find(type, length)) {
+  case VEGA_PDSWC:
     return PDSWC(line, info);
-  else if (strcmp(type, "$PDAAV") == 0)
+
+  case VEGA_PDAAV:
     return PDAAV(line, info);
-  else if (strcmp(type, "$PDVSC") == 0)
+
+  case VEGA_PDVSC:
     return PDVSC(line, info);
-  else if (strcmp(type, "$PDVDV") == 0)
+
+  case VEGA_PDVDV:
     return PDVDV(line, info);
-  else if (strcmp(type, "$PDVDS") == 0)
+
+  case VEGA_PDVDS:
     return PDVDS(line, info);
-  else if (strcmp(type, "$PDVVT") == 0)
+
+  case VEGA_PDVVT:
     return PDVVT(line, info);
-  else if (strcmp(type, "$PDVSD") == 0) {
+
+  case VEGA_PDVSD: {
     const char *message = line.Rest();
 #ifdef _UNICODE
     TCHAR buffer[strlen(message)];
@@ -310,8 +343,11 @@ VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
 
     Message::AddMessage(buffer);
     return true;
-  } else if (strcmp(type, "$PDTSM") == 0)
+  }
+
+  case VEGA_PDTSM:
     return PDTSM(line, info);
-  else
-    return false;
+  }
+
+  return false;
 }
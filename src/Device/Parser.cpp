@@ -31,12 +31,15 @@ Copyright_License {
 #include "NMEA/Info.hpp"
 #include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Util/StringUtil.hpp"
 #include "Compatibility/string.h" /* for _ttoi() */
 #include "Units/System.hpp"
 #include "OS/Clock.hpp"
 #include "Driver/FLARM/StaticParser.hpp"
+#include "FLARM/ProtectedTrafficStore.hpp"
 
+#include <assert.h>
 #include <math.h>
 #include <ctype.h>
 #include <stdlib.h>
@@ -50,7 +53,7 @@ using std::max;
 int NMEAParser::start_day = -1;
 
 NMEAParser::NMEAParser(bool _ignore_checksum)
-  :ignore_checksum(_ignore_checksum)
+  :ignore_checksum(_ignore_checksum), traffic_store(NULL)
 {
   Reset();
 }
@@ -63,6 +66,63 @@ NMEAParser::Reset()
   last_time = fixed_zero;
 }
 
+namespace NMEASentence {
+  enum Code {
+    UNKNOWN,
+    GSA,
+    GLL,
+    RMC,
+    GGA,
+    PTAS1,
+    PFLAE,
+    PFLAV,
+    PFLAA,
+    PFLAU,
+    PGRMZ,
+  };
+}
+
+/**
+ * The sentences understood by NMEAParser.  The first ones are
+ * looked up without the talker id ("GP", "GN", ...), the proprietary
+ * ones with the "P".
+ */
+static const NMEASentenceTable::Entry sentence_entries[] = {
+  { "GSA", NMEASentence::GSA },
+  { "GLL", NMEASentence::GLL },
+  { "RMC", NMEASentence::RMC },
+  { "GGA", NMEASentence::GGA },
+  { "PTAS1", NMEASentence::PTAS1 },
+  { "PFLAE", NMEASentence::PFLAE },
+  { "PFLAV", NMEASentence::PFLAV },
+  { "PFLAA", NMEASentence::PFLAA },
+  { "PFLAU", NMEASentence::PFLAU },
+  { "PGRMZ", NMEASentence::PGRMZ },
+  { NULL, NMEASentence::UNKNOWN }
+};
+
+static const NMEASentenceTable sentence_table(sentence_entries);
+
+gcc_pure
+static unsigned
+LookupSentence(const char *address, size_t length)
+{
+  assert(length > 0 && address[0] == '$');
+
+  /* a standard sentence with a two-letter talker id */
+  if (length == 6 && IsAlphaASCII(address[1]) && IsAlphaASCII(address[2])) {
+    const unsigned code = sentence_table.Find(address + 3, 3);
+    if (code != NMEASentence::UNKNOWN)
+      return code;
+  }
+
+  // if (proprietary sentence) ...
+  if (address[1] == 'P')
+    return sentence_table.Find(address + 1, length - 1);
+
+  return NMEASentence::UNKNOWN;
+}
+
 bool
 NMEAParser::ParseLine(const char *string, NMEAInfo &info)
 {
@@ -76,55 +136,46 @@ NMEAParser::ParseLine(const char *string, NMEAInfo &info)
 
   NMEAInputLine line(string);
 
-  char type[16];
-  line.Read(type, 16);
+  size_t length;
+  const char *address = line.ReadView(length);
 
-  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
-    if (StringIsEqual(type + 3, "GSA"))
-      return GSA(line, info);
+  switch (LookupSentence(address, length)) {
+  case NMEASentence::GSA:
+    return GSA(line, info);
 
-    if (StringIsEqual(type + 3, "GLL"))
-      return GLL(line, info);
+  case NMEASentence::GLL:
+    return GLL(line, info);
 
-    if (StringIsEqual(type + 3, "RMC"))
-      return RMC(line, info);
+  case NMEASentence::RMC:
+    return RMC(line, info);
 
-    if (StringIsEqual(type + 3, "GGA"))
-      return GGA(line, info);
-  }
+  case NMEASentence::GGA:
+    return GGA(line, info);
 
-  // if (proprietary sentence) ...
-  if (type[1] == 'P') {
     // Airspeed and vario sentence
-    if (StringIsEqual(type + 1, "PTAS1"))
-      return PTAS1(line, info);
+  case NMEASentence::PTAS1:
+    return PTAS1(line, info);
 
     // FLARM sentences
-    if (StringIsEqual(type + 1, "PFLAE")) {
-      ParsePFLAE(line, info.flarm.error, info.clock);
-      return true;
-    }
+  case NMEASentence::PFLAE:
+    ParsePFLAE(line, info.flarm.error, info.clock);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAV")) {
-      ParsePFLAV(line, info.flarm.version, info.clock);
-      return true;
-    }
+  case NMEASentence::PFLAV:
+    ParsePFLAV(line, info.flarm.version, info.clock);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAA")) {
-      ParsePFLAA(line, info.flarm.traffic, info.clock);
-      return true;
-    }
+  case NMEASentence::PFLAA:
+    PFLAA(line, info);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAU")) {
-      ParsePFLAU(line, info.flarm.status, info.clock);
-      return true;
-    }
+  case NMEASentence::PFLAU:
+    ParsePFLAU(line, info.flarm.status, info.clock);
+    return true;
 
     // Garmin altitude sentence
-    if (StringIsEqual(type + 1, "PGRMZ"))
-      return RMZ(line, info);
-
-    return false;
+  case NMEASentence::PGRMZ:
+    return RMZ(line, info);
   }
 
   return false;
@@ -629,6 +680,21 @@ NMEAParser::NMEAChecksum(const char *string)
   return VerifyNMEAChecksum(string);
 }
 
+void
+NMEAParser::PFLAA(NMEAInputLine &line, NMEAInfo &info)
+{
+  FlarmTraffic traffic;
+  if (!ParsePFLAA(line, traffic))
+    return;
+
+  info.flarm.traffic.Update(traffic, info.clock);
+
+  if (traffic_store != NULL) {
+    ProtectedTrafficStore::ExclusiveLease store(*traffic_store);
+    store->Update(traffic, info.clock);
+  }
+}
+
 bool
 NMEAParser::PTAS1(NMEAInputLine &line, NMEAInfo &info)
 {
@@ -28,6 +28,7 @@ Copyright_License {
 
 struct NMEAInfo;
 struct BrokenDateTime;
+class ProtectedTrafficStore;
 class NMEAInputLine;
 struct GeoPoint;
 
@@ -37,6 +38,12 @@ class NMEAParser
   static int start_day;
   fixed last_time;
 
+  /**
+   * If not NULL, then all PFLAA targets are added to this store, in
+   * addition to the (small) TrafficList of the NMEAInfo.
+   */
+  ProtectedTrafficStore *traffic_store;
+
 public:
   bool real;
 
@@ -62,6 +69,10 @@ public:
     use_geoid = true;
   }
 
+  void SetTrafficStore(ProtectedTrafficStore *_traffic_store) {
+    traffic_store = _traffic_store;
+  }
+
   /**
    * Parses a provided NMEA String into a NMEA_INFO struct
    * @param line NMEA string
@@ -168,6 +179,12 @@ private:
    * @return Parsing success
    */
   static bool PTAS1(NMEAInputLine &line, NMEAInfo &info);
+
+  /**
+   * Parses a PFLAA sentence (FLARM traffic) into the TrafficList of
+   * the NMEAInfo and into #traffic_store.
+   */
+  void PFLAA(NMEAInputLine &line, NMEAInfo &info);
 };
 
 #endif
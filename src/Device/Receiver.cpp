@@ -0,0 +1,72 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Receiver.hpp"
+
+DeviceReceiver::DeviceReceiver(Handler &_handler)
+  :handler(_handler), submit_pending(false)
+{
+  state.Reset();
+}
+
+void
+DeviceReceiver::Reset()
+{
+  state.Reset();
+  submit_pending = false;
+}
+
+void
+DeviceReceiver::Submit()
+{
+  if (!submit_pending)
+    return;
+
+  /* DeviceBlackboard::Merge() expires only its own copy, which gets
+     replaced by the next submission; expire the private state, or
+     stale FLARM targets would fill up its TrafficList */
+  state.Expire();
+
+  if (handler.SubmitReceivedState(state))
+    submit_pending = false;
+}
+
+void
+DeviceReceiver::DataReceived(const void *data, size_t length)
+{
+  /* apply the timeout which the DeviceBlackboard has applied to its
+     copy meanwhile */
+  state.ExpireWallClock();
+
+  PortLineSplitter::DataReceived(data, length);
+
+  Submit();
+}
+
+void
+DeviceReceiver::LineReceived(const char *line)
+{
+  state.UpdateClock();
+  if (handler.ParseReceivedLine(line, state))
+    submit_pending = true;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_DEVICE_RECEIVER_HPP
+#define XCSOAR_DEVICE_RECEIVER_HPP
+
+#include "Port/LineSplitter.hpp"
+#include "NMEA/Info.hpp"
+
+/**
+ * The receive path of a device: the port's receive thread parses
+ * the NMEA sentences into a private #NMEAInfo without locking,
+ * expires it and submits a copy after each chunk of data, see
+ * DeviceBlackboard::SubmitRealState().
+ *
+ * This is used by #DeviceDescriptor, and does not depend on the
+ * #DeviceBlackboard or on the UI, so it can be tested on its own.
+ *
+ * Only the receive thread may use this object while the #Port is
+ * open.
+ */
+class DeviceReceiver : public PortLineSplitter {
+public:
+  class Handler {
+  public:
+    /**
+     * Parse one NMEA sentence into the specified state.
+     *
+     * @return true if the state has been modified
+     */
+    virtual bool ParseReceivedLine(const char *line, NMEAInfo &state) = 0;
+
+    /**
+     * Submit a copy of the state to the merge thread, and wake it up.
+     *
+     * @return false if the queue is full; the state will be
+     * submitted again after the next chunk of data
+     */
+    virtual bool SubmitReceivedState(const NMEAInfo &state) = 0;
+  };
+
+private:
+  Handler &handler;
+
+  NMEAInfo state;
+
+  /**
+   * Has #state been modified since it was last submitted?  This is
+   * still set after a submission has failed because the queue was
+   * full.
+   */
+  bool submit_pending;
+
+public:
+  DeviceReceiver(Handler &_handler);
+
+  void Reset();
+
+  bool IsSubmitPending() const {
+    return submit_pending;
+  }
+
+  /**
+   * Obtain the state for a driver which parses binary data instead
+   * of NMEA sentences.  Call SetModified() if it has been modified,
+   * and Submit() afterwards.
+   */
+  NMEAInfo &BeginUpdate() {
+    state.ExpireWallClock();
+    state.UpdateClock();
+    return state;
+  }
+
+  void SetModified() {
+    submit_pending = true;
+  }
+
+  /**
+   * Expire stale values in the state and submit it if it has been
+   * modified.
+   */
+  void Submit();
+
+  /**
+   * Parse all lines in the chunk, and submit the state only once.
+   */
+  virtual void DataReceived(const void *data, size_t length);
+
+protected:
+  /* virtual methods from PortLineHandler */
+  virtual void LineReceived(const char *line);
+};
+
+#endif
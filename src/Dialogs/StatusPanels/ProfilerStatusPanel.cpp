@@ -0,0 +1,85 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ProfilerStatusPanel.hpp"
+#include "Profiler.hpp"
+#include "Interface.hpp"
+#include "Util/StaticString.hpp"
+
+void
+ProfilerStatusPanel::Refresh()
+{
+  StaticString<80> text;
+
+  for (unsigned i = 0; i < Profiler::N_POINTS; ++i) {
+    const Profiler::Point point = (Profiler::Point)i;
+    const Profiler::Result result = Profiler::Get(point);
+    if (result.count == 0) {
+      SetText(i, _T(""));
+      continue;
+    }
+
+    /* the average of the most recent durations */
+    unsigned history[Profiler::HISTORY_SIZE];
+    const unsigned n = Profiler::GetHistory(point, history,
+                                            Profiler::HISTORY_SIZE);
+    unsigned sum = 0;
+    for (unsigned j = 0; j < n; ++j)
+      sum += history[j];
+
+    text.Format(_T("avg %.1f, recent %.1f, max %.1f ms"),
+                result.GetAverageUS() / 1000.,
+                sum / 1000. / n,
+                result.max_us / 1000.);
+    SetText(i, text);
+  }
+}
+
+void
+ProfilerStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
+{
+  for (unsigned i = 0; i < Profiler::N_POINTS; ++i)
+    AddReadOnly(Profiler::GetName((Profiler::Point)i));
+}
+
+void
+ProfilerStatusPanel::Show(const PixelRect &rc)
+{
+  Refresh();
+  CommonInterface::GetLiveBlackboard().AddListener(rate_limiter);
+  StatusPanel::Show(rc);
+}
+
+void
+ProfilerStatusPanel::Hide()
+{
+  StatusPanel::Hide();
+  CommonInterface::GetLiveBlackboard().RemoveListener(rate_limiter);
+  rate_limiter.Cancel();
+}
+
+void
+ProfilerStatusPanel::OnGPSUpdate(const MoreData &basic)
+{
+  Refresh();
+}
@@ -24,7 +24,9 @@ Copyright_License {
 #include "SystemStatusPanel.hpp"
 #include "Logger/Logger.hpp"
 #include "Components.hpp"
+#include "Computer/GlideComputer.hpp"
 #include "Interface.hpp"
+#include "InfoBoxes/InfoBoxManager.hpp"
 #include "Language/Language.hpp"
 
 enum Controls {
@@ -34,6 +36,11 @@ enum Controls {
   FLARM,
   Logger,
   Battery,
+  InfoBoxUpdates,
+  CalculationLoad,
+
+  /** one row for each GlideComputer::Stage */
+  FirstStage,
 };
 
 gcc_pure
@@ -103,6 +110,31 @@ SystemStatusPanel::Refresh()
     Temp.AppendFormat(_T("%.0f%%"), (double)basic.battery_level);
 
   SetText(Battery, Temp);
+
+  /* how many InfoBox updates actually changed something, and how
+     often they were repainted */
+  const InfoBoxManager::Statistics &infobox = InfoBoxManager::statistics;
+  Temp.Format(_T("%u (%u changed), %u repaints"),
+              infobox.updates, infobox.changed, infobox.repaints);
+  SetText(InfoBoxUpdates, Temp);
+
+  if (glide_computer == NULL)
+    return;
+
+  const StageScheduler &scheduler = glide_computer->GetScheduler();
+
+  Temp.Format(_T("%.1f %%"), scheduler.GetLoad());
+  SetText(CalculationLoad, Temp);
+
+  for (unsigned i = 0; i < scheduler.size(); ++i) {
+    const StageScheduler::Statistics statistics = scheduler.GetStatistics(i);
+    Temp.Format(_T("avg %.1f ms, max %.1f ms"),
+                statistics.GetAverageUS() / 1000.,
+                statistics.max_us / 1000.);
+    if (statistics.deferred > 0)
+      Temp.AppendFormat(_T(", %u deferred"), statistics.deferred);
+    SetText(FirstStage + i, Temp);
+  }
 }
 
 void
@@ -114,6 +146,16 @@ SystemStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
   AddReadOnly(_T("FLARM"));
   AddReadOnly(_("Logger"));
   AddReadOnly(_("Supply voltage"));
+  AddReadOnly(_("InfoBox updates"));
+
+  if (glide_computer == NULL)
+    return;
+
+  AddReadOnly(_("Calculation load"));
+
+  const StageScheduler &scheduler = glide_computer->GetScheduler();
+  for (unsigned i = 0; i < scheduler.size(); ++i)
+    AddReadOnly(scheduler.GetName(i));
 }
 
 void
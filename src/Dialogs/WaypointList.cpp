@@ -36,6 +36,7 @@ Copyright_License {
 #include "Waypoint/WaypointList.hpp"
 #include "Waypoint/WaypointListBuilder.hpp"
 #include "Waypoint/WaypointFilter.hpp"
+#include "Waypoint/WaypointFilterIndex.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Components.hpp"
 #include "Compiler.h"
@@ -68,6 +69,12 @@ static WndProperty *distance_filter;
 static WndProperty *direction_filter;
 static WndProperty *type_filter;
 
+/**
+ * Kept across dialog invocations, it is rebuilt only when the
+ * waypoint database changes.
+ */
+static WaypointFilterIndex filter_index;
+
 static OrderedTask *ordered_task;
 static unsigned ordered_task_index;
 
@@ -222,10 +229,13 @@ FillList(WaypointList &list, const Waypoints &src,
 
   WaypointListBuilder builder(filter, location, list,
                               ordered_task, ordered_task_index);
-  builder.Visit(src);
 
-  if (positive(filter.distance) || !negative(filter.direction.Native()))
-    list.SortByDistance(location);
+  if (positive(filter.distance) || !negative(filter.direction.Native())) {
+    /* the index returns the waypoints ordered by distance */
+    filter_index.Update(src);
+    builder.Visit(filter_index);
+  } else
+    builder.Visit(src);
 }
 
 static void
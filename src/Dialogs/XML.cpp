@@ -56,9 +56,12 @@ Copyright_License {
 #include "ResourceLoader.hpp"
 #include "Look/DialogLook.hpp"
 #include "Inflate.hpp"
+#include "Asset.hpp"
 
 #include <zlib/zlib.h>
 
+#include <list>
+
 #include <stdio.h>    // for _stprintf
 #include <assert.h>
 #include <tchar.h>
@@ -326,14 +329,62 @@ LoadXMLFromResource(const TCHAR* resource, XML::Results *xml_results)
   return x;
 }
 
+/**
+ * The most recently used dialog resources, already parsed.  Inflating
+ * and parsing a resource takes longer than creating the dialog's
+ * controls, and the resources never change at runtime.
+ */
+class XMLDialogCache {
+  struct Item {
+    tstring resource;
+
+    /** a shallow copy of the parsed tree */
+    XMLNode node;
+
+    Item(const TCHAR *_resource, XMLNode &&_node)
+      :resource(_resource), node(std::move(_node)) {}
+  };
+
+  /** most recently used first */
+  std::list<Item> items;
+
+public:
+  const XMLNode *Get(const TCHAR *resource) {
+    for (auto i = items.begin(), end = items.end(); i != end; ++i) {
+      if (i->resource == resource) {
+        items.splice(items.begin(), items, i);
+        return &items.front().node;
+      }
+    }
+
+    return NULL;
+  }
+
+  const XMLNode &Add(const TCHAR *resource, XMLNode &&node) {
+    const unsigned max_size = HasLittleMemory() ? 4 : 16;
+    if (items.size() >= max_size)
+      items.pop_back();
+
+    items.emplace_front(resource, std::move(node));
+    return items.front().node;
+  }
+};
+
+static XMLDialogCache xml_dialog_cache;
+
 /**
  * Tries to load an XML file from the resources
  * @param lpszXML The resource name
- * @return The parsed XMLNode
+ * @return The parsed XMLNode (a shallow copy, which remains valid
+ * when the resource is evicted from the cache)
  */
-static XMLNode *
+static XMLNode
 LoadXMLFromResource(const TCHAR *resource)
 {
+  const XMLNode *cached = xml_dialog_cache.Get(resource);
+  if (cached != NULL)
+    return *cached;
+
   XML::Results xml_results;
 
   // Reset errors
@@ -345,8 +396,12 @@ LoadXMLFromResource(const TCHAR *resource)
 
   // Show errors if they exist
   assert(xml_results.error == XML::eXMLErrorNone);
+  assert(node != NULL);
 
-  return node;
+  const XMLNode &result = xml_dialog_cache.Add(resource, std::move(*node));
+  delete node;
+
+  return result;
 }
 
 static void
@@ -386,12 +441,10 @@ LoadWindow(const CallBackTableEntry *lookup_table, SubForm *form,
   if (!form)
     return NULL;
 
-  XMLNode *node = LoadXMLFromResource(resource);
-  assert(node != NULL);
+  const XMLNode node = LoadXMLFromResource(resource);
 
   // load only one top-level control.
-  Window *window = LoadChild(*form, parent, lookup_table, *node, 0, style);
-  delete node;
+  Window *window = LoadChild(*form, parent, lookup_table, node, 0, style);
 
   assert(!XML::global_error);
 
@@ -415,20 +468,16 @@ LoadDialog(const CallBackTableEntry *lookup_table, SingleWindow &parent,
   WndForm *form = NULL;
 
   // Find XML file or resource and load XML data out of it
-  XMLNode *node = LoadXMLFromResource(resource);
-
-  // TODO code: put in error checking here and get rid of exits in xmlParser
-  // If XML error occurred -> Error messagebox + cancel
-  assert(node != NULL);
+  const XMLNode node = LoadXMLFromResource(resource);
 
   // If the main XMLNode is of type "Form"
-  assert(StringIsEqual(node->GetName(), _T("Form")));
+  assert(StringIsEqual(node.GetName(), _T("Form")));
 
   // Determine the dialog size
-  const TCHAR* caption = GetCaption(*node);
+  const TCHAR* caption = GetCaption(node);
   const PixelRect rc = target_rc ? *target_rc : parent.GetClientRect();
-  ControlPosition pos = GetPosition(*node, rc, 0);
-  ControlSize size = GetSize(*node, rc, pos);
+  ControlPosition pos = GetPosition(node, rc, 0);
+  ControlSize size = GetSize(node, rc, pos);
 
   InitScaleWidth(size, rc);
 
@@ -469,8 +518,7 @@ LoadDialog(const CallBackTableEntry *lookup_table, SingleWindow &parent,
 
   // Load the children controls
   LoadChildrenFromXML(*form, form->GetClientAreaWindow(),
-                      lookup_table, node);
-  delete node;
+                      lookup_table, &node);
 
   // If XML error occurred -> Error messagebox + cancel
   assert(!XML::global_error);
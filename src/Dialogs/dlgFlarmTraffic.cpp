@@ -50,6 +50,8 @@
 #include "Formatter/UserUnits.hpp"
 #include "Units/Units.hpp"
 #include "Renderer/UnitSymbolRenderer.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Components.hpp"
 
 /**
  * A Window which renders FLARM traffic, with user interaction.
@@ -72,7 +74,7 @@ protected:
   void CalcAutoZoom();
 
 public:
-  void Update(Angle new_direction, const TrafficList &new_data,
+  void Update(Angle new_direction, const TrafficStore &new_data,
               const TeamCodeSettings &new_settings);
   void UpdateTaskDirection(bool show_task_direction, Angle bearing);
 
@@ -192,7 +194,7 @@ FlarmTrafficControl::CalcAutoZoom()
 }
 
 void
-FlarmTrafficControl::Update(Angle new_direction, const TrafficList &new_data,
+FlarmTrafficControl::Update(Angle new_direction, const TrafficStore &new_data,
                             const TeamCodeSettings &new_settings)
 {
   FlarmTrafficWindow::Update(new_direction, new_data, new_settings);
@@ -671,9 +673,11 @@ Update()
       XCSoarInterface::Basic().flarm.traffic.IsEmpty())
     wf->SetModalResult(mrOK);
 
-  wdf->Update(XCSoarInterface::Basic().track,
-              XCSoarInterface::Basic().flarm.traffic,
-              CommonInterface::GetComputerSettings().team_code);
+  {
+    ProtectedTrafficStore::Lease store(device_blackboard->GetTrafficStore());
+    wdf->Update(XCSoarInterface::Basic().track, store,
+                CommonInterface::GetComputerSettings().team_code);
+  }
 
   wdf->UpdateTaskDirection(XCSoarInterface::Calculated().task_stats.task_valid &&
                            XCSoarInterface::Calculated().task_stats.current_leg.solution_remaining.IsOk(),
@@ -42,6 +42,7 @@
 #include "LocalPath.hpp"
 #include "UIGlobals.hpp"
 #include "Components.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
 #include "Formatter/UserUnits.hpp"
 #include "Formatter/AngleFormatter.hpp"
 #include "Util/StringUtil.hpp"
@@ -63,14 +64,22 @@ static void
 UpdateChanging()
 {
   TCHAR tmp[20];
-  const FlarmTraffic* target =
-    XCSoarInterface::Basic().flarm.traffic.FindTraffic(target_id);
 
-  bool target_ok = target && target->IsDefined();
+  /* the radar shows the targets of the TrafficStore, which may
+     not all be in the NMEAInfo */
+  FlarmTraffic target;
+  bool target_ok;
+  {
+    ProtectedTrafficStore::Lease store(device_blackboard->GetTrafficStore());
+    const FlarmTraffic *traffic = store->FindTraffic(target_id);
+    target_ok = traffic != NULL && traffic->IsDefined();
+    if (target_ok)
+      target = *traffic;
+  }
 
   // Fill distance field
   if (target_ok)
-    FormatUserDistanceSmart(target->distance, tmp, 20, fixed(1000));
+    FormatUserDistanceSmart(target.distance, tmp, 20, fixed(1000));
   else
     _tcscpy(tmp, _T("--"));
   SetFormValue(*wf, _T("prpDistance"), tmp);
@@ -78,30 +87,30 @@ UpdateChanging()
   // Fill horizontal direction field
   if (target_ok)
     FormatAngleDelta(tmp, ARRAY_SIZE(tmp),
-                     target->Bearing() - CommonInterface::Basic().track);
+                     target.Bearing() - CommonInterface::Basic().track);
   else
     _tcscpy(tmp, _T("--"));
   SetFormValue(*wf, _T("prpDirectionH"), tmp);
 
   // Fill altitude field
-  if (target_ok && target->altitude_available)
-    FormatUserAltitude(target->altitude, tmp, 20);
+  if (target_ok && target.altitude_available)
+    FormatUserAltitude(target.altitude, tmp, 20);
   else
     _tcscpy(tmp, _T("--"));
   SetFormValue(*wf, _T("prpAltitude"), tmp);
 
   // Fill vertical direction field
   if (target_ok) {
-    Angle dir = Angle::Radians((fixed)atan2(target->relative_altitude,
-                                            target->distance)).AsDelta();
+    Angle dir = Angle::Radians((fixed)atan2(target.relative_altitude,
+                                            target.distance)).AsDelta();
     FormatVerticalAngleDelta(tmp, ARRAY_SIZE(tmp), dir);
   } else
     _tcscpy(tmp, _T("--"));
   SetFormValue(*wf, _T("prpDirectionV"), tmp);
 
   // Fill climb speed field
-  if (target_ok && target->climb_rate_avg30s_available)
-    FormatUserVerticalSpeed(target->climb_rate_avg30s, tmp, 20);
+  if (target_ok && target.climb_rate_avg30s_available)
+    FormatUserVerticalSpeed(target.climb_rate_avg30s, tmp, 20);
   else
     _tcscpy(tmp, _T("--"));
   SetFormValue(*wf, _T("prpVSpeed"), tmp);
@@ -31,6 +31,7 @@ Copyright_License {
 #include "StatusPanels/RulesStatusPanel.hpp"
 #include "StatusPanels/SystemStatusPanel.hpp"
 #include "StatusPanels/TimesStatusPanel.hpp"
+#include "StatusPanels/ProfilerStatusPanel.hpp"
 #include "Screen/Key.h"
 #include "Protection.hpp"
 #include "Math/Earth.hpp"
@@ -40,6 +41,7 @@ Copyright_License {
 #include "Math/FastMath.h"
 #include "LocalTime.hpp"
 #include "Components.hpp"
+#include "Profiler.hpp"
 #include "Task/ProtectedTaskManager.hpp"
 #include "Navigation/Geometry/GeoVector.hpp"
 #include "Compiler.h"
@@ -122,6 +124,11 @@ dlgStatusShowModal(int start_page)
   Widget *times_panel = new TimesStatusPanel(look);
   wTabBar->AddTab(times_panel, _T("Times"), false, TimesIcon);
 
+  if (Profiler::IsEnabled()) {
+    Widget *profiler_panel = new ProfilerStatusPanel(look);
+    wTabBar->AddTab(profiler_panel, _T("Profiler"), false);
+  }
+
   /* restore previous page */
 
   if (start_page != -1) {
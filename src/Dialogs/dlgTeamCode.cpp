@@ -138,6 +138,10 @@ OnFlarmLockClicked(gcc_unused WndButton &button)
   FlarmId ids[30];
   unsigned count =
     FlarmDetails::FindIdsByCallSign(settings.team_flarm_callsign, ids, 30);
+  if (count == 0)
+    /* no exact match: offer all callsigns beginning with the input */
+    count = FlarmDetails::FindIdsByCallSignPrefix(settings.team_flarm_callsign,
+                                                  ids, 30);
 
   if (count > 0) {
     const FlarmId id =
@@ -222,6 +222,10 @@ public:
     days_of_operation = mask;
   }
 
+  const AirspaceActivity &GetDays() const {
+    return days_of_operation;
+  }
+
   /** 
    * Get type of airspace
    * 
@@ -336,6 +340,10 @@ public:
     return m_border;
   }
 
+  bool IsConvex() const {
+    return m_is_convex;
+  }
+
   /**
    * On-demand access of clearance border.  Generated on call,
    * to deallocate, call clear_clearance().  Uses mutable object
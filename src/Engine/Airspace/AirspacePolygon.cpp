@@ -59,6 +59,17 @@ AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts,
   }
 }
 
+AirspacePolygon::AirspacePolygon(const GeoPoint *begin, const GeoPoint *end,
+                                 bool is_convex)
+  :AbstractAirspace(Shape::POLYGON)
+{
+  m_is_convex = is_convex;
+
+  m_border.reserve(end - begin);
+  for (const GeoPoint *i = begin; i != end; ++i)
+    m_border.push_back(SearchPoint(*i));
+}
+
 const GeoPoint 
 AirspacePolygon::GetCenter() const
 {
@@ -46,6 +46,17 @@ public:
    */
   AirspacePolygon(const std::vector<GeoPoint> &pts, const bool prune = false);
 
+  /**
+   * Constructor for a border which has been closed and checked by
+   * the other constructor before, e.g. one which is loaded from a
+   * cache file.  This skips the (expensive) convexity check.
+   *
+   * @param is_convex the AbstractAirspace::IsConvex() value of the
+   * original airspace
+   */
+  AirspacePolygon(const GeoPoint *begin, const GeoPoint *end,
+                  bool is_convex);
+
   /**
    * Get arbitrary center or reference point for use in determining
    * overall center location of all airspaces
@@ -253,6 +253,7 @@ Airspaces::Optimise()
       tmp_as.pop_front();
     }
     airspace_tree.optimise();
+    ++serial;
   }
 }
 
@@ -279,6 +280,7 @@ Airspaces::Add(AbstractAirspace *airspace)
   }
 
   tmp_as.push_back(airspace);
+  ++serial;
 }
 
 void
@@ -303,6 +305,7 @@ Airspaces::clear()
 
   // then delete the tree
   airspace_tree.clear();
+  ++serial;
 }
 
 unsigned
@@ -26,12 +26,15 @@
 #include "AirspaceActivity.hpp"
 #include "Predicate/AirspacePredicate.hpp"
 #include "Util/NonCopyable.hpp"
+#include "Util/Serial.hpp"
 #include "Navigation/TaskProjection.hpp"
 #include "Atmosphere/Pressure.hpp"
 #include "Compiler.h"
 
 #include <deque>
 
+#include <assert.h>
+
 class RasterTerrain;
 class AirspaceVisitor;
 class AirspaceIntersectionVisitor;
@@ -68,6 +71,11 @@ class Airspaces:
   AtmosphericPressure qnh;
   AirspaceActivity activity_mask;
 
+  /**
+   * This gets incremented each time airspaces are added or removed.
+   */
+  Serial serial;
+
   bool owns_children;
 
   AirspaceTree airspace_tree;
@@ -98,6 +106,10 @@ public:
    */
   ~Airspaces();
 
+  const Serial &GetSerial() const {
+    return serial;
+  }
+
   /** 
    * Add airspace to the internal airspace tree.  
    * The airspace is not copied; ownership is transferred to this class if
@@ -119,6 +131,24 @@ public:
    */
   void clear();
 
+  /**
+   * Returns the number of airspaces which were added since the last
+   * Optimise() call.
+   */
+  unsigned GetPendingCount() const {
+    return tmp_as.size();
+  }
+
+  /**
+   * Returns an airspace which was added since the last Optimise()
+   * call, in the order of the Add() calls.
+   */
+  const AbstractAirspace &GetPending(unsigned i) const {
+    assert(i < tmp_as.size());
+
+    return *tmp_as[i];
+  }
+
   /**
    * Size of airspace (in tree, not in temporary store) ---
    * must call optimise() before this for it to be accurate.
@@ -114,15 +114,23 @@ void
 ContestDijkstra::UpdateTrace(bool force)
 {
   if (!IsMasterUpdated()) {
-    if ((finished || force) &&
-        append_serial != trace_master.GetAppendSerial()) {
+    if (append_serial == trace_master.GetAppendSerial())
+      return;
+
+    if (finished) {
       const unsigned old_size = n_points;
       if (UpdateTraceTail())
         /* new data from the master trace, start incremental solver */
         AddIncrementalEdges(old_size);
+      return;
     }
 
-    return;
+    if (!force)
+      return;
+
+    /* the incremental solver can only resume a finished search; the
+       caller wants the new points now, so reload the whole trace
+       and start over */
   }
 
   trace.reserve(trace_master.GetMaxSize());
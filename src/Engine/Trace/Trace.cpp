@@ -477,3 +477,32 @@ Trace::GetPoints(TracePointVector &v, unsigned min_time,
     i.NextSquareRange(sq_range, end);
   } while (i != end);
 }
+
+bool
+Trace::SyncPoints(TracePointVector &v, const GeoPoint &location,
+                  fixed min_distance) const
+{
+  assert(!v.empty());
+
+  const unsigned last_time = v.back().GetTime();
+
+  /* walk back to the first point which is not in the vector yet;
+     usually, that is only one or two points */
+  Trace::const_iterator i = end(), begin = this->begin();
+  while (i != begin) {
+    --i;
+    if (i->GetTime() <= last_time) {
+      ++i;
+      break;
+    }
+  }
+
+  const size_t old_size = v.size();
+  const unsigned range = ProjectRange(location, min_distance);
+  const unsigned sq_range = range * range;
+  for (const Trace::const_iterator end = this->end(); i != end; ++i)
+    if (i->FlatSquareDistance(v.back()) >= sq_range)
+      v.push_back(*i);
+
+  return v.size() > old_size;
+}
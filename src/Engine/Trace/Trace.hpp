@@ -381,6 +381,16 @@ public:
   void GetPoints(TracePointVector &v, unsigned min_time,
                  const GeoPoint &location, fixed resolution) const;
 
+  /**
+   * Append the points which were added after the last element of the
+   * vector, with the same resolution filter as GetPoints().  This must
+   * not be called after thinning has occurred, see GetModifySerial().
+   *
+   * @return true if new points were added
+   */
+  bool SyncPoints(TracePointVector &v, const GeoPoint &location,
+                  fixed resolution) const;
+
   const TracePoint &front() const {
     assert(!empty());
 
@@ -22,9 +22,130 @@ Copyright_License {
 */
 
 #include "Database.hpp"
+#include "OS/FileMapping.hpp"
 #include "Util/StringUtil.hpp"
 
-#include <assert.h>
+#include <algorithm>
+
+#include <string.h>
+
+struct FlarmDatabase::Header {
+  enum {
+    VERSION = 1,
+  };
+
+  uint32_t version;
+
+  /** sizeof(FlarmRecord), to detect incompatible builds (e.g. a
+      different TCHAR) */
+  uint32_t record_size;
+
+  uint32_t num_records, num_callsigns;
+};
+
+/* the records follow the two uint32_t arrays in the image */
+static_assert(sizeof(FlarmId) == sizeof(uint32_t), "Wrong FlarmId size");
+static_assert(sizeof(uint32_t) % sizeof(TCHAR) == 0, "Wrong TCHAR size");
+
+class FlarmDatabase::CallSignCompare {
+  const FlarmRecord *records;
+
+public:
+  CallSignCompare(const FlarmRecord *_records):records(_records) {}
+
+  bool operator()(uint32_t a, uint32_t b) const {
+    int result = _tcscmp(records[a].callsign, records[b].callsign);
+    return result < 0 || (result == 0 && a < b);
+  }
+
+  bool operator()(uint32_t a, const TCHAR *b) const {
+    return _tcscmp(records[a].callsign, b) < 0;
+  }
+
+  bool operator()(const TCHAR *a, uint32_t b) const {
+    return _tcscmp(a, records[b].callsign) < 0;
+  }
+};
+
+/**
+ * Compares only the first characters of the call sign, i.e. all call
+ * signs beginning with the prefix are considered equal.
+ */
+class FlarmDatabase::PrefixCompare {
+  const FlarmRecord *records;
+  size_t length;
+
+public:
+  PrefixCompare(const FlarmRecord *_records, size_t _length)
+    :records(_records), length(_length) {}
+
+  bool operator()(const TCHAR *a, uint32_t b) const {
+    return _tcsncmp(a, records[b].callsign, length) < 0;
+  }
+};
+
+class FlarmRecordIndexCompare {
+  const std::vector<FlarmId> &ids;
+
+public:
+  FlarmRecordIndexCompare(const std::vector<FlarmId> &_ids):ids(_ids) {}
+
+  bool operator()(unsigned a, unsigned b) const {
+    return ids[a] < ids[b];
+  }
+};
+
+FlarmDatabase::FlarmDatabase()
+  :mapping(NULL), num_records(0), num_callsigns(0),
+   ids(NULL), records(NULL), by_callsign(NULL) {}
+
+FlarmDatabase::~FlarmDatabase()
+{
+  delete mapping;
+}
+
+void
+FlarmDatabase::SetVectors()
+{
+  assert(mapping == NULL);
+
+  num_records = record_vector.size();
+  num_callsigns = callsign_vector.size();
+  ids = id_vector.data();
+  records = record_vector.data();
+  by_callsign = callsign_vector.data();
+}
+
+void
+FlarmDatabase::Unmap()
+{
+  delete mapping;
+  mapping = NULL;
+}
+
+void
+FlarmDatabase::Clear()
+{
+  Unmap();
+
+  id_vector.clear();
+  record_vector.clear();
+  callsign_vector.clear();
+  SetVectors();
+}
+
+void
+FlarmDatabase::Detach()
+{
+  assert(mapping != NULL);
+
+  id_vector.assign(ids, ids + num_records);
+  record_vector.assign(records, records + num_records);
+  callsign_vector.assign(by_callsign, by_callsign + num_callsigns);
+
+  Unmap();
+  SetVectors();
+}
 
 void
 FlarmDatabase::Insert(const FlarmRecord &record)
@@ -34,21 +155,158 @@ FlarmDatabase::Insert(const FlarmRecord &record)
     /* ignore malformed records */
     return;
 
-  map.insert(std::make_pair(id, record));
+  if (mapping != NULL)
+    Detach();
+
+  id_vector.push_back(id);
+  record_vector.push_back(record);
 }
 
-const FlarmRecord *
-FlarmDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+void
+FlarmDatabase::Optimise()
 {
-  for (auto i = map.begin(), end = map.end(); i != end; ++i) {
-    assert(i->first.IsDefined());
+  if (mapping != NULL || IsOptimised())
+    return;
+
+  /* sort by id; the stable sort keeps the first of several records
+     with the same id in front */
+  std::vector<unsigned> order(record_vector.size());
+  for (unsigned i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::stable_sort(order.begin(), order.end(),
+                   FlarmRecordIndexCompare(id_vector));
 
-    const FlarmRecord &record = i->second;
-    if (StringIsEqual(record.callsign, cn))
-      return &record;
+  std::vector<FlarmId> new_ids;
+  std::vector<FlarmRecord> new_records;
+  new_ids.reserve(order.size());
+  new_records.reserve(order.size());
+
+  for (auto i = order.begin(), end = order.end(); i != end; ++i) {
+    if (!new_ids.empty() && new_ids.back() == id_vector[*i])
+      continue;
+
+    new_ids.push_back(id_vector[*i]);
+    new_records.push_back(record_vector[*i]);
+  }
+
+  id_vector.swap(new_ids);
+  record_vector.swap(new_records);
+
+  callsign_vector.clear();
+  for (unsigned i = 0; i < record_vector.size(); ++i)
+    if (!record_vector[i].callsign.empty())
+      callsign_vector.push_back(i);
+
+  std::sort(callsign_vector.begin(), callsign_vector.end(),
+            CallSignCompare(record_vector.data()));
+
+  SetVectors();
+}
+
+bool
+FlarmDatabase::Save(FILE *file) const
+{
+  assert(IsOptimised());
+
+  Header header;
+  header.version = Header::VERSION;
+  header.record_size = sizeof(FlarmRecord);
+  header.num_records = num_records;
+  header.num_callsigns = num_callsigns;
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fwrite(ids, sizeof(*ids), num_records, file) == num_records &&
+    fwrite(by_callsign, sizeof(*by_callsign), num_callsigns,
+           file) == num_callsigns &&
+    fwrite(records, sizeof(*records), num_records, file) == num_records;
+}
+
+bool
+FlarmDatabase::Map(const TCHAR *path, size_t offset)
+{
+  FileMapping *new_mapping = new FileMapping(path);
+  if (new_mapping->error() || offset % sizeof(uint32_t) != 0 ||
+      new_mapping->size() < offset + sizeof(Header)) {
+    delete new_mapping;
+    return false;
   }
 
-  return NULL;
+  const Header &header = *(const Header *)new_mapping->at(offset);
+  const uint64_t size = sizeof(header) +
+    (uint64_t)header.num_records * (sizeof(FlarmId) + sizeof(FlarmRecord)) +
+    (uint64_t)header.num_callsigns * sizeof(uint32_t);
+
+  if (header.version != Header::VERSION ||
+      header.record_size != sizeof(FlarmRecord) ||
+      header.num_callsigns > header.num_records ||
+      new_mapping->size() - offset < size) {
+    delete new_mapping;
+    return false;
+  }
+
+  const FlarmId *new_ids = (const FlarmId *)(&header + 1);
+  const uint32_t *new_by_callsign =
+    (const uint32_t *)(new_ids + header.num_records);
+  const FlarmRecord *new_records =
+    (const FlarmRecord *)(new_by_callsign + header.num_callsigns);
+
+  /* the lookup methods rely on these indices */
+  for (unsigned i = 0; i < header.num_callsigns; ++i) {
+    if (new_by_callsign[i] >= header.num_records) {
+      delete new_mapping;
+      return false;
+    }
+  }
+
+  Clear();
+
+  mapping = new_mapping;
+  num_records = header.num_records;
+  num_callsigns = header.num_callsigns;
+  ids = new_ids;
+  records = new_records;
+  by_callsign = new_by_callsign;
+  return true;
+}
+
+const FlarmRecord *
+FlarmDatabase::FindRecordById(FlarmId id) const
+{
+  assert(IsOptimised());
+
+  const FlarmId *end = ids + num_records;
+  const FlarmId *i = std::lower_bound(ids, end, id);
+  return i != end && *i == id
+    ? &records[i - ids]
+    : NULL;
+}
+
+void
+FlarmDatabase::FindCallSignRange(const TCHAR *cn, bool prefix,
+                                 const uint32_t *&begin_r,
+                                 const uint32_t *&end_r) const
+{
+  assert(IsOptimised());
+
+  const uint32_t *end = by_callsign + num_callsigns;
+  begin_r = std::lower_bound(by_callsign, end, cn,
+                             CallSignCompare(records));
+  end_r = prefix
+    ? std::upper_bound(begin_r, end, cn,
+                       PrefixCompare(records, _tcslen(cn)))
+    : std::upper_bound(begin_r, end, cn, CallSignCompare(records));
+}
+
+const FlarmRecord *
+FlarmDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+{
+  const uint32_t *begin, *end;
+  FindCallSignRange(cn, false, begin, end);
+
+  return begin != end
+    ? &records[*begin]
+    : NULL;
 }
 
 unsigned
@@ -56,14 +314,12 @@ FlarmDatabase::FindRecordsByCallSign(const TCHAR *cn,
                                      const FlarmRecord *array[],
                                      unsigned size) const
 {
-  unsigned count = 0;
-  for (auto i = map.begin(), end = map.end(); i != end; ++i) {
-    assert(i->first.IsDefined());
+  const uint32_t *begin, *end;
+  FindCallSignRange(cn, false, begin, end);
 
-    const FlarmRecord &record = i->second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = &record;
-  }
+  unsigned count = 0;
+  for (auto i = begin; i != end && count < size; ++i)
+    array[count++] = &records[*i];
 
   return count;
 }
@@ -72,14 +328,31 @@ unsigned
 FlarmDatabase::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                                  unsigned size) const
 {
+  const uint32_t *begin, *end;
+  FindCallSignRange(cn, false, begin, end);
+
   unsigned count = 0;
-  for (auto i = map.begin(), end = map.end(); i != end; ++i) {
-    assert(i->first.IsDefined());
+  for (auto i = begin; i != end && count < size; ++i)
+    array[count++] = ids[*i];
 
-    const FlarmRecord &record = i->second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = i->first;
-  }
+  return count;
+}
+
+unsigned
+FlarmDatabase::FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                                       unsigned size) const
+{
+  assert(prefix != NULL);
+
+  if (StringIsEmpty(prefix))
+    return 0;
+
+  const uint32_t *begin, *end;
+  FindCallSignRange(prefix, true, begin, end);
+
+  unsigned count = 0;
+  for (auto i = begin; i != end && count < size; ++i)
+    array[count++] = ids[*i];
 
   return count;
 }
@@ -26,44 +26,112 @@ Copyright_License {
 
 #include "FlarmId.hpp"
 #include "Record.hpp"
+#include "Util/NonCopyable.hpp"
 #include "Compiler.h"
 
-#include <map>
+#include <vector>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <tchar.h>
 
-class NLineReader;
-class FlarmId;
+class FileMapping;
 
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * After all records have been added with Insert(), Optimise() builds
+ * a compact image: the records sorted by FLARM id (found with a
+ * binary search) and a list of record indices sorted by call sign,
+ * which answers exact and prefix call sign queries with a binary
+ * search, too.
+ *
+ * This image can be written to a cache file with Save(), and mapped
+ * into memory with Map() on the next start, which avoids parsing the
+ * (hex encoded) FLARMnet file again.
  */
-class FlarmDatabase {
-  typedef std::map<FlarmId, FlarmRecord> RecordMap;
-  RecordMap map;
+class FlarmDatabase : private NonCopyable {
+  struct Header;
+  class CallSignCompare;
+  class PrefixCompare;
+
+  /**
+   * The image owned by this object, i.e. if it has not been mapped
+   * from a cache file.  New records are appended here; they are
+   * indexed by Optimise().
+   */
+  std::vector<FlarmId> id_vector;
+  std::vector<FlarmRecord> record_vector;
+  std::vector<uint32_t> callsign_vector;
+
+  FileMapping *mapping;
+
+  /**
+   * The image used by the lookup methods, pointing either into the
+   * vectors above or into #mapping.
+   */
+  unsigned num_records, num_callsigns;
+  const FlarmId *ids;
+  const FlarmRecord *records;
+
+  /**
+   * Indices into #records, sorted by call sign (and then by id).
+   * Records without a call sign are omitted.
+   */
+  const uint32_t *by_callsign;
 
 public:
+  FlarmDatabase();
+  ~FlarmDatabase();
+
   bool IsEmpty() const {
-    return map.empty();
+    return num_records == 0 && record_vector.empty();
   }
 
-  void Clear() {
-    map.clear();
+  /**
+   * Returns the number of records, not counting those which have not
+   * been indexed by Optimise() yet.
+   */
+  unsigned GetCount() const {
+    return num_records;
   }
 
+  void Clear();
+
+  /**
+   * Adds a record.  The lookup methods will not see it until
+   * Optimise() has been called.
+   */
   void Insert(const FlarmRecord &record);
 
+  /**
+   * Build the lookup tables after the last Insert() call.  If a FLARM
+   * id occurs more than once, only the first record is kept.
+   */
+  void Optimise();
+
+  /**
+   * Write the image to a (cache) file.
+   */
+  bool Save(FILE *file) const;
+
+  /**
+   * Replace the contents of this object with an image written by
+   * Save(), by mapping the file into memory.
+   *
+   * @param offset the position of the image within the file
+   * @return false if the file could not be mapped or is not valid
+   */
+  bool Map(const TCHAR *path, size_t offset=0);
+
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
    * @param id FLARM id
    * @return FLARMNetRecord object
    */
   gcc_pure
-  const FlarmRecord *FindRecordById(FlarmId id) {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmRecord *FindRecordById(FlarmId id) const;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
@@ -78,13 +146,47 @@ public:
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                              unsigned size) const;
 
-  RecordMap::const_iterator begin() const {
-    return map.begin();
+  /**
+   * Finds the ids of all records whose call sign begins with the
+   * specified (non-empty) prefix, ordered by call sign.
+   */
+  unsigned FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                                   unsigned size) const;
+
+  /**
+   * Iterate over all records, ordered by FLARM id.
+   */
+  const FlarmRecord *begin() const {
+    assert(IsOptimised());
+
+    return records;
   }
 
-  RecordMap::const_iterator end() const {
-    return map.end();
+  const FlarmRecord *end() const {
+    return records + num_records;
   }
+
+private:
+  bool IsOptimised() const {
+    return mapping != NULL || record_vector.size() == num_records;
+  }
+
+  /**
+   * Copy the mapped image into the vectors, to allow modifications.
+   */
+  void Detach();
+
+  void Unmap();
+
+  void SetVectors();
+
+  /**
+   * Determine the range of #by_callsign which contains the call
+   * sign (or, if prefix is true, all call signs starting with it).
+   */
+  void FindCallSignRange(const TCHAR *cn, bool prefix,
+                         const uint32_t *&begin_r,
+                         const uint32_t *&end_r) const;
 };
 
 #endif
@@ -29,3 +29,15 @@ FlarmCalculations::Average30s(FlarmId flarmId, fixed curTime, fixed curAltitude)
   ClimbAverageCalculator &item = averageCalculatorMap[flarmId];
   return item.GetAverage(curTime, curAltitude, fixed(30));
 }
+
+void
+FlarmCalculations::CleanUp(fixed now)
+{
+  for (auto i = averageCalculatorMap.begin();
+       i != averageCalculatorMap.end();) {
+    if (i->second.Expired(now, fixed(60)))
+      averageCalculatorMap.erase(i++);
+    else
+      ++i;
+  }
+}
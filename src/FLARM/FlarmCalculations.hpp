@@ -37,6 +37,13 @@ private:
 
 public:
   fixed Average30s(FlarmId flarmId, fixed curTime, fixed curAltitude);
+
+  /**
+   * Forget the calculators of all targets which have not been
+   * updated for a while, so the map does not grow without bounds
+   * when hundreds of targets pass by.
+   */
+  void CleanUp(fixed now);
 };
 
 #endif
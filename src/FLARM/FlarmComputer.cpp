@@ -26,16 +26,16 @@ Copyright_License {
 #include "NMEA/Info.hpp"
 #include "Engine/Navigation/Geometry/GeoVector.hpp"
 
-void
-FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
-                       const NMEAInfo &basic)
+/**
+ * Calculates the factors which convert the relative positions of the
+ * targets to latitude and longitude differences.
+ */
+static void
+CalculateProjection(const NMEAInfo &basic,
+                    fixed &north_to_latitude, fixed &east_to_longitude)
 {
-  // if (FLARM data is available)
-  if (!flarm.IsDetected())
-    return;
-
-  fixed north_to_latitude(0);
-  fixed east_to_longitude(0);
+  north_to_latitude = fixed_zero;
+  east_to_longitude = fixed_zero;
 
   if (basic.location_available) {
     // Precalculate relative east and north projection to lat/lon
@@ -56,103 +56,157 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
       east_to_longitude = delta_lon.Degrees() / dlon;
     }
   }
+}
+
+/**
+ * Calculates location, altitude, average climb speed and looks up
+ * the callsign of one target.
+ *
+ * @param last_traffic the state of this target at the previous
+ * calculation, or NULL if it was not known then
+ */
+static void
+ProcessTraffic(FlarmTraffic &traffic, const FlarmTraffic *last_traffic,
+               const NMEAInfo &basic,
+               fixed north_to_latitude, fixed east_to_longitude,
+               FlarmCalculations &calculations)
+{
+  // if we don't know the target's name yet
+  if (!traffic.HasName()) {
+    // lookup the name of this target's id
+    const TCHAR *fname = FlarmDetails::LookupCallsign(traffic.id);
+    if (fname != NULL)
+      traffic.name = fname;
+  }
+
+  // Calculate distance
+  traffic.distance = SmallHypot(traffic.relative_north,
+                                traffic.relative_east);
+
+  // Calculate Location
+  traffic.location_available = basic.location_available;
+  if (traffic.location_available) {
+    traffic.location.latitude =
+        Angle::Degrees(traffic.relative_north * north_to_latitude) +
+        basic.location.latitude;
+
+    traffic.location.longitude =
+        Angle::Degrees(traffic.relative_east * east_to_longitude) +
+        basic.location.longitude;
+  }
+
+  // Calculate absolute altitude
+  traffic.altitude_available = basic.gps_altitude_available;
+  if (traffic.altitude_available)
+    traffic.altitude = traffic.relative_altitude + RoughAltitude(basic.gps_altitude);
+
+  // Calculate average climb rate
+  traffic.climb_rate_avg30s_available = traffic.altitude_available;
+  if (traffic.climb_rate_avg30s_available)
+    traffic.climb_rate_avg30s =
+      calculations.Average30s(traffic.id, basic.time, traffic.altitude);
+
+  // The following calculations are only relevant for targets
+  // where information is missing
+  if (traffic.track_received && traffic.turn_rate_received &&
+      traffic.speed_received && traffic.climb_rate_received)
+    return;
+
+  // Check if the target has been seen before in the last seconds
+  if (last_traffic == NULL || !last_traffic->valid)
+    return;
+
+  // Calculate the time difference between now and the last contact
+  fixed dt = traffic.valid.GetTimeDifference(last_traffic->valid);
+  if (positive(dt)) {
+    // Calculate the immediate climb rate
+    if (!traffic.climb_rate_received)
+      traffic.climb_rate =
+        (traffic.relative_altitude - last_traffic->relative_altitude) / dt;
+  } else {
+    // Since the time difference is zero (or negative)
+    // we can just copy the old values
+    if (!traffic.climb_rate_received)
+      traffic.climb_rate = last_traffic->climb_rate;
+  }
+
+  if (positive(dt) &&
+      traffic.location_available &&
+      last_traffic->location_available) {
+    // Calculate the GeoVector between now and the last contact
+    GeoVector vec = last_traffic->location.DistanceBearing(traffic.location);
+
+    if (!traffic.track_received)
+      traffic.track = vec.bearing;
+
+    // Calculate the turn rate
+    if (!traffic.turn_rate_received) {
+      Angle turn_rate = traffic.track - last_traffic->track;
+      traffic.turn_rate =
+        turn_rate.AsDelta().Degrees() / dt;
+    }
+
+    // Calculate the speed [m/s]
+    if (!traffic.speed_received)
+      traffic.speed = vec.distance / dt;
+  } else {
+    // Since the time difference is zero (or negative)
+    // we can just copy the old values
+    if (!traffic.track_received)
+      traffic.track = last_traffic->track;
+
+    if (!traffic.turn_rate_received)
+      traffic.turn_rate = last_traffic->turn_rate;
+
+    if (!traffic.speed_received)
+      traffic.speed = last_traffic->speed;
+  }
+}
+
+void
+FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
+                       const NMEAInfo &basic)
+{
+  // if (FLARM data is available)
+  if (!flarm.IsDetected())
+    return;
+
+  fixed north_to_latitude, east_to_longitude;
+  CalculateProjection(basic, north_to_latitude, east_to_longitude);
+
+  last_index.Build(last_flarm.traffic);
 
   // for each item in traffic
   for (auto it = flarm.traffic.list.begin(), end = flarm.traffic.list.end();
-       it != end; ++it) {
-    FlarmTraffic &traffic = *it;
-
-    // if we don't know the target's name yet
-    if (!traffic.HasName()) {
-      // lookup the name of this target's id
-      const TCHAR *fname = FlarmDetails::LookupCallsign(traffic.id);
-      if (fname != NULL)
-        traffic.name = fname;
-    }
+       it != end; ++it)
+    ProcessTraffic(*it, last_index.FindTraffic(it->id), basic,
+                   north_to_latitude, east_to_longitude,
+                   flarm_calculations);
 
-    // Calculate distance
-    traffic.distance = SmallHypot(traffic.relative_north,
-                                  traffic.relative_east);
+  if (basic.time_available)
+    flarm_calculations.CleanUp(basic.time);
+}
 
-    // Calculate Location
-    traffic.location_available = basic.location_available;
-    if (traffic.location_available) {
-      traffic.location.latitude =
-          Angle::Degrees(traffic.relative_north * north_to_latitude) +
-          basic.location.latitude;
+void
+FlarmComputer::Process(TrafficStore &store, const NMEAInfo &basic)
+{
+  store.Expire(basic.clock);
 
-      traffic.location.longitude =
-          Angle::Degrees(traffic.relative_east * east_to_longitude) +
-          basic.location.longitude;
-    }
+  if (!store.IsEmpty()) {
+    fixed north_to_latitude, east_to_longitude;
+    CalculateProjection(basic, north_to_latitude, east_to_longitude);
 
-    // Calculate absolute altitude
-    traffic.altitude_available = basic.gps_altitude_available;
-    if (traffic.altitude_available)
-      traffic.altitude = traffic.relative_altitude + RoughAltitude(basic.gps_altitude);
-
-    // Calculate average climb rate
-    traffic.climb_rate_avg30s_available = traffic.altitude_available;
-    if (traffic.climb_rate_avg30s_available)
-      traffic.climb_rate_avg30s =
-        flarm_calculations.Average30s(traffic.id, basic.time, traffic.altitude);
-
-    // The following calculations are only relevant for targets
-    // where information is missing
-    if (traffic.track_received && traffic.turn_rate_received &&
-        traffic.speed_received && traffic.climb_rate_received)
-      continue;
-
-    // Check if the target has been seen before in the last seconds
-    const FlarmTraffic *last_traffic =
-      last_flarm.traffic.FindTraffic(traffic.id);
-    if (last_traffic == NULL || !last_traffic->valid)
-      continue;
-
-    // Calculate the time difference between now and the last contact
-    fixed dt = traffic.valid.GetTimeDifference(last_traffic->valid);
-    if (positive(dt)) {
-      // Calculate the immediate climb rate
-      if (!traffic.climb_rate_received)
-        traffic.climb_rate =
-          (traffic.relative_altitude - last_traffic->relative_altitude) / dt;
-    } else {
-      // Since the time difference is zero (or negative)
-      // we can just copy the old values
-      if (!traffic.climb_rate_received)
-        traffic.climb_rate = last_traffic->climb_rate;
-    }
+    for (auto it = store.list.begin(), end = store.list.end();
+         it != end; ++it)
+      ProcessTraffic(*it, last_store.FindTraffic(it->id), basic,
+                     north_to_latitude, east_to_longitude,
+                     store_calculations);
 
-    if (positive(dt) &&
-        traffic.location_available &&
-        last_traffic->location_available) {
-      // Calculate the GeoVector between now and the last contact
-      GeoVector vec = last_traffic->location.DistanceBearing(traffic.location);
-
-      if (!traffic.track_received)
-        traffic.track = vec.bearing;
-
-      // Calculate the turn rate
-      if (!traffic.turn_rate_received) {
-        Angle turn_rate = traffic.track - last_traffic->track;
-        traffic.turn_rate =
-          turn_rate.AsDelta().Degrees() / dt;
-      }
-
-      // Calculate the speed [m/s]
-      if (!traffic.speed_received)
-        traffic.speed = vec.distance / dt;
-    } else {
-      // Since the time difference is zero (or negative)
-      // we can just copy the old values
-      if (!traffic.track_received)
-        traffic.track = last_traffic->track;
-
-      if (!traffic.turn_rate_received)
-        traffic.turn_rate = last_traffic->turn_rate;
-
-      if (!traffic.speed_received)
-        traffic.speed = last_traffic->speed;
-    }
+    store.UpdateSpatialIndex();
   }
+
+  last_store = store;
+
+  if (basic.time_available)
+    store_calculations.CleanUp(basic.time);
 }
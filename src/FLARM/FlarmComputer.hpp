@@ -25,6 +25,8 @@ Copyright_License {
 #define XCSOAR_FLARM_COMPUTER_HPP
 
 #include "FLARM/FlarmCalculations.hpp"
+#include "FLARM/TrafficIdIndex.hpp"
+#include "FLARM/TrafficStore.hpp"
 
 struct FlarmData;
 struct NMEAInfo;
@@ -32,13 +34,44 @@ struct NMEAInfo;
 class FlarmComputer {
   FlarmCalculations flarm_calculations;
 
+  /**
+   * An index of the previous traffic list, for looking up each
+   * target's previous state.
+   */
+  TrafficIdIndex last_index;
+
+  /**
+   * The climb averages of the targets in the #TrafficStore.  They
+   * are separate from #flarm_calculations, because both are updated
+   * on every call.
+   */
+  FlarmCalculations store_calculations;
+
+  /**
+   * A copy of the #TrafficStore at the previous call, for looking up
+   * each target's previous state.  It is kept here, and not in the
+   * blackboards, because it is much larger than the #TrafficList.
+   */
+  TrafficStore last_store;
+
 public:
+  FlarmComputer() {
+    last_store.Clear();
+  }
+
   /**
    * Calculates location, altitude, average climb speed and
    * looks up the callsign of each target
    */
   void Process(FlarmData &flarm, const FlarmData &last_flarm,
                const NMEAInfo &basic);
+
+  /**
+   * Expires the targets in the #TrafficStore, calculates their
+   * derived attributes like Process() and updates its spatial index.
+   * The caller must hold a lease on the store.
+   */
+  void Process(TrafficStore &store, const NMEAInfo &basic);
 };
 
 #endif
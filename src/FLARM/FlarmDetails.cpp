@@ -33,6 +33,7 @@ Copyright_License {
 #include "IO/TextWriter.hpp"
 
 #include <assert.h>
+#include <windef.h> /* for MAX_PATH */
 
 struct FlarmIdNameCouple
 {
@@ -44,23 +45,21 @@ struct FlarmIdNameCouple
 static TrivialArray<FlarmIdNameCouple, 200> flarm_names;
 
 void
-FlarmDetails::Load()
+FlarmDetails::Load(FileCache *cache)
 {
   LogStartUp(_T("FlarmDetails::Load"));
 
   LoadSecondary();
-  LoadFLARMnet();
+  LoadFLARMnet(cache);
 }
 
 void
-FlarmDetails::LoadFLARMnet()
+FlarmDetails::LoadFLARMnet(FileCache *cache)
 {
-  NLineReader *reader = OpenDataTextFileA(_T("data.fln"));
-  if (reader == NULL)
-    return;
+  TCHAR path[MAX_PATH];
+  LocalPath(path, _T("data.fln"));
 
-  unsigned num_records = FlarmNet::LoadFile(*reader);
-  delete reader;
+  unsigned num_records = FlarmNet::LoadFile(path, cache);
 
   if (num_records > 0)
     LogStartUp(_T("%u FLARMnet ids found"), num_records);
@@ -237,3 +236,27 @@ FlarmDetails::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
 
   return count;
 }
+
+unsigned
+FlarmDetails::FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                                      unsigned size)
+{
+  assert(prefix != NULL);
+
+  if (StringIsEmpty(prefix))
+    return 0;
+
+  unsigned count = FlarmNet::FindIdsByCallSignPrefix(prefix, array, size);
+
+  const size_t length = _tcslen(prefix);
+  for (unsigned i = 0; i < flarm_names.size() && count < size; i++) {
+    if (_tcsncmp(flarm_names[i].name, prefix, length) == 0) {
+      assert(flarm_names[i].id.IsDefined());
+
+      array[count] = flarm_names[i].id;
+      count++;
+    }
+  }
+
+  return count;
+}
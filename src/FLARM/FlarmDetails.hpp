@@ -27,20 +27,23 @@ Copyright_License {
 
 class FlarmId;
 struct FlarmRecord;
+class FileCache;
 
 namespace FlarmDetails
 {
   /**
    * Loads XCSoar's own FLARM details file and the FLARMnet file
+   *
+   * @param cache an optional cache for the parsed FLARMnet file
    */
   void
-  Load();
+  Load(FileCache *cache);
 
   /**
    * Loads the FLARMnet file
    */
   void
-  LoadFLARMnet();
+  LoadFLARMnet(FileCache *cache);
 
   /**
    * Opens XCSoars own FLARM details file, parses it and
@@ -114,6 +117,14 @@ namespace FlarmDetails
 
   unsigned
   FindIdsByCallSign(const TCHAR *cn, FlarmId array[], unsigned size);
+
+  /**
+   * Like FindIdsByCallSign(), but finds all callsigns beginning with
+   * the specified prefix.
+   */
+  unsigned
+  FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                          unsigned size);
 }
 
 #endif
@@ -66,6 +66,16 @@ public:
     return value < other.value;
   }
 
+  /**
+   * Returns a value suitable for hash tables.
+   */
+  gcc_pure
+  unsigned Hash() const {
+    /* Fibonacci hashing: spread the (mostly sequential) 24 bit FLARM
+       ids over all bits */
+    return value * 2654435761u;
+  }
+
   static FlarmId Parse(const char *input, char **endptr_r);
 #ifdef _UNICODE
   static FlarmId Parse(const TCHAR *input, TCHAR **endptr_r);
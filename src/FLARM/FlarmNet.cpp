@@ -30,6 +30,9 @@ Copyright_License {
 #include "Util/CharUtil.hpp"
 #include "IO/LineReader.hpp"
 #include "IO/FileLineReader.hpp"
+#include "IO/FileCache.hpp"
+
+#include <windef.h> /* for MAX_PATH */
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -57,8 +60,40 @@ FlarmNet::LoadFile(NLineReader &reader)
   return FlarmNetReader::LoadFile(reader, *database);
 }
 
+static const TCHAR *const cache_name = _T("flarmnet");
+
+static bool
+MapCacheFile(FlarmDatabase &database, const TCHAR *path, FileCache &cache)
+{
+  TCHAR buffer[MAX_PATH];
+  const TCHAR *cache_path = cache.LoadPath(cache_name, path, buffer);
+  if (cache_path == NULL)
+    return false;
+
+  if (!database.Map(cache_path, FileCache::HEADER_SIZE)) {
+    cache.Flush(cache_name);
+    return false;
+  }
+
+  return true;
+}
+
+static void
+SaveCacheFile(const FlarmDatabase &database, const TCHAR *path,
+              FileCache &cache)
+{
+  FILE *file = cache.Save(cache_name, path);
+  if (file == NULL)
+    return;
+
+  if (database.Save(file))
+    cache.Commit(cache_name, file);
+  else
+    cache.Cancel(cache_name, file);
+}
+
 unsigned
-FlarmNet::LoadFile(const TCHAR *path)
+FlarmNet::LoadFile(const TCHAR *path, FileCache *cache)
 {
   // Clear database before adding new entries
   if (database == NULL)
@@ -66,7 +101,14 @@ FlarmNet::LoadFile(const TCHAR *path)
   else
     database->Clear();
 
-  return FlarmNetReader::LoadFile(path, *database);
+  if (cache != NULL && MapCacheFile(*database, path, *cache))
+    return database->GetCount();
+
+  unsigned count = FlarmNetReader::LoadFile(path, *database);
+  if (cache != NULL && count > 0)
+    SaveCacheFile(*database, path, *cache);
+
+  return count;
 }
 
 const FlarmRecord *
@@ -104,3 +146,13 @@ FlarmNet::FindIdsByCallSign(const TCHAR *cn, FlarmId array[], unsigned size)
 
   return database->FindIdsByCallSign(cn, array, size);
 }
+
+unsigned
+FlarmNet::FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                                  unsigned size)
+{
+  if (database == NULL)
+    return 0;
+
+  return database->FindIdsByCallSignPrefix(prefix, array, size);
+}
@@ -31,6 +31,7 @@ Copyright_License {
 struct FlarmRecord;
 class NLineReader;
 class FlarmId;
+class FileCache;
 
 /**
  * Handles the FlarmNet.org file
@@ -45,9 +46,12 @@ namespace FlarmNet
    * Reads the FlarmNet.org file and fills the map
    *
    * @param path the path of the file
+   * @param cache if not NULL, then the parsed database is stored in
+   * this cache, and the next call maps the cache file instead of
+   * parsing the FlarmNet.org file again
    * @return the number of records read from the file
    */
-  unsigned LoadFile(const TCHAR *path);
+  unsigned LoadFile(const TCHAR *path, FileCache *cache=NULL);
 
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
@@ -65,6 +69,13 @@ namespace FlarmNet
   unsigned FindRecordsByCallSign(const TCHAR *cn, const FlarmRecord *array[],
                                  unsigned size);
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[], unsigned size);
+
+  /**
+   * Finds the ids of all records whose callsign begins with the
+   * specified prefix.
+   */
+  unsigned FindIdsByCallSignPrefix(const TCHAR *prefix, FlarmId array[],
+                                   unsigned size);
 };
 
 #endif
@@ -139,6 +139,7 @@ FlarmNetReader::LoadFile(NLineReader &reader, FlarmDatabase &database)
     }
   }
 
+  database.Optimise();
   return itemCount;
 }
 
@@ -27,11 +27,13 @@ Copyright_License {
 #include "Components.hpp"
 #include "MergeThread.hpp"
 
+#include <assert.h>
+
+static bool loaded;
+
 void
 LoadFlarmDatabases()
 {
-  static bool loaded;
-
   if (loaded)
     return;
 
@@ -41,8 +43,22 @@ LoadFlarmDatabases()
      databases */
   merge_thread->Suspend();
 
-  FlarmDetails::Load();
+  FlarmDetails::Load(file_cache);
   FlarmFriends::Load();
 
   merge_thread->Resume();
 }
+
+void
+PreloadFlarmDatabases()
+{
+  assert(merge_thread == NULL);
+
+  if (loaded)
+    return;
+
+  loaded = true;
+
+  FlarmDetails::Load(file_cache);
+  FlarmFriends::Load();
+}
@@ -31,4 +31,12 @@ Copyright_License {
 void
 LoadFlarmDatabases();
 
+/**
+ * Load all FLARM databases into memory during startup, before the
+ * MergeThread has been created.  This may be called in any thread,
+ * but not concurrently with LoadFlarmDatabases().
+ */
+void
+PreloadFlarmDatabases();
+
 #endif
@@ -23,6 +23,72 @@ Copyright_License {
 
 #include "List.hpp"
 
+void
+TrafficList::Expire(fixed clock)
+{
+  new_traffic.Expire(clock, fixed(60));
+
+  const Validity now(clock);
+  const bool time_warp = last_expire.Modified(now);
+  last_expire = now;
+
+  /* all targets are newer than #oldest; if that one is still fresh,
+     there is nothing to do */
+  if (!time_warp && oldest.IsValid() &&
+      !oldest.IsOlderThan(clock, fixed_two))
+    return;
+
+  oldest.Clear();
+
+  for (unsigned i = list.size(); i-- > 0;) {
+    FlarmTraffic &traffic = list[i];
+    if (!traffic.Refresh(clock))
+      list.quick_remove(i);
+    else if (!oldest.IsValid() || oldest.Modified(traffic.valid))
+      oldest = traffic.valid;
+  }
+}
+
+gcc_pure
+static fixed
+GetSquareDistance(const FlarmTraffic &traffic)
+{
+  return sqr(traffic.relative_north) + sqr(traffic.relative_east);
+}
+
+bool
+TrafficList::Update(const FlarmTraffic &traffic, fixed clock)
+{
+  FlarmTraffic *slot = FindTraffic(traffic.id);
+  if (slot == NULL) {
+    if (list.full()) {
+      /* keep the nearest targets; the TrafficStore has room for all
+         of them */
+      FlarmTraffic *farthest = list.begin();
+      for (auto it = list.begin(), end = list.end(); it != end; ++it)
+        if (GetSquareDistance(*it) > GetSquareDistance(*farthest))
+          farthest = it;
+
+      if (GetSquareDistance(traffic) >= GetSquareDistance(*farthest))
+        return false;
+
+      slot = farthest;
+      slot->id = traffic.id;
+    } else
+      slot = AllocateTraffic(traffic.id);
+
+    slot->Clear();
+
+    new_traffic.Update(clock);
+  }
+
+  // set time of fix to current time
+  slot->valid.Update(clock);
+
+  slot->Update(traffic);
+  return true;
+}
+
 const FlarmTraffic *
 TrafficList::FindMaximumAlert() const
 {
@@ -29,12 +29,20 @@ Copyright_License {
 #include "Util/TrivialArray.hpp"
 #include "Util/TypeTraits.hpp"
 
+#include <assert.h>
+
 /**
  * This class keeps track of the traffic objects received from a
  * FLARM.
+ *
+ * It is part of #NMEAInfo, which is copied by value for every fix,
+ * and must therefore remain small.  When it is full, it keeps the
+ * nearest targets.  All targets are kept in the #TrafficStore.
+ * Consumers which need faster lookups build their own index, see
+ * #TrafficIdIndex.
  */
 struct TrafficList {
-  static gcc_constexpr_data size_t MAX_COUNT = 25;
+  static gcc_constexpr_data size_t MAX_COUNT = 50;
 
   /**
    * When was the last new traffic received?
@@ -44,9 +52,25 @@ struct TrafficList {
   /** Flarm traffic information */
   TrivialArray<FlarmTraffic, MAX_COUNT> list;
 
+private:
+  /**
+   * A lower bound for the #FlarmTraffic::valid time stamps of all
+   * targets.  As long as this one has not expired, no target can
+   * have expired, and Expire() does not need to check them all.
+   */
+  Validity oldest;
+
+  /**
+   * The clock of the last Expire() call, to detect time warps.
+   */
+  Validity last_expire;
+
+public:
   void Clear() {
     new_traffic.Clear();
     list.clear();
+    oldest.Clear();
+    last_expire.Clear();
   }
 
   bool IsEmpty() const {
@@ -62,13 +86,10 @@ struct TrafficList {
       *this = add;
   }
 
-  void Expire(fixed clock) {
-    new_traffic.Expire(clock, fixed(60));
-
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
-        list.quick_remove(i);
-  }
+  /**
+   * Remove all targets which have not been updated recently.
+   */
+  void Expire(fixed clock);
 
   unsigned GetActiveTrafficCount() const {
     return list.size();
@@ -131,16 +152,35 @@ struct TrafficList {
   }
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object from the array.  The caller
+   * is responsible for initialising all attributes except for the
+   * id.
    *
+   * @param id the FLARM id of the new target, which must not be in
+   * the list already
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  FlarmTraffic *AllocateTraffic() {
-    return list.full()
-      ? NULL
-      : &list.append();
+  FlarmTraffic *AllocateTraffic(FlarmId id) {
+    assert(FindTraffic(id) == NULL);
+
+    if (list.full())
+      return NULL;
+
+    FlarmTraffic &traffic = list.append();
+    traffic.id = id;
+    return &traffic;
   }
 
+  /**
+   * Copy the received attributes of the specified target to the
+   * target with the same id.  If it is not yet known, it is added;
+   * if the array is full, it replaces the target farthest away from
+   * us, unless it is even farther away.
+   *
+   * @return false if the target was not added
+   */
+  bool Update(const FlarmTraffic &traffic, fixed clock);
+
   /**
    * Search for the previous traffic in the ordered list.
    */
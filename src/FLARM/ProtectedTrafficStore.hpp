@@ -0,0 +1,47 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLARM_PROTECTED_TRAFFIC_STORE_HPP
+#define XCSOAR_FLARM_PROTECTED_TRAFFIC_STORE_HPP
+
+#include "Thread/Guard.hpp"
+#include "TrafficStore.hpp"
+
+/**
+ * The #TrafficStore with its own lock.  The receive threads add
+ * targets while parsing, the MergeThread expires them and calculates
+ * the derived attributes, and the user interface reads them.
+ *
+ * Never lock DeviceBlackboard::mutex while holding a lease on this
+ * object; the MergeThread locks in the opposite order.
+ */
+class ProtectedTrafficStore : public Guard<TrafficStore> {
+  TrafficStore store;
+
+public:
+  ProtectedTrafficStore():Guard<TrafficStore>(store) {
+    store.Clear();
+  }
+};
+
+#endif
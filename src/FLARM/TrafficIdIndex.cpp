@@ -0,0 +1,59 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TrafficIdIndex.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+void
+TrafficIdIndex::Build(const TrafficList &_traffic)
+{
+  traffic = &_traffic;
+  std::fill(slots, slots + SIZE, 0);
+
+  for (unsigned i = 0, n = traffic->list.size(); i < n; ++i) {
+    unsigned slot = GetSlot(traffic->list[i].id);
+    while (slots[slot] != 0)
+      slot = (slot + 1) % SIZE;
+
+    slots[slot] = i + 1;
+  }
+}
+
+const FlarmTraffic *
+TrafficIdIndex::FindTraffic(FlarmId id) const
+{
+  assert(traffic != NULL);
+
+  for (unsigned slot = GetSlot(id);; slot = (slot + 1) % SIZE) {
+    const unsigned i = slots[slot];
+    if (i == 0)
+      return NULL;
+
+    const FlarmTraffic &t = traffic->list[i - 1];
+    if (t.id == id)
+      return &t;
+  }
+}
@@ -0,0 +1,80 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLARM_TRAFFIC_ID_INDEX_HPP
+#define XCSOAR_FLARM_TRAFFIC_ID_INDEX_HPP
+
+#include "List.hpp"
+#include "Compiler.h"
+
+#include <stdint.h>
+
+/**
+ * A hash table of the FLARM ids in a #TrafficList, for consumers
+ * which look up many targets by id.  It is built on demand by the
+ * consumer and is not part of #TrafficList, which is copied around
+ * with #NMEAInfo.
+ *
+ * The index refers to the list it was built from; it must be rebuilt
+ * after that list has been modified.
+ */
+class TrafficIdIndex {
+  /**
+   * The number of slots in the hash table is 2^BITS; that is at
+   * least twice TrafficList::MAX_COUNT.
+   */
+  static gcc_constexpr_data unsigned BITS = 7;
+  static gcc_constexpr_data unsigned SIZE = 1u << BITS;
+
+  static_assert(SIZE >= 2 * TrafficList::MAX_COUNT, "hash table too small");
+
+  const TrafficList *traffic;
+
+  /**
+   * Open addressing hash table (linear probing).  Each slot contains
+   * the #TrafficList::list index plus one, or zero if the slot is
+   * empty.
+   */
+  uint8_t slots[SIZE];
+
+public:
+  TrafficIdIndex():traffic(NULL) {}
+
+  void Build(const TrafficList &traffic);
+
+  /**
+   * Looks up a target by its FLARM id.
+   *
+   * @return the target, or NULL if not found
+   */
+  gcc_pure
+  const FlarmTraffic *FindTraffic(FlarmId id) const;
+
+private:
+  gcc_const
+  static unsigned GetSlot(FlarmId id) {
+    return id.Hash() >> (32 - BITS);
+  }
+};
+
+#endif
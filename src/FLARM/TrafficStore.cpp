@@ -0,0 +1,309 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TrafficStore.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+void
+TrafficStore::Clear()
+{
+  list.clear();
+  std::fill(id_index, id_index + ID_INDEX_SIZE, 0);
+  grid_valid = false;
+  oldest.Clear();
+  last_expire.Clear();
+}
+
+int
+TrafficStore::FindIndex(FlarmId id) const
+{
+  for (unsigned slot = GetIdSlot(id);; slot = (slot + 1) % ID_INDEX_SIZE) {
+    const unsigned i = id_index[slot];
+    if (i == 0)
+      return -1;
+
+    if (list[i - 1].id == id)
+      return i - 1;
+  }
+}
+
+FlarmTraffic *
+TrafficStore::AllocateTraffic(FlarmId id)
+{
+  assert(FindIndex(id) < 0);
+
+  if (list.full())
+    return NULL;
+
+  unsigned slot = GetIdSlot(id);
+  while (id_index[slot] != 0)
+    slot = (slot + 1) % ID_INDEX_SIZE;
+
+  FlarmTraffic &traffic = list.append();
+  traffic.id = id;
+  id_index[slot] = list.size();
+  grid_valid = false;
+  return &traffic;
+}
+
+bool
+TrafficStore::Update(const FlarmTraffic &traffic, fixed clock)
+{
+  FlarmTraffic *slot = FindTraffic(traffic.id);
+  if (slot == NULL) {
+    slot = AllocateTraffic(traffic.id);
+    if (slot == NULL)
+      return false;
+
+    slot->Clear();
+  }
+
+  slot->valid.Update(clock);
+  slot->Update(traffic);
+
+  /* the position has changed */
+  grid_valid = false;
+
+  return true;
+}
+
+void
+TrafficStore::RemoveFromIdIndex(unsigned i)
+{
+  unsigned slot = GetIdSlot(list[i].id);
+  while (id_index[slot] != i + 1) {
+    assert(id_index[slot] != 0);
+    slot = (slot + 1) % ID_INDEX_SIZE;
+  }
+
+  /* backward shift deletion: move following entries of the probe
+     sequence into the gap, unless they are already at their home
+     slot (or between it and the gap) */
+  unsigned gap = slot;
+  for (unsigned j = (gap + 1) % ID_INDEX_SIZE; id_index[j] != 0;
+       j = (j + 1) % ID_INDEX_SIZE) {
+    const unsigned home = GetIdSlot(list[id_index[j] - 1].id);
+    const bool stays = gap <= j
+      ? (gap < home && home <= j)
+      : (gap < home || home <= j);
+    if (stays)
+      continue;
+
+    id_index[gap] = id_index[j];
+    gap = j;
+  }
+
+  id_index[gap] = 0;
+}
+
+void
+TrafficStore::MoveInIdIndex(unsigned from, unsigned to)
+{
+  unsigned slot = GetIdSlot(list[from].id);
+  while (id_index[slot] != from + 1) {
+    assert(id_index[slot] != 0);
+    slot = (slot + 1) % ID_INDEX_SIZE;
+  }
+
+  id_index[slot] = to + 1;
+}
+
+void
+TrafficStore::RemoveTraffic(unsigned i)
+{
+  assert(i < list.size());
+
+  RemoveFromIdIndex(i);
+
+  /* quick_remove() moves the last item into the gap */
+  const unsigned last = list.size() - 1;
+  if (i != last)
+    MoveInIdIndex(last, i);
+
+  list.quick_remove(i);
+  grid_valid = false;
+}
+
+void
+TrafficStore::Expire(fixed clock)
+{
+  const Validity now(clock);
+  const bool time_warp = last_expire.Modified(now);
+  last_expire = now;
+
+  /* all targets are newer than #oldest; if that one is still fresh,
+     there is nothing to do */
+  if (!time_warp && oldest.IsValid() &&
+      !oldest.IsOlderThan(clock, fixed_two))
+    return;
+
+  oldest.Clear();
+
+  for (unsigned i = list.size(); i-- > 0;) {
+    FlarmTraffic &traffic = list[i];
+    if (!traffic.Refresh(clock))
+      RemoveTraffic(i);
+    else if (!oldest.IsValid() || oldest.Modified(traffic.valid))
+      oldest = traffic.valid;
+  }
+}
+
+const FlarmTraffic *
+TrafficStore::FindMaximumAlert() const
+{
+  const FlarmTraffic *alert = NULL;
+
+  for (auto it = list.begin(), end = list.end(); it != end; ++it) {
+    const FlarmTraffic &traffic = *it;
+
+    if (traffic.HasAlarm() &&
+        (alert == NULL ||
+         ((unsigned)traffic.alarm_level > (unsigned)alert->alarm_level ||
+          (traffic.alarm_level == alert->alarm_level &&
+           /* if the levels match -> let the distance decide (smaller
+              distance wins) */
+           traffic.distance < alert->distance))))
+      alert = &traffic;
+  }
+
+  return alert;
+}
+
+unsigned
+TrafficStore::ClipGridIndex(fixed value)
+{
+  const int i = (int)floor((value + fixed(GRID_SIZE * GRID_CELL_SIZE / 2))
+                           / GRID_CELL_SIZE);
+  return i < 0
+    ? 0
+    : std::min(unsigned(i), GRID_SIZE - 1);
+}
+
+unsigned
+TrafficStore::GetGridCell(fixed north, fixed east)
+{
+  const fixed extent(GRID_SIZE * GRID_CELL_SIZE / 2);
+  if (!(fabs(north) < extent) || !(fabs(east) < extent))
+    return GRID_SIZE * GRID_SIZE;
+
+  return GetGridRow(north) * GRID_SIZE + GetGridColumn(east);
+}
+
+bool
+TrafficStore::IsOutsideGrid(fixed north, fixed east, fixed range)
+{
+  const fixed extent(GRID_SIZE * GRID_CELL_SIZE / 2);
+  return fabs(north) + range >= extent || fabs(east) + range >= extent;
+}
+
+void
+TrafficStore::UpdateSpatialIndex()
+{
+  std::fill(grid_head, grid_head + GRID_SIZE * GRID_SIZE + 1, 0);
+
+  /* insert in reverse order, to keep each cell in list order */
+  for (unsigned i = list.size(); i-- > 0;) {
+    const FlarmTraffic &traffic = list[i];
+    const unsigned cell = GetGridCell(traffic.relative_north,
+                                      traffic.relative_east);
+    grid_next[i] = grid_head[cell];
+    grid_head[cell] = i + 1;
+  }
+
+  grid_valid = true;
+}
+
+/**
+ * Helper for TrafficStore::FindNearest().
+ */
+struct NearestTrafficVisitor {
+  fixed north, east;
+
+  const FlarmTraffic *result;
+  fixed square_distance;
+
+  NearestTrafficVisitor(fixed _north, fixed _east, fixed max_range)
+    :north(_north), east(_east), result(NULL),
+     square_distance(sqr(max_range)) {}
+
+  void operator()(const FlarmTraffic &traffic) {
+    const fixed d = sqr(traffic.relative_north - north) +
+      sqr(traffic.relative_east - east);
+    if (d <= square_distance) {
+      result = &traffic;
+      square_distance = d;
+    }
+  }
+};
+
+const FlarmTraffic *
+TrafficStore::FindNearest(fixed north, fixed east, fixed max_range) const
+{
+  NearestTrafficVisitor visitor(north, east, max_range);
+
+  if (!grid_valid) {
+    for (auto it = list.begin(), end = list.end(); it != end; ++it)
+      visitor(*it);
+    return visitor.result;
+  }
+
+  /* search the grid in rings around the cell containing the
+     position, until the nearest target found so far is closer than
+     the next ring */
+  const int center_row = GetGridRow(north);
+  const int center_column = GetGridColumn(east);
+
+  for (int ring = 0; ring < (int)GRID_SIZE; ++ring) {
+    if (ring > 0 &&
+        sqr(fixed((ring - 1) * (int)GRID_CELL_SIZE)) > visitor.square_distance)
+      break;
+
+    for (int row = center_row - ring; row <= center_row + ring; ++row) {
+      if (row < 0 || row >= (int)GRID_SIZE)
+        continue;
+
+      const bool edge = row == center_row - ring || row == center_row + ring;
+      const int step = edge ? 1 : 2 * ring;
+
+      for (int column = center_column - ring; column <= center_column + ring;
+           column += step) {
+        if (column < 0 || column >= (int)GRID_SIZE)
+          continue;
+
+        const unsigned cell = row * GRID_SIZE + column;
+        for (unsigned i = grid_head[cell]; i != 0; i = grid_next[i - 1])
+          visitor(list[i - 1]);
+      }
+    }
+  }
+
+  if (IsOutsideGrid(north, east, sqrt(visitor.square_distance)))
+    for (unsigned i = grid_head[GRID_SIZE * GRID_SIZE]; i != 0;
+         i = grid_next[i - 1])
+      visitor(list[i - 1]);
+
+  return visitor.result;
+}
@@ -0,0 +1,336 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLARM_TRAFFIC_STORE_HPP
+#define XCSOAR_FLARM_TRAFFIC_STORE_HPP
+
+#include "Traffic.hpp"
+#include "NMEA/Validity.hpp"
+#include "Util/TrivialArray.hpp"
+#include "Util/TypeTraits.hpp"
+
+#include <stdint.h>
+
+/**
+ * All traffic received from the FLARM devices (or from a similar
+ * source such as OGN/ADS-B feeds, which may deliver hundreds of
+ * targets).
+ *
+ * Unlike #TrafficList, this is not part of #NMEAInfo and is not
+ * copied with the blackboards; there is one instance, see
+ * #ProtectedTrafficStore.  The NMEA parser adds each target, and the
+ * #FlarmComputer expires them and calculates the derived attributes.
+ *
+ * Besides the plain list, it maintains a hash index of the FLARM ids
+ * (for FindTraffic()) and a grid of the positions relative to our
+ * own aircraft (for VisitWithinRange() and FindNearest()).
+ *
+ * Do not add or remove items from #list directly; use Update() or
+ * AllocateTraffic() and Expire().
+ */
+struct TrafficStore {
+  static gcc_constexpr_data size_t MAX_COUNT = 256;
+
+  /**
+   * The number of slots in the FLARM id hash table is 2^ID_INDEX_BITS;
+   * that is at least twice #MAX_COUNT.
+   */
+  static gcc_constexpr_data unsigned ID_INDEX_BITS = 9;
+  static gcc_constexpr_data unsigned ID_INDEX_SIZE = 1u << ID_INDEX_BITS;
+
+  /**
+   * The number of grid cells in each direction.
+   */
+  static gcc_constexpr_data unsigned GRID_SIZE = 16;
+
+  /**
+   * The edge length of one grid cell [m].  The grid covers 10 km in
+   * each direction, which is the largest radar range; targets beyond
+   * that are kept in an extra "outside" cell.
+   */
+  static gcc_constexpr_data unsigned GRID_CELL_SIZE = 1250;
+
+  TrivialArray<FlarmTraffic, MAX_COUNT> list;
+
+private:
+  /**
+   * Open addressing hash table (linear probing) of the FLARM ids.
+   * Each slot contains the #list index plus one, or zero if the slot
+   * is empty.
+   */
+  uint16_t id_index[ID_INDEX_SIZE];
+
+  /**
+   * The first target in each grid cell (#list index plus one, zero
+   * means the cell is empty); the last element is the "outside" cell.
+   */
+  uint16_t grid_head[GRID_SIZE * GRID_SIZE + 1];
+
+  /**
+   * The next target in the same grid cell, same encoding as
+   * #grid_head.
+   */
+  uint16_t grid_next[MAX_COUNT];
+
+  /**
+   * Is the grid up to date?  It is invalidated by all operations
+   * which add or remove targets, and rebuilt by
+   * UpdateSpatialIndex().
+   */
+  bool grid_valid;
+
+  /**
+   * A lower bound for the #FlarmTraffic::valid time stamps of all
+   * targets.  As long as this one has not expired, no target can
+   * have expired, and Expire() does not need to check them all.
+   */
+  Validity oldest;
+
+  /**
+   * The clock of the last Expire() call, to detect time warps.
+   */
+  Validity last_expire;
+
+public:
+  void Clear();
+
+  bool IsEmpty() const {
+    return list.empty();
+  }
+
+  unsigned GetActiveTrafficCount() const {
+    return list.size();
+  }
+
+  /**
+   * Remove all targets which have not been updated recently.
+   */
+  void Expire(fixed clock);
+
+  /**
+   * Looks up an item in the traffic list.
+   *
+   * @param id FLARM id
+   * @return the FLARM_TRAFFIC pointer, NULL if not found
+   */
+  FlarmTraffic *FindTraffic(FlarmId id) {
+    const int i = FindIndex(id);
+    return i >= 0 ? &list[i] : NULL;
+  }
+
+  /**
+   * Looks up an item in the traffic list.
+   *
+   * @param id FLARM id
+   * @return the FLARM_TRAFFIC pointer, NULL if not found
+   */
+  const FlarmTraffic *FindTraffic(FlarmId id) const {
+    const int i = FindIndex(id);
+    return i >= 0 ? &list[i] : NULL;
+  }
+
+  /**
+   * Allocates a new FLARM_TRAFFIC object from the array.  The caller
+   * is responsible for initialising all attributes except for the
+   * id.
+   *
+   * @param id the FLARM id of the new target, which must not be in
+   * the list already
+   * @return the FLARM_TRAFFIC pointer, NULL if the array is full
+   */
+  FlarmTraffic *AllocateTraffic(FlarmId id);
+
+  /**
+   * Copy the received attributes of the specified target to the
+   * target with the same id, which is added if it is not yet known.
+   *
+   * @return false if the target is new and the array is full
+   */
+  bool Update(const FlarmTraffic &traffic, fixed clock);
+
+  /**
+   * Search for the previous traffic in the ordered list.
+   */
+  const FlarmTraffic *PreviousTraffic(const FlarmTraffic *t) const {
+    return t > list.begin()
+      ? t - 1
+      : NULL;
+  }
+
+  /**
+   * Search for the next traffic in the ordered list.
+   */
+  const FlarmTraffic *NextTraffic(const FlarmTraffic *t) const {
+    return t + 1 < list.end()
+      ? t + 1
+      : NULL;
+  }
+
+  /**
+   * Search for the first traffic in the ordered list.
+   */
+  const FlarmTraffic *FirstTraffic() const {
+    return list.empty() ? NULL : list.begin();
+  }
+
+  /**
+   * Search for the last traffic in the ordered list.
+   */
+  const FlarmTraffic *LastTraffic() const {
+    return list.empty() ? NULL : list.end() - 1;
+  }
+
+  /**
+   * Finds the most critical alert.  Returns NULL if there is no
+   * alert.
+   */
+  gcc_pure
+  const FlarmTraffic *FindMaximumAlert() const;
+
+  unsigned TrafficIndex(const FlarmTraffic *t) const {
+    return t - list.begin();
+  }
+
+  /**
+   * Rebuild the grid from the current FlarmTraffic::relative_north
+   * and FlarmTraffic::relative_east values.  Until this is called
+   * after a modification, the range queries fall back to scanning
+   * the whole list.
+   */
+  void UpdateSpatialIndex();
+
+  /**
+   * Invoke the visitor (with a "const FlarmTraffic &" parameter) for
+   * all targets within the specified distance of the specified
+   * position.  Positions are relative to our own aircraft [m].
+   */
+  template<typename V>
+  void VisitWithinRange(fixed north, fixed east, fixed range,
+                        V &visitor) const {
+    const fixed square_range = sqr(range);
+
+    if (!grid_valid) {
+      for (auto it = list.begin(), end = list.end(); it != end; ++it)
+        if (IsWithinRange(*it, north, east, square_range))
+          visitor(*it);
+      return;
+    }
+
+    const unsigned min_column = GetGridColumn(east - range);
+    const unsigned max_column = GetGridColumn(east + range);
+    const unsigned min_row = GetGridRow(north - range);
+    const unsigned max_row = GetGridRow(north + range);
+
+    for (unsigned row = min_row; row <= max_row; ++row)
+      for (unsigned column = min_column; column <= max_column; ++column)
+        VisitCell(row * GRID_SIZE + column, north, east, square_range,
+                  visitor);
+
+    if (IsOutsideGrid(north, east, range))
+      VisitCell(GRID_SIZE * GRID_SIZE, north, east, square_range, visitor);
+  }
+
+  /**
+   * Find the target nearest to the specified position (relative to
+   * our own aircraft [m]).
+   *
+   * @param max_range ignore targets farther away than this
+   * @return the target or NULL if there is none within range
+   */
+  gcc_pure
+  const FlarmTraffic *FindNearest(fixed north, fixed east,
+                                  fixed max_range) const;
+
+private:
+  gcc_pure
+  static unsigned GetIdSlot(FlarmId id) {
+    return id.Hash() >> (32 - ID_INDEX_BITS);
+  }
+
+  gcc_pure
+  int FindIndex(FlarmId id) const;
+
+  /**
+   * Remove the hash table entry pointing to the specified #list
+   * index.
+   */
+  void RemoveFromIdIndex(unsigned i);
+
+  /**
+   * Change the hash table entry pointing to list index #from to point
+   * to #to.
+   */
+  void MoveInIdIndex(unsigned from, unsigned to);
+
+  void RemoveTraffic(unsigned i);
+
+  gcc_const
+  static unsigned GetGridColumn(fixed east) {
+    return ClipGridIndex(east);
+  }
+
+  gcc_const
+  static unsigned GetGridRow(fixed north) {
+    return ClipGridIndex(north);
+  }
+
+  gcc_const
+  static unsigned ClipGridIndex(fixed value);
+
+  /**
+   * Returns the grid cell index of the specified position, or
+   * GRID_SIZE*GRID_SIZE if it is outside the grid.
+   */
+  gcc_const
+  static unsigned GetGridCell(fixed north, fixed east);
+
+  /**
+   * Does the specified circle extend beyond the grid?
+   */
+  gcc_const
+  static bool IsOutsideGrid(fixed north, fixed east, fixed range);
+
+  gcc_pure
+  static bool IsWithinRange(const FlarmTraffic &traffic,
+                            fixed north, fixed east, fixed square_range) {
+    return sqr(traffic.relative_north - north) +
+      sqr(traffic.relative_east - east) <= square_range;
+  }
+
+  template<typename V>
+  void VisitCell(unsigned cell, fixed north, fixed east, fixed square_range,
+                 V &visitor) const {
+    for (unsigned i = grid_head[cell]; i != 0; i = grid_next[i - 1]) {
+      const FlarmTraffic &traffic = list[i - 1];
+      if (IsWithinRange(traffic, north, east, square_range))
+        visitor(traffic);
+    }
+  }
+};
+
+static_assert(TrafficStore::ID_INDEX_SIZE >= 2 * TrafficStore::MAX_COUNT,
+              "hash table too small");
+
+static_assert(is_trivial<TrafficStore>::value, "type is not trivial");
+
+#endif
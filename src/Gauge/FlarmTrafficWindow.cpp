@@ -145,11 +145,26 @@ FlarmTrafficWindow::UpdateSelector(const FlarmId id, const RasterPoint pt)
     SetTarget(id);
 
   // If we don't have a valid selection and we can't find
-  // a target close to to the RasterPoint we select the next one
-  // on the internal list
+  // a target close to to the RasterPoint we select the one nearest
+  // to our own aircraft
   if (selection < 0 && (
       pt.x < 0 || pt.y < 0 ||
       !SelectNearTarget(pt.x, pt.y, radius * 2)) )
+    SelectNearestTarget();
+}
+
+void
+FlarmTrafficWindow::SelectNearestTarget()
+{
+  // If warning is displayed -> prevent selector movement
+  if (WarningMode())
+    return;
+
+  const FlarmTraffic *traffic =
+    data.FindNearest(fixed_zero, fixed_zero, fixed(50000));
+  if (traffic != NULL)
+    SetTarget(traffic);
+  else
     NextTarget();
 }
 
@@ -170,7 +185,7 @@ FlarmTrafficWindow::UpdateWarnings()
  * This should be called when the radar needs to be repainted
  */
 void
-FlarmTrafficWindow::Update(Angle new_direction, const TrafficList &new_data,
+FlarmTrafficWindow::Update(Angle new_direction, const TrafficStore &new_data,
                            const TeamCodeSettings &new_settings)
 {
   FlarmId selection_id;
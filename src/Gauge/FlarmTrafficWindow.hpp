@@ -25,7 +25,7 @@
 #define FLARM_TRAFFIC_WINDOW_H
 
 #include "Screen/PaintWindow.hpp"
-#include "FLARM/List.hpp"
+#include "FLARM/TrafficStore.hpp"
 #include "FLARM/Friends.hpp"
 #include "TeamCodeSettings.hpp"
 #include "Math/FastRotation.hpp"
@@ -60,13 +60,16 @@ protected:
 
   bool small;
 
-  RasterPoint sc[TrafficList::MAX_COUNT];
+  RasterPoint sc[TrafficStore::MAX_COUNT];
 
   bool enable_north_up;
   Angle heading;
   FastRotation fr;
   FastIntegerRotation fir;
-  TrafficList data;
+  /**
+   * A copy of the #TrafficStore, made by Update().
+   */
+  TrafficStore data;
   TeamCodeSettings settings;
 
 public:
@@ -100,6 +103,11 @@ public:
 
   void NextTarget();
   void PrevTarget();
+
+  /**
+   * Select the target nearest to our own aircraft.
+   */
+  void SelectNearestTarget();
   bool SelectNearTarget(int x, int y, int max_distance);
 
   void SetDistance(fixed _distance) {
@@ -114,7 +122,7 @@ protected:
 
   void UpdateSelector(const FlarmId id, const RasterPoint pt);
   void UpdateWarnings();
-  void Update(Angle new_direction, const TrafficList &new_data,
+  void Update(Angle new_direction, const TrafficStore &new_data,
               const TeamCodeSettings &new_settings);
   void PaintRadarNoTraffic(Canvas &canvas) const;
   void PaintRadarTarget(Canvas &canvas, const FlarmTraffic &traffic,
@@ -28,6 +28,8 @@ Copyright_License {
 #include "NMEA/MoreData.hpp"
 #include "ComputerSettings.hpp"
 #include "Dialogs/Traffic.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Components.hpp"
 
 /**
  * Widget to display a FLARM gauge
@@ -65,7 +67,8 @@ void
 SmallTrafficWindow::Update(const NMEAInfo &gps_info,
                            const TeamCodeSettings &settings)
 {
-  FlarmTrafficWindow::Update(gps_info.track, gps_info.flarm.traffic, settings);
+  ProtectedTrafficStore::Lease store(device_blackboard->GetTrafficStore());
+  FlarmTrafficWindow::Update(gps_info.track, store, settings);
 }
 
 /**
@@ -0,0 +1,92 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGCFixReader.hpp"
+#include "IGCParser.hpp"
+#include "IGCFix.hpp"
+
+#include <string.h>
+
+IGCFixReader::IGCFixReader(const TCHAR *path)
+  :mapping(path)
+{
+  position = (const char *)mapping.data();
+  end = position != NULL ? (const char *)mapping.end() : NULL;
+
+  extensions.clear();
+  date.Clear();
+}
+
+void
+IGCFixReader::ParseOtherLine(const char *line, size_t length)
+{
+  if (line[0] != 'I' && line[0] != 'H')
+    return;
+
+  /* these are rare, and their parsers expect a null-terminated
+     string */
+  char buffer[256];
+  if (length >= sizeof(buffer))
+    return;
+
+  memcpy(buffer, line, length);
+  buffer[length] = 0;
+
+  if (buffer[0] == 'I')
+    IGCParseExtensions(buffer, extensions);
+  else if (memcmp(buffer, "HFDTE", 5) == 0) {
+    BrokenDate value;
+    if (IGCParseDateRecord(buffer, value))
+      date = value;
+  }
+}
+
+unsigned
+IGCFixReader::Read(IGCFix *fixes, unsigned max)
+{
+  unsigned n = 0;
+
+  while (n < max && position < end) {
+    const char *line = position;
+    const char *eol = (const char *)memchr(line, '\n', end - line);
+    if (eol != NULL)
+      position = eol + 1;
+    else
+      position = eol = end;
+
+    if (eol > line && eol[-1] == '\r')
+      --eol;
+
+    const size_t length = eol - line;
+    if (length == 0)
+      continue;
+
+    if (line[0] == 'B') {
+      if (IGCParseFix(line, length, extensions, fixes[n]))
+        ++n;
+    } else
+      ParseOtherLine(line, length);
+  }
+
+  return n;
+}
@@ -0,0 +1,113 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_FIX_READER_HPP
+#define XCSOAR_IGC_FIX_READER_HPP
+
+#include "IGCExtensions.hpp"
+#include "OS/FileMapping.hpp"
+#include "DateTime.hpp"
+#include "Util/NonCopyable.hpp"
+
+#include <tchar.h>
+#include <stddef.h>
+
+struct IGCFix;
+
+/**
+ * Reads the "B" records of an IGC file in batches.  The file is
+ * mapped into memory and scanned in place, i.e. lines are neither
+ * copied into a buffer nor null-terminated.  The "I" record
+ * (extension layout) and the "HFDTE" date are picked up on the way.
+ */
+class IGCFixReader : private NonCopyable {
+  FileMapping mapping;
+
+  const char *position, *end;
+
+  IGCExtensions extensions;
+
+  BrokenDate date;
+
+public:
+  IGCFixReader(const TCHAR *path);
+
+  /**
+   * Has the constructor failed?
+   */
+  bool error() const {
+    return mapping.error();
+  }
+
+  /**
+   * Returns the date from the "HFDTE" record, if it has been read
+   * already.  Check BrokenDate::Plausible().
+   */
+  const BrokenDate &GetDate() const {
+    return date;
+  }
+
+  const IGCExtensions &GetExtensions() const {
+    return extensions;
+  }
+
+  /**
+   * Returns the size of the file, in bytes.
+   */
+  size_t GetSize() const {
+    return mapping.size();
+  }
+
+  /**
+   * Returns the current position in the file, in bytes.
+   */
+  size_t Tell() const {
+    return position - (const char *)mapping.data();
+  }
+
+  /**
+   * Read the next batch of fixes.  Malformed "B" records are skipped;
+   * fixes with gps_valid=false are returned.
+   *
+   * @return the number of fixes stored in the array; 0 at the end of
+   * the file
+   */
+  unsigned Read(IGCFix *fixes, unsigned max);
+
+  /**
+   * Read the next fix.
+   *
+   * @return false at the end of the file
+   */
+  bool Read(IGCFix &fix) {
+    return Read(&fix, 1) > 0;
+  }
+
+private:
+  /**
+   * Handle a line which is not a "B" record.
+   */
+  void ParseOtherLine(const char *line, size_t length);
+};
+
+#endif
@@ -108,6 +108,120 @@ IGCParseDateRecord(const char *line, BrokenDate &date)
   return date.Plausible();
 }
 
+/**
+ * Parse a fixed number of decimal digits.  The loop has no
+ * data-dependent branches: invalid characters are only collected in
+ * a flag, which is checked once at the end.  The caller must ensure
+ * that #n characters are readable.
+ *
+ * @return the value, or -1 if one of the characters is not a digit
+ */
+static int
+ParseFixedDigits(const char *p, unsigned n)
+{
+  unsigned value = 0, invalid = 0;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned digit = (unsigned char)p[i] - (unsigned char)'0';
+    invalid |= digit > 9;
+    value = value * 10 + digit;
+  }
+
+  return invalid ? -1 : (int)value;
+}
+
+/**
+ * Parse a five character altitude field, which may be negative
+ * ("-0012").
+ */
+static bool
+ParseAltitude(const char *p, int &value_r)
+{
+  if (*p == '-') {
+    const int value = ParseFixedDigits(p + 1, 4);
+    if (value < 0)
+      return false;
+
+    value_r = -value;
+  } else {
+    const int value = ParseFixedDigits(p, 5);
+    if (value < 0)
+      return false;
+
+    value_r = value;
+  }
+
+  return true;
+}
+
+/**
+ * Is the string at least #n characters long?  This is used to check
+ * null-terminated input before passing it to the fixed-width parsers.
+ */
+static bool
+HasLength(const char *p, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i)
+    if (p[i] == 0)
+      return false;
+
+  return true;
+}
+
+/**
+ * Parse "HHMMSS"; at least 6 characters must be readable.
+ */
+static bool
+ParseTimeFixed(const char *p, BrokenTime &time)
+{
+  const int hour = ParseFixedDigits(p, 2);
+  const int minute = ParseFixedDigits(p + 2, 2);
+  const int second = ParseFixedDigits(p + 4, 2);
+  if ((hour | minute | second) < 0)
+    return false;
+
+  time = BrokenTime(hour, minute, second);
+  return time.Plausible();
+}
+
+/**
+ * Parse "DDMMmmm[N/S]DDDMMmmm[E/W]"; at least 17 characters must be
+ * readable.
+ */
+static bool
+ParseLocationFixed(const char *p, GeoPoint &location)
+{
+  const int lat_degrees = ParseFixedDigits(p, 2);
+  const int lat_minutes = ParseFixedDigits(p + 2, 5);
+  const char lat_char = p[7];
+  const int lon_degrees = ParseFixedDigits(p + 8, 3);
+  const int lon_minutes = ParseFixedDigits(p + 11, 5);
+  const char lon_char = p[16];
+
+  if ((lat_degrees | lat_minutes | lon_degrees | lon_minutes) < 0)
+    return false;
+
+  if (lat_degrees >= 90 || lat_minutes >= 60000 ||
+      (lat_char != 'N' && lat_char != 'S'))
+    return false;
+
+  if (lon_degrees >= 180 || lon_minutes >= 60000 ||
+      (lon_char != 'E' && lon_char != 'W'))
+    return false;
+
+  location.latitude = Angle::Degrees(fixed(lat_degrees) +
+                                     fixed(lat_minutes) / 60000);
+  if (lat_char == 'S')
+    location.latitude.Flip();
+
+  location.longitude = Angle::Degrees(fixed(lon_degrees) +
+                                      fixed(lon_minutes) / 60000);
+  if (lon_char == 'W')
+    location.longitude.Flip();
+
+  return true;
+}
+
 static int
 ParseTwoDigits(const char *p)
 {
@@ -217,22 +331,18 @@ ParseExtensionValueN(const char *p, const char *end, size_t n,
 }
 
 bool
-IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
+IGCParseFix(const char *buffer, size_t length,
+            const IGCExtensions &extensions, IGCFix &fix)
 {
-  if (*buffer != 'B')
+  /* "B" + time (6) + location (17) + validity (1) + altitudes (10) */
+  if (length < 35 || *buffer != 'B')
     return false;
 
   BrokenTime time;
-  if (!IGCParseTime(buffer + 1, time))
-    return false;
-
-  char valid_char;
-  int gps_altitude, pressure_altitude;
-
-  if (sscanf(buffer + 24, "%c%05d%05d",
-             &valid_char, &pressure_altitude, &gps_altitude) != 3)
+  if (!ParseTimeFixed(buffer + 1, time))
     return false;
 
+  const char valid_char = buffer[24];
   if (valid_char == 'A')
     fix.gps_valid = true;
   else if (valid_char == 'V')
@@ -240,23 +350,23 @@ IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
   else
     return false;
 
-  fix.gps_altitude = gps_altitude;
-  fix.pressure_altitude = pressure_altitude;
+  if (!ParseAltitude(buffer + 25, fix.pressure_altitude) ||
+      !ParseAltitude(buffer + 30, fix.gps_altitude))
+    return false;
 
-  if (!IGCParseLocation(buffer + 7, fix.location))
+  if (!ParseLocationFixed(buffer + 7, fix.location))
     return false;
 
   fix.time = time;
 
   fix.ClearExtensions();
 
-  const size_t line_length = strlen(buffer);
   for (auto i = extensions.begin(), end = extensions.end(); i != end; ++i) {
     const IGCExtension &extension = *i;
     assert(extension.start > 0);
     assert(extension.finish >= extension.start);
 
-    if (extension.finish > line_length)
+    if (extension.finish > length)
       /* exceeds the input line length */
       continue;
 
@@ -289,35 +399,15 @@ IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
 }
 
 bool
-IGCParseLocation(const char *buffer, GeoPoint &location)
+IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
 {
-  unsigned lat_degrees, lat_minutes, lon_degrees, lon_minutes;
-  char lat_char, lon_char;
-
-  if (sscanf(buffer, "%02u%05u%c%03u%05u%c",
-             &lat_degrees, &lat_minutes, &lat_char,
-             &lon_degrees, &lon_minutes, &lon_char) != 6)
-    return false;
-
-  if (lat_degrees >= 90 || lat_minutes >= 60000 ||
-      (lat_char != 'N' && lat_char != 'S'))
-    return false;
-
-  if (lon_degrees >= 180 || lon_minutes >= 60000 ||
-      (lon_char != 'E' && lon_char != 'W'))
-    return false;
-
-  location.latitude = Angle::Degrees(fixed(lat_degrees) +
-                                     fixed(lat_minutes) / 60000);
-  if (lat_char == 'S')
-    location.latitude.Flip();
-
-  location.longitude = Angle::Degrees(fixed(lon_degrees) +
-                                      fixed(lon_minutes) / 60000);
-  if (lon_char == 'W')
-    location.longitude.Flip();
+  return IGCParseFix(buffer, strlen(buffer), extensions, fix);
+}
 
-  return true;
+bool
+IGCParseLocation(const char *buffer, GeoPoint &location)
+{
+  return HasLength(buffer, 17) && ParseLocationFixed(buffer, location);
 }
 
 bool
@@ -332,13 +422,7 @@ IGCParseFix(const char *buffer, IGCFix &fix)
 bool
 IGCParseTime(const char *buffer, BrokenTime &time)
 {
-  unsigned hour, minute, second;
-
-  if (sscanf(buffer, "%02u%02u%02u", &hour, &minute, &second) != 3)
-    return false;
-
-  time = BrokenTime(hour, minute, second);
-  return time.Plausible();
+  return HasLength(buffer, 6) && ParseTimeFixed(buffer, time);
 }
 
 static bool
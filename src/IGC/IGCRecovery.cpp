@@ -0,0 +1,115 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGC/IGCRecovery.hpp"
+#include "IO/FileHandle.hpp"
+#include "OS/FileUtil.hpp"
+#include "Util/AllocatedArray.hpp"
+
+#include <algorithm>
+
+#include <windef.h> /* for MAX_PATH */
+#include <string.h>
+
+TCHAR *
+IGCGetPartialPath(TCHAR *buffer, const TCHAR *path)
+{
+  _tcscpy(buffer, path);
+  _tcscat(buffer, IGC_PARTIAL_SUFFIX);
+  return buffer;
+}
+
+/**
+ * Determine the final name of a partial file.
+ *
+ * @return false if the name does not end with #IGC_PARTIAL_SUFFIX
+ */
+static bool
+GetFinalPath(TCHAR *buffer, const TCHAR *partial_path)
+{
+  const size_t length = _tcslen(partial_path);
+  const size_t suffix_length = _tcslen(IGC_PARTIAL_SUFFIX);
+  if (length <= suffix_length || length >= MAX_PATH ||
+      _tcscmp(partial_path + length - suffix_length,
+              IGC_PARTIAL_SUFFIX) != 0)
+    return false;
+
+  std::copy(partial_path, partial_path + length - suffix_length, buffer);
+  buffer[length - suffix_length] = _T('\0');
+  return true;
+}
+
+bool
+IGCRecoverFile(const TCHAR *partial_path)
+{
+  TCHAR final_path[MAX_PATH];
+  if (!GetFinalPath(final_path, partial_path) ||
+      File::Exists(final_path))
+    return false;
+
+  AllocatedArray<char> data;
+  long length;
+
+  {
+    FileHandle src(partial_path, _T("rb"));
+    if (!src.IsOpen() || !src.Seek(0, SEEK_END))
+      return false;
+
+    length = src.Tell();
+    if (length < 0 || !src.Seek(0, SEEK_SET))
+      return false;
+
+    data.GrowDiscard(length + 1);
+    if (src.Read(data.begin(), 1, length) != (size_t)length)
+      return false;
+  }
+
+  /* a crash may have interrupted the last line; IGC readers would
+     reject the whole file because of it */
+  while (length > 0 && data[length - 1] != '\n')
+    --length;
+
+  {
+    FileHandle dest(final_path, _T("wb"));
+    if (!dest.IsOpen())
+      return false;
+
+    static const char note[] = "LXCSRECOVERED AFTER CRASH";
+#ifdef HAVE_POSIX
+    static const char newline[] = "\n";
+#else
+    static const char newline[] = "\r\n";
+#endif
+
+    if (dest.Write(data.begin(), 1, length) != (size_t)length ||
+        dest.Write(note, 1, strlen(note)) != strlen(note) ||
+        dest.Write(newline, 1, strlen(newline)) != strlen(newline) ||
+        !dest.Sync()) {
+      File::Delete(final_path);
+      return false;
+    }
+  }
+
+  File::Delete(partial_path);
+  return true;
+}
@@ -0,0 +1,57 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_RECOVERY_HPP
+#define XCSOAR_IGC_RECOVERY_HPP
+
+#include <tchar.h>
+
+/**
+ * This suffix is appended to the name of an IGC file while it is
+ * being written.  A file with this suffix which exists while no
+ * logger is running has been left behind by a crash.
+ */
+#define IGC_PARTIAL_SUFFIX _T(".part")
+
+/**
+ * Build the name of the partial file for the specified IGC file.
+ *
+ * @param buffer a buffer of at least MAX_PATH characters
+ */
+TCHAR *
+IGCGetPartialPath(TCHAR *buffer, const TCHAR *path);
+
+/**
+ * Recover an IGC file which was left behind by a crash: drop the
+ * incomplete last line, append an "L" record which marks the file as
+ * recovered, and rename it to its final name.  The file is not
+ * signed.
+ *
+ * @param partial_path the path of the file, ending with
+ * #IGC_PARTIAL_SUFFIX
+ * @return true on success
+ */
+bool
+IGCRecoverFile(const TCHAR *partial_path);
+
+#endif
@@ -22,7 +22,8 @@ Copyright_License {
 */
 
 #include "IGC/IGCWriter.hpp"
-#include "IO/TextWriter.hpp"
+#include "IGC/IGCRecovery.hpp"
+#include "OS/FileUtil.hpp"
 #include "NMEA/Info.hpp"
 #include "Version.hpp"
 #include "Compatibility/string.h"
@@ -54,6 +55,8 @@ FormatIGCLocation(char *buffer, const GeoPoint &location)
 }
 
 IGCWriter::IGCWriter(const TCHAR *_path, bool simulator)
+  :thread(IGCGetPartialPath(partial_path, _path), grecord),
+   finished(false)
 {
   _tcscpy(path, _path);
 
@@ -63,42 +66,26 @@ IGCWriter::IGCWriter(const TCHAR *_path, bool simulator)
     grecord.Initialize();
 }
 
+IGCWriter::~IGCWriter()
+{
+  Finish();
+}
+
 bool
 IGCWriter::Flush()
 {
-  if (buffer.IsEmpty())
-    return true;
-
-  TextWriter writer(path, true);
-  if (writer.error())
-    return false;
-
-  for (unsigned i = 0; i < buffer.Length(); ++i) {
-    if (!writer.writeln(buffer[i]))
-      return false;
-
-    grecord.AppendRecordToBuffer(buffer[i]);
-  }
-
-  if (!writer.flush())
-    return false;
-
-  buffer.Clear();
-  return true;
+  return thread.Flush();
 }
 
 void
 IGCWriter::Finish()
 {
-  Flush();
-}
+  if (finished)
+    return;
 
-static void
-ReplaceNonIGCChars(char *p)
-{
-  for (; *p != 0; ++p)
-    if (!GRecord::IsValidIGCChar(*p))
-      *p = ' ';
+  finished = true;
+  thread.Close();
+  File::Rename(partial_path, path);
 }
 
 bool
@@ -106,19 +93,14 @@ IGCWriter::WriteLine(const char *line)
 {
   assert(strchr(line, '\r') == NULL);
   assert(strchr(line, '\n') == NULL);
+  assert(!finished);
 
-  if (buffer.IsFull() && !Flush())
-    return false;
-
-  assert(!buffer.IsFull());
-
-  char *dest = buffer.Append();
-  strncpy(dest, line, MAX_IGC_BUFF);
-  dest[MAX_IGC_BUFF - 1] = '\0';
-
-  ReplaceNonIGCChars(dest);
+  if (thread.Push(line))
+    return true;
 
-  return true;
+  /* the queue is full, which means the storage device has not kept
+     up for a long time; there is no way around waiting for it */
+  return thread.Flush() && thread.Push(line);
 }
 
 bool
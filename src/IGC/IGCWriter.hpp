@@ -26,7 +26,7 @@ Copyright_License {
 
 #include "Logger/LoggerFRecord.hpp"
 #include "Logger/LoggerGRecord.hpp"
-#include "Util/BatchBuffer.hpp"
+#include "IGCWriterThread.hpp"
 #include "Math/fixed.hpp"
 #include "Engine/Navigation/GeoPoint.hpp"
 #include "IGCFix.hpp"
@@ -39,26 +39,52 @@ struct NMEAInfo;
 struct Declaration;
 struct GeoPoint;
 
+/**
+ * Formats IGC records.  The file is written by an #IGCWriterThread;
+ * until Finish() is called, it has the #IGC_PARTIAL_SUFFIX, so a
+ * flight which was interrupted by a crash can be recognized and
+ * recovered with IGCRecoverFile().
+ */
 class IGCWriter {
   enum {
-    /** Number of records in disk buffer */
-    LOGGER_DISK_BUFFER_NUM_RECS = 10,
     MAX_IGC_BUFF = 255,
   };
 
   TCHAR path[MAX_PATH];
-  BatchBuffer<char[MAX_IGC_BUFF],LOGGER_DISK_BUFFER_NUM_RECS> buffer;
+  TCHAR partial_path[MAX_PATH];
 
   GRecord grecord;
 
+  IGCWriterThread thread;
+
+  bool finished;
+
   IGCFix last_valid_point;
   bool last_valid_point_initialized;
 
 public:
   IGCWriter(const TCHAR *_path, bool simulator);
 
+  /**
+   * Calls Finish() if that has not been done yet.
+   */
+  ~IGCWriter();
+
+  /**
+   * Wait until all records have been written and synced to the
+   * storage device.
+   */
   bool Flush();
+
+  /**
+   * Write all records, close the file and give it its final name.
+   * After that, no more records may be written.
+   */
   void Finish();
+
+  /**
+   * Append the G record.  Call this after Finish().
+   */
   void Sign();
 
   bool WriteLine(const char *line);
@@ -0,0 +1,167 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGC/IGCWriterThread.hpp"
+#include "Logger/LoggerGRecord.hpp"
+#include "IO/TextWriter.hpp"
+#include "OS/Clock.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+IGCWriterThread::IGCWriterThread(const TCHAR *_path, GRecord &_grecord)
+  :grecord(_grecord), writer(NULL), last_sync(MonotonicClockMS()),
+   error(false), sync_requested(false), closed(false)
+{
+  _tcscpy(path, _path);
+}
+
+IGCWriterThread::~IGCWriterThread()
+{
+  Close();
+}
+
+bool
+IGCWriterThread::Push(const char *line)
+{
+  assert(!closed);
+
+  Line *slot = queue.BeginPush();
+  if (slot == NULL)
+    return false;
+
+  strncpy(slot->text, line, MAX_LINE);
+  slot->text[MAX_LINE - 1] = '\0';
+  queue.CommitPush();
+
+  /* the thread holds the mutex only for a short time while it is
+     working, so this does not wait for disk I/O */
+  ScopeLock protect(mutex);
+  if (!IsBusy())
+    Trigger();
+
+  return true;
+}
+
+bool
+IGCWriterThread::Flush()
+{
+  ScopeLock protect(mutex);
+  sync_requested = true;
+  if (!IsBusy())
+    Trigger();
+
+  /* if the thread was busy, it sees the flag before it goes idle */
+  WaitDone();
+  return !error;
+}
+
+void
+IGCWriterThread::Close()
+{
+  if (closed)
+    return;
+
+  Flush();
+  closed = true;
+
+  mutex.Lock();
+  Stop();
+  mutex.Unlock();
+
+  delete writer;
+  writer = NULL;
+}
+
+static void
+ReplaceNonIGCChars(char *p)
+{
+  for (; *p != 0; ++p)
+    if (!GRecord::IsValidIGCChar(*p))
+      *p = ' ';
+}
+
+bool
+IGCWriterThread::WriteQueued(bool sync)
+{
+  if (writer == NULL) {
+    if (queue.IsEmpty())
+      /* don't create the file before there is something to write */
+      return true;
+
+    writer = new TextWriter(path, true);
+    if (writer->error()) {
+      delete writer;
+      writer = NULL;
+      queue.Clear();
+      return false;
+    }
+  }
+
+  bool success = true;
+
+  const Line *line;
+  while ((line = queue.Peek()) != NULL) {
+    char buffer[MAX_LINE];
+    strcpy(buffer, line->text);
+    queue.Shift();
+
+    ReplaceNonIGCChars(buffer);
+
+    if (!writer->writeln(buffer))
+      success = false;
+
+    grecord.AppendRecordToBuffer(buffer);
+  }
+
+  const unsigned now = MonotonicClockMS();
+  if (sync || now - last_sync >= SYNC_INTERVAL_MS) {
+    if (!writer->sync())
+      success = false;
+
+    last_sync = now;
+  } else if (!writer->flush())
+    success = false;
+
+  return success;
+}
+
+void
+IGCWriterThread::Tick()
+{
+  do {
+    const bool sync = sync_requested;
+    sync_requested = false;
+
+    mutex.Unlock();
+    const bool success = WriteQueued(sync);
+    mutex.Lock();
+
+    if (!success)
+      error = true;
+
+    /* records which were queued while we were writing have not
+       triggered the (busy) thread; check again with the mutex locked,
+       so none of them is left behind */
+  } while (!queue.IsEmpty() || sync_requested);
+}
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_WRITER_THREAD_HPP
+#define XCSOAR_IGC_WRITER_THREAD_HPP
+
+#include "Thread/StandbyThread.hpp"
+#include "Thread/SPSCQueue.hpp"
+
+#include <tchar.h>
+#include <windef.h> /* for MAX_PATH */
+
+class GRecord;
+class TextWriter;
+
+/**
+ * Writes IGC records to a file in a background thread, so the
+ * producer (usually the calculation thread) never waits for the disk.
+ * The records are passed through a lock-free queue; the thread
+ * replaces illegal characters, feeds the records into the G record
+ * digest and appends them to the file, which it keeps open.
+ *
+ * All records the thread has dequeued are passed to the operating
+ * system right away, i.e. they survive a crash of XCSoar.  To survive
+ * a power failure as well, the file is synced to the storage device
+ * every #SYNC_INTERVAL_MS milliseconds, which bounds the data loss
+ * window.
+ */
+class IGCWriterThread : private StandbyThread {
+public:
+  enum {
+    MAX_LINE = 255,
+
+    /**
+     * The number of records which may be queued.  At 4 Hz with an F
+     * record now and then, this is roughly one minute.
+     */
+    QUEUE_SIZE = 256,
+
+    SYNC_INTERVAL_MS = 5000,
+  };
+
+private:
+  struct Line {
+    char text[MAX_LINE];
+  };
+
+  SPSCQueue<Line, QUEUE_SIZE> queue;
+
+  TCHAR path[MAX_PATH];
+
+  /**
+   * The digest of all records written.  It is owned by the thread
+   * while the thread runs.
+   */
+  GRecord &grecord;
+
+  /**
+   * The open file; only used by the thread.
+   */
+  TextWriter *writer;
+
+  /**
+   * The MonotonicClockMS() value of the last sync.
+   */
+  unsigned last_sync;
+
+  /**
+   * Has a write failed?  Protected by the mutex.
+   */
+  bool error;
+
+  /**
+   * Shall the thread sync the file after the next batch?  Protected
+   * by the mutex.
+   */
+  bool sync_requested;
+
+  /**
+   * Has Close() been called?  Only used by the producer.
+   */
+  bool closed;
+
+public:
+  IGCWriterThread(const TCHAR *path, GRecord &grecord);
+
+  /**
+   * Calls Close() if that has not been done yet.
+   */
+  ~IGCWriterThread();
+
+  /**
+   * Queue a record and wake up the thread.  This never waits for
+   * disk I/O.  Only one thread may call this method.
+   *
+   * @return false if the queue is full
+   */
+  bool Push(const char *line);
+
+  /**
+   * Wait until all queued records have been written and synced to
+   * the storage device.
+   *
+   * @return false if a write has failed since the file was opened
+   */
+  bool Flush();
+
+  /**
+   * Write and sync all queued records, stop the thread and close the
+   * file.  Afterwards, the G record digest may be used by the caller,
+   * and no more records may be pushed.
+   */
+  void Close();
+
+protected:
+  virtual void Tick();
+
+private:
+  /**
+   * Write all queued records and pass them to the operating system,
+   * and sync the file if requested or when the sync interval has
+   * passed.  Called by the thread without holding the mutex.
+   */
+  bool WriteQueued(bool sync);
+};
+
+#endif
@@ -38,8 +38,8 @@ CSVLine::CSVLine(const char *line):
 size_t
 CSVLine::Skip()
 {
-  const char* _seperator = strchr(data, ',');
-  if (_seperator != NULL && _seperator < end) {
+  const char *_seperator = (const char *)memchr(data, ',', end - data);
+  if (_seperator != NULL) {
     size_t length = _seperator - data;
     data = _seperator + 1;
     return length;
@@ -60,21 +60,20 @@ CSVLine::ReadFirstChar()
 void
 CSVLine::Read(char *dest, size_t size)
 {
-  const char *src = data;
-  size_t length = Skip();
+  size_t length;
+  const char *src = ReadView(length);
   if (length >= size)
     length = size - 1;
-  strncpy(dest, src, length);
+  memcpy(dest, src, length);
   dest[length] = '\0';
 }
 
 bool
 CSVLine::ReadCompare(const char *value)
 {
-  size_t length = strlen(value);
-  char buffer[length + 2];
-  Read(buffer, length + 2);
-  return strcmp(buffer, value) == 0;
+  size_t length;
+  const char *src = ReadView(length);
+  return length == strlen(value) && memcmp(src, value, length) == 0;
 }
 
 long
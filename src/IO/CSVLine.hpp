@@ -57,6 +57,19 @@ public:
 
   char ReadFirstChar();
 
+  /**
+   * Read the next column without copying it.
+   *
+   * @param length_r receives the length of the column
+   * @return a pointer to the beginning of the column; it is not
+   * null-terminated
+   */
+  const char *ReadView(size_t &length_r) {
+    const char *src = data;
+    length_r = Skip();
+    return src;
+  }
+
   void Read(char *dest, size_t size);
   bool ReadCompare(const char *value);
 
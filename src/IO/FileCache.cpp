@@ -86,6 +86,9 @@ GetRegularFileInfo(const TCHAR *path, FileInfo &info)
 #endif
 }
 
+const size_t FileCache::HEADER_SIZE =
+  sizeof(FILE_CACHE_MAGIC) + sizeof(FileInfo);
+
 FileCache::FileCache(const TCHAR *_cache_path)
   :cache_path(_tcsdup(_cache_path)), cache_path_length(_tcslen(_cache_path)) {}
 
@@ -156,6 +159,21 @@ FileCache::Load(const TCHAR *name, const TCHAR *original_path)
   return file;
 }
 
+const TCHAR *
+FileCache::LoadPath(const TCHAR *name, const TCHAR *original_path,
+                    TCHAR *buffer)
+{
+  if (PathBufferSize(name) > MAX_PATH)
+    return NULL;
+
+  FILE *file = Load(name, original_path);
+  if (file == NULL)
+    return NULL;
+
+  fclose(file);
+  return MakeCachePath(buffer, name);
+}
+
 FILE *
 FileCache::Save(const TCHAR *name, const TCHAR *original_path)
 {
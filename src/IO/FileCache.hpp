@@ -32,6 +32,12 @@ class FileCache {
   size_t cache_path_length;
 
 public:
+  /**
+   * The size of the header which precedes the payload of each cache
+   * file.
+   */
+  static const size_t HEADER_SIZE;
+
   FileCache(const TCHAR *_cache_path);
   ~FileCache();
 
@@ -43,6 +49,17 @@ public:
   void Flush(const TCHAR *name);
   FILE *Load(const TCHAR *name, const TCHAR *original_path);
 
+  /**
+   * Validates the cache file like Load(), but returns its path
+   * instead of opening it, e.g. to map it into memory.  The payload
+   * begins at HEADER_SIZE.
+   *
+   * @param buffer a buffer of at least MAX_PATH characters
+   * @return the path, or NULL if there is no valid cache file
+   */
+  const TCHAR *LoadPath(const TCHAR *name, const TCHAR *original_path,
+                        TCHAR *buffer);
+
   FILE *Save(const TCHAR *name, const TCHAR *original_path);
   bool Commit(const TCHAR *name, FILE *file);
   void Cancel(const TCHAR *name, FILE *file);
@@ -32,6 +32,12 @@ Copyright_License {
 #include <tchar.h>
 #endif
 
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#elif !defined(_WIN32_WCE)
+#include <io.h>
+#endif
+
 class FileHandle {
 private:
   FILE *file;
@@ -71,6 +77,28 @@ public:
     return fflush(file) == 0;
   }
 
+  /**
+   * Like Flush(), but also ask the operating system to write the
+   * file contents to the physical device.  This is expensive, and
+   * should only be used for data which must survive a power failure.
+   */
+  bool Sync() {
+    assert(file != NULL);
+
+    if (fflush(file) != 0)
+      return false;
+
+#ifdef HAVE_POSIX
+    return fsync(fileno(file)) == 0;
+#elif !defined(_WIN32_WCE)
+    return _commit(_fileno(file)) == 0;
+#else
+    /* no way to sync a FILE on Windows CE, fflush() is the best we
+       can do */
+    return true;
+#endif
+  }
+
   bool Seek(long offset, int whence) {
     assert(file != NULL);
     return fseek(file, offset, whence) == 0;
@@ -0,0 +1,155 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "MappedLineReader.hpp"
+
+#include <string.h>
+#include <stdint.h>
+
+MappedLineReaderA::MappedLineReaderA(const TCHAR *path)
+  :mapping(path), position(NULL), end(NULL)
+{
+  if (!mapping.error()) {
+    position = (const char *)mapping.data();
+    end = (const char *)mapping.end();
+  }
+}
+
+gcc_pure
+static bool
+IsASCII(const char *p, const char *end)
+{
+  /* check one machine word at a time; the unaligned head and tail
+     are checked byte by byte */
+  const size_t high_bits = (size_t)0x8080808080808080ull;
+
+  while (p < end && (uintptr_t)p % sizeof(size_t) != 0)
+    if ((unsigned char)*p++ >= 0x80)
+      return false;
+
+  for (; p + sizeof(size_t) <= end; p += sizeof(size_t)) {
+    size_t word;
+    memcpy(&word, p, sizeof(word));
+    if ((word & high_bits) != 0)
+      return false;
+  }
+
+  for (; p < end; ++p)
+    if ((unsigned char)*p >= 0x80)
+      return false;
+
+  return true;
+}
+
+bool
+MappedLineReaderA::IsASCII() const
+{
+  return ::IsASCII(position, end);
+}
+
+char *
+MappedLineReaderA::read()
+{
+  if (position >= end)
+    /* end of file */
+    return NULL;
+
+  const char *line = position;
+  const char *eol = (const char *)memchr(line, '\n', end - line);
+  if (eol == NULL)
+    /* last line, not terminated by a line feed */
+    position = eol = end;
+  else
+    position = eol + 1;
+
+  /* purge trailing carriage return characters */
+  while (eol > line && eol[-1] == '\r')
+    --eol;
+
+  const size_t length = eol - line;
+  char *dest = buffer.get(length + 1);
+  if (dest == NULL)
+    /* allocation has failed */
+    return NULL;
+
+  memcpy(dest, line, length);
+  dest[length] = 0;
+  return dest;
+}
+
+long
+MappedLineReaderA::size() const
+{
+  return mapping.size();
+}
+
+long
+MappedLineReaderA::tell() const
+{
+  return error() ? 0 : position - (const char *)mapping.data();
+}
+
+MappedLineReader::MappedLineReader(const TCHAR *path,
+                                   ConvertLineReader::charset cs)
+  :splitter(path), convert(splitter, cs),
+   ascii(!splitter.error() && splitter.IsASCII())
+{
+}
+
+TCHAR *
+MappedLineReader::read()
+{
+  if (!ascii)
+    return convert.read();
+
+#ifdef _UNICODE
+  const char *narrow = splitter.read();
+  if (narrow == NULL)
+    return NULL;
+
+  size_t length = strlen(narrow);
+  TCHAR *t = tbuffer.get(length + 1);
+  if (t == NULL)
+    return NULL;
+
+  /* ASCII is a subset of UTF-16, no lookup required */
+  for (size_t i = 0; i <= length; ++i)
+    t[i] = (TCHAR)narrow[i];
+
+  return t;
+#else
+  return splitter.read();
+#endif
+}
+
+long
+MappedLineReader::size() const
+{
+  return splitter.size();
+}
+
+long
+MappedLineReader::tell() const
+{
+  return splitter.tell();
+}
@@ -0,0 +1,118 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IO_MAPPED_LINE_READER_HPP
+#define XCSOAR_IO_MAPPED_LINE_READER_HPP
+
+#include "LineReader.hpp"
+#include "ConvertLineReader.hpp"
+#include "OS/FileMapping.hpp"
+#include "Util/ReusableArray.hpp"
+#include "Compiler.h"
+
+/**
+ * A NLineReader implementation which maps the whole file into memory
+ * instead of reading it through FileSource.  This saves one read()
+ * system call per 4 kB block, and unlike LineSplitter, the line
+ * length is not limited by the Source buffer size.
+ *
+ * The mapping is read-only, but read() must return a writable
+ * null-terminated string; therefore each line is copied into a small
+ * buffer which stays in the CPU cache.  A private (copy-on-write)
+ * mapping would avoid that, but it would duplicate every page of the
+ * file in anonymous memory, and measurements have shown that the
+ * page faults cost more than the copy.
+ *
+ * Like LineSplitter, it assumes that lines are delimited by a
+ * linefeed character, and deletes carriage returns.
+ */
+class MappedLineReaderA : public NLineReader {
+  FileMapping mapping;
+
+  /**
+   * The remaining portion of the file.
+   */
+  const char *position, *end;
+
+  /** the current line, null-terminated */
+  ReusableArray<char> buffer;
+
+public:
+  MappedLineReaderA(const TCHAR *path);
+
+  /**
+   * Has the constructor failed?  This also fails for empty files;
+   * the caller should fall back to FileLineReaderA then.
+   */
+  bool error() const {
+    return mapping.error();
+  }
+
+  /**
+   * Does the (remaining) file consist of 7-bit ASCII characters only?
+   */
+  gcc_pure
+  bool IsASCII() const;
+
+public:
+  virtual char *read();
+  virtual long size() const;
+  virtual long tell() const;
+};
+
+/**
+ * Glue class which combines MappedLineReaderA and ConvertLineReader,
+ * and provides a public TLineReader interface.
+ *
+ * If the file is plain ASCII (which is the common case for waypoint
+ * and airspace files), all character sets decode to the same string,
+ * and the lines are passed through without validation or conversion.
+ */
+class MappedLineReader : public TLineReader {
+  MappedLineReaderA splitter;
+  ConvertLineReader convert;
+
+  /**
+   * Skip ConvertLineReader, because the file is plain ASCII?
+   */
+  bool ascii;
+
+#ifdef _UNICODE
+  ReusableArray<TCHAR> tbuffer;
+#endif
+
+public:
+  MappedLineReader(const TCHAR *path,
+                   ConvertLineReader::charset cs=ConvertLineReader::UTF8);
+
+  bool error() const {
+    return splitter.error();
+  }
+
+public:
+  virtual TCHAR *read();
+  virtual long size() const;
+  virtual long tell() const;
+};
+
+#endif
@@ -84,6 +84,15 @@ public:
     return file.Flush();
   }
 
+  /**
+   * Like flush(), but also ask the operating system to write the
+   * file contents to the physical device.
+   */
+  bool sync() {
+    assert(file.IsOpen());
+    return file.Sync();
+  }
+
   /**
    * Write one character.
    */
@@ -40,6 +40,7 @@ Copyright_License {
 #include "Profile/InfoBoxConfig.hpp"
 #include "Interface.hpp"
 #include "UIState.hpp"
+#include "LogFile.hpp"
 
 #include <assert.h>
 #include <stdio.h>
@@ -52,6 +53,8 @@ namespace InfoBoxManager
 {
   InfoBoxLayout::Layout layout;
 
+  Statistics statistics;
+
   /**
    * Is this the initial DisplayInfoBox() call?  If yes, then all
    * content objects need to be created.
@@ -253,7 +256,9 @@ InfoBoxManager::DisplayInfoBox()
       DisplayTypeLast[i] = DisplayType;
     }
 
-    InfoBoxes[i]->UpdateContent();
+    ++statistics.updates;
+    if (InfoBoxes[i]->UpdateContent())
+      ++statistics.changed;
   }
 
   first = false;
@@ -466,6 +471,9 @@ InfoBoxManager::Create(PixelRect rc, const InfoBoxLayout::Layout &_layout,
 void
 InfoBoxManager::Destroy()
 {
+  LogStartUp(_T("InfoBox updates: %u (%u changed), repaints: %u"),
+             statistics.updates, statistics.changed, statistics.repaints);
+
   for (unsigned i = 0; i < layout.count; i++) {
     delete InfoBoxes[i];
     InfoBoxes[i] = NULL;
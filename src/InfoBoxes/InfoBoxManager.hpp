@@ -50,6 +50,23 @@ namespace InfoBoxManager
 
   extern InfoBoxLayout::Layout layout;
 
+  /**
+   * Counters which show how much work the InfoBox update pipeline
+   * does.
+   */
+  struct Statistics {
+    /** the number of InfoBoxContent::Update() calls */
+    unsigned updates;
+
+    /** the number of updates which modified the InfoBoxData */
+    unsigned changed;
+
+    /** the number of InfoBoxWindow::OnPaint() calls */
+    unsigned repaints;
+  };
+
+  extern Statistics statistics;
+
   void Event_Select(int i);
   void Event_Change(int i);
 
@@ -63,6 +63,7 @@ InfoBoxWindow::InfoBoxWindow(ContainerWindow &_parent,
    focus_timer(*this)
 {
   data.Clear();
+  text_size.Clear();
 
   style.EnableDoubleClicks();
   set(parent, x, y, width, height, style);
@@ -85,6 +86,7 @@ void
 InfoBoxWindow::SetTitle(const TCHAR *_title)
 {
   data.SetTitle(_title);
+  text_size.title_valid = false;
   Invalidate(title_rect);
 }
 
@@ -99,7 +101,12 @@ InfoBoxWindow::PaintTitle(Canvas &canvas)
   const Font &font = *look.title.font;
   canvas.Select(font);
 
-  PixelSize tsize = canvas.CalcTextSize(data.title);
+  if (!text_size.title_valid) {
+    text_size.title = canvas.CalcTextSize(data.title);
+    text_size.title_valid = true;
+  }
+
+  const PixelSize tsize = text_size.title;
 
   PixelScalar halftextwidth = (title_rect.left + title_rect.right - tsize.cx) / 2;
   PixelScalar x = max(PixelScalar(1),
@@ -133,6 +140,30 @@ InfoBoxWindow::PaintTitle(Canvas &canvas)
   }
 }
 
+const Font &
+InfoBoxWindow::SelectValueFont(Canvas &canvas, PixelSize &size)
+{
+  if (!text_size.value_valid) {
+    canvas.Select(*look.value.font);
+    text_size.value = canvas.CalcTextSize(data.value);
+    text_size.value_small =
+      text_size.value.cx > value_rect.right - value_rect.left;
+    if (text_size.value_small) {
+      canvas.Select(*look.small_font);
+      text_size.value = canvas.CalcTextSize(data.value);
+    }
+
+    text_size.value_valid = true;
+  }
+
+  const Font &font = text_size.value_small
+    ? *look.small_font
+    : *look.value.font;
+  canvas.Select(font);
+  size = text_size.value;
+  return font;
+}
+
 void
 InfoBoxWindow::PaintValue(Canvas &canvas)
 {
@@ -148,15 +179,9 @@ InfoBoxWindow::PaintValue(Canvas &canvas)
     PixelScalar unit_width =
         UnitSymbolRenderer::GetSize(canvas, data.value_unit).cx;
 
-    canvas.Select(*look.value.font);
-    UPixelScalar ascent_height = look.value.font->GetAscentHeight();
-
-    PixelSize value_size = canvas.CalcTextSize(data.value);
-    if (value_size.cx > value_rect.right - value_rect.left) {
-      canvas.Select(*look.small_font);
-      ascent_height = look.small_font->GetAscentHeight();
-      value_size = canvas.CalcTextSize(data.value);
-    }
+    PixelSize value_size;
+    const Font &font = SelectValueFont(canvas, value_size);
+    const UPixelScalar ascent_height = font.GetAscentHeight();
 
     PixelScalar x = max(
         PixelScalar(0),
@@ -180,17 +205,10 @@ InfoBoxWindow::PaintValue(Canvas &canvas)
   }
 #endif
 
-  canvas.Select(*look.value.font);
-  UPixelScalar ascent_height = look.value.font->GetAscentHeight();
-  UPixelScalar capital_height = look.value.font->GetCapitalHeight();
-
-  PixelSize value_size = canvas.CalcTextSize(data.value);
-  if (value_size.cx > value_rect.right - value_rect.left) {
-    canvas.Select(*look.small_font);
-    ascent_height = look.small_font->GetAscentHeight();
-    capital_height = look.small_font->GetCapitalHeight();
-    value_size = canvas.CalcTextSize(data.value);
-  }
+  PixelSize value_size;
+  const Font &font = SelectValueFont(canvas, value_size);
+  const UPixelScalar ascent_height = font.GetAscentHeight();
+  const UPixelScalar capital_height = font.GetCapitalHeight();
 
   PixelSize unit_size;
   const UnitSymbol *unit_symbol = units_look.GetSymbol(data.value_unit);
@@ -234,7 +252,12 @@ InfoBoxWindow::PaintComment(Canvas &canvas)
   const Font &font = *look.comment.font;
   canvas.Select(font);
 
-  PixelSize tsize = canvas.CalcTextSize(data.comment);
+  if (!text_size.comment_valid) {
+    text_size.comment = canvas.CalcTextSize(data.comment);
+    text_size.comment_valid = true;
+  }
+
+  const PixelSize tsize = text_size.comment;
 
   PixelScalar x = max(PixelScalar(1),
                       PixelScalar((comment_rect.left + comment_rect.right
@@ -309,36 +332,50 @@ InfoBoxWindow::SetContentProvider(InfoBoxContent *_content)
   content = _content;
 
   data.SetInvalid();
+  text_size.Clear();
   Invalidate();
 }
 
-void
+bool
 InfoBoxWindow::UpdateContent()
 {
   if (content == NULL)
-    return;
+    return false;
 
   InfoBoxData old = data;
   content->Update(data);
 
-  if (old.GetCustom() || data.GetCustom())
+  const bool title_changed = !data.CompareTitle(old);
+  const bool value_changed = !data.CompareValue(old);
+  const bool comment_changed = !data.CompareComment(old);
+
+  if (title_changed)
+    text_size.title_valid = false;
+  if (value_changed)
+    text_size.value_valid = false;
+  if (comment_changed)
+    text_size.comment_valid = false;
+
+  if (old.GetCustom() || data.GetCustom()) {
     /* must Invalidate everything when custom painting is/was
        enabled */
     Invalidate();
-  else {
+    return true;
+  }
+
 #ifdef ENABLE_OPENGL
-    if (!data.CompareTitle(old) || !data.CompareValue(old) ||
-        !data.CompareComment(old))
-      Invalidate();
+  if (title_changed || value_changed || comment_changed)
+    Invalidate();
 #else
-    if (!data.CompareTitle(old))
-      Invalidate(title_rect);
-    if (!data.CompareValue(old))
-      Invalidate(value_rect);
-    if (!data.CompareComment(old))
-      Invalidate(comment_rect);
+  if (title_changed)
+    Invalidate(title_rect);
+  if (value_changed)
+    Invalidate(value_rect);
+  if (comment_changed)
+    Invalidate(comment_rect);
 #endif
-  }
+
+  return title_changed || value_changed || comment_changed;
 }
 
 bool
@@ -409,6 +446,9 @@ InfoBoxWindow::OnResize(UPixelScalar width, UPixelScalar height)
 
   value_and_comment_rect = value_rect;
   value_and_comment_rect.bottom = comment_rect.bottom;
+
+  /* the value font depends on the width of value_rect */
+  text_size.value_valid = false;
 }
 
 bool
@@ -500,6 +540,8 @@ InfoBoxWindow::OnMouseDouble(PixelScalar x, PixelScalar y)
 void
 InfoBoxWindow::OnPaint(Canvas &canvas)
 {
+  ++InfoBoxManager::statistics.repaints;
+
   Paint(canvas);
 }
 
@@ -82,6 +82,34 @@ private:
 
   PeriodClock click_clock;
 
+  /**
+   * Cached text measurements of #data, which avoid measuring
+   * unmodified strings on every repaint.  The flags are cleared when
+   * the corresponding text or the layout changes.
+   */
+  struct TextSizeCache {
+    bool title_valid, value_valid, comment_valid;
+
+    /**
+     * Does the value need the small font, because it does not fit
+     * into #value_rect with the regular value font?
+     */
+    bool value_small;
+
+    PixelSize title, value, comment;
+
+    void Clear() {
+      title_valid = value_valid = comment_valid = false;
+    }
+  } text_size;
+
+  /**
+   * Selects the font for the value (the regular value font, or the
+   * small font if it doesn't fit), and returns the size of the value
+   * text.
+   */
+  const Font &SelectValueFont(Canvas &canvas, PixelSize &size);
+
   /**
    * Paints the InfoBox title to the given canvas
    * @param canvas The canvas to paint on
@@ -143,7 +171,14 @@ public:
   }
 
   void SetContentProvider(InfoBoxContent *_content);
-  void UpdateContent();
+
+  /**
+   * Calls InfoBoxContent::Update() and invalidates the parts of the
+   * window which have changed.
+   *
+   * @return true if the InfoBoxData was modified
+   */
+  bool UpdateContent();
 
 protected:
   bool HandleKey(InfoBoxContent::InfoBoxKeyCodes keycode);
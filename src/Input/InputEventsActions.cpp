@@ -255,6 +255,9 @@ InputEvents::eventFlarmDetails(gcc_unused const TCHAR *misc)
 
   FlarmId ids[30];
   unsigned count = FlarmDetails::FindIdsByCallSign(callsign, ids, 30);
+  if (count == 0)
+    /* no exact match: offer all callsigns beginning with the input */
+    count = FlarmDetails::FindIdsByCallSignPrefix(callsign, ids, 30);
 
   if (count > 0) {
     FlarmId id = dlgFlarmDetailsListShowModal(
@@ -67,11 +67,11 @@ CommonInterface::IsPanning()
 void
 XCSoarInterface::ReceiveGPS()
 {
+  ReadPublishedBasic(*device_blackboard);
+
   {
     ScopeLock protect(device_blackboard->mutex);
 
-    ReadBlackboardBasic(device_blackboard->Basic());
-
     const NMEAInfo &real = device_blackboard->RealState();
     movement_detected = real.alive && real.gps.real &&
       real.MovementDetected();
@@ -87,10 +87,10 @@ XCSoarInterface::ReceiveGPS()
 void
 XCSoarInterface::ReceiveCalculated()
 {
+  ReadPublishedCalculated(*device_blackboard);
+
   {
     ScopeLock protect(device_blackboard->mutex);
-
-    ReadBlackboardCalculated(device_blackboard->Calculated());
     device_blackboard->ReadComputerSettings(GetComputerSettings());
   }
 
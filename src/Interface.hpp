@@ -150,6 +150,14 @@ public:
     blackboard.ReadBlackboardCalculated(derived_info);
   }
 
+  static void ReadPublishedBasic(const DeviceBlackboard &device_blackboard) {
+    blackboard.ReadPublishedBasic(device_blackboard);
+  }
+
+  static void ReadPublishedCalculated(const DeviceBlackboard &device_blackboard) {
+    blackboard.ReadPublishedCalculated(device_blackboard);
+  }
+
   static void AddListener(BlackboardListener &listener) {
     blackboard.AddListener(listener);
   }
@@ -0,0 +1,288 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Pool.hpp"
+#include "Job.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
+#include "Util/StringUtil.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+/**
+ * The maximum value of JobPool::Task::GetProgress().
+ */
+static const unsigned PROGRESS_SCALE = 1024;
+
+unsigned
+JobPool::Task::GetProgress() const
+{
+  switch (state) {
+  case State::WAITING:
+    return 0;
+
+  case State::RUNNING:
+    return progress_range > 0
+      ? std::min(progress_position, progress_range) * PROGRESS_SCALE
+        / progress_range
+      : 0;
+
+  case State::DONE:
+  case State::SKIPPED:
+    break;
+  }
+
+  return PROGRESS_SCALE;
+}
+
+bool
+JobPool::Task::IsCancelled() const
+{
+  return pool.cancelled.Get();
+}
+
+void
+JobPool::Task::Sleep(unsigned ms)
+{
+  ::Sleep(ms);
+}
+
+void
+JobPool::Task::SetErrorMessage(const TCHAR *_error)
+{
+  pool.mutex.Lock();
+  error = _error;
+  update_error = true;
+  pool.mutex.Unlock();
+
+  pool.trigger.Signal();
+}
+
+void
+JobPool::Task::SetText(const TCHAR *_text)
+{
+  pool.mutex.Lock();
+  text = _text;
+  progress_range = progress_position = 0;
+  pool.mutex.Unlock();
+
+  pool.trigger.Signal();
+}
+
+/* the progress methods don't signal the trigger; the main thread
+   polls the progress periodically, which is good enough for a
+   progress bar */
+
+void
+JobPool::Task::SetProgressRange(unsigned range)
+{
+  pool.mutex.Lock();
+  progress_range = range;
+  pool.mutex.Unlock();
+}
+
+void
+JobPool::Task::SetProgressPosition(unsigned position)
+{
+  pool.mutex.Lock();
+  progress_position = position;
+  pool.mutex.Unlock();
+}
+
+void
+JobPool::Task::RunJob()
+{
+  const uint64_t start_time = MonotonicClockUS();
+  job->Run(*this);
+  const uint64_t end_time = MonotonicClockUS();
+
+  pool.mutex.Lock();
+  duration = end_time - start_time;
+  state = State::DONE;
+  pool.mutex.Unlock();
+
+  pool.trigger.Signal();
+}
+
+void
+JobPool::Task::Run()
+{
+  RunJob();
+}
+
+JobPool::~JobPool()
+{
+  for (unsigned i = 0; i < n_tasks; ++i) {
+    assert(!tasks[i]->IsDefined());
+    delete tasks[i];
+  }
+}
+
+unsigned
+JobPool::Add(Job &job, const TCHAR *name)
+{
+  assert(n_tasks < MAX_JOBS);
+
+  tasks[n_tasks] = new Task(*this, job, name);
+  return n_tasks++;
+}
+
+void
+JobPool::Depend(unsigned job, unsigned dependency)
+{
+  assert(job < n_tasks);
+  assert(dependency < job);
+
+  tasks[job]->dependencies |= 1u << dependency;
+}
+
+bool
+JobPool::IsReady(const Task &task) const
+{
+  for (unsigned i = 0; i < n_tasks; ++i)
+    if ((task.dependencies & (1u << i)) != 0 &&
+        tasks[i]->state != State::DONE)
+      return false;
+
+  return true;
+}
+
+unsigned
+JobPool::StartReady(unsigned max_threads)
+{
+  const bool is_cancelled = cancelled.Get();
+
+  unsigned running = 0;
+  for (unsigned i = 0; i < n_tasks; ++i)
+    if (tasks[i]->state == State::RUNNING)
+      ++running;
+
+  unsigned pending = running;
+  for (unsigned i = 0; i < n_tasks; ++i) {
+    Task &task = *tasks[i];
+    if (task.state != State::WAITING)
+      continue;
+
+    if (is_cancelled) {
+      task.state = State::SKIPPED;
+      continue;
+    }
+
+    ++pending;
+
+    if (running >= max_threads || !IsReady(task))
+      continue;
+
+    task.state = State::RUNNING;
+    ++running;
+
+    if (!task.Start()) {
+      /* no thread available: run it synchronously */
+      mutex.Unlock();
+      task.RunJob();
+      mutex.Lock();
+      --running;
+      --pending;
+    }
+  }
+
+  return pending;
+}
+
+void
+JobPool::UpdateProgress(OperationEnvironment &env,
+                        StaticString<128u> &current_text)
+{
+  StaticString<128u> errors[MAX_JOBS];
+  unsigned n_errors = 0;
+
+  StaticString<128u> text;
+  text.clear();
+
+  unsigned progress = 0;
+
+  mutex.Lock();
+
+  for (unsigned i = 0; i < n_tasks; ++i) {
+    Task &task = *tasks[i];
+
+    if (task.update_error) {
+      errors[n_errors++] = task.error;
+      task.update_error = false;
+    }
+
+    /* show the text of the oldest running job */
+    if (text.empty() && task.state == State::RUNNING)
+      text = task.text;
+
+    progress += task.GetProgress();
+  }
+
+  mutex.Unlock();
+
+  for (unsigned i = 0; i < n_errors; ++i)
+    env.SetErrorMessage(errors[i]);
+
+  if (!text.empty() && !StringIsEqual(text, current_text)) {
+    current_text = text;
+    env.SetText(text);
+    env.SetProgressRange(PROGRESS_SCALE);
+  }
+
+  if (n_tasks > 0)
+    env.SetProgressPosition(progress / n_tasks);
+}
+
+bool
+JobPool::Run(OperationEnvironment &env, unsigned max_threads)
+{
+  assert(max_threads > 0);
+
+  StaticString<128u> current_text;
+  current_text.clear();
+
+  while (true) {
+    if (env.IsCancelled())
+      cancelled.Set();
+
+    mutex.Lock();
+    const unsigned pending = StartReady(max_threads);
+    mutex.Unlock();
+
+    UpdateProgress(env, current_text);
+
+    if (pending == 0)
+      break;
+
+    trigger.Wait(200);
+    trigger.Reset();
+  }
+
+  for (unsigned i = 0; i < n_tasks; ++i)
+    if (tasks[i]->IsDefined())
+      tasks[i]->Join();
+
+  return !cancelled.Get();
+}
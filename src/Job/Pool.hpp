@@ -0,0 +1,192 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_JOB_POOL_HPP
+#define XCSOAR_JOB_POOL_HPP
+
+#include "Operation/Operation.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Trigger.hpp"
+#include "Thread/Flag.hpp"
+#include "Util/StaticString.hpp"
+
+#include <stdint.h>
+
+class Job;
+
+/**
+ * Runs a number of #Job instances concurrently, each in its own
+ * thread, while respecting dependencies between them.  The progress
+ * of all jobs is combined and passed to the caller's
+ * #OperationEnvironment, in the calling thread.
+ *
+ * Usage: register all jobs with Add() and Depend(), then call Run(),
+ * which blocks until all jobs have finished.
+ */
+class JobPool : private NonCopyable {
+public:
+  static const unsigned MAX_JOBS = 16;
+
+private:
+  enum class State : uint8_t {
+    WAITING,
+    RUNNING,
+    DONE,
+    SKIPPED,
+  };
+
+  /**
+   * One job, the thread it runs in, and the #OperationEnvironment
+   * it reports to.  All attributes written by the job thread are
+   * protected by JobPool::mutex.
+   */
+  class Task : public Thread, public OperationEnvironment {
+    JobPool &pool;
+
+  public:
+    Job *job;
+    const TCHAR *name;
+
+    /** bit mask of jobs which must be finished before this one */
+    unsigned dependencies;
+
+    State state;
+
+    StaticString<128u> text, error;
+    bool update_error;
+
+    unsigned progress_range, progress_position;
+
+    /** the wall-clock time spent in Job::Run() [us] */
+    uint64_t duration;
+
+    Task(JobPool &_pool, Job &_job, const TCHAR *_name)
+      :pool(_pool), job(&_job), name(_name), dependencies(0),
+       state(State::WAITING), update_error(false),
+       progress_range(0), progress_position(0), duration(0) {
+      text.clear();
+      error.clear();
+    }
+
+    /**
+     * Run the job in the current thread.
+     */
+    void RunJob();
+
+    /**
+     * Returns this job's progress in the range 0..1024.
+     */
+    gcc_pure
+    unsigned GetProgress() const;
+
+    /* virtual methods from class OperationEnvironment */
+    virtual bool IsCancelled() const;
+    virtual void Sleep(unsigned ms);
+    virtual void SetErrorMessage(const TCHAR *text);
+    virtual void SetText(const TCHAR *text);
+    virtual void SetProgressRange(unsigned range);
+    virtual void SetProgressPosition(unsigned position);
+
+  protected:
+    /* virtual methods from class Thread */
+    virtual void Run();
+  };
+
+  Mutex mutex;
+
+  /**
+   * Signalled by a job thread when it has something new to report.
+   */
+  Trigger trigger;
+
+  Flag cancelled;
+
+  unsigned n_tasks;
+  Task *tasks[MAX_JOBS];
+
+public:
+  JobPool():n_tasks(0) {}
+  ~JobPool();
+
+  /**
+   * Schedule a job.
+   *
+   * @param name a short name for log messages
+   * @return a handle which may be passed to Depend() and
+   * GetDuration()
+   */
+  unsigned Add(Job &job, const TCHAR *name);
+
+  /**
+   * Declare that #job must not be started before #dependency has
+   * finished.
+   */
+  void Depend(unsigned job, unsigned dependency);
+
+  /**
+   * Run all jobs and wait for their completion.  The number of
+   * concurrent jobs is limited by #max_threads.
+   *
+   * @return false if the operation was cancelled; in that case, jobs
+   * which have not been started yet were skipped
+   */
+  bool Run(OperationEnvironment &env, unsigned max_threads);
+
+  unsigned GetCount() const {
+    return n_tasks;
+  }
+
+  const TCHAR *GetName(unsigned job) const {
+    return tasks[job]->name;
+  }
+
+  /**
+   * Returns the wall-clock time the job took to run [us], or 0 if it
+   * was skipped.
+   */
+  uint64_t GetDuration(unsigned job) const {
+    return tasks[job]->duration;
+  }
+
+private:
+  gcc_pure
+  bool IsReady(const Task &task) const;
+
+  /**
+   * Start all jobs which are ready, as long as the thread limit
+   * permits.  Caller must hold the mutex.
+   *
+   * @return the number of jobs still running or waiting
+   */
+  unsigned StartReady(unsigned max_threads);
+
+  /**
+   * Pass new texts, error messages and the combined progress to the
+   * caller's environment.
+   */
+  void UpdateProgress(OperationEnvironment &env,
+                      StaticString<128u> &current_text);
+};
+
+#endif
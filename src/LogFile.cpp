@@ -28,6 +28,7 @@ Copyright_License {
 #include "Formatter/TimeFormatter.hpp"
 #include "OS/Clock.hpp"
 #include "Util/StaticString.hpp"
+#include "Thread/Mutex.hpp"
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -37,6 +38,13 @@ Copyright_License {
 #include <android/log.h>
 #endif
 
+/**
+ * Serialises access to the log file.  The data file loaders log from
+ * the JobPool threads, and without this lock, their lines could be
+ * interleaved or the file could be truncated twice.  It also protects
+ * the static variables in LogStartUp().
+ */
+static Mutex log_mutex;
 
 void
 LogStartUp(const TCHAR *Str, ...)
@@ -44,10 +52,6 @@ LogStartUp(const TCHAR *Str, ...)
   static bool initialised = false;
   static TCHAR szFileName[MAX_PATH];
 
-  if (!initialised) {
-    LocalPath(szFileName, _T("xcsoar-startup.log"));
-  }
-
   TCHAR buf[MAX_PATH];
   va_list ap;
 
@@ -66,6 +70,11 @@ LogStartUp(const TCHAR *Str, ...)
   fprintf(stderr, "%s\n", buf);
 #endif
 
+  const ScopeLock protect(log_mutex);
+
+  if (!initialised)
+    LocalPath(szFileName, _T("xcsoar-startup.log"));
+
   TextWriter writer(szFileName, initialised);
   if (writer.error())
     return;
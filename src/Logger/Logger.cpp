@@ -163,3 +163,12 @@ Logger::ClearBuffer()
   Poco::ScopedRWLock protect(lock, true);
   logger.ClearBuffer();
 }
+
+void
+Logger::RecoverPartialFiles()
+{
+  Poco::ScopedRWLock protect(lock, true);
+  assert(!logger.IsActive());
+
+  LoggerImpl::RecoverPartialFiles();
+}
@@ -63,6 +63,11 @@ public:
                      bool noAsk = false);
   void LoggerNote(const TCHAR *text);
   void ClearBuffer();
+
+  /**
+   * @see LoggerImpl::RecoverPartialFiles()
+   */
+  void RecoverPartialFiles();
 };
 
 #endif
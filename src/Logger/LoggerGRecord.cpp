@@ -26,6 +26,8 @@
 #include "IO/FileLineReader.hpp"
 #include "IO/TextWriter.hpp"
 
+#include <algorithm>
+
 #include <tchar.h>
 #include <string.h>
 
@@ -59,23 +61,31 @@ GRecord::AppendRecordToBuffer(const char *record)
 void
 GRecord::AppendStringToBuffer(const unsigned char *in)
 {
-  for (int i = 0; i < 4; i++)
-    // skip whitespace flag=1
-    md5[i].AppendString(in, true);
+  /* filter the invalid characters once for all four MD5 contexts, in
+     chunks to avoid a dynamic buffer for very long records */
+  char buffer[256];
+
+  const char *src = (const char *)in;
+  size_t remaining = strlen(src);
+  while (remaining > 0) {
+    const size_t n = std::min(remaining, sizeof(buffer));
+    md5.Append(buffer, MD5::FilterIGCChars(src, n, buffer));
+    src += n;
+    remaining -= n;
+  }
 }
 
 void
 GRecord::FinalizeBuffer()
 {
-  for (int i = 0; i < 4; i++)
-    md5[i].Finalize();
+  md5.Finalize();
 }
 
 void
 GRecord::GetDigest(char *output)
 {
-  for (int i = 0; i <= 3; i++)
-    md5[i].GetDigest(output + i * 32);
+  for (unsigned i = 0; i < MD5x4::LANES; i++)
+    md5.GetDigest(i, output + i * 32);
 
   output[128] = '\0';
 }
@@ -91,27 +101,27 @@ GRecord::Initialize(int key_id)
   {
   case 2:
     // key 2
-    md5[0].InitKey(0x1C80A301,0x9EB30b89,0x39CB2Afe,0x0D0FEA76);
-    md5[1].InitKey(0x48327203,0x3948ebea,0x9a9b9c9e,0xb3bed89a);
-    md5[2].InitKey(0x67452301,0xefcdab89,0x98badcfe,0x10325476);
-    md5[3].InitKey(0xc8e899e8,0x9321c28a,0x438eba12,0x8cbe0aee);
+    md5.InitKey(0, 0x1C80A301,0x9EB30b89,0x39CB2Afe,0x0D0FEA76);
+    md5.InitKey(1, 0x48327203,0x3948ebea,0x9a9b9c9e,0xb3bed89a);
+    md5.InitKey(2, 0x67452301,0xefcdab89,0x98badcfe,0x10325476);
+    md5.InitKey(3, 0xc8e899e8,0x9321c28a,0x438eba12,0x8cbe0aee);
     break;
 
   case 3:
     // key 3
-    md5[0].InitKey(0x7894abde,0x9cb4e90a,0x0bc8f0ea,0x03a9e01a);
-    md5[1].InitKey(0x3c4a4c93,0x9cbf7ae3,0xa9bcd0ea,0x9a8c2aaa);
-    md5[2].InitKey(0x3c9ae1f1,0x9fe02a1f,0x3fc9a497,0x93cad3ef);
-    md5[3].InitKey(0x41a0c8e8,0xf0e37acf,0xd8bcabe2,0x9bed015a);
+    md5.InitKey(0, 0x7894abde,0x9cb4e90a,0x0bc8f0ea,0x03a9e01a);
+    md5.InitKey(1, 0x3c4a4c93,0x9cbf7ae3,0xa9bcd0ea,0x9a8c2aaa);
+    md5.InitKey(2, 0x3c9ae1f1,0x9fe02a1f,0x3fc9a497,0x93cad3ef);
+    md5.InitKey(3, 0x41a0c8e8,0xf0e37acf,0xd8bcabe2,0x9bed015a);
     break;
 
   case 1:
   default:
     // key 1
-    md5[0].InitKey(0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476);
-    md5[1].InitKey(0x48327203, 0x3948ebea, 0x9a9b9c9e, 0xb3bed89a);
-    md5[2].InitKey(0x67452301, 0xefcdab89,  0x98badcfe, 0x10325476);
-    md5[3].InitKey( 0xc8e899e8, 0x9321c28a, 0x438eba12, 0x8cbe0aee);
+    md5.InitKey(0, 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476);
+    md5.InitKey(1, 0x48327203, 0x3948ebea, 0x9a9b9c9e, 0xb3bed89a);
+    md5.InitKey(2, 0x67452301, 0xefcdab89,  0x98badcfe, 0x10325476);
+    md5.InitKey(3,  0xc8e899e8, 0x9321c28a, 0x438eba12, 0x8cbe0aee);
     break;
   }
 }
@@ -38,7 +38,10 @@ public:
   };
 
 private:
-  MD5 md5[4];
+  /**
+   * The four MD5 contexts of the G record, computed in parallel.
+   */
+  MD5x4 md5;
 
   enum {
     BUFF_LEN = 255,
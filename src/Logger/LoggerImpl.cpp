@@ -33,6 +33,7 @@
 #include "Interface.hpp"
 #include "Util/CharUtil.hpp"
 #include "IGCFileCleanup.hpp"
+#include "IGC/IGCRecovery.hpp"
 
 #ifdef HAVE_POSIX
 #include <unistd.h>
@@ -223,7 +224,10 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
                         'X', logger_id, i);
 
     LocalPath(filename, _T("logs"), name);
-    if (!File::Exists(filename))
+
+    TCHAR partial_path[MAX_PATH];
+    if (!File::Exists(filename) &&
+        !File::Exists(IGCGetPartialPath(partial_path, filename)))
       break;  // file not exist, we'll use this name
   }
 
@@ -296,6 +300,27 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
   }
 }
 
+class PartialIGCFileVisitor : public File::Visitor {
+public:
+  virtual void Visit(const TCHAR *path, const TCHAR *filename) {
+    if (IGCRecoverFile(path))
+      LogStartUp(_T("Recovered partial IGC file: %s"), path);
+    else
+      LogStartUp(_T("Failed to recover partial IGC file: %s"), path);
+  }
+};
+
+void
+LoggerImpl::RecoverPartialFiles()
+{
+  TCHAR path[MAX_PATH];
+  LocalPath(path, _T("logs"));
+
+  PartialIGCFileVisitor visitor;
+  Directory::VisitSpecificFiles(path, _T("*.igc") IGC_PARTIAL_SUFFIX,
+                                visitor);
+}
+
 void
 LoggerImpl::ClearBuffer()
 {
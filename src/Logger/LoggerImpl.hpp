@@ -130,6 +130,13 @@ public:
   void LoggerNote(const TCHAR *text);
   void ClearBuffer();
 
+  /**
+   * Recover the IGC files which were left behind when XCSoar crashed
+   * while the logger was running.  Call this before the logger is
+   * started.
+   */
+  static void RecoverPartialFiles();
+
 private:
   /**
    * @param logger_id the ID of the logger, consisting of exactly 3
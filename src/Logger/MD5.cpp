@@ -26,7 +26,9 @@
 #include "Compiler.h"
 
 #include <algorithm>
+#include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 static gcc_constexpr_data uint32_t k[64] = {
   // k[i] := floor(abs(sin(i)) * (2 pow 32))
@@ -143,6 +145,37 @@ MD5::IsValidIGCChar(char c)
          c != 0x7E;
 }
 
+/**
+ * A bitmap of all characters accepted by MD5::IsValidIGCChar(), used
+ * by MD5::FilterIGCChars().
+ */
+static gcc_constexpr_data uint32_t valid_igc_chars[256 / 32] = {
+  0x00000000,
+  /* 0x20..0x3f without '!', '$', '*', ',' */
+  0xffffebed,
+  /* 0x40..0x5f without backslash, '^' */
+  0xafffffff,
+  /* 0x60..0x7f without '~', DEL */
+  0x3fffffff,
+  0, 0, 0, 0,
+};
+
+size_t
+MD5::FilterIGCChars(const char *src, size_t length, char *dest)
+{
+  char *const start = dest;
+
+  /* branch-free: always store the character, but advance only if it
+     is valid */
+  for (const char *end = src + length; src != end; ++src) {
+    const uint8_t ch = *src;
+    *dest = ch;
+    dest += (valid_igc_chars[ch >> 5] >> (ch & 0x1f)) & 1;
+  }
+
+  return dest - start;
+}
+
 void
 MD5::Append(uint8_t ch)
 {
@@ -157,6 +190,18 @@ MD5::Append(const void *data, size_t length)
 {
   const uint8_t *i = (const uint8_t *)data, *const end = i + length;
 
+  /* fill up the partial block */
+  while (i != end && message_length % ARRAY_SIZE(buff512bits) != 0)
+    Append(*i++);
+
+  /* whole blocks are copied in one go */
+  while (size_t(end - i) >= ARRAY_SIZE(buff512bits)) {
+    std::copy(i, i + ARRAY_SIZE(buff512bits), buff512bits);
+    Process512(buff512bits);
+    i += ARRAY_SIZE(buff512bits);
+    message_length += ARRAY_SIZE(buff512bits);
+  }
+
   while (i != end)
     Append(*i++);
 }
@@ -266,3 +311,208 @@ MD5::GetDigest(char *buffer)
   sprintf(buffer, "%08x%08x%08x%08x",
           ByteSwap32(h0), ByteSwap32(h1), ByteSwap32(h2), ByteSwap32(h3));
 }
+
+#if GCC_VERSION >= 40800
+
+/**
+ * The four lanes of MD5x4 as one SIMD vector; the compiler emits
+ * SSE2/NEON instructions where available, and falls back to scalar
+ * code elsewhere.
+ */
+typedef uint32_t MD5Lanes __attribute__((vector_size(16)));
+
+static inline MD5Lanes
+LoadLanes(const uint32_t *src)
+{
+  MD5Lanes v;
+  memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+static inline void
+StoreLanes(uint32_t *dest, MD5Lanes v)
+{
+  memcpy(dest, &v, sizeof(v));
+}
+
+static inline MD5Lanes
+leftrotate(MD5Lanes x, uint32_t c)
+{
+  return (x << c) | (x >> (32 - c));
+}
+
+#else
+
+/**
+ * Portable fallback for compilers without vector extensions.
+ */
+struct MD5Lanes {
+  uint32_t v[MD5x4::LANES];
+
+  MD5Lanes() = default;
+
+  MD5Lanes(uint32_t x) {
+    std::fill(v, v + MD5x4::LANES, x);
+  }
+
+#define MD5_LANES_OPERATOR(op) \
+  MD5Lanes operator op(const MD5Lanes &other) const { \
+    MD5Lanes result; \
+    for (unsigned i = 0; i < MD5x4::LANES; ++i) \
+      result.v[i] = v[i] op other.v[i]; \
+    return result; \
+  } \
+  MD5Lanes &operator op##=(const MD5Lanes &other) { \
+    return *this = *this op other; \
+  }
+
+  MD5_LANES_OPERATOR(+)
+  MD5_LANES_OPERATOR(&)
+  MD5_LANES_OPERATOR(|)
+  MD5_LANES_OPERATOR(^)
+
+#undef MD5_LANES_OPERATOR
+
+  MD5Lanes operator~() const {
+    MD5Lanes result;
+    for (unsigned i = 0; i < MD5x4::LANES; ++i)
+      result.v[i] = ~v[i];
+    return result;
+  }
+};
+
+static inline MD5Lanes
+LoadLanes(const uint32_t *src)
+{
+  MD5Lanes v;
+  std::copy(src, src + MD5x4::LANES, v.v);
+  return v;
+}
+
+static inline void
+StoreLanes(uint32_t *dest, MD5Lanes v)
+{
+  std::copy(v.v, v.v + MD5x4::LANES, dest);
+}
+
+static inline MD5Lanes
+leftrotate(MD5Lanes x, uint32_t c)
+{
+  for (unsigned i = 0; i < MD5x4::LANES; ++i)
+    x.v[i] = leftrotate(x.v[i], c);
+  return x;
+}
+
+#endif
+
+void
+MD5x4::InitKey(unsigned lane,
+               uint32_t h0in, uint32_t h1in, uint32_t h2in, uint32_t h3in)
+{
+  assert(lane < LANES);
+
+  h[0][lane] = h0in;
+  h[1][lane] = h1in;
+  h[2][lane] = h2in;
+  h[3][lane] = h3in;
+  message_length = 0;
+}
+
+void
+MD5x4::Append(const void *data, size_t length)
+{
+  const uint8_t *i = (const uint8_t *)data, *const end = i + length;
+
+  while (i != end) {
+    const unsigned position =
+      unsigned(message_length % ARRAY_SIZE(buff512bits));
+    const size_t n = std::min(size_t(end - i),
+                              ARRAY_SIZE(buff512bits) - position);
+
+    if (n == ARRAY_SIZE(buff512bits)) {
+      /* a whole block: no need to copy it to the buffer */
+      Process512(i);
+    } else {
+      std::copy(i, i + n, buff512bits + position);
+      if (position + n == ARRAY_SIZE(buff512bits))
+        Process512(buff512bits);
+    }
+
+    i += n;
+    message_length += n;
+  }
+}
+
+void
+MD5x4::Finalize()
+{
+  /* same padding as MD5::Finalize() */
+  const unsigned buffer_left_over = message_length % 64;
+
+  buff512bits[buffer_left_over] = 0x80;
+  std::fill(buff512bits + buffer_left_over + 1,
+            buff512bits + ARRAY_SIZE(buff512bits), 0);
+
+  if (buffer_left_over >= 64 - 8) {
+    /* no room for the length: pad another block */
+    Process512(buff512bits);
+    std::fill(buff512bits, buff512bits + ARRAY_SIZE(buff512bits), 0);
+  }
+
+  *(uint64_t *)(void *)(buff512bits + 56) = ToLE64(message_length * 8);
+
+  Process512(buff512bits);
+}
+
+void
+MD5x4::Process512(const uint8_t *s512in)
+{
+  /* the message words are the same for all lanes; memcpy() because
+     the input may be unaligned */
+  uint32_t w[16];
+  memcpy(w, s512in, sizeof(w));
+  for (unsigned j = 0; j < 16; j++)
+    w[j] = ToLE32(w[j]);
+
+  MD5Lanes a = LoadLanes(h[0]), b = LoadLanes(h[1]),
+    c = LoadLanes(h[2]), d = LoadLanes(h[3]);
+
+  for (unsigned i = 0; i < 64; i++) {
+    MD5Lanes f;
+    unsigned g;
+    if (i <= 15) {
+      f = (b & c) | ((~b) & d);
+      g = i;
+    } else if (i <= 31) {
+      f = (d & b) | ((~d) & c);
+      g = (5 * i + 1) % 16;
+    } else if (i <= 47) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) % 16;
+    } else {
+      f = c ^ (b | (~d));
+      g = (7 * i) % 16;
+    }
+
+    const MD5Lanes temp = d;
+    d = c;
+    c = b;
+    b += leftrotate(a + f + (k[i] + w[g]), r[i]);
+    a = temp;
+  }
+
+  StoreLanes(h[0], LoadLanes(h[0]) + a);
+  StoreLanes(h[1], LoadLanes(h[1]) + b);
+  StoreLanes(h[2], LoadLanes(h[2]) + c);
+  StoreLanes(h[3], LoadLanes(h[3]) + d);
+}
+
+void
+MD5x4::GetDigest(unsigned lane, char *buffer) const
+{
+  assert(lane < LANES);
+
+  sprintf(buffer, "%08x%08x%08x%08x",
+          ByteSwap32(h[0][lane]), ByteSwap32(h[1][lane]),
+          ByteSwap32(h[2][lane]), ByteSwap32(h[3][lane]));
+}
@@ -58,6 +58,51 @@ public:
   void Finalize();
   void GetDigest(char *buffer);
   static bool IsValidIGCChar(char c);
+
+  /**
+   * Copy all characters which are valid according to
+   * IsValidIGCChar() from the source to the destination buffer.  The
+   * destination must be large enough for #length characters.
+   *
+   * @return the number of characters written to #dest
+   */
+  static size_t FilterIGCChars(const char *src, size_t length, char *dest);
+};
+
+/**
+ * Four MD5 contexts with different keys which are fed with the same
+ * message.  This is what the G record needs; since the message (and
+ * thus the padding) is identical, all four are computed in one pass
+ * over the data, each 32 bit word of the state being a vector of four
+ * lanes.
+ */
+class MD5x4
+{
+public:
+  enum {
+    LANES = 4,
+  };
+
+private:
+  uint8_t buff512bits[64];
+
+  /**
+   * The hash state: h[word][lane].
+   */
+  uint32_t h[4][LANES];
+
+  uint64_t message_length;
+
+  void Process512(const uint8_t *in);
+
+public:
+  void InitKey(unsigned lane,
+               uint32_t h0in, uint32_t h1in, uint32_t h2in, uint32_t h3in);
+
+  void Append(const void *data, size_t length);
+
+  void Finalize();
+  void GetDigest(unsigned lane, char *buffer) const;
 };
 
 #endif
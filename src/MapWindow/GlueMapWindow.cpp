@@ -82,9 +82,7 @@ GlueMapWindow::ExchangeBlackboard()
 {
   /* copy device_blackboard to MapWindow */
 
-  device_blackboard->mutex.Lock();
-  ReadBlackboard(device_blackboard->Basic(), device_blackboard->Calculated());
-  device_blackboard->mutex.Unlock();
+  MapWindowBlackboard::ReadBlackboard(*device_blackboard);
 
 #ifndef ENABLE_OPENGL
   next_mutex.Lock();
@@ -27,14 +27,11 @@ Copyright_License {
 #include "Screen/Canvas.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Renderer/AirspaceRendererSettings.hpp"
-#include "MapCanvas.hpp"
-#include "Navigation/SearchPointVector.hpp"
 
 MapDrawHelper::MapDrawHelper(Canvas &_canvas, Canvas &_buffer, Canvas &_stencil,
                              const WindowProjection &_proj,
                              const AirspaceRendererSettings &_settings)
-  :clip(_proj.GetScreenBounds().Scale(fixed(1.1))),
-   canvas(_canvas),
+  :canvas(_canvas),
    buffer(_buffer),
    stencil(_stencil),
    proj(_proj),
@@ -45,8 +42,7 @@ MapDrawHelper::MapDrawHelper(Canvas &_canvas, Canvas &_buffer, Canvas &_stencil,
 }
 
 MapDrawHelper::MapDrawHelper(const MapDrawHelper &other)
-  :clip(other.clip),
-   canvas(other.canvas),
+  :canvas(other.canvas),
    buffer(other.buffer),
    stencil(other.stencil),
    proj(other.proj),
@@ -56,35 +52,12 @@ MapDrawHelper::MapDrawHelper(const MapDrawHelper &other)
 {
 }
 
-void 
-MapDrawHelper::DrawSearchPointVector(const SearchPointVector &points)
+void
+MapDrawHelper::DrawPolygon(const RasterPoint *points, unsigned num_points)
 {
-  size_t size = points.size();
-  if (size < 3)
-    return;
-
-  /* copy all SearchPointVector elements to geo_points */
-  geo_points.GrowDiscard(size * 3);
-  for (unsigned i = 0; i < size; ++i)
-    geo_points[i] = points[i].get_location();
-
-  /* clip them */
-  size = clip.ClipPolygon(geo_points.begin(), geo_points.begin(), size);
-  if (size < 3)
-    /* it's completely outside the screen */
-    return;
-
-  /* draw it all */
-  RasterPoint screen[size];
-  for (unsigned i = 0; i < size; ++i)
-    screen[i] = proj.GeoToScreen(geo_points[i]);
-
-  if (!MapCanvas::IsVisible(canvas, screen, size))
-    return;
-
-  buffer.DrawPolygon(&screen[0], size);
+  buffer.DrawPolygon(points, num_points);
   if (use_stencil)
-    stencil.DrawPolygon(&screen[0], size);
+    stencil.DrawPolygon(points, num_points);
 }
 
 void 
@@ -27,27 +27,17 @@ Copyright_License {
 #ifndef ENABLE_OPENGL
 
 #include "Screen/Point.hpp"
-#include "Geo/GeoClip.hpp"
-#include "Util/AllocatedArray.hpp"
 
 class Canvas;
 class Projection;
 class WindowProjection;
 struct AirspaceRendererSettings;
-class SearchPointVector;
 
 /**
  * Utility class to draw multilayer items on a canvas with stencil masking
  */
 class MapDrawHelper
 {
-  const GeoClip clip;
-
-  /**
-   * A variable-length buffer for clipped GeoPoints.
-   */
-  AllocatedArray<GeoPoint> geo_points;
-
 public:
   Canvas &canvas;
   Canvas &buffer;
@@ -68,7 +58,11 @@ public:
   MapDrawHelper(const MapDrawHelper &other);
 
 protected:
-  void DrawSearchPointVector(const SearchPointVector &points);
+  /**
+   * Draw a polygon which has already been clipped and projected to
+   * screen coordinates.
+   */
+  void DrawPolygon(const RasterPoint *points, unsigned num_points);
 
   void DrawCircle(const RasterPoint &center, unsigned radius);
 
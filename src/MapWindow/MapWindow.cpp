@@ -31,6 +31,7 @@ Copyright_License {
 #include "Computer/GlideComputer.hpp"
 #include "Units/Units.hpp"
 #include "Operation/Operation.hpp"
+#include "Profiler.hpp"
 
 #include <tchar.h>
 
@@ -52,6 +53,7 @@ MapWindow::MapWindow(const MapLook &_look,
    trail_renderer(look.trail),
    task(NULL), route_planner(NULL), glide_computer(NULL),
    marks(NULL),
+   traffic_store(NULL),
    compass_visible(true)
 #ifndef ENABLE_OPENGL
    , ui_generation(1), buffer_generation(0),
@@ -122,10 +124,11 @@ MapWindow::ReadBlackboard(const MoreData &nmea_info,
 unsigned
 MapWindow::UpdateTopography(unsigned max_update)
 {
-  if (topography != NULL && GetMapSettings().topography_enabled)
-    return topography->ScanVisibility(visible_projection, max_update);
-  else
+  if (topography == NULL || !GetMapSettings().topography_enabled)
     return 0;
+
+  ScopeProfile profile(Profiler::TOPOGRAPHY_UPDATE);
+  return topography->ScanVisibility(visible_projection, max_update);
 }
 
 bool
@@ -140,6 +143,8 @@ MapWindow::UpdateTerrain()
       terrain_center.Distance(location) < fixed(1000))
     return false;
 
+  ScopeProfile profile(Profiler::TERRAIN_UPDATE);
+
   // always service terrain even if it's not used by the map,
   // because it's used by other calculations
   RasterTerrain::ExclusiveLease lease(*terrain);
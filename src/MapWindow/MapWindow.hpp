@@ -46,6 +46,7 @@ class TopographyRenderer;
 class RasterTerrain;
 class RasterWeather;
 class ProtectedMarkers;
+class ProtectedTrafficStore;
 class Waypoints;
 struct Waypoint;
 class Airspaces;
@@ -136,6 +137,8 @@ protected:
 
   ProtectedMarkers *marks;
 
+  const ProtectedTrafficStore *traffic_store;
+
   bool compass_visible;
 
 #ifndef ENABLE_OPENGL
@@ -207,6 +210,10 @@ public:
     marks = _marks;
   }
 
+  void SetTrafficStore(const ProtectedTrafficStore *_traffic_store) {
+    traffic_store = _traffic_store;
+  }
+
   void ReadBlackboard(const MoreData &nmea_info,
                       const DerivedInfo &derived_info);
 
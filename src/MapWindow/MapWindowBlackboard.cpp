@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "MapWindowBlackboard.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
 
 void
 MapWindowBlackboard::ReadComputerSettings(const ComputerSettings
@@ -45,3 +46,9 @@ MapWindowBlackboard::ReadBlackboard(const MoreData &nmea_info,
   calculated_info = derived_info;
 }
 
+void
+MapWindowBlackboard::ReadBlackboard(const DeviceBlackboard &device_blackboard)
+{
+  device_blackboard.ReadBasic(gps_info);
+  device_blackboard.ReadCalculated(calculated_info);
+}
@@ -28,6 +28,8 @@ Copyright_License {
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
 #include "Blackboard/MapSettingsBlackboard.hpp"
 
+class DeviceBlackboard;
+
 /**
  * Blackboard used by map window: provides read-only access to local
  * copies of data required by map window
@@ -41,6 +43,12 @@ class MapWindowBlackboard:
 protected:
   void ReadBlackboard(const MoreData &nmea_info,
                       const DerivedInfo &derived_info);
+
+  /**
+   * Copy the data published by the DeviceBlackboard.  The
+   * DeviceBlackboard does not need to be locked.
+   */
+  void ReadBlackboard(const DeviceBlackboard &device_blackboard);
   void ReadComputerSettings(const ComputerSettings &settings);
   void ReadMapSettings(const MapSettings &settings);
 };
@@ -64,6 +64,12 @@ MapWaypointLabelListCompare(const void *elem1, const void *elem2)
   if (!e1.isWatchedWaypoint && e2.isWatchedWaypoint)
     return 1;
 
+  if (e1.wasVisible && !e2.wasVisible)
+    return -1;
+
+  if (!e1.wasVisible && e2.wasVisible)
+    return 1;
+
   if (e1.AltArivalAGL > e2.AltArivalAGL)
     return -1;
 
@@ -77,7 +83,8 @@ void
 WaypointLabelList::Add(const TCHAR *Name, PixelScalar X, PixelScalar Y,
                        TextInBoxMode Mode,
                        RoughAltitude AltArivalAGL, bool inTask,
-                       bool isLandable, bool isAirport, bool isWatchedWaypoint)
+                       bool isLandable, bool isAirport, bool isWatchedWaypoint,
+                       unsigned id, bool wasVisible)
 {
   if ((X < - WPCIRCLESIZE)
       || X > PixelScalar(width + (WPCIRCLESIZE * 3))
@@ -99,6 +106,8 @@ WaypointLabelList::Add(const TCHAR *Name, PixelScalar X, PixelScalar Y,
   E->isLandable = isLandable;
   E->isAirport  = isAirport;
   E->isWatchedWaypoint = isWatchedWaypoint;
+  E->id = id;
+  E->wasVisible = wasVisible;
 }
 
 void
@@ -43,6 +43,15 @@ public:
     bool isLandable;
     bool isAirport;
     bool isWatchedWaypoint;
+
+    /** the id of the waypoint this label belongs to */
+    unsigned id;
+
+    /**
+     * Was the label of this waypoint drawn in the previous frame?
+     * Such a label is preferred over others of the same class.
+     */
+    bool wasVisible;
   };
 
 protected:
@@ -58,7 +67,8 @@ public:
   void Add(const TCHAR *Name, PixelScalar X, PixelScalar Y, TextInBoxMode Mode,
            RoughAltitude AltArivalAGL,
            bool inTask, bool isLandable, bool isAirport,
-           bool isWatchedWaypoint);
+           bool isWatchedWaypoint,
+           unsigned id, bool wasVisible);
   void Sort();
 
   unsigned size() const {
@@ -28,10 +28,13 @@ Copyright_License {
 #include "Task/ProtectedTaskManager.hpp"
 #include "Units/Units.hpp"
 #include "Renderer/AircraftRenderer.hpp"
+#include "Profiler.hpp"
 
 void
 MapWindow::RenderTerrain(Canvas &canvas)
 {
+  ScopeProfile profile(Profiler::RENDER_TERRAIN);
+
   background.SetShadingAngle(render_projection, GetMapSettings().terrain,
                              Calculated());
   background.Draw(canvas, render_projection, GetMapSettings().terrain);
@@ -40,6 +43,8 @@ MapWindow::RenderTerrain(Canvas &canvas)
 void
 MapWindow::RenderTopography(Canvas &canvas)
 {
+  ScopeProfile profile(Profiler::RENDER_TOPOGRAPHY);
+
   if (topography_renderer != NULL && GetMapSettings().topography_enabled)
     topography_renderer->Draw(canvas, render_projection);
 }
@@ -62,6 +67,8 @@ MapWindow::RenderFinalGlideShading(Canvas &canvas)
 void
 MapWindow::RenderAirspace(Canvas &canvas)
 {
+  ScopeProfile profile(Profiler::RENDER_AIRSPACE);
+
   if (GetMapSettings().airspace.enable)
     airspace_renderer.Draw(canvas,
 #ifndef ENABLE_OPENGL
@@ -92,6 +99,8 @@ MapWindow::RenderGlide(Canvas &canvas)
 void
 MapWindow::Render(Canvas &canvas, const PixelRect &rc)
 { 
+  ScopeProfile profile(Profiler::MAP_RENDER);
+
   const NMEAInfo &basic = Basic();
 
   render_projection = visible_projection;
@@ -102,7 +111,8 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
       aircraft_pos = render_projection.GeoToScreen(basic.location);
 
   // reset label over-write preventer
-  label_block.reset();
+  label_block.reset(render_projection.GetScreenWidth(),
+                    render_projection.GetScreenHeight());
 
   // Render terrain, groundline and topography
   draw_sw.Mark(_T("RenderTerrain"));
@@ -32,6 +32,7 @@ Copyright_License {
 #include "Screen/Layout.hpp"
 #include "Math/Screen.hpp"
 #include "Look/MapLook.hpp"
+#include "Profiler.hpp"
 
 #include <stdio.h>
 #include <math.h>
@@ -39,6 +40,8 @@ Copyright_License {
 void
 MapWindow::DrawTask(Canvas &canvas)
 {
+  ScopeProfile profile(Profiler::RENDER_TASK);
+
   if (task == NULL)
     return;
 
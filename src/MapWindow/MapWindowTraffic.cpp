@@ -29,14 +29,33 @@ Copyright_License {
 #include "Screen/Layout.hpp"
 #include "Screen/TextInBox.hpp"
 #include "Util/StringUtil.hpp"
+#include "Util/TrivialArray.hpp"
+#include "Engine/Navigation/Geometry/GeoVector.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Formatter/UserUnits.hpp"
 #include "Look/TrafficLook.hpp"
 #include "Renderer/TrafficRenderer.hpp"
 #include "FLARM/FriendsGlue.hpp"
+#include "FLARM/ProtectedTrafficStore.hpp"
+#include "Profiler.hpp"
 
 #include <stdio.h>
 
+/**
+ * Collects the targets passed by TrafficStore::VisitWithinRange().
+ */
+struct TrafficCollector {
+  TrivialArray<const FlarmTraffic *, TrafficStore::MAX_COUNT> list;
+
+  TrafficCollector() {
+    list.clear();
+  }
+
+  void operator()(const FlarmTraffic &traffic) {
+    list.append(&traffic);
+  }
+};
+
 /**
  * Draws the FLARM traffic icons onto the given canvas
  * @param canvas Canvas for drawing
@@ -45,13 +64,14 @@ void
 MapWindow::DrawFLARMTraffic(Canvas &canvas,
                             const RasterPoint aircraft_pos) const
 {
+  ScopeProfile profile(Profiler::RENDER_TRAFFIC);
+
   // Return if FLARM icons on moving map are disabled
   if (!GetMapSettings().show_flarm_on_map)
     return;
 
   // Return if FLARM data is not available
-  const TrafficList &flarm = Basic().flarm.traffic;
-  if (flarm.IsEmpty())
+  if (traffic_store == NULL || !Basic().location_available)
     return;
 
   const WindowProjection &projection = render_projection;
@@ -62,10 +82,25 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
   if (projection.GetMapScale() > fixed_int_constant(7300))
     return;
 
+  /* look up the targets around the screen center; the grid works
+     with positions relative to our own aircraft */
+  const GeoVector center_vector =
+    Basic().location.DistanceBearing(projection.GetGeoScreenCenter());
+  const auto sc_center = center_vector.bearing.SinCos();
+
+  ProtectedTrafficStore::Lease store(*traffic_store);
+  if (store->IsEmpty())
+    return;
+
+  TrafficCollector collector;
+  store->VisitWithinRange(center_vector.distance * sc_center.second,
+                          center_vector.distance * sc_center.first,
+                          projection.GetScreenDistanceMeters(), collector);
+
   // Circle through the FLARM targets
-  for (auto it = flarm.list.begin(), end = flarm.list.end();
+  for (auto it = collector.list.begin(), end = collector.list.end();
       it != end; ++it) {
-    const FlarmTraffic &traffic = *it;
+    const FlarmTraffic &traffic = **it;
 
     if (!traffic.location_available)
       continue;
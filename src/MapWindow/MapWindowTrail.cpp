@@ -24,10 +24,13 @@ Copyright_License {
 #include "MapWindow.hpp"
 #include "Renderer/TrailRenderer.hpp"
 #include "Computer/GlideComputer.hpp"
+#include "Profiler.hpp"
 
 void
 MapWindow::RenderTrail(Canvas &canvas, const RasterPoint aircraft_pos)
 {
+  ScopeProfile profile(Profiler::RENDER_TRAIL);
+
   unsigned min_time = max(0, (int)Basic().time - 600);
   DrawTrail(canvas, aircraft_pos, min_time);
 }
@@ -23,10 +23,13 @@ Copyright_License {
 
 #include "MapWindow.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "Profiler.hpp"
 
 void
 MapWindow::DrawWaypoints(Canvas &canvas)
 {
+  ScopeProfile profile(Profiler::RENDER_WAYPOINTS);
+
   waypoint_renderer.render(canvas, label_block,
                             render_projection, GetMapSettings().waypoint,
                            GetComputerSettings().polar,
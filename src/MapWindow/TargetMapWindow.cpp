@@ -206,7 +206,8 @@ TargetMapWindow::OnPaintBuffer(Canvas &canvas)
   const RasterPoint aircraft_pos = projection.GeoToScreen(Basic().location);
 
   // reset label over-write preventer
-  label_block.reset();
+  label_block.reset(projection.GetScreenWidth(),
+                    projection.GetScreenHeight());
 
   // Render terrain, groundline and topography
   RenderTerrain(canvas);
@@ -110,7 +110,10 @@ public:
    * @return the rotated coordinates
    */
   gcc_pure
-  Pair Rotate(int x, int y) const;
+  Pair Rotate(int x, int y) const {
+    return Pair((x * cost - y * sint + 512) >> 10,
+                (y * cost + x * sint + 512) >> 10);
+  }
 
   gcc_pure
   Pair Rotate(const Pair p) const {
@@ -39,6 +39,7 @@ MergeThread::Process()
 {
   assert(!IsDefined() || IsInside());
 
+  device_blackboard.FetchCalculated();
   device_blackboard.Merge();
 
   const MoreData &basic = device_blackboard.Basic();
@@ -51,6 +52,13 @@ MergeThread::Process()
 
   flarm_computer.Process(device_blackboard.SetBasic().flarm,
                          last_fix.flarm, basic);
+
+  {
+    ProtectedTrafficStore::ExclusiveLease store(device_blackboard.GetTrafficStore());
+    flarm_computer.Process(store, basic);
+  }
+
+  device_blackboard.PublishBasic();
 }
 
 void
@@ -34,9 +34,12 @@ VerifyNMEAChecksum(const char *p)
 {
   assert(p != NULL);
 
-  const char *asterisk = strrchr(p, '*');
-  if (asterisk == NULL)
-    return false;
+  /* the checksum is at the end; search the asterisk backwards */
+  const char *asterisk = p + strlen(p);
+  do {
+    if (asterisk == p)
+      return false;
+  } while (*--asterisk != '*');
 
   const char *checksum_string = asterisk + 1;
   char *endptr;
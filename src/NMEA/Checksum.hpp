@@ -26,6 +26,9 @@ Copyright_License {
 
 #include "Compiler.h"
 
+#include <stddef.h>
+#include <string.h>
+
 /**
  * Calculates the checksum for the specified line (without the
  * asterisk and the newline character).
@@ -69,6 +72,19 @@ NMEAChecksum(const char *p, unsigned length)
     ++p;
   }
 
+  /* combine one machine word at a time; the xor of all bytes equals
+     the xor of the bytes of the combined word */
+  size_t words = 0;
+  for (; i + sizeof(words) <= length; i += sizeof(words)) {
+    size_t word;
+    memcpy(&word, p, sizeof(word));
+    words ^= word;
+    p += sizeof(word);
+  }
+
+  for (unsigned j = 0; j < sizeof(words); ++j)
+    checksum ^= (unsigned char)(words >> (j * 8));
+
   for (; i < length; ++i)
     checksum ^= *p++;
 
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_NMEA_SENTENCE_TABLE_HPP
+#define XCSOAR_NMEA_SENTENCE_TABLE_HPP
+
+#include "Util/NonCopyable.hpp"
+#include "Compiler.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Packs a NMEA sentence address of up to 8 characters into an
+ * integer, which can be compared at once.
+ *
+ * @return the packed address, or 0 if it is empty or too long
+ */
+gcc_pure
+static inline uint64_t
+NMEASentenceID(const char *p, size_t length)
+{
+  if (length == 0 || length > 8)
+    return 0;
+
+  uint64_t id = 0;
+  for (size_t i = 0; i < length; ++i)
+    id = (id << 8) | (uint8_t)p[i];
+
+  return id;
+}
+
+/**
+ * A table which maps NMEA sentence addresses (e.g. "$PFLAU") to
+ * codes, for use in a switch statement.  This replaces chains of
+ * string comparisons: a lookup packs the address with
+ * NMEASentenceID(), and then probes a small hash table.
+ *
+ * The table is built once (usually as a static object), from a
+ * constant list of entries.
+ */
+class NMEASentenceTable : private NonCopyable {
+public:
+  struct Entry {
+    /**
+     * The sentence address; it must not be longer than 8 characters.
+     */
+    const char *address;
+
+    /**
+     * The code returned by Find(); must not be 0.
+     */
+    unsigned code;
+  };
+
+private:
+  /** the number of hash slots; must be a power of two */
+  static const unsigned SLOTS = 64;
+
+  struct Slot {
+    uint64_t id;
+    unsigned code;
+  };
+
+  Slot slots[SLOTS];
+
+  gcc_const
+  static unsigned Hash(uint64_t id) {
+    return (unsigned)((id * 0x9e3779b97f4a7c15ull) >> 58) & (SLOTS - 1);
+  }
+
+public:
+  /**
+   * @param entries a list of entries, terminated by one with a NULL
+   * address; at most SLOTS/2 entries are allowed
+   */
+  explicit NMEASentenceTable(const Entry *entries) {
+    for (unsigned i = 0; i < SLOTS; ++i)
+      slots[i].id = 0;
+
+    unsigned n = 0;
+    for (const Entry *e = entries; e->address != NULL; ++e, ++n) {
+      assert(n < SLOTS / 2);
+      assert(e->code != 0);
+
+      size_t length = 0;
+      while (e->address[length] != 0)
+        ++length;
+
+      const uint64_t id = NMEASentenceID(e->address, length);
+      assert(id != 0);
+
+      unsigned i = Hash(id);
+      while (slots[i].id != 0) {
+        assert(slots[i].id != id);
+        i = (i + 1) & (SLOTS - 1);
+      }
+
+      slots[i].id = id;
+      slots[i].code = e->code;
+    }
+  }
+
+  /**
+   * Look up an address.
+   *
+   * @param address the address; does not need to be null-terminated
+   * @param length the length of the address
+   * @return the code of the matching entry, or 0 if there is none
+   */
+  gcc_pure
+  unsigned Find(const char *address, size_t length) const {
+    const uint64_t id = NMEASentenceID(address, length);
+    if (id == 0)
+      return 0;
+
+    for (unsigned i = Hash(id); slots[i].id != 0;
+         i = (i + 1) & (SLOTS - 1))
+      if (slots[i].id == id)
+        return slots[i].code;
+
+    return 0;
+  }
+};
+
+#endif
@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #ifndef XCSOAR_OS_SLEEP_H
+#define XCSOAR_OS_SLEEP_H
 
 #ifdef WIN32
 
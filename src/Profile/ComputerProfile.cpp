@@ -37,6 +37,7 @@ namespace Profile {
   static void Load(VoiceSettings &settings);
   static void Load(PlacesOfInterestSettings &settings);
   static void Load(FeaturesSettings &settings);
+  static void Load(ComputationRateSettings &settings);
 };
 
 void
@@ -128,6 +129,15 @@ Profile::Load(FeaturesSettings &settings)
   Get(szProfileEnableNavBaroAltitude, settings.nav_baro_altitude_enabled);
 }
 
+void
+Profile::Load(ComputationRateSettings &settings)
+{
+  Get(szProfileHighRateMode, settings.high_rate_enabled);
+  Get(szProfileCalculationPeriod, settings.calculation_period);
+  Get(szProfileTaskCalculationPeriod, settings.task_period);
+  Get(szProfileIdleCalculationPeriod, settings.idle_period);
+}
+
 void
 Profile::Load(ComputerSettings &settings)
 {
@@ -138,6 +148,7 @@ Profile::Load(ComputerSettings &settings)
   Load(settings.voice);
   Load(settings.poi);
   Load(settings.features);
+  Load(settings.rate);
   Load(settings.airspace);
 
   Get(szProfileEnableExternalTriggerCruise,
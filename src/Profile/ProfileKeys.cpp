@@ -171,6 +171,11 @@ const TCHAR szProfileAATMinTime[] = _T("AATMinTime");
 const TCHAR szProfileAATTimeMargin[] = _T("AATTimeMargin");
 
 const TCHAR szProfileEnableNavBaroAltitude[] = _T("EnableNavBaroAltitude");
+const TCHAR szProfileHighRateMode[] = _T("HighRateMode");
+const TCHAR szProfileCalculationPeriod[] = _T("CalculationPeriod");
+const TCHAR szProfileTaskCalculationPeriod[] = _T("TaskCalculationPeriod");
+const TCHAR szProfileIdleCalculationPeriod[] = _T("IdleCalculationPeriod");
+const TCHAR szProfileEnableProfiler[] = _T("EnableProfiler");
 
 const TCHAR szProfileLoggerTimeStepCruise[] = _T("LoggerTimeStepCruise");
 const TCHAR szProfileLoggerTimeStepCircling[] = _T("LoggerTimeStepCircling");
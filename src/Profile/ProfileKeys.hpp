@@ -166,6 +166,11 @@ extern const TCHAR szProfileAATMinTime[];
 extern const TCHAR szProfileAATTimeMargin[];
 
 extern const TCHAR szProfileEnableNavBaroAltitude[];
+extern const TCHAR szProfileHighRateMode[];
+extern const TCHAR szProfileCalculationPeriod[];
+extern const TCHAR szProfileTaskCalculationPeriod[];
+extern const TCHAR szProfileIdleCalculationPeriod[];
+extern const TCHAR szProfileEnableProfiler[];
 
 extern const TCHAR szProfileLoggerTimeStepCruise[];
 extern const TCHAR szProfileLoggerTimeStepCircling[];
@@ -0,0 +1,265 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Profiler.hpp"
+#include "Thread/Local.hpp"
+#include "IO/TextWriter.hpp"
+#include "Util/Macros.hpp"
+
+#include <string.h>
+
+namespace Profiler {
+  /**
+   * The maximum number of threads with their own counters.  Further
+   * threads get no slot; their updates are only counted in
+   * #dropped.
+   */
+  static const unsigned MAX_THREADS = 8;
+
+  struct Counter {
+    unsigned count;
+    uint64_t total_us;
+    unsigned max_us;
+    unsigned histogram[N_BUCKETS];
+  };
+
+  struct History {
+    unsigned values[HISTORY_SIZE];
+
+    /** the total number of values written so far */
+    unsigned n;
+  };
+
+  bool enabled;
+
+  static Counter counters[MAX_THREADS][N_POINTS];
+  static History histories[N_POINTS];
+
+  /** the slot number of the current thread plus one; 0 if unset */
+  static ThreadLocalInteger thread_slot;
+  static unsigned n_threads;
+
+  /** the number of updates from threads without a slot */
+  static unsigned dropped;
+
+  static const TCHAR *const names[N_POINTS] = {
+    _T("Calculation"),
+    _T("Warnings"),
+    _T("Fast"),
+    _T("Task"),
+    _T("Statistics"),
+    _T("Task idle"),
+    _T("Contest"),
+    _T("Map"),
+    _T("Terrain"),
+    _T("Topography"),
+    _T("Airspace"),
+    _T("Task drawing"),
+    _T("Waypoints"),
+    _T("Trail"),
+    _T("Traffic"),
+    _T("Terrain update"),
+    _T("Topography update"),
+    _T("Device parser"),
+  };
+
+  /**
+   * @return the counter slot of the current thread, or MAX_THREADS
+   * if all slots are taken
+   */
+  static unsigned
+  GetThreadSlot()
+  {
+    unsigned slot = thread_slot.Get();
+    if (slot == 0) {
+      slot = __sync_add_and_fetch(&n_threads, 1);
+      if (slot > MAX_THREADS)
+        slot = MAX_THREADS + 1;
+      thread_slot.Set((int)slot);
+    }
+
+    return slot - 1;
+  }
+
+  gcc_const
+  static unsigned
+  GetBucket(unsigned duration_us)
+  {
+    unsigned bucket = 0;
+    while (duration_us > 0 && bucket < N_BUCKETS - 1) {
+      duration_us >>= 1;
+      ++bucket;
+    }
+
+    return bucket;
+  }
+}
+
+unsigned
+Profiler::Result::GetPercentileUS(unsigned percent) const
+{
+  const unsigned threshold = (count * percent + 99) / 100;
+  unsigned sum = 0;
+
+  for (unsigned i = 0; i < N_BUCKETS - 1; ++i) {
+    sum += histogram[i];
+    if (sum >= threshold)
+      return i == 0 ? 0 : 1u << i;
+  }
+
+  return max_us;
+}
+
+void
+Profiler::SetEnabled(bool _enabled)
+{
+  enabled = _enabled;
+}
+
+const TCHAR *
+Profiler::GetName(Point point)
+{
+  static_assert(ARRAY_SIZE(names) == N_POINTS, "Wrong number of names");
+  return names[point];
+}
+
+void
+Profiler::Add(Point point, unsigned duration_us)
+{
+  const unsigned slot = GetThreadSlot();
+  if (slot >= MAX_THREADS) {
+    __sync_fetch_and_add(&dropped, 1);
+    return;
+  }
+
+  Counter &counter = counters[slot][point];
+  ++counter.count;
+  counter.total_us += duration_us;
+  if (duration_us > counter.max_us)
+    counter.max_us = duration_us;
+  ++counter.histogram[GetBucket(duration_us)];
+
+  History &history = histories[point];
+  const unsigned n = __sync_fetch_and_add(&history.n, 1);
+  history.values[n % HISTORY_SIZE] = duration_us;
+}
+
+Profiler::Result
+Profiler::Get(Point point)
+{
+  Result result;
+  memset(&result, 0, sizeof(result));
+
+  for (unsigned t = 0; t < MAX_THREADS; ++t) {
+    const Counter &counter = counters[t][point];
+    result.count += counter.count;
+    result.total_us += counter.total_us;
+    if (counter.max_us > result.max_us)
+      result.max_us = counter.max_us;
+    for (unsigned i = 0; i < N_BUCKETS; ++i)
+      result.histogram[i] += counter.histogram[i];
+  }
+
+  return result;
+}
+
+unsigned
+Profiler::GetDropped()
+{
+  return dropped;
+}
+
+unsigned
+Profiler::GetHistory(Point point, unsigned *dest, unsigned max)
+{
+  const History &history = histories[point];
+  const unsigned n = history.n;
+
+  unsigned size = n < HISTORY_SIZE ? n : HISTORY_SIZE;
+  if (size > max)
+    size = max;
+
+  for (unsigned i = 0; i < size; ++i)
+    dest[i] = history.values[(n - size + i) % HISTORY_SIZE];
+
+  return size;
+}
+
+void
+Profiler::Reset()
+{
+  memset(counters, 0, sizeof(counters));
+  memset(histories, 0, sizeof(histories));
+  dropped = 0;
+}
+
+void
+Profiler::Dump(TextWriter &writer)
+{
+  writer.printfln(_T("%-18s %8s %10s %8s %8s %8s"),
+                  _T("point"), _T("count"), _T("total_ms"),
+                  _T("avg_us"), _T("p95_us"), _T("max_us"));
+
+  for (unsigned i = 0; i < N_POINTS; ++i) {
+    const Point point = (Point)i;
+    const Result result = Get(point);
+    if (result.count == 0)
+      continue;
+
+    writer.printfln(_T("%-18s %8u %10u %8u %8u %8u"),
+                    GetName(point), result.count,
+                    unsigned(result.total_us / 1000),
+                    result.GetAverageUS(), result.GetPercentileUS(95),
+                    result.max_us);
+  }
+
+  if (dropped > 0)
+    writer.printfln(_T("%u updates from threads without counters dropped"),
+                    dropped);
+
+  writer.newline();
+  writer.writeln("histogram (bucket i: duration below 2^i us)");
+
+  for (unsigned i = 0; i < N_POINTS; ++i) {
+    const Point point = (Point)i;
+    const Result result = Get(point);
+    if (result.count == 0)
+      continue;
+
+    writer.printf(_T("%-18s"), GetName(point));
+    for (unsigned j = 0; j < N_BUCKETS; ++j)
+      writer.printf(" %u", result.histogram[j]);
+    writer.newline();
+  }
+}
+
+bool
+Profiler::Dump(const TCHAR *path)
+{
+  TextWriter writer(path);
+  if (writer.error())
+    return false;
+
+  Dump(writer);
+  return true;
+}
@@ -0,0 +1,185 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PROFILER_HPP
+#define XCSOAR_PROFILER_HPP
+
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <stdint.h>
+#include <tchar.h>
+
+class TextWriter;
+
+/**
+ * A lightweight profiler for the hot paths of the calculation and
+ * draw threads.  Each instrumented code section (a #Point) gets a
+ * call counter, the accumulated and maximum duration, a logarithmic
+ * histogram, and a ring buffer of the most recent durations.
+ *
+ * Counters are kept per thread, so updating them needs neither locks
+ * nor atomic operations.  There is a small fixed number of thread
+ * slots; updates from threads beyond that are dropped and only
+ * counted (see GetDropped()).  Readers sum up all threads; they may see a
+ * slightly inconsistent snapshot, which is good enough for a
+ * diagnostic tool.
+ *
+ * The profiler is disabled by default; then #ScopeProfile only
+ * checks a flag, and does not even read the clock.
+ */
+namespace Profiler {
+  enum Point {
+    CALCULATION_TICK,
+
+    /* the GlideComputer::Stage values, in the same order (checked by
+       a static_assert in GlideComputer.cpp) */
+    STAGE_WARNINGS,
+    STAGE_FAST,
+    STAGE_TASK,
+    STAGE_STATS,
+    STAGE_TASK_IDLE,
+    STAGE_CONTEST,
+
+    MAP_RENDER,
+    RENDER_TERRAIN,
+    RENDER_TOPOGRAPHY,
+    RENDER_AIRSPACE,
+    RENDER_TASK,
+    RENDER_WAYPOINTS,
+    RENDER_TRAIL,
+    RENDER_TRAFFIC,
+
+    TERRAIN_UPDATE,
+    TOPOGRAPHY_UPDATE,
+
+    DEVICE_PARSE,
+
+    N_POINTS
+  };
+
+  /**
+   * Bucket i of the histogram counts durations below 2^i
+   * microseconds (and at least 2^(i-1)); the last one counts all
+   * longer durations.
+   */
+  static const unsigned N_BUCKETS = 20;
+
+  /**
+   * The number of recent durations kept for each point.
+   */
+  static const unsigned HISTORY_SIZE = 64;
+
+  struct Result {
+    unsigned count;
+    uint64_t total_us;
+    unsigned max_us;
+    unsigned histogram[N_BUCKETS];
+
+    unsigned GetAverageUS() const {
+      return count > 0 ? unsigned(total_us / count) : 0;
+    }
+
+    /**
+     * Returns an upper bound of the specified percentile [us], as
+     * far as the histogram resolution allows.
+     */
+    gcc_pure
+    unsigned GetPercentileUS(unsigned percent) const;
+  };
+
+  extern bool enabled;
+
+  static inline bool
+  IsEnabled()
+  {
+    return enabled;
+  }
+
+  void SetEnabled(bool enabled);
+
+  gcc_const
+  const TCHAR *GetName(Point point);
+
+  /**
+   * Account one execution of the specified point.
+   */
+  void Add(Point point, unsigned duration_us);
+
+  /**
+   * Sum up the counters of all threads.
+   */
+  gcc_pure
+  Result Get(Point point);
+
+  /**
+   * Returns the number of updates which were dropped, because they
+   * came from a thread which did not get its own counters.
+   */
+  gcc_pure
+  unsigned GetDropped();
+
+  /**
+   * Copy the most recent durations [us] of the specified point,
+   * oldest first.
+   *
+   * @return the number of values copied
+   */
+  unsigned GetHistory(Point point, unsigned *dest, unsigned max);
+
+  /**
+   * Clear all counters.  Counter updates which happen concurrently
+   * may get lost.
+   */
+  void Reset();
+
+  void Dump(TextWriter &writer);
+
+  /**
+   * Write all results to the specified file.
+   *
+   * @return false on error
+   */
+  bool Dump(const TCHAR *path);
+}
+
+/**
+ * Measures the lifetime of this object, and adds it to a
+ * #Profiler::Point.
+ */
+class ScopeProfile {
+  const Profiler::Point point;
+  const uint64_t start_us;
+
+public:
+  explicit ScopeProfile(Profiler::Point _point)
+    :point(_point),
+     start_us(Profiler::IsEnabled() ? MonotonicClockUS() : 0) {}
+
+  ~ScopeProfile() {
+    if (start_us != 0)
+      Profiler::Add(point, unsigned(MonotonicClockUS() - start_us));
+  }
+};
+
+#endif
@@ -24,6 +24,7 @@ Copyright_License {
 #include "Projection.hpp"
 #include "Math/Earth.hpp"
 #include "Math/Angle.hpp"
+#include "Math/FastMath.h"
 
 Projection::Projection() :
   geo_location(Angle::Zero(), Angle::Zero()),
@@ -72,6 +73,56 @@ Projection::GeoToScreen(const GeoPoint &g) const
   return sc;
 }
 
+void
+Projection::GeoToScreen(const GeoPoint *src, RasterPoint *dest,
+                        unsigned n) const
+{
+#ifdef FIXED_MATH
+  for (const GeoPoint *end = src + n; src != end; ++src, ++dest)
+    *dest = GeoToScreen(*src);
+#else
+  /* this is GeoToScreen() with GeoPoint::Normalize() and
+     fastcosine() expanded, and all attributes copied to local
+     variables, to allow the compiler to keep them in registers */
+
+  const fixed half_circle = Angle::HalfCircle().Native();
+  const fixed quarter_circle = Angle::QuarterCircle().Native();
+
+  /* the offset which makes the cosine table index positive before
+     it is truncated, which is cheaper than floor(); the table is
+     periodic, so this doesn't change the result */
+  const fixed index_offset = fixed(4096 * 64) + fixed_half;
+
+  const fixed origin_longitude = geo_location.longitude.Native();
+  const fixed origin_latitude = geo_location.latitude.Native();
+  const FastIntegerRotation rotation = screen_rotation;
+  const int origin_x = screen_origin.x, origin_y = screen_origin.y;
+
+  for (const GeoPoint *end = src + n; src != end; ++src, ++dest) {
+    fixed dlon = origin_longitude - src->longitude.Native();
+    if (dlon > half_circle || dlon <= -half_circle)
+      dlon = Angle::Native(dlon).AsDelta().Native();
+
+    fixed dlat = origin_latitude - src->latitude.Native();
+    if (dlat < -quarter_circle)
+      dlat = -quarter_circle;
+    else if (dlat > quarter_circle)
+      dlat = quarter_circle;
+
+    const unsigned index = (unsigned)(src->latitude.Native() * INT_ANGLE_MULT
+                                      + index_offset) & 0xfff;
+    const fixed cosine = COSTABLE[index];
+
+    const FastIntegerRotation::Pair p =
+      rotation.Rotate((int)(cosine * AngleToPixels(Angle::Native(dlon))),
+                      (int)AngleToPixels(Angle::Native(dlat)));
+
+    dest->x = origin_x - p.first;
+    dest->y = origin_y + p.second;
+  }
+#endif
+}
+
 void 
 Projection::SetScale(const fixed _scale)
 {
@@ -137,6 +137,24 @@ public:
     return ScreenToGeo(pt.x, pt.y);
   }
 
+  /**
+   * Does the other object convert all GeoPoints to the same screen
+   * coordinates?  This allows checking whether cached screen
+   * coordinates are still valid.
+   */
+  gcc_pure
+  bool operator==(const Projection &other) const {
+    return geo_location == other.geo_location &&
+      screen_origin.x == other.screen_origin.x &&
+      screen_origin.y == other.screen_origin.y &&
+      screen_rotation.GetAngle() == other.screen_rotation.GetAngle() &&
+      scale == other.scale;
+  }
+
+  bool operator!=(const Projection &other) const {
+    return !(*this == other);
+  }
+
   /**
    * Converts a GeoPoint to screen coordinates
    * @param g GeoPoint to convert
@@ -144,6 +162,18 @@ public:
   gcc_pure
   RasterPoint GeoToScreen(const GeoPoint &g) const;
 
+  /**
+   * Converts an array of GeoPoints to screen coordinates.  The result
+   * is the same as calling GeoToScreen() for each point, but the
+   * projection parameters are loaded only once, and the inner loop
+   * has no function calls.  Use this for polylines and polygons.
+   *
+   * @param src the GeoPoints to convert
+   * @param dest a buffer for at least n RasterPoints
+   * @param n the number of points
+   */
+  void GeoToScreen(const GeoPoint *src, RasterPoint *dest, unsigned n) const;
+
   /**
    * Returns the origin/rotation center in screen coordinates
    * @return The origin/rotation center in screen coordinates
@@ -102,6 +102,17 @@ CreateCalculationThread()
 
   calculation_thread = new CalculationThread(*glide_computer);
   calculation_thread->SetComputerSettings(CommonInterface::GetComputerSettings());
+
+  const ComputationRateSettings &rate =
+    CommonInterface::GetComputerSettings().rate;
+  if (rate.high_rate_enabled) {
+    /* process every fix of a 10-20 Hz device; the expensive task
+       calculations are decimated by GlideComputer */
+    merge_thread->SetPeriod(rate.calculation_period / 2,
+                            rate.calculation_period / 5, 0);
+    calculation_thread->SetPeriod(rate.calculation_period,
+                                  rate.calculation_period / 5, 0);
+  }
 }
 
 void
@@ -0,0 +1,258 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceRenderCache.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Navigation/SearchPointVector.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/Triangulate.hpp"
+#endif
+
+#include <stdlib.h>
+
+/**
+ * Polygons are clipped to the screen bounds scaled by this factor,
+ * which allows panning by a quarter of the screen size before the
+ * cache must be discarded.
+ */
+static gcc_constexpr_data fixed CLIP_SCALE(1.5);
+
+AirspaceRenderCache::AirspaceRenderCache()
+  :airspaces(NULL), valid(false), frame(0)
+{
+  statistics.hits = statistics.misses = 0;
+  statistics.unchanged = statistics.translated = statistics.flushed = 0;
+}
+
+void
+AirspaceRenderCache::Flush()
+{
+  shapes.clear();
+  valid = false;
+}
+
+bool
+AirspaceRenderCache::IsTranslation(const WindowProjection &other,
+                                   RasterPoint &offset_r) const
+{
+  if (other.GetScale() != projection.GetScale() ||
+      other.GetScreenAngle() != projection.GetScreenAngle() ||
+      other.GetScreenWidth() != projection.GetScreenWidth() ||
+      other.GetScreenHeight() != projection.GetScreenHeight())
+    return false;
+
+  /* the cached outlines must still cover the whole screen */
+  const GeoBounds clip_bounds = projection.GetScreenBounds().Scale(CLIP_SCALE);
+  if (!clip_bounds.IsInside(other.GetScreenBounds()))
+    return false;
+
+  const RasterPoint origin = other.GeoToScreen(projection.GetGeoLocation());
+  const RasterPoint &old_origin = projection.GetScreenOrigin();
+  const RasterPoint offset = { PixelScalar(origin.x - old_origin.x),
+                               PixelScalar(origin.y - old_origin.y) };
+
+  /* panning east or west is not an exact translation, because the
+     horizontal scale depends on the latitude of each point (see
+     Projection::GeoToScreen()); check the error at the corners of the
+     clipped area */
+  const GeoPoint corners[4] = {
+    GeoPoint(clip_bounds.west, clip_bounds.north),
+    GeoPoint(clip_bounds.east, clip_bounds.north),
+    GeoPoint(clip_bounds.west, clip_bounds.south),
+    GeoPoint(clip_bounds.east, clip_bounds.south),
+  };
+
+  for (unsigned i = 0; i < 4; ++i) {
+    const RasterPoint a = projection.GeoToScreen(corners[i]);
+    const RasterPoint b = other.GeoToScreen(corners[i]);
+    if (abs(a.x + offset.x - b.x) > 1 || abs(a.y + offset.y - b.y) > 1)
+      return false;
+  }
+
+  offset_r = offset;
+  return true;
+}
+
+void
+AirspaceRenderCache::RemoveUnused()
+{
+  for (auto i = shapes.begin(); i != shapes.end();) {
+    if (i->second.frame + 1 < frame)
+      i = shapes.erase(i);
+    else
+      ++i;
+  }
+}
+
+void
+AirspaceRenderCache::Begin(const Airspaces &_airspaces,
+                           const WindowProjection &_projection)
+{
+  ++frame;
+
+  if (valid && &_airspaces == airspaces &&
+      _airspaces.GetSerial() == serial) {
+    if (_projection == projection &&
+        _projection.GetScreenWidth() == projection.GetScreenWidth() &&
+        _projection.GetScreenHeight() == projection.GetScreenHeight()) {
+      offset.x = offset.y = 0;
+      ++statistics.unchanged;
+      RemoveUnused();
+      return;
+    }
+
+    if (IsTranslation(_projection, offset)) {
+      ++statistics.translated;
+      RemoveUnused();
+      return;
+    }
+  }
+
+  Flush();
+  ++statistics.flushed;
+
+  airspaces = &_airspaces;
+  serial = _airspaces.GetSerial();
+  projection = _projection;
+  clip = projection.GetScreenBounds().Scale(CLIP_SCALE);
+  offset.x = offset.y = 0;
+  valid = true;
+}
+
+static void
+UpdateBounds(PixelRect &bounds, const RasterPoint &pt)
+{
+  if (pt.x < bounds.left)
+    bounds.left = pt.x;
+  if (pt.x >= bounds.right)
+    bounds.right = pt.x + 1;
+  if (pt.y < bounds.top)
+    bounds.top = pt.y;
+  if (pt.y >= bounds.bottom)
+    bounds.bottom = pt.y + 1;
+}
+
+void
+AirspaceRenderCache::Project(Shape &shape, const AirspacePolygon &airspace)
+{
+  shape.num_points = 0;
+#ifdef ENABLE_OPENGL
+  shape.num_triangle_indices = 0;
+  shape.triangulated = false;
+#endif
+
+  const SearchPointVector &points = airspace.GetPoints();
+  unsigned num_points = points.size();
+  if (num_points < 3)
+    return;
+
+  /* copy all SearchPointVector elements to geo_points */
+  geo_points.GrowDiscard(num_points * 3);
+  for (unsigned i = 0; i < num_points; ++i)
+    geo_points[i] = points[i].get_location();
+
+  /* clip them */
+  num_points = clip.ClipPolygon(geo_points.begin(),
+                                geo_points.begin(), num_points);
+  if (num_points < 3)
+    /* it's completely outside the clipped area */
+    return;
+
+  /* project all GeoPoints to screen coordinates */
+  shape.points.GrowDiscard(num_points);
+  projection.GeoToScreen(geo_points.begin(), shape.points.begin(),
+                         num_points);
+  shape.num_points = num_points;
+
+  shape.bounds.left = 0x7fff;
+  shape.bounds.top = 0x7fff;
+  shape.bounds.right = -1;
+  shape.bounds.bottom = -1;
+  for (unsigned i = 0; i < num_points; ++i)
+    UpdateBounds(shape.bounds, shape.points[i]);
+}
+
+bool
+AirspaceRenderCache::IsVisible(const Shape &shape) const
+{
+  return shape.num_points >= 3 &&
+    shape.bounds.left + offset.x < (int)projection.GetScreenWidth() &&
+    shape.bounds.right + offset.x >= 0 &&
+    shape.bounds.top + offset.y < (int)projection.GetScreenHeight() &&
+    shape.bounds.bottom + offset.y >= 0;
+}
+
+AirspaceRenderCache::Shape *
+AirspaceRenderCache::Get(const AirspacePolygon &airspace)
+{
+  assert(valid);
+
+  Shape *shape;
+  auto i = shapes.find(&airspace);
+  if (i != shapes.end()) {
+    shape = &i->second;
+    ++statistics.hits;
+  } else {
+    shape = &shapes[&airspace];
+    Project(*shape, airspace);
+    ++statistics.misses;
+  }
+
+  shape->frame = frame;
+
+  return IsVisible(*shape) ? shape : NULL;
+}
+
+const RasterPoint *
+AirspaceRenderCache::GetScreenPoints(const Shape &shape)
+{
+  if (offset.x == 0 && offset.y == 0)
+    return shape.points.begin();
+
+  screen_points.GrowDiscard(shape.num_points);
+  for (unsigned i = 0; i < shape.num_points; ++i) {
+    screen_points[i].x = shape.points[i].x + offset.x;
+    screen_points[i].y = shape.points[i].y + offset.y;
+  }
+
+  return screen_points.begin();
+}
+
+#ifdef ENABLE_OPENGL
+
+unsigned
+AirspaceRenderCache::Triangulate(Shape &shape)
+{
+  if (!shape.triangulated) {
+    shape.num_triangle_indices =
+      PolygonToTriangles(shape.points.begin(), shape.num_points,
+                         shape.triangles);
+    shape.triangulated = true;
+  }
+
+  return shape.num_triangle_indices;
+}
+
+#endif
@@ -0,0 +1,213 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_RENDER_CACHE_HPP
+#define XCSOAR_AIRSPACE_RENDER_CACHE_HPP
+
+#include "Projection/WindowProjection.hpp"
+#include "Geo/GeoClip.hpp"
+#include "Screen/Point.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "Util/NonCopyable.hpp"
+#include "Util/Serial.hpp"
+#include "Compiler.h"
+
+#include <unordered_map>
+
+#include <assert.h>
+
+class AbstractAirspace;
+class AirspacePolygon;
+class Airspaces;
+
+/**
+ * Keeps the clipped screen outlines of airspace polygons between
+ * frames.
+ *
+ * Clipping and projecting a polygon (and on OpenGL, triangulating
+ * it) is the expensive part of drawing airspaces, and the result
+ * depends only on the projection.  The shapes are therefore reused as
+ * long as the projection does not change.  When the map is only
+ * panned, they are reused as well, and the caller adds GetOffset()
+ * to all coordinates.  To allow that, polygons are clipped with a
+ * margin around the screen.
+ */
+class AirspaceRenderCache : private NonCopyable {
+public:
+  struct Shape {
+    /**
+     * The clipped outline, in the coordinates of GetProjection().
+     */
+    AllocatedArray<RasterPoint> points;
+    unsigned num_points;
+
+    /**
+     * The bounding box of #points.
+     */
+    PixelRect bounds;
+
+#ifdef ENABLE_OPENGL
+    /**
+     * Triangle indices for filling the outline, see
+     * PolygonToTriangles().  They are calculated by Triangulate()
+     * on demand.
+     */
+    AllocatedArray<GLushort> triangles;
+    unsigned num_triangle_indices;
+    bool triangulated;
+#endif
+
+    /**
+     * The frame in which this shape was last used.
+     */
+    unsigned frame;
+  };
+
+  struct Statistics {
+    /**
+     * The number of Get() calls which were answered from the cache,
+     * and those which had to project the polygon.
+     */
+    unsigned hits, misses;
+
+    /**
+     * The number of frames which reused the cache without and with
+     * a translation, and those which discarded it.
+     */
+    unsigned unchanged, translated, flushed;
+  };
+
+private:
+  const Airspaces *airspaces;
+  Serial serial;
+
+  /**
+   * The projection of all cached shapes.
+   */
+  WindowProjection projection;
+  GeoClip clip;
+  bool valid;
+
+  /**
+   * The offset from GetProjection() to the projection of the current
+   * frame.
+   */
+  RasterPoint offset;
+
+  unsigned frame;
+
+  std::unordered_map<const AbstractAirspace *, Shape> shapes;
+
+  /**
+   * A buffer for clipped GeoPoints.
+   */
+  AllocatedArray<GeoPoint> geo_points;
+
+  /**
+   * A buffer for GetScreenPoints().
+   */
+  AllocatedArray<RasterPoint> screen_points;
+
+  Statistics statistics;
+
+public:
+  AirspaceRenderCache();
+
+  /**
+   * Prepare a new frame.  The cache is kept if it was created from
+   * the same airspaces and a projection which differs at most by a
+   * translation; otherwise all shapes are discarded.  Shapes which
+   * were not used in the previous frame are discarded, too.
+   */
+  void Begin(const Airspaces &airspaces, const WindowProjection &projection);
+
+  /**
+   * Discard all shapes.
+   */
+  void Flush();
+
+  /**
+   * Returns the projection of the cached coordinates.  Use it to
+   * project other airspace elements (e.g. circles) so they can be
+   * drawn with the same offset.
+   */
+  const WindowProjection &GetProjection() const {
+    assert(valid);
+
+    return projection;
+  }
+
+  /**
+   * Returns the offset which needs to be added to all cached
+   * coordinates.
+   */
+  RasterPoint GetOffset() const {
+    assert(valid);
+
+    return offset;
+  }
+
+  /**
+   * Returns the shape of the specified polygon, or NULL if it is not
+   * visible.
+   */
+  Shape *Get(const AirspacePolygon &airspace);
+
+  /**
+   * Returns the outline of the shape in the coordinates of the
+   * current frame, i.e. with GetOffset() applied.  The returned
+   * pointer is valid until the next call.
+   */
+  const RasterPoint *GetScreenPoints(const Shape &shape);
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Calculate the triangles of the shape, unless that was done
+   * already.
+   *
+   * @return the number of triangle indices, 0 on failure
+   */
+  static unsigned Triangulate(Shape &shape);
+#endif
+
+  const Statistics &GetStatistics() const {
+    return statistics;
+  }
+
+  size_t size() const {
+    return shapes.size();
+  }
+
+private:
+  bool IsTranslation(const WindowProjection &other,
+                     RasterPoint &offset_r) const;
+
+  void Project(Shape &shape, const AirspacePolygon &airspace);
+
+  gcc_pure
+  bool IsVisible(const Shape &shape) const;
+
+  void RemoveUnused();
+};
+
+#endif
@@ -44,6 +44,9 @@ Copyright_License {
 #include "Screen/OpenGL/Scope.hpp"
 #endif
 
+#include <algorithm>
+#include <vector>
+
 class AirspaceWarningCopy
 {
 private:
@@ -129,21 +132,86 @@ public:
   }
 };
 
+/**
+ * Collects the airspaces to be drawn, to draw them grouped by class:
+ * all airspaces of one class share pen and brush, and the drawing
+ * order does not depend on the layout of the airspace tree anymore.
+ */
+class AirspaceDrawList : public AirspaceVisitor
+{
+  std::vector<const AbstractAirspace *> airspaces;
+
+public:
+  void Visit(const AirspaceCircle &airspace) {
+    airspaces.push_back(&airspace);
+  }
+
+  void Visit(const AirspacePolygon &airspace) {
+    airspaces.push_back(&airspace);
+  }
+
+  void Sort() {
+    std::stable_sort(airspaces.begin(), airspaces.end(), CompareType);
+  }
+
+  void VisitAll(AirspaceVisitor &visitor) const {
+    for (auto i = airspaces.begin(), end = airspaces.end(); i != end; ++i)
+      visitor.Visit(**i);
+  }
+
+private:
+  static bool CompareType(const AbstractAirspace *a,
+                          const AbstractAirspace *b) {
+    return a->GetType() < b->GetType();
+  }
+};
+
 #ifdef ENABLE_OPENGL
 
-class AirspaceVisitorRenderer : public AirspaceVisitor, protected MapCanvas
+/**
+ * Applies the offset of the #AirspaceRenderCache to the OpenGL
+ * modelview matrix.
+ */
+class AirspaceCacheTranslation
 {
+public:
+  AirspaceCacheTranslation(const AirspaceRenderCache &cache) {
+    const RasterPoint offset = cache.GetOffset();
+
+    glPushMatrix();
+#ifdef HAVE_GLES
+    glTranslatex((GLfixed)offset.x << 16, (GLfixed)offset.y << 16, 0);
+#else
+    glTranslatef(offset.x, offset.y, 0);
+#endif
+  }
+
+  ~AirspaceCacheTranslation() {
+    glPopMatrix();
+  }
+};
+
+class AirspaceVisitorRenderer : public AirspaceVisitor
+{
+  Canvas &canvas;
+  AirspaceRenderCache &cache;
+
+  /**
+   * The projection of the cached shapes, which is also used for
+   * circles, so everything can be drawn with the cache's offset.
+   */
+  const WindowProjection &projection;
+
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
 
 public:
-  AirspaceVisitorRenderer(Canvas &_canvas, const WindowProjection &_projection,
+  AirspaceVisitorRenderer(Canvas &_canvas, AirspaceRenderCache &_cache,
                           const AirspaceLook &_look,
                           const AirspaceWarningCopy &_warnings,
                           const AirspaceRendererSettings &_settings)
-    :MapCanvas(_canvas, _projection,
-               _projection.GetScreenBounds().Scale(fixed(1.1))),
+    :canvas(_canvas), cache(_cache), projection(_cache.GetProjection()),
      look(_look), warning_manager(_warnings), settings(_settings)
   {
     glStencilMask(0xff);
@@ -190,7 +258,8 @@ public:
   }
 
   void Visit(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
+    AirspaceRenderCache::Shape *shape = cache.Get(airspace);
+    if (shape == NULL)
       return;
 
     bool fill_airspace = warning_manager.HasWarning(airspace) ||
@@ -205,29 +274,40 @@ public:
       if (!fill_airspace) {
         // set stencil for filling (bit 0)
         SetFillStencil();
-        DrawPrepared();
+        DrawOutline(*shape);
       }
 
       // fill interior without overpainting any previous outlines
       {
         SetupInterior(airspace, !fill_airspace);
         GLEnable blend(GL_BLEND);
-        DrawPrepared();
+        DrawInterior(*shape);
       }
 
       if (!fill_airspace) {
         // clear fill stencil (bit 0)
         ClearFillStencil();
-        DrawPrepared();
+        DrawOutline(*shape);
       }
     }
 
     // draw outline
     if (SetupOutline(airspace))
-      DrawPrepared();
+      DrawOutline(*shape);
   }
 
 private:
+  void DrawOutline(const AirspaceRenderCache::Shape &shape) {
+    canvas.DrawPolygon(shape.points.begin(), shape.num_points);
+  }
+
+  void DrawInterior(AirspaceRenderCache::Shape &shape) {
+    const unsigned num_triangle_indices =
+      AirspaceRenderCache::Triangulate(shape);
+    canvas.DrawPolygon(shape.points.begin(), shape.num_points,
+                       shape.triangles.begin(), num_triangle_indices);
+  }
+
   bool SetupOutline(const AbstractAirspace &airspace) {
     AirspaceClass type = airspace.GetType();
 
@@ -286,56 +366,68 @@ private:
   }
 };
 
-class AirspaceFillRenderer : public AirspaceVisitor, protected MapCanvas
+/**
+ * Draws airspaces with #AirspaceRendererSettings::FillMode::ALL.
+ * The interiors of all airspaces are drawn in a first pass, and the
+ * outlines in a second one, so the outlines stay on top (like on
+ * GDI).
+ */
+class AirspaceFillRenderer : public AirspaceVisitor
 {
+  Canvas &canvas;
+  AirspaceRenderCache &cache;
+  const WindowProjection &projection;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
 
+  bool outline_pass;
+
 public:
-  AirspaceFillRenderer(Canvas &_canvas, const WindowProjection &_projection,
+  AirspaceFillRenderer(Canvas &_canvas, AirspaceRenderCache &_cache,
                        const AirspaceLook &_look,
                        const AirspaceWarningCopy &_warnings,
                        const AirspaceRendererSettings &_settings)
-    :MapCanvas(_canvas, _projection,
-               _projection.GetScreenBounds().Scale(fixed(1.1))),
-     look(_look), warning_manager(_warnings), settings(_settings)
+    :canvas(_canvas), cache(_cache), projection(_cache.GetProjection()),
+     look(_look), warning_manager(_warnings), settings(_settings),
+     outline_pass(false)
   {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
 
+  void BeginOutlines() {
+    outline_pass = true;
+  }
+
 public:
   void Visit(const AirspaceCircle &airspace) {
     RasterPoint screen_center = projection.GeoToScreen(airspace.GetCenter());
     unsigned screen_radius = projection.GeoToScreenDistance(airspace.GetRadius());
 
-    {
+    if (!outline_pass) {
       GLEnable blend(GL_BLEND);
       SetupInterior(airspace);
       canvas.DrawCircle(screen_center.x, screen_center.y, screen_radius);
-    }
-
-    // draw outline
-    if (SetupOutline(airspace))
+    } else if (SetupOutline(airspace))
       canvas.DrawCircle(screen_center.x, screen_center.y, screen_radius);
   }
 
   void Visit(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
+    AirspaceRenderCache::Shape *shape = cache.Get(airspace);
+    if (shape == NULL)
       return;
 
-    if (!warning_manager.IsAcked(airspace)) {
-      // fill interior without overpainting any previous outlines
-      {
+    if (!outline_pass) {
+      if (!warning_manager.IsAcked(airspace)) {
         SetupInterior(airspace);
         GLEnable blend(GL_BLEND);
-        DrawPrepared();
+        const unsigned num_triangle_indices =
+          AirspaceRenderCache::Triangulate(*shape);
+        canvas.DrawPolygon(shape->points.begin(), shape->num_points,
+                           shape->triangles.begin(), num_triangle_indices);
       }
-    }
-
-    // draw outline
-    if (SetupOutline(airspace))
-      DrawPrepared();
+    } else if (SetupOutline(airspace))
+      canvas.DrawPolygon(shape->points.begin(), shape->num_points);
   }
 
 private:
@@ -375,15 +467,17 @@ class AirspaceVisitorMap:
   public AirspaceVisitor,
   public MapDrawHelper
 {
+  AirspaceRenderCache &cache;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warnings;
 
 public:
   AirspaceVisitorMap(MapDrawHelper &_helper,
+                     AirspaceRenderCache &_cache,
                      const AirspaceWarningCopy &_warnings,
                      const AirspaceRendererSettings &_settings,
                      const AirspaceLook &_airspace_look)
-    :MapDrawHelper(_helper),
+    :MapDrawHelper(_helper), cache(_cache),
      look(_airspace_look), warnings(_warnings)
   {
     switch (settings.fill_mode) {
@@ -424,9 +518,13 @@ public:
         AirspaceClassRendererSettings::FillMode::NONE)
       return;
 
+    const AirspaceRenderCache::Shape *shape = cache.Get(airspace);
+    if (shape == NULL)
+      return;
+
     BufferRenderStart();
     SetBufferPens(airspace);
-    DrawSearchPointVector(airspace.GetPoints());
+    DrawPolygon(cache.GetScreenPoints(*shape), shape->num_points);
   }
 
   void DrawIntercepts() {
@@ -480,16 +578,18 @@ class AirspaceOutlineRenderer
   :public AirspaceVisitor,
    protected MapCanvas
 {
+  AirspaceRenderCache &cache;
   const AirspaceLook &look;
   const AirspaceRendererSettings &settings;
 
 public:
   AirspaceOutlineRenderer(Canvas &_canvas, const WindowProjection &_projection,
+                          AirspaceRenderCache &_cache,
                           const AirspaceLook &_look,
                           const AirspaceRendererSettings &_settings)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(fixed(1.1))),
-     look(_look), settings(_settings)
+     cache(_cache), look(_look), settings(_settings)
   {
     if (settings.black_outline)
       canvas.SelectBlackPen();
@@ -518,8 +618,12 @@ public:
   }
 
   void Visit(const AirspacePolygon &airspace) {
-    if (SetupCanvas(airspace))
-      DrawPolygon(airspace.GetPoints());
+    if (!SetupCanvas(airspace))
+      return;
+
+    const AirspaceRenderCache::Shape *shape = cache.Get(airspace);
+    if (shape != NULL)
+      canvas.DrawPolygon(cache.GetScreenPoints(*shape), shape->num_points);
   }
 };
 
@@ -549,42 +653,43 @@ AirspaceRenderer::Draw(Canvas &canvas,
   if (airspaces == NULL)
     return;
 
+  cache.Begin(*airspaces, projection);
+
+  AirspaceDrawList draw_list;
+  airspaces->VisitWithinRange(projection.GetGeoScreenCenter(),
+                              projection.GetScreenDistanceMeters(),
+                              draw_list, visible);
+  draw_list.Sort();
+
 #ifdef ENABLE_OPENGL
+  const AirspaceCacheTranslation translation(cache);
+
   if (settings.fill_mode == AirspaceRendererSettings::FillMode::ALL) {
-    AirspaceFillRenderer renderer(canvas, projection, look, awc,
-                                  settings);
-    airspaces->VisitWithinRange(projection.GetGeoScreenCenter(),
-                                          projection.GetScreenDistanceMeters(),
-                                          renderer, visible);
+    AirspaceFillRenderer renderer(canvas, cache, look, awc, settings);
+    draw_list.VisitAll(renderer);
+    renderer.BeginOutlines();
+    draw_list.VisitAll(renderer);
   } else {
-    AirspaceVisitorRenderer renderer(canvas, projection, look, awc,
-                                     settings);
-    airspaces->VisitWithinRange(projection.GetGeoScreenCenter(),
-                                          projection.GetScreenDistanceMeters(),
-                                          renderer, visible);
+    AirspaceVisitorRenderer renderer(canvas, cache, look, awc, settings);
+    draw_list.VisitAll(renderer);
   }
 #else
   MapDrawHelper helper(canvas, buffer_canvas, stencil_canvas, projection,
                        settings);
-  AirspaceVisitorMap v(helper, awc, settings,
-                       look);
+  AirspaceVisitorMap v(helper, cache, awc, settings, look);
 
-  // JMW TODO wasteful to draw twice, can't it be drawn once?
-  // we are using two draws so borders go on top of everything
+  // we are using two passes so borders go on top of everything
 
-  airspaces->VisitWithinRange(projection.GetGeoScreenCenter(),
-                                        projection.GetScreenDistanceMeters(),
-                                        v, visible);
+  draw_list.VisitAll(v);
 
   awc.VisitWarnings(v);
   awc.VisitInside(v);
 
   v.DrawIntercepts();
 
-  AirspaceOutlineRenderer outline_renderer(canvas, projection, look, settings);
-  airspaces->VisitWithinRange(projection.GetGeoScreenCenter(),
-                                        projection.GetScreenDistanceMeters(),
-                                        outline_renderer, visible);
+  AirspaceOutlineRenderer outline_renderer(canvas, projection, cache,
+                                           look, settings);
+  draw_list.VisitAll(outline_renderer);
   awc.VisitWarnings(outline_renderer);
   awc.VisitInside(outline_renderer);
 #endif
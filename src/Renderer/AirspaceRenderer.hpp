@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_AIRSPACE_RENDERER_HPP
 #define XCSOAR_AIRSPACE_RENDERER_HPP
 
+#include "AirspaceRenderCache.hpp"
 #include "Util/StaticArray.hpp"
 #include "Engine/Navigation/GeoPoint.hpp"
 
@@ -48,6 +49,11 @@ class AirspaceRenderer
 
   StaticArray<GeoPoint,32> intersections;
 
+  /**
+   * The screen outlines of the airspaces drawn in the previous frame.
+   */
+  AirspaceRenderCache cache;
+
 public:
   AirspaceRenderer(const AirspaceLook &_look)
     :look(_look), airspaces(NULL), warning_manager(NULL) {}
@@ -66,6 +72,7 @@ public:
 
   void SetAirspaces(const Airspaces *_airspaces) {
     airspaces = _airspaces;
+    cache.Flush();
   }
 
   void SetAirspaceWarnings(const ProtectedAirspaceWarningManager *_warning_manager) {
@@ -75,6 +82,11 @@ public:
   void Clear() {
     airspaces = NULL;
     warning_manager = NULL;
+    cache.Flush();
+  }
+
+  const AirspaceRenderCache::Statistics &GetCacheStatistics() const {
+    return cache.GetStatistics();
   }
 
   /**
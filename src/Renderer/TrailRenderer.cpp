@@ -34,12 +34,15 @@ Copyright_License {
 
 #include <algorithm>
 
+#include <assert.h>
+
 using std::min;
 using std::max;
 
 bool
 TrailRenderer::LoadTrace(const TraceComputer &trace_computer)
 {
+  trail_valid = false;
   trace.clear();
   trace_computer.LockedCopyTo(trace);
   return !trace.empty();
@@ -50,6 +53,7 @@ TrailRenderer::LoadTrace(const TraceComputer &trace_computer,
                          unsigned min_time,
                          const WindowProjection &projection)
 {
+  trail_valid = false;
   trace.clear();
   trace_computer.LockedCopyTo(trace, min_time,
                               projection.GetGeoScreenCenter(),
@@ -77,6 +81,236 @@ GetSnailColorIndex(fixed cv)
                            (short)((cv + fixed_one) / 2 * TrailLook::NUMSNAILCOLORS)));
 }
 
+unsigned
+TrailRenderer::SyncTrail(const TraceComputer &trace_computer,
+                         unsigned min_time,
+                         const WindowProjection &projection)
+{
+  const fixed resolution = projection.DistancePixelsToMeters(3);
+  unsigned unchanged = 0;
+
+  trace_computer.Lock();
+  const Trace &full = trace_computer.GetFull();
+
+  if (trail_valid && !trace.empty() &&
+      full.GetModifySerial() == modify_serial &&
+      resolution == trail_resolution && min_time >= trail_min_time) {
+    /* append the new points */
+    unchanged = trace.size();
+    if (full.GetAppendSerial() != append_serial)
+      full.SyncPoints(trace, projection.GetGeoScreenCenter(), resolution);
+  } else {
+    /* the trace was thinned, or the map was zoomed: reload */
+    trace.clear();
+    full.GetPoints(trace, min_time, projection.GetGeoScreenCenter(),
+                   resolution);
+    trail_resolution = resolution;
+    trail_valid = true;
+  }
+
+  modify_serial = full.GetModifySerial();
+  append_serial = full.GetAppendSerial();
+  trace_computer.Unlock();
+
+  trail_min_time = min_time;
+
+  /* drop the points which have become too old */
+  auto i = trace.begin();
+  while (i != trace.end() && i->GetTime() < min_time)
+    ++i;
+
+  const unsigned n_old = i - trace.begin();
+  if (n_old > 0) {
+    if (n_old < unchanged && n_old < run_points) {
+      /* the older part of the trail is kept */
+      DropOldPoints(n_old);
+      unchanged -= n_old;
+    } else {
+      trace.erase(trace.begin(), i);
+      unchanged = 0;
+    }
+  }
+
+  return unchanged;
+}
+
+void
+TrailRenderer::DropOldPoints(unsigned n)
+{
+  assert(n < colours.size());
+  assert(n < run_points);
+
+  trace.erase(trace.begin(), trace.begin() + n);
+  colours.erase(colours.begin(), colours.begin() + n);
+  run_points -= n;
+
+  /* remove the runs which end before the new first point, and trim
+     the one which crosses it; a run needs at least two points */
+  auto r = runs.begin();
+  while (r != runs.end() && r->first_point + (r->end - r->begin) <= n + 1)
+    ++r;
+
+  if (r == runs.end())
+    /* the open run (if any) is gone; the next point starts a new
+       one */
+    run_open = false;
+
+  runs.erase(runs.begin(), r);
+
+  if (runs.empty()) {
+    vertices.clear();
+    return;
+  }
+
+  if (runs.front().first_point < n) {
+    runs.front().begin += n - runs.front().first_point;
+    runs.front().first_point = n;
+  }
+
+  /* discard the vertices before the first run */
+  const unsigned n_vertices = runs.front().begin;
+  vertices.erase(vertices.begin(), vertices.begin() + n_vertices);
+
+  for (auto i = runs.begin(), end = runs.end(); i != end; ++i) {
+    i->begin -= n_vertices;
+    i->end -= n_vertices;
+    i->first_point -= n;
+  }
+}
+
+unsigned
+TrailRenderer::UpdateColours(unsigned first, bool altitude)
+{
+  if (altitude != altitude_colours) {
+    altitude_colours = altitude;
+    first = 0;
+  }
+
+  if (first == 0) {
+    if (altitude) {
+      value_max = fixed(1000);
+      value_min = fixed(500);
+    } else {
+      value_max = fixed(0.75);
+      value_min = fixed(-2.0);
+    }
+  }
+
+  fixed new_max = value_max, new_min = value_min;
+  if (altitude) {
+    for (auto it = trace.begin() + first; it != trace.end(); ++it) {
+      new_max = max(it->GetAltitude(), new_max);
+      new_min = min(it->GetAltitude(), new_min);
+    }
+  } else {
+    for (auto it = trace.begin() + first; it != trace.end(); ++it) {
+      new_max = max(it->GetVario(), new_max);
+      new_min = min(it->GetVario(), new_min);
+    }
+    new_max = min(fixed(7.5), new_max);
+    new_min = max(fixed(-5.0), new_min);
+  }
+
+  if (new_max != value_max || new_min != value_min) {
+    /* the scale has changed: all colours must be recalculated */
+    value_max = new_max;
+    value_min = new_min;
+    first = 0;
+  }
+
+  colours.resize(trace.size());
+  for (unsigned i = first; i < trace.size(); ++i) {
+    const TracePoint &point = trace[i];
+    if (altitude) {
+      unsigned index((point.GetAltitude() - value_min)
+                     / (value_max - value_min)
+                     * (TrailLook::NUMSNAILCOLORS - 1));
+      colours[i] = max(0u, min(TrailLook::NUMSNAILCOLORS - 1, index));
+    } else {
+      const fixed colour_vario = negative(point.GetVario())
+        ? - point.GetVario() / value_min
+        : point.GetVario() / value_max ;
+      colours[i] = GetSnailColorIndex(colour_vario);
+    }
+  }
+
+  return first;
+}
+
+void
+TrailRenderer::UpdateRuns(unsigned first, const WindowProjection &projection,
+                          bool enable_traildrift, const GeoPoint &traildrift,
+                          fixed time)
+{
+  if (first == 0 || first < run_points || projection != run_projection ||
+      enable_traildrift != run_drift ||
+      (enable_traildrift &&
+       (!(traildrift == run_drift_vector) || time != run_time))) {
+    /* start over */
+    run_projection = projection;
+    run_drift = enable_traildrift;
+    run_drift_vector = traildrift;
+    run_time = time;
+    run_points = 0;
+    run_last_valid = false;
+    run_open = false;
+    runs.clear();
+    vertices.clear();
+  }
+
+  const unsigned n = trace.size() - run_points;
+  if (n == 0)
+    return;
+
+  geo_points.GrowDiscard(n);
+  points.GrowDiscard(n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const TracePoint &point = trace[run_points + i];
+    geo_points[i] = enable_traildrift
+      ? point.get_location().Parametric(traildrift,
+                                        point.CalculateDrift(time))
+      : point.get_location();
+  }
+
+  projection.GeoToScreen(geo_points.begin(), points.begin(), n);
+
+  const GeoBounds bounds = projection.GetScreenBounds().Scale(fixed_four);
+
+  for (unsigned i = 0; i < n; ++i) {
+    if (!bounds.IsInside(geo_points[i])) {
+      /* the point is outside of the MapWindow; don't paint it */
+      run_last_valid = false;
+      run_open = false;
+      continue;
+    }
+
+    const RasterPoint pt = points[i];
+
+    if (run_last_valid) {
+      const unsigned colour = colours[run_points + i];
+      if (!run_open || runs.back().colour != colour) {
+        /* begin a new run at the previous point */
+        Run run;
+        run.begin = vertices.size();
+        run.first_point = run_points + i - 1;
+        run.colour = colour;
+        runs.push_back(run);
+        vertices.push_back(run_last_point);
+      }
+
+      vertices.push_back(pt);
+      runs.back().end = vertices.size();
+      run_open = true;
+    }
+
+    run_last_point = pt;
+    run_last_valid = true;
+  }
+
+  run_points = trace.size();
+}
+
 void
 TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
                     const WindowProjection &projection, unsigned min_time,
@@ -87,7 +321,8 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
   if (settings.trail_length == TRAIL_OFF)
     return;
 
-  if (!LoadTrace(trace_computer, min_time, projection))
+  unsigned first = SyncTrail(trace_computer, min_time, projection);
+  if (trace.empty())
     return;
 
   if (!calculated.wind_available)
@@ -99,72 +334,29 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
                                          calculated.wind.bearing,
                                          calculated.wind.norm);
     traildrift = basic.location - tp1;
-  }
+  } else
+    traildrift = GeoPoint::Zero();
 
-  fixed value_max, value_min;
-
-  if (settings.snail_type == stAltitude) {
-    value_max = fixed(1000);
-    value_min = fixed(500);
-    for (auto it = trace.begin(); it != trace.end(); ++it) {
-      value_max = max(it->GetAltitude(), value_max);
-      value_min = min(it->GetAltitude(), value_min);
-    }
-  } else {
-    value_max = fixed(0.75);
-    value_min = fixed(-2.0);
-    for (auto it = trace.begin(); it != trace.end(); ++it) {
-      value_max = max(it->GetVario(), value_max);
-      value_min = min(it->GetVario(), value_min);
-    }
-    value_max = min(fixed(7.5), value_max);
-    value_min = max(fixed(-5.0), value_min);
-  }
+  const bool altitude = settings.snail_type == stAltitude;
+  first = UpdateColours(first, altitude);
+  UpdateRuns(first, projection, enable_traildrift, traildrift, basic.time);
 
   bool scaled_trail = settings.snail_scaling_enabled &&
                       projection.GetMapScale() <= fixed_int_constant(6000);
 
-  const GeoBounds bounds = projection.GetScreenBounds().Scale(fixed_four);
-
-  RasterPoint last_point;
-  bool last_valid = false;
-  for (auto it = trace.begin(), end = trace.end(); it != end; ++it) {
-    const GeoPoint gp = enable_traildrift
-      ? it->get_location().Parametric(traildrift,
-                                      it->CalculateDrift(basic.time))
-      : it->get_location();
-    if (!bounds.IsInside(gp)) {
-      /* the point is outside of the MapWindow; don't paint it */
-      last_valid = false;
-      continue;
-    }
+  const Pen *pens = altitude || !scaled_trail
+    ? look.hpSnail
+    : look.hpSnailVario;
 
-    RasterPoint pt = projection.GeoToScreen(gp);
-
-    if (last_valid) {
-      if (settings.snail_type == stAltitude) {
-        unsigned index((it->GetAltitude() - value_min) / (value_max - value_min)
-                       * (TrailLook::NUMSNAILCOLORS - 1));
-        index = max(0u, min(TrailLook::NUMSNAILCOLORS - 1, index));
-        canvas.Select(look.hpSnail[index]);
-      } else {
-        const fixed colour_vario = negative(it->GetVario())
-          ? - it->GetVario() / value_min
-          : it->GetVario() / value_max ;
-
-        if (!scaled_trail)
-          canvas.Select(look.hpSnail[GetSnailColorIndex(colour_vario)]);
-        else
-          canvas.Select(look.hpSnailVario[GetSnailColorIndex(colour_vario)]);
-      }
-      canvas.DrawLinePiece(last_point, pt);
-    }
-    last_point = pt;
-    last_valid = true;
+  for (auto i = runs.begin(), end = runs.end(); i != end; ++i) {
+    canvas.Select(pens[i->colour]);
+    canvas.DrawPolyline(&vertices[i->begin], i->end - i->begin);
   }
 
-  if (last_valid)
-    canvas.DrawLine(last_point, pos);
+  if (run_last_valid) {
+    canvas.Select(pens[colours.back()]);
+    canvas.DrawLine(run_last_point, pos);
+  }
 }
 
 void
@@ -188,12 +380,14 @@ TrailRenderer::DrawTraceVector(Canvas &canvas,
                                const WindowProjection &projection,
                                const ContestTraceVector &trace)
 {
+  geo_points.GrowDiscard(trace.size());
   points.GrowDiscard(trace.size());
 
   unsigned n = 0;
   for (auto i = trace.begin(), end = trace.end(); i != end; ++i)
-    points[n++] = projection.GeoToScreen(i->get_location());
+    geo_points[n++] = i->get_location();
 
+  projection.GeoToScreen(geo_points.begin(), points.begin(), n);
   canvas.DrawPolyline(points.begin(), n);
 }
 
@@ -201,11 +395,13 @@ void
 TrailRenderer::DrawTraceVector(Canvas &canvas, const Projection &projection,
                                const TracePointVector &trace)
 {
+  geo_points.GrowDiscard(trace.size());
   points.GrowDiscard(trace.size());
 
   unsigned n = 0;
   for (auto i = trace.begin(), end = trace.end(); i != end; ++i)
-    points[n++] = projection.GeoToScreen(i->get_location());
+    geo_points[n++] = i->get_location();
 
+  projection.GeoToScreen(geo_points.begin(), points.begin(), n);
   canvas.DrawPolyline(points.begin(), n);
 }
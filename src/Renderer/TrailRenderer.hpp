@@ -25,10 +25,16 @@ Copyright_License {
 #define XCSOAR_TRAIL_RENDERER_HPP
 
 #include "Util/AllocatedArray.hpp"
+#include "Util/Serial.hpp"
 #include "Screen/Point.hpp"
+#include "Projection/Projection.hpp"
 #include "Engine/Trace/Point.hpp"
 #include "Engine/Trace/Vector.hpp"
 
+#include <vector>
+
+#include <stdint.h>
+
 class Canvas;
 class TraceComputer;
 class Projection;
@@ -40,13 +46,78 @@ struct DerivedInfo;
 struct MapSettings;
 
 class TrailRenderer {
+  /**
+   * A sequence of snail trail segments with the same colour, which
+   * is drawn with one DrawPolyline() call.
+   */
+  struct Run {
+    /** the range of this run in #vertices */
+    unsigned begin, end;
+
+    /**
+     * The #trace index of the point at #begin; the vertices of a run
+     * are consecutive trace points.
+     */
+    unsigned first_point;
+
+    unsigned colour;
+  };
+
   const TrailLook &look;
 
   TracePointVector trace;
+  AllocatedArray<GeoPoint> geo_points;
   AllocatedArray<RasterPoint> points;
 
+  /*
+   * The snail trail is kept between two frames: new trace points are
+   * appended, and only when the #Trace gets thinned or the map is
+   * zoomed, it is loaded again.
+   */
+
+  /** does #trace contain the snail trail managed by SyncTrail()? */
+  bool trail_valid;
+
+  /** the #Trace serials and parameters #trace was loaded with */
+  Serial modify_serial, append_serial;
+  fixed trail_resolution;
+  unsigned trail_min_time;
+
+  /** the value range of the colour scale, see UpdateColours() */
+  bool altitude_colours;
+  fixed value_min, value_max;
+
+  /** the snail colour index of each point in #trace */
+  std::vector<uint8_t> colours;
+
+  /*
+   * The projected snail trail, batched into runs of one colour.  It
+   * is extended as long as the projection and the trail drift
+   * remain unchanged.
+   */
+
+  Projection run_projection;
+  bool run_drift;
+  GeoPoint run_drift_vector;
+  fixed run_time;
+
+  /** the number of #trace points included in #runs */
+  unsigned run_points;
+
+  /** the screen location of the last point, if it is visible */
+  RasterPoint run_last_point;
+  bool run_last_valid;
+
+  /** does the last run end at #run_last_point? */
+  bool run_open;
+
+  std::vector<Run> runs;
+  std::vector<RasterPoint> vertices;
+
 public:
-  TrailRenderer(const TrailLook &_look):look(_look) {}
+  TrailRenderer(const TrailLook &_look)
+    :look(_look), trail_valid(false), altitude_colours(false),
+     run_points(0) {}
 
   /**
    * Load the full trace into this object.
@@ -84,6 +155,43 @@ public:
 private:
   void DrawTraceVector(Canvas &canvas, const Projection &projection,
                        const TracePointVector &trace);
+
+  /**
+   * Update the snail trail in #trace.
+   *
+   * @return the number of points at the beginning of #trace which
+   * were already there in the previous call
+   */
+  unsigned SyncTrail(const TraceComputer &trace_computer, unsigned min_time,
+                     const WindowProjection &projection);
+
+  /**
+   * Remove the specified number of points from the beginning of
+   * #trace, and shift #colours and #runs accordingly.
+   *
+   * @param n the number of points to remove; must be smaller than
+   * the number of points covered by #colours and #runs
+   */
+  void DropOldPoints(unsigned n);
+
+  /**
+   * Calculate the colours of the new points in #trace.  If the value
+   * range has changed, all colours are recalculated.
+   *
+   * @param first the first point which has no colour yet
+   * @return the first point whose colour has changed
+   */
+  unsigned UpdateColours(unsigned first, bool altitude);
+
+  /**
+   * Project the new points of #trace and append them to #runs.
+   *
+   * @param first the first point which was not projected yet, or
+   * whose colour has changed
+   */
+  void UpdateRuns(unsigned first, const WindowProjection &projection,
+                  bool enable_traildrift, const GeoPoint &traildrift,
+                  fixed time);
 };
 
 #endif
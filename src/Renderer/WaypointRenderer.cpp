@@ -54,6 +54,8 @@ Copyright_License {
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 
+#include <algorithm>
+
 #include <assert.h>
 #include <stdio.h>
 
@@ -147,6 +149,12 @@ class WaypointVisitorMap:
   const TaskBehaviour &task_behaviour;
   const MoreData &basic;
 
+  /**
+   * The (sorted) ids of the waypoints whose labels were drawn in the
+   * previous frame; NULL if that layout is not relevant anymore.
+   */
+  const std::vector<unsigned> *last_labels;
+
   TCHAR sAltUnit[4];
   bool task_valid;
 
@@ -167,10 +175,11 @@ public:
                      const WaypointRendererSettings &_settings,
                      const WaypointLook &_look,
                      const TaskBehaviour &_task_behaviour,
-                     const MoreData &_basic)
+                     const MoreData &_basic,
+                     const std::vector<unsigned> *_last_labels)
     :projection(_projection),
      settings(_settings), look(_look), task_behaviour(_task_behaviour),
-     basic(_basic),
+     basic(_basic), last_labels(_last_labels),
      task_valid(false),
      labels(projection.GetScreenWidth(), projection.GetScreenHeight())
   {
@@ -342,9 +351,13 @@ protected:
       // make space for the green circle
       sc.x += 5;
 
+    const bool was_visible = last_labels != NULL &&
+      std::binary_search(last_labels->begin(), last_labels->end(),
+                         way_point.id);
+
     labels.Add(Buffer, sc.x + 5, sc.y, text_mode, vwp.arrival_height_glide,
                vwp.in_task, way_point.IsLandable(), way_point.IsAirport(),
-               watchedWaypoint);
+               watchedWaypoint, way_point.id, was_visible);
   }
 
   void AddWaypoint(const Waypoint &way_point, bool in_task) {
@@ -455,18 +468,48 @@ public:
   }
 };
 
+/**
+ * Draw the labels in the order of their priority, and collect the
+ * waypoint ids of those which were drawn in #visible.
+ */
 static void
 MapWaypointLabelRender(Canvas &canvas, UPixelScalar width, UPixelScalar height,
                        LabelBlock &label_block,
-                       WaypointLabelList &labels)
+                       WaypointLabelList &labels,
+                       std::vector<unsigned> &visible)
 {
   labels.Sort();
 
+  visible.clear();
+
   for (unsigned i = 0; i < labels.size(); i++) {
     const WaypointLabelList::Label *E = &labels[i];
-    TextInBox(canvas, E->Name, E->Pos.x, E->Pos.y, E->Mode,
-              width, height, &label_block);
+    if (TextInBox(canvas, E->Name, E->Pos.x, E->Pos.y, E->Mode,
+                  width, height, &label_block))
+      visible.push_back(E->id);
   }
+
+  std::sort(visible.begin(), visible.end());
+}
+
+/**
+ * Has the projection changed so little since the previous frame that
+ * the previous label layout is still a good guess?  Panning doesn't
+ * change the relative position of labels, only zooming and rotating
+ * do.
+ */
+gcc_pure
+static bool
+IsSimilarLayout(const MapWindowProjection &projection,
+                fixed last_scale, Angle last_screen_angle)
+{
+  if (!positive(last_scale) ||
+      fabs(projection.GetScale() - last_scale) >= last_scale / 20)
+    return false;
+
+  const Angle rotation =
+    (projection.GetScreenAngle() - last_screen_angle).AsDelta();
+  return rotation.AbsoluteDegrees() < fixed(5);
 }
 
 void
@@ -482,7 +525,11 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
   if ((way_points == NULL) || way_points->IsEmpty())
     return;
 
-  WaypointVisitorMap v(projection, settings, look, task_behaviour, basic);
+  const bool similar = !last_labels.empty() &&
+    IsSimilarLayout(projection, last_scale, last_screen_angle);
+
+  WaypointVisitorMap v(projection, settings, look, task_behaviour, basic,
+                       similar ? &last_labels : NULL);
 
   if (task != NULL) {
     ProtectedTaskManager::Lease task_manager(*task);
@@ -508,5 +555,8 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
   MapWaypointLabelRender(canvas,
                          projection.GetScreenWidth(),
                          projection.GetScreenHeight(),
-                         label_block, v.labels);
+                         label_block, v.labels, last_labels);
+
+  last_scale = projection.GetScale();
+  last_screen_angle = projection.GetScreenAngle();
 }
@@ -25,6 +25,10 @@ Copyright_License {
 #define XCSOAR_WAY_POINT_RENDERER_HPP
 
 #include "Util/NonCopyable.hpp"
+#include "Math/fixed.hpp"
+#include "Math/Angle.hpp"
+
+#include <vector>
 
 struct WaypointRendererSettings;
 struct WaypointLook;
@@ -47,6 +51,21 @@ class WaypointRenderer : private NonCopyable {
 
   const WaypointLook &look;
 
+  /**
+   * The ids of the waypoints whose labels were drawn in the previous
+   * frame (sorted).  As long as the map scale and orientation stay
+   * (almost) the same, these labels win over other labels of the
+   * same class, which keeps the label layout from flickering when
+   * the map moves or arrival altitudes change.
+   */
+  std::vector<unsigned> last_labels;
+
+  /**
+   * The map scale and orientation #last_labels were drawn with.
+   */
+  fixed last_scale;
+  Angle last_screen_angle;
+
 public:
   enum Reachability
   {
@@ -57,10 +76,12 @@ public:
 
   WaypointRenderer(const Waypoints *_way_points,
                    const WaypointLook &_look)
-    :way_points(_way_points), look(_look) {}
+    :way_points(_way_points), look(_look),
+     last_scale(fixed_zero), last_screen_angle(Angle::Zero()) {}
 
   void set_way_points(const Waypoints *_way_points) {
     way_points = _way_points;
+    last_labels.clear();
   }
 
   void render(Canvas &canvas, LabelBlock &label_block,
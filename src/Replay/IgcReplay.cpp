@@ -22,7 +22,6 @@
 */
 
 #include "Replay/IgcReplay.hpp"
-#include "IGC/IGCParser.hpp"
 #include "IGC/IGCFix.hpp"
 #include "Util/StringUtil.hpp"
 
@@ -38,21 +37,12 @@ IgcReplay::IgcReplay() :
   file_name[0] = _T('\0');
 }
 
-bool
-IgcReplay::ScanBuffer(const char *buffer, IGCFix &fix)
-{
-  return IGCParseFix(buffer, fix) && fix.gps_valid;
-}
-
 bool
 IgcReplay::ReadPoint(IGCFix &fix)
 {
-  char *buffer;
-
-  while ((buffer = reader->read()) != NULL) {
-    if (ScanBuffer(buffer, fix))
+  while (reader->Read(fix))
+    if (fix.gps_valid)
       return true;
-  }
 
   return false;
 }
@@ -163,10 +153,12 @@ IgcReplay::OpenFile()
   if (StringIsEmpty(file_name))
     return false;
 
-  reader = new FileLineReaderA(file_name);
+  reader = new IGCFixReader(file_name);
   if (!reader->error())
     return true;
 
+  delete reader;
+  reader = NULL;
   return false;
 }
 
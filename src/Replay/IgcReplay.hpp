@@ -27,7 +27,7 @@ Copyright_License {
 #include "Math/fixed.hpp"
 #include "AbstractReplay.hpp"
 #include "Replay/CatmullRomInterpolator.hpp"
-#include "IO/FileLineReader.hpp"
+#include "IGC/IGCFixReader.hpp"
 
 #include <tchar.h>
 #include <windef.h> /* for MAX_PATH */
@@ -42,7 +42,7 @@ class IgcReplay: public AbstractReplay
   CatmullRomInterpolator cli;
 
   TCHAR file_name[MAX_PATH];
-  FileLineReaderA *reader;
+  IGCFixReader *reader;
 
 protected:
   fixed t_simulation;
@@ -67,8 +67,6 @@ protected:
                          const fixed speed, const Angle bearing,
                          const fixed alt, const fixed baroalt, const fixed t) = 0;
 
-  bool ScanBuffer(const char *buffer, IGCFix &fix);
-
   bool ReadPoint(IGCFix &fix);
 
 private:
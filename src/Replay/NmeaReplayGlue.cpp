@@ -56,6 +56,7 @@ NmeaReplayGlue::Start()
     CommonInterface::GetSystemSettings().devices[0];
 
   parser->SetIgnoreChecksum(config.ignore_checksum);
+  parser->SetTrafficStore(&device_blackboard->GetTrafficStore());
 
   /* instantiate it */
   const struct DeviceRegister *driver = FindDriverByName(config.driver_name);
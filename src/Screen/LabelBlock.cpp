@@ -24,11 +24,9 @@ Copyright_License {
 // simple code to prevent text writing over map city names
 #include "Screen/LabelBlock.hpp"
 
-void
-LabelBlock::Bucket::Clear()
-{
-  blocks.clear();
-}
+#include <algorithm>
+
+#include <assert.h>
 
 static gcc_pure bool
 CheckRectOverlap(const PixelRect& rc1, const PixelRect& rc2)
@@ -37,39 +35,76 @@ CheckRectOverlap(const PixelRect& rc1, const PixelRect& rc2)
     rc1.top < rc2.bottom && rc1.bottom > rc2.top;
 }
 
-bool
-LabelBlock::Bucket::Check(const PixelRect rc) const
+void
+LabelBlock::reset(UPixelScalar width, UPixelScalar height)
 {
-  for (auto i = blocks.begin(), end = blocks.end(); i != end; ++i)
-    if (CheckRectOverlap(*i, rc))
-      return false;
-
-  return true;
+  columns = std::min((unsigned(width) + CELL_SIZE - 1) >> CELL_SHIFT,
+                     unsigned(MAX_CELLS));
+  rows = std::min((unsigned(height) + CELL_SIZE - 1) >> CELL_SHIFT,
+                  unsigned(MAX_CELLS));
+  if (columns == 0)
+    columns = 1;
+  if (rows == 0)
+    rows = 1;
+
+  cells.assign(columns * rows, unsigned(NONE));
+  entries.clear();
+  rects.clear();
 }
 
-void LabelBlock::reset()
+unsigned
+LabelBlock::GetColumn(PixelScalar x) const
 {
-  for (unsigned i = 0; i < BUCKET_COUNT; ++i)
-    buckets[i].Clear();
+  if (x < 0)
+    return 0;
+
+  return std::min(unsigned(x) >> CELL_SHIFT, columns - 1);
 }
 
-bool LabelBlock::check(const PixelRect rc)
+unsigned
+LabelBlock::GetRow(PixelScalar y) const
 {
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
-
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
-
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
+  if (y < 0)
+    return 0;
 
-  if (top < bottom && !buckets[top].Check(rc))
-    return false;
+  return std::min(unsigned(y) >> CELL_SHIFT, rows - 1);
+}
 
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
+bool
+LabelBlock::check(const PixelRect rc)
+{
+  if (cells.empty())
+    /* reset() has not been called yet */
+    reset(1, 1);
+
+  const unsigned left = GetColumn(rc.left);
+  const unsigned right = GetColumn(rc.right - 1);
+  const unsigned top = GetRow(rc.top);
+  const unsigned bottom = GetRow(rc.bottom - 1);
+
+  for (unsigned row = top; row <= bottom; ++row) {
+    for (unsigned column = left; column <= right; ++column) {
+      for (unsigned i = cells[row * columns + column]; i != NONE;
+           i = entries[i].next) {
+        if (CheckRectOverlap(rects[entries[i].rect], rc))
+          return false;
+      }
+    }
+  }
+
+  const unsigned index = rects.size();
+  rects.push_back(rc);
+
+  for (unsigned row = top; row <= bottom; ++row) {
+    for (unsigned column = left; column <= right; ++column) {
+      unsigned &head = cells[row * columns + column];
+      const Entry entry = { index, head };
+      head = entries.size();
+      entries.push_back(entry);
+    }
+  }
+
+  assert(rects.size() <= entries.size());
 
   return true;
 }
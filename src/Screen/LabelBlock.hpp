@@ -25,52 +25,81 @@ Copyright_License {
 #define SCREEN_LABELBLOCK_HPP
 
 #include "Screen/Point.hpp"
-#include "Util/StaticArray.hpp"
+#include "Util/NonCopyable.hpp"
 #include "Compiler.h"
 
-class LabelBlock {
-#if defined(_WIN32_WCE) && _WIN32_WCE < 0x400
-  /* PPC2000 (ancient hardware, expect small screens) */
-  static const unsigned SCREEN_HEIGHT = 1024;
-  static const unsigned BUCKET_SIZE = 32;
-#elif defined(_WIN32_WCE) || defined(HAVE_GLES)
-  /* embedded (Android or Windows CE) */
-  static const unsigned SCREEN_HEIGHT = 2048;
-  static const unsigned BUCKET_SIZE = 64;
-#else
-  /* desktop, screen may be huge, lots of memory */
-  static const unsigned SCREEN_HEIGHT = 4096;
-  static const unsigned BUCKET_SIZE = 64;
-#endif
-  static const unsigned BUCKET_SHIFT = 7;
-  static const unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static const unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
+#include <vector>
+
+/**
+ * Prevents map labels from being drawn over each other: check()
+ * accepts a label rectangle only if it does not overlap one which
+ * was accepted before.  Labels must therefore be checked in order of
+ * decreasing priority.
+ *
+ * The accepted rectangles are indexed by a uniform grid covering the
+ * screen, with a singly linked list of rectangles per cell, so a
+ * check only looks at the labels in its neighbourhood.  Rectangles
+ * outside of the screen are attributed to the border cells.  The
+ * storage is kept by reset(), and after the first few frames, no
+ * memory is allocated.
+ */
+class LabelBlock : private NonCopyable {
+  static const unsigned CELL_SHIFT = 6;
+  static const unsigned CELL_SIZE = 1 << CELL_SHIFT;
 
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * The maximum number of rows and columns; a larger screen shares
+   * the last ones.
    */
-  class Bucket {
-    typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
-    BlockArray blocks;
+  static const unsigned MAX_CELLS = 64;
 
-  public:
-    void Clear();
+  static const unsigned NONE = unsigned(-1);
 
-    gcc_pure
-    bool Check(const PixelRect rc) const;
+  struct Entry {
+    /** index into #rects */
+    unsigned rect;
 
-    void Add(const PixelRect rc) {
-      if (!blocks.full())
-        blocks.append(rc);
-    }
+    /** the next entry of the same cell, or #NONE */
+    unsigned next;
   };
 
-  Bucket buckets[BUCKET_COUNT];
+  unsigned columns, rows;
+
+  /** the first entry of each cell, or #NONE */
+  std::vector<unsigned> cells;
+
+  std::vector<Entry> entries;
+  std::vector<PixelRect> rects;
 
 public:
+  LabelBlock():columns(0), rows(0) {}
+
+  /**
+   * Remove all labels, and resize the grid for a new screen size.
+   */
+  void reset(UPixelScalar width, UPixelScalar height);
+
+  /**
+   * Check whether the specified label rectangle is still free, and
+   * if so, reserve it.
+   *
+   * @return true if the label may be drawn
+   */
   bool check(const PixelRect rc);
-  void reset();
+
+  /**
+   * Returns the number of labels accepted since the last reset().
+   */
+  unsigned size() const {
+    return rects.size();
+  }
+
+private:
+  gcc_pure
+  unsigned GetColumn(PixelScalar x) const;
+
+  gcc_pure
+  unsigned GetRow(PixelScalar y) const;
 };
 
 #endif
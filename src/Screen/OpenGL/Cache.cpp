@@ -26,15 +26,20 @@ Copyright_License {
 #include "Screen/OpenGL/Debug.hpp"
 #include "Screen/OpenGL/Point.hpp"
 #include "Screen/Font.hpp"
-#include "Screen/Color.hpp"
+
+#ifdef ANDROID
 #include "Util/ListHead.hpp"
 #include "Util/Cache.hpp"
 #include "Util/StringUtil.hpp"
+#else
+#include "Screen/OpenGL/GlyphAtlas.hpp"
+#endif
 
 #include <unordered_map>
-#include <string>
 #include <assert.h>
 
+#ifdef ANDROID
+
 /**
  * A key type for the Cache template class.  It can be operated in two
  * modes: the zero-allocation mode is used by default; it stores a
@@ -133,13 +138,8 @@ struct RenderedText : public ListHead {
     other.texture = NULL;
   }
 
-#ifdef ANDROID
   RenderedText(int id, unsigned width, unsigned height)
     :texture(new GLTexture(id, width, height)) {}
-#else
-  RenderedText(SDL_Surface *surface)
-    :texture(new GLTexture(surface)) {}
-#endif
 
   ~RenderedText() {
     delete texture;
@@ -207,26 +207,12 @@ TextCache::Get(const Font *font, const char *text)
 
   /* render the text into a OpenGL texture */
 
-#ifdef ANDROID
   PixelSize size;
   int texture_id = font->TextTextureGL(text, size);
   if (texture_id == 0)
     return NULL;
 
   RenderedText rt(texture_id, size.cx, size.cy);
-#else
-  const Color background_color = COLOR_BLACK;
-  const Color text_color = COLOR_WHITE;
-  SDL_Surface *surface = ::TTF_RenderUTF8_Shaded(font->Native(), text,
-                                                 text_color, background_color);
-  if (surface == NULL)
-    return NULL;
-
-  /* insert into cache */
-
-  RenderedText rt(surface);
-  SDL_FreeSurface(surface);
-#endif
 
   GLTexture *texture = rt.texture;
 
@@ -246,3 +232,57 @@ TextCache::Flush()
   size_cache.Clear();
   text_cache.Clear();
 }
+
+#else
+
+/**
+ * The glyph atlases of all fonts.  The key is only used for the
+ * lookup; GetAtlas() compares the TTF_Font pointer, in case the
+ * #Font object has been reloaded.
+ */
+static std::unordered_map<const Font *, GlyphAtlas *> atlases;
+
+GlyphAtlas &
+TextCache::GetAtlas(const Font &font)
+{
+  assert(pthread_equal(pthread_self(), OpenGL::thread));
+  assert(font.IsDefined());
+
+  GlyphAtlas *&atlas = atlases[&font];
+  if (atlas != NULL && atlas->GetNative() != font.Native()) {
+    delete atlas;
+    atlas = NULL;
+  }
+
+  if (atlas == NULL)
+    atlas = new GlyphAtlas(font.Native());
+
+  return *atlas;
+}
+
+PixelSize
+TextCache::GetSize(const Font &font, const char *text)
+{
+  return GetAtlas(font).TextSize(text);
+}
+
+size_t
+TextCache::GetMemoryUsage()
+{
+  size_t result = 0;
+  for (auto i = atlases.begin(), end = atlases.end(); i != end; ++i)
+    result += i->second->GetMemoryUsage();
+  return result;
+}
+
+void
+TextCache::Flush()
+{
+  assert(pthread_equal(pthread_self(), OpenGL::thread));
+
+  for (auto i = atlases.begin(), end = atlases.end(); i != end; ++i)
+    delete i->second;
+  atlases.clear();
+}
+
+#endif
@@ -26,19 +26,42 @@ Copyright_License {
 
 #include "Compiler.h"
 
+#include <stddef.h>
+
 struct PixelSize;
 class GLTexture;
+class GlyphAtlas;
 class Font;
 
+/**
+ * On Android, whole strings are rendered (by Java code) into one
+ * texture each, and the most recently used ones are cached.  With
+ * SDL_ttf, text is composed from the glyphs in a #GlyphAtlas for each
+ * font.
+ */
 namespace TextCache {
   gcc_pure
   PixelSize GetSize(const Font &font, const char *text);
 
+#ifdef ANDROID
   gcc_pure
   PixelSize LookupSize(const Font &font, const char *text);
 
   gcc_pure
   GLTexture *Get(const Font *font, const char *text);
+#else
+  /**
+   * Returns the #GlyphAtlas of the specified font, and creates it if
+   * necessary.
+   */
+  GlyphAtlas &GetAtlas(const Font &font);
+
+  /**
+   * Returns the number of bytes occupied by all glyph atlas textures.
+   */
+  gcc_pure
+  size_t GetMemoryUsage();
+#endif
 
   void Flush();
 };
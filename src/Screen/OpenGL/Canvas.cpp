@@ -34,6 +34,10 @@ Copyright_License {
 #include "Screen/OpenGL/Compatibility.hpp"
 #include "Screen/Util.hpp"
 
+#ifndef ANDROID
+#include "Screen/OpenGL/GlyphAtlas.hpp"
+#endif
+
 #ifndef NDEBUG
 #include "Util/UTF8.hpp"
 #endif
@@ -117,30 +121,54 @@ Canvas::DrawRaisedEdge(PixelRect &rc)
 void
 Canvas::DrawPolyline(const RasterPoint *points, unsigned num_points)
 {
-  glVertexPointer(2, GL_VALUE, 0, points);
-
   pen.Bind();
+
+  if (pen.GetWidth() > 2) {
+    /* like DrawLinePiece(): wide lines are drawn as triangles, with
+       caps to hide the gaps at the joints */
+    unsigned strip_len = LineToTriangles(points, num_points, vertex_buffer,
+                                         pen.GetWidth(), false, true);
+    if (strip_len > 0) {
+      glVertexPointer(2, GL_VALUE, 0, vertex_buffer.begin());
+      glDrawArrays(GL_TRIANGLE_STRIP, 0, strip_len);
+      pen.Unbind();
+      return;
+    }
+  }
+
+  glVertexPointer(2, GL_VALUE, 0, points);
   glDrawArrays(GL_LINE_STRIP, 0, num_points);
   pen.Unbind();
 }
 
 void
 Canvas::DrawPolygon(const RasterPoint *points, unsigned num_points)
+{
+  if (brush.IsHollow() && !pen.IsDefined())
+    return;
+
+  static AllocatedArray<GLushort> triangle_buffer;
+  unsigned idx_count = 0;
+  if (!brush.IsHollow() && num_points >= 3)
+    idx_count = PolygonToTriangles(points, num_points, triangle_buffer);
+
+  DrawPolygon(points, num_points, triangle_buffer.begin(), idx_count);
+}
+
+void
+Canvas::DrawPolygon(const RasterPoint *points, unsigned num_points,
+                    const GLushort *triangles,
+                    unsigned num_triangle_indices)
 {
   if (brush.IsHollow() && !pen.IsDefined())
     return;
 
   glVertexPointer(2, GL_VALUE, 0, points);
 
-  if (!brush.IsHollow() && num_points >= 3) {
+  if (!brush.IsHollow() && num_triangle_indices > 0) {
     brush.Set();
-
-    static AllocatedArray<GLushort> triangle_buffer;
-    unsigned idx_count = PolygonToTriangles(points, num_points,
-                                            triangle_buffer);
-    if (idx_count > 0)
-      glDrawElements(GL_TRIANGLES, idx_count, GL_UNSIGNED_SHORT,
-                     triangle_buffer.begin());
+    glDrawElements(GL_TRIANGLES, num_triangle_indices, GL_UNSIGNED_SHORT,
+                   triangles);
   }
 
   if (pen_over_brush()) {
@@ -447,6 +475,39 @@ Canvas::DrawFocusRectangle(PixelRect rc)
   DrawOutlineRectangle(rc.left, rc.top, rc.right, rc.bottom, COLOR_DARK_GRAY);
 }
 
+#ifndef ANDROID
+
+/**
+ * Draws the text which was laid out by GlyphAtlas::Prepare().
+ *
+ * @param cut_out cut out the shape of the glyphs in black before
+ * drawing them in the text color?  This is not necessary on a black
+ * opaque background
+ */
+static void
+DrawPreparedText(GlyphAtlas &atlas, bool cut_out, const Color text_color)
+{
+  GLEnable scope(GL_TEXTURE_2D);
+  atlas.Bind();
+  GLLogicOp logic_op(GL_AND_INVERTED);
+
+  if (cut_out) {
+    /* cut out the shape in black */
+    OpenGL::glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    atlas.Draw();
+  }
+
+  if (text_color != COLOR_BLACK) {
+    /* draw the text color on top */
+    OpenGL::glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    logic_op.set(GL_OR);
+    text_color.Set();
+    atlas.Draw();
+  }
+}
+
+#endif
+
 void
 Canvas::text(PixelScalar x, PixelScalar y, const TCHAR *text)
 {
@@ -461,6 +522,18 @@ Canvas::text(PixelScalar x, PixelScalar y, const TCHAR *text)
   if (font == NULL)
     return;
 
+#ifndef ANDROID
+  GlyphAtlas &atlas = TextCache::GetAtlas(*font);
+  const PixelSize size = atlas.Prepare(text, x, y);
+
+  if (background_mode == OPAQUE)
+    /* draw the opaque background */
+    DrawFilledRectangle(x, y, x + size.cx, y + size.cy, background_color);
+
+  DrawPreparedText(atlas,
+                   background_mode != OPAQUE || background_color != COLOR_BLACK,
+                   text_color);
+#else
   GLTexture *texture = TextCache::Get(font, text);
   if (texture == NULL)
     return;
@@ -488,6 +561,7 @@ Canvas::text(PixelScalar x, PixelScalar y, const TCHAR *text)
     text_color.Set();
     texture->Draw(x, y);
   }
+#endif
 }
 
 void
@@ -504,6 +578,11 @@ Canvas::text_transparent(PixelScalar x, PixelScalar y, const TCHAR *text)
   if (font == NULL)
     return;
 
+#ifndef ANDROID
+  GlyphAtlas &atlas = TextCache::GetAtlas(*font);
+  atlas.Prepare(text, x, y);
+  DrawPreparedText(atlas, true, text_color);
+#else
   GLTexture *texture = TextCache::Get(font, text);
   if (texture == NULL)
     return;
@@ -523,6 +602,7 @@ Canvas::text_transparent(PixelScalar x, PixelScalar y, const TCHAR *text)
     text_color.Set();
     texture->Draw(x, y);
   }
+#endif
 }
 
 void
@@ -541,6 +621,11 @@ Canvas::TextClipped(PixelScalar x, PixelScalar y,
   if (font == NULL)
     return;
 
+#ifndef ANDROID
+  GlyphAtlas &atlas = TextCache::GetAtlas(*font);
+  atlas.Prepare(text, x, y, width, height);
+  DrawPreparedText(atlas, true, text_color);
+#else
   GLTexture *texture = TextCache::Get(font, text);
   if (texture == NULL)
     return;
@@ -565,6 +650,7 @@ Canvas::TextClipped(PixelScalar x, PixelScalar y,
     text_color.Set();
     texture->Draw(x, y, width, height, 0, 0, width, height);
   }
+#endif
 }
 
 void
@@ -260,6 +260,19 @@ public:
 
   void DrawPolygon(const RasterPoint *points, unsigned num_points);
 
+  /**
+   * Like DrawPolygon(), but uses triangles which were calculated
+   * before by PolygonToTriangles(), for polygons which are drawn
+   * repeatedly.
+   *
+   * @param triangles the triangle indices
+   * @param num_triangle_indices the number of triangle indices; 0
+   * means the polygon is not filled
+   */
+  void DrawPolygon(const RasterPoint *points, unsigned num_points,
+                   const GLushort *triangles,
+                   unsigned num_triangle_indices);
+
   /**
    * Draw a triangle fan (GL_TRIANGLE_FAN).  The first point is the
    * origin of the fan.
@@ -0,0 +1,399 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Screen/OpenGL/GlyphAtlas.hpp"
+#include "Screen/OpenGL/Texture.hpp"
+#include "Util/UTF8.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+GlyphAtlas::GlyphAtlas(TTF_Font *_font)
+  :font(_font),
+   ascent(TTF_FontAscent(_font)), line_height(TTF_FontHeight(_font)),
+   texture(NULL), height(INITIAL_HEIGHT),
+   shelf_x(0), shelf_y(0), shelf_height(0),
+   generation(0)
+{
+  assert(font != NULL);
+
+  for (unsigned i = 0; i < 0x100; ++i)
+    latin1[i].measured = latin1[i].rendered = false;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+  delete texture;
+}
+
+unsigned
+GlyphAtlas::GetGlyphCount() const
+{
+  unsigned n = 0;
+  for (unsigned i = 0; i < 0x100; ++i)
+    if (latin1[i].rendered)
+      ++n;
+
+  for (auto i = others.begin(), end = others.end(); i != end; ++i)
+    if (i->second.rendered)
+      ++n;
+
+  return n;
+}
+
+GlyphAtlas::Glyph &
+GlyphAtlas::Measure(unsigned ch)
+{
+  Glyph *glyph;
+  if (ch < 0x100) {
+    glyph = &latin1[ch];
+    if (glyph->measured)
+      return *glyph;
+  } else {
+    auto i = others.find(ch);
+    if (i != others.end())
+      return i->second;
+
+    glyph = &others[ch];
+  }
+
+  glyph->measured = true;
+  glyph->rendered = false;
+  glyph->x = glyph->y = 0;
+  glyph->width = glyph->height = 0;
+
+  int minx, maxx, miny, maxy, advance;
+  if (ch > 0xffff ||
+      TTF_GlyphMetrics(font, (Uint16)ch,
+                       &minx, &maxx, &miny, &maxy, &advance) != 0) {
+    /* SDL_ttf 2.0 supports only the basic multilingual plane */
+    glyph->left = glyph->top = glyph->advance = 0;
+    return *glyph;
+  }
+
+  glyph->left = minx;
+  glyph->top = ascent - maxy;
+  glyph->advance = advance;
+  return *glyph;
+}
+
+SDL_Surface *
+GlyphAtlas::Rasterise(unsigned ch) const
+{
+  assert(ch <= 0xffff);
+
+  /* white on black: the palette of the resulting 8 bit surface maps
+     each pixel value to the same luminance */
+  const SDL_Color text_color = { 0xff, 0xff, 0xff, 0 };
+  const SDL_Color background_color = { 0, 0, 0, 0 };
+  return TTF_RenderGlyph_Shaded(font, (Uint16)ch,
+                                text_color, background_color);
+}
+
+void
+GlyphAtlas::CreateTexture()
+{
+  assert(texture == NULL);
+
+  texture = new GLTexture(WIDTH, height);
+
+  /* replace the RGB storage allocated by GLTexture with an 8 bit
+     luminance image */
+  texture->Bind();
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, WIDTH, height, 0,
+               GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+}
+
+void
+GlyphAtlas::Upload(const SDL_Surface &surface, const Glyph &glyph)
+{
+  assert(texture != NULL);
+  assert(surface.format->BytesPerPixel == 1);
+  assert(glyph.width == surface.w);
+  assert(glyph.height == surface.h);
+
+  if (glyph.width == 0 || glyph.height == 0)
+    return;
+
+  texture->Bind();
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, surface.pitch);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, glyph.x, glyph.y,
+                  glyph.width, glyph.height,
+                  GL_LUMINANCE, GL_UNSIGNED_BYTE, surface.pixels);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+bool
+GlyphAtlas::Allocate(Glyph &glyph)
+{
+  /* leave one pixel between two glyphs, to avoid bleeding with
+     linear texture filtering */
+
+  if (shelf_x + glyph.width > WIDTH) {
+    /* start a new shelf */
+    shelf_y += shelf_height + 1;
+    shelf_x = 0;
+    shelf_height = 0;
+  }
+
+  if (glyph.width > WIDTH || shelf_y + glyph.height > height)
+    return false;
+
+  glyph.x = shelf_x;
+  glyph.y = shelf_y;
+
+  shelf_x += glyph.width + 1;
+  shelf_height = std::max(shelf_height, UPixelScalar(glyph.height));
+  return true;
+}
+
+void
+GlyphAtlas::Grow()
+{
+  assert(height < MAX_HEIGHT);
+
+  height *= 2;
+
+  delete texture;
+  texture = NULL;
+  CreateTexture();
+
+  /* the glyph positions don't change, because the width stays the
+     same; only the texture contents need to be restored */
+
+  for (unsigned i = 0; i < 0x100; ++i) {
+    const Glyph &glyph = latin1[i];
+    if (!glyph.rendered)
+      continue;
+
+    SDL_Surface *surface = Rasterise(i);
+    if (surface != NULL) {
+      Upload(*surface, glyph);
+      SDL_FreeSurface(surface);
+    }
+  }
+
+  for (auto i = others.begin(), end = others.end(); i != end; ++i) {
+    const Glyph &glyph = i->second;
+    if (!glyph.rendered)
+      continue;
+
+    SDL_Surface *surface = Rasterise(i->first);
+    if (surface != NULL) {
+      Upload(*surface, glyph);
+      SDL_FreeSurface(surface);
+    }
+  }
+}
+
+void
+GlyphAtlas::Clear()
+{
+  for (unsigned i = 0; i < 0x100; ++i)
+    latin1[i].rendered = false;
+
+  for (auto i = others.begin(), end = others.end(); i != end; ++i)
+    i->second.rendered = false;
+
+  shelf_x = shelf_y = shelf_height = 0;
+  ++generation;
+}
+
+const GlyphAtlas::Glyph &
+GlyphAtlas::Render(unsigned ch)
+{
+  Glyph &glyph = Measure(ch);
+  if (glyph.rendered || ch > 0xffff)
+    return glyph;
+
+  if (texture == NULL)
+    CreateTexture();
+
+  SDL_Surface *surface = Rasterise(ch);
+  if (surface == NULL) {
+    /* no bitmap (e.g. a space) */
+    glyph.width = glyph.height = 0;
+    glyph.rendered = true;
+    return glyph;
+  }
+
+  glyph.width = surface->w;
+  glyph.height = surface->h;
+
+  while (!Allocate(glyph)) {
+    if (height < MAX_HEIGHT)
+      Grow();
+    else if (shelf_x > 0 || shelf_y > 0)
+      Clear();
+    else {
+      /* this glyph is larger than the whole texture */
+      glyph.width = glyph.height = 0;
+      break;
+    }
+  }
+
+  if (glyph.width > 0)
+    Upload(*surface, glyph);
+  SDL_FreeSurface(surface);
+
+  glyph.rendered = true;
+  return glyph;
+}
+
+PixelSize
+GlyphAtlas::TextSize(const char *text)
+{
+  assert(text != NULL);
+
+  PixelScalar pen = 0, right = 0;
+
+  unsigned ch;
+  while ((ch = NextUTF8(text)) != 0) {
+    const Glyph &glyph = Measure(ch);
+    pen += glyph.advance;
+    right = std::max(right, pen);
+  }
+
+  return { right, PixelScalar(line_height) };
+}
+
+bool
+GlyphAtlas::Layout(const char *text, PixelScalar x, PixelScalar y,
+                   PixelScalar right, PixelScalar bottom, PixelSize &size)
+{
+  const unsigned start_generation = generation;
+
+  quads.clear();
+
+  PixelScalar pen = x;
+
+  unsigned ch;
+  while ((ch = NextUTF8(text)) != 0) {
+    const Glyph &glyph = Render(ch);
+    if (generation != start_generation)
+      /* the texture was cleared, and the quads of the previous
+         glyphs are stale */
+      return false;
+
+    Quad quad;
+    quad.dest.left = pen + glyph.left;
+    quad.dest.top = y + glyph.top;
+    quad.dest.right = quad.dest.left + glyph.width;
+    quad.dest.bottom = quad.dest.top + glyph.height;
+    quad.src.left = glyph.x;
+    quad.src.top = glyph.y;
+    quad.src.right = glyph.x + glyph.width;
+    quad.src.bottom = glyph.y + glyph.height;
+
+    pen += glyph.advance;
+
+    /* clip */
+
+    if (quad.dest.left < x) {
+      quad.src.left += x - quad.dest.left;
+      quad.dest.left = x;
+    }
+
+    if (quad.dest.top < y) {
+      quad.src.top += y - quad.dest.top;
+      quad.dest.top = y;
+    }
+
+    if (quad.dest.right > right) {
+      quad.src.right -= quad.dest.right - right;
+      quad.dest.right = right;
+    }
+
+    if (quad.dest.bottom > bottom) {
+      quad.src.bottom -= quad.dest.bottom - bottom;
+      quad.dest.bottom = bottom;
+    }
+
+    if (quad.dest.left < quad.dest.right && quad.dest.top < quad.dest.bottom)
+      quads.push_back(quad);
+  }
+
+  size.cx = pen - x;
+  size.cy = line_height;
+  return true;
+}
+
+PixelSize
+GlyphAtlas::Prepare(const char *text, PixelScalar x, PixelScalar y,
+                    UPixelScalar max_width, UPixelScalar max_height)
+{
+  assert(text != NULL);
+
+  const PixelScalar right = x + max_width, bottom = y + max_height;
+
+  PixelSize size;
+  if (!Layout(text, x, y, right, bottom, size) &&
+      !Layout(text, x, y, right, bottom, size))
+    /* the text does not fit into the texture, not even after it was
+       cleared; give up */
+    quads.clear();
+
+  return size;
+}
+
+void
+GlyphAtlas::Bind()
+{
+  if (texture != NULL)
+    texture->Bind();
+}
+
+void
+GlyphAtlas::Draw() const
+{
+  if (quads.empty())
+    return;
+
+  assert(texture != NULL);
+
+  const GLfloat scale_x = 1. / WIDTH, scale_y = 1. / height;
+
+  glBegin(GL_QUADS);
+
+  for (auto i = quads.begin(), end = quads.end(); i != end; ++i) {
+    const Quad &quad = *i;
+    const GLfloat x0 = quad.src.left * scale_x;
+    const GLfloat y0 = quad.src.top * scale_y;
+    const GLfloat x1 = quad.src.right * scale_x;
+    const GLfloat y1 = quad.src.bottom * scale_y;
+
+    glTexCoord2f(x0, y0);
+    glVertex2i(quad.dest.left, quad.dest.top);
+    glTexCoord2f(x1, y0);
+    glVertex2i(quad.dest.right, quad.dest.top);
+    glTexCoord2f(x1, y1);
+    glVertex2i(quad.dest.right, quad.dest.bottom);
+    glTexCoord2f(x0, y1);
+    glVertex2i(quad.dest.left, quad.dest.bottom);
+  }
+
+  glEnd();
+}
@@ -0,0 +1,218 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_OPENGL_GLYPH_ATLAS_HPP
+#define XCSOAR_SCREEN_OPENGL_GLYPH_ATLAS_HPP
+
+#include "Screen/OpenGL/Features.hpp"
+#include "Screen/OpenGL/Point.hpp"
+#include "Util/NonCopyable.hpp"
+#include "Compiler.h"
+
+#ifdef ANDROID
+#error The glyph atlas requires SDL_ttf
+#endif
+
+#include <SDL_ttf.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+class GLTexture;
+
+/**
+ * All glyphs of one font that have been drawn so far, rasterised
+ * into one luminance texture.  Text is drawn by composing glyph
+ * quads, so a new string does not need to be rasterised, and text
+ * measurements need only the (cached) glyph metrics.
+ *
+ * Glyphs are packed into rows ("shelves") of the texture.  When it is
+ * full, its height is doubled up to #MAX_HEIGHT; after that, all
+ * glyphs are discarded and rasterised again on demand.
+ *
+ * Kerning is not applied, neither by TextSize() nor by Prepare().
+ */
+class GlyphAtlas : private NonCopyable {
+  static gcc_constexpr_data unsigned WIDTH = 512;
+  static gcc_constexpr_data unsigned INITIAL_HEIGHT = 64;
+  static gcc_constexpr_data unsigned MAX_HEIGHT = 512;
+
+  struct Glyph {
+    /** the position of the bitmap in the texture */
+    uint16_t x, y;
+
+    /** the size of the bitmap */
+    uint16_t width, height;
+
+    /**
+     * The offset of the bitmap relative to the pen position and the
+     * top of the line.
+     */
+    int16_t left, top;
+
+    int16_t advance;
+
+    bool measured, rendered;
+  };
+
+  /**
+   * One glyph quad of the text which was laid out by Prepare().
+   */
+  struct Quad {
+    PixelRect dest;
+    PixelRect src;
+  };
+
+  TTF_Font *const font;
+
+  const int ascent;
+  const UPixelScalar line_height;
+
+  GLTexture *texture;
+  UPixelScalar height;
+
+  /** the insertion point of the next glyph */
+  UPixelScalar shelf_x, shelf_y, shelf_height;
+
+  /**
+   * Incremented each time all rendered glyphs are discarded.
+   */
+  unsigned generation;
+
+  /**
+   * Fast lookup table for the Latin-1 range.
+   */
+  Glyph latin1[0x100];
+
+  std::unordered_map<unsigned, Glyph> others;
+
+  std::vector<Quad> quads;
+
+public:
+  explicit GlyphAtlas(TTF_Font *font);
+  ~GlyphAtlas();
+
+  TTF_Font *GetNative() const {
+    return font;
+  }
+
+  /**
+   * Returns the number of bytes occupied by the texture.
+   */
+  gcc_pure
+  size_t GetMemoryUsage() const {
+    return size_t(WIDTH) * height;
+  }
+
+  /**
+   * Returns the number of glyphs currently stored in the texture.
+   */
+  gcc_pure
+  unsigned GetGlyphCount() const;
+
+  /**
+   * Calculates the size of the specified UTF-8 string.  This does not
+   * rasterise any glyph.
+   */
+  PixelSize TextSize(const char *text);
+
+  /**
+   * Rasterises all glyphs of the specified UTF-8 string, and lays
+   * them out at the specified position, clipped to the specified
+   * size.  The result is kept until the next call, and is drawn by
+   * Draw().
+   *
+   * @return the (unclipped) size of the text
+   */
+  PixelSize Prepare(const char *text, PixelScalar x, PixelScalar y,
+                    UPixelScalar max_width=0x7fff,
+                    UPixelScalar max_height=0x7fff);
+
+  /**
+   * Binds the texture.
+   */
+  void Bind();
+
+  /**
+   * Draws the text laid out by the last Prepare() call with the
+   * current texture environment.  Call Bind() before this method.
+   */
+  void Draw() const;
+
+private:
+  /**
+   * Returns the glyph of the specified character, with metrics but
+   * possibly without a bitmap.
+   */
+  Glyph &Measure(unsigned ch);
+
+  /**
+   * Like Measure(), but ensures that the glyph has been rasterised
+   * into the texture.
+   */
+  const Glyph &Render(unsigned ch);
+
+  /**
+   * Rasterises a glyph with SDL_ttf.  The caller is responsible for
+   * freeing the surface.
+   */
+  SDL_Surface *Rasterise(unsigned ch) const;
+
+  /**
+   * Copies a rasterised glyph into the texture at the glyph's
+   * position.
+   */
+  void Upload(const SDL_Surface &surface, const Glyph &glyph);
+
+  /**
+   * Reserves space for a bitmap of the specified size.
+   *
+   * @return false if the texture is full
+   */
+  bool Allocate(Glyph &glyph);
+
+  /**
+   * Doubles the height of the texture, and uploads all glyphs again.
+   */
+  void Grow();
+
+  /**
+   * Discards all glyph bitmaps.
+   */
+  void Clear();
+
+  void CreateTexture();
+
+  /**
+   * Lays out the text; returns false if a glyph could not be
+   * rasterised without discarding the texture contents, in which case
+   * the caller needs to start over.
+   */
+  bool Layout(const char *text, PixelScalar x, PixelScalar y,
+              PixelScalar right, PixelScalar bottom, PixelSize &size);
+};
+
+#endif
@@ -195,10 +195,12 @@ Canvas::CalcTextSize(const TCHAR *text) const
     return size;
 
 #ifdef ENABLE_OPENGL
+#ifdef ANDROID
   /* see if the TextCache can handle this request */
   size = TextCache::LookupSize(*font, text);
   if (size.cy > 0)
     return size;
+#endif
 
   return TextCache::GetSize(*font, text);
 #else
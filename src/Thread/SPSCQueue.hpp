@@ -0,0 +1,145 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_SPSC_QUEUE_HPP
+#define XCSOAR_THREAD_SPSC_QUEUE_HPP
+
+#include "Util/NonCopyable.hpp"
+
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * A fixed-size lock-free ring buffer which passes items from exactly
+ * one producer thread to exactly one consumer thread.  It stores up
+ * to "size-1" items (for the full/empty distinction).
+ *
+ * Each side modifies only its own index, and the memory barriers
+ * order the index update against the item access.  The producer and
+ * the consumer may each be changed at any time, as long as there is
+ * never more than one of each at once.
+ */
+template<typename T, unsigned size>
+class SPSCQueue : private NonCopyable {
+  T data[size];
+
+  /**
+   * The index of the oldest item; only modified by the consumer.
+   */
+  volatile unsigned head;
+
+  /**
+   * The index of the next free slot; only modified by the producer.
+   */
+  volatile unsigned tail;
+
+  static unsigned Next(unsigned i) {
+    assert(i < size);
+
+    return (i + 1) % size;
+  }
+
+public:
+  SPSCQueue():head(0), tail(0) {}
+
+  bool IsEmpty() const {
+    return head == tail;
+  }
+
+  /**
+   * Producer: obtain the slot for the next item.  Fill it, and then
+   * call CommitPush().
+   *
+   * @return NULL if the queue is full
+   */
+  T *BeginPush() {
+    const unsigned t = tail;
+    if (Next(t) == head)
+      return NULL;
+
+    /* don't touch the slot before the consumer has released it */
+    __sync_synchronize();
+    return &data[t];
+  }
+
+  /**
+   * Producer: make the item obtained by BeginPush() visible to the
+   * consumer.
+   */
+  void CommitPush() {
+    assert(Next(tail) != head);
+
+    __sync_synchronize();
+    tail = Next(tail);
+  }
+
+  /**
+   * Producer: append a copy of the specified item.
+   *
+   * @return false if the queue is full
+   */
+  bool Push(const T &value) {
+    T *slot = BeginPush();
+    if (slot == NULL)
+      return false;
+
+    *slot = value;
+    CommitPush();
+    return true;
+  }
+
+  /**
+   * Consumer: return the oldest item without removing it.
+   *
+   * @return NULL if the queue is empty
+   */
+  const T *Peek() const {
+    const unsigned h = head;
+    if (h == tail)
+      return NULL;
+
+    /* don't read the item before the producer has committed it */
+    __sync_synchronize();
+    return &data[h];
+  }
+
+  /**
+   * Consumer: remove the item returned by Peek().
+   */
+  void Shift() {
+    assert(!IsEmpty());
+
+    __sync_synchronize();
+    head = Next(head);
+  }
+
+  /**
+   * Consumer: discard all items.
+   */
+  void Clear() {
+    __sync_synchronize();
+    head = tail;
+  }
+};
+
+#endif
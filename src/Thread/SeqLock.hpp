@@ -0,0 +1,155 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_SEQ_LOCK_HPP
+#define XCSOAR_THREAD_SEQ_LOCK_HPP
+
+#include "Util/NonCopyable.hpp"
+#include "OS/Sleep.h"
+
+#include <assert.h>
+
+/**
+ * A sequence lock: a synchronisation primitive for data which is
+ * written by one thread and read by many.  The writer never waits;
+ * instead, a reader detects that it has raced with the writer, and
+ * copies again.
+ *
+ * The sequence number is odd while a write is in progress.  A read
+ * is valid if the number was even before the copy, and has not
+ * changed after it.
+ *
+ * Writers must be serialised by the caller (usually there is only
+ * one thread which modifies the data).
+ */
+class SeqLock : private NonCopyable {
+  volatile unsigned sequence;
+
+public:
+  SeqLock():sequence(0) {}
+
+  void BeginWrite() {
+    assert((sequence & 1) == 0);
+
+    sequence = sequence + 1;
+    __sync_synchronize();
+  }
+
+  void EndWrite() {
+    assert((sequence & 1) == 1);
+
+    __sync_synchronize();
+    sequence = sequence + 1;
+  }
+
+  /**
+   * Start reading.  If the writer is busy, yield to let it finish
+   * first.
+   *
+   * @return the sequence number to be passed to EndRead()
+   */
+  unsigned BeginRead() const {
+    unsigned result;
+    while (((result = sequence) & 1) != 0)
+      Sleep(0);
+
+    __sync_synchronize();
+    return result;
+  }
+
+  /**
+   * Finish reading.
+   *
+   * @return true if the data which was read is consistent, false if
+   * it must be read again
+   */
+  bool EndRead(unsigned start) const {
+    __sync_synchronize();
+    return sequence == start;
+  }
+};
+
+/**
+ * A value which is published with a #SeqLock.  The type must be
+ * safe to copy even while it is being modified, i.e. it must not
+ * own pointers or other resources (all blackboard structs qualify).
+ */
+template<typename T>
+class SeqLocked : private NonCopyable {
+  SeqLock lock;
+  T value;
+
+public:
+  /**
+   * Replace the value.  Concurrent calls must be serialised by the
+   * caller.
+   */
+  void Write(const T &src) {
+    lock.BeginWrite();
+    value = src;
+    lock.EndWrite();
+  }
+
+  /**
+   * Copy a consistent snapshot of the value.
+   *
+   * @return the number of additional copies which were necessary
+   * because the writer was active at the same time
+   */
+  unsigned Read(T &dest) const {
+    unsigned retries = 0;
+
+    while (true) {
+      const unsigned start = lock.BeginRead();
+      dest = value;
+      if (lock.EndRead(start))
+        return retries;
+
+      ++retries;
+    }
+  }
+
+  /**
+   * Like Read(), but don't copy if the value has not been modified
+   * since the previous call.
+   *
+   * @param sequence the sequence number of the copy in #dest, updated
+   * by this method; initialise with 0 to force a copy
+   * @return true if the value was copied
+   */
+  bool ReadIfModified(T &dest, unsigned &sequence) const {
+    while (true) {
+      const unsigned start = lock.BeginRead();
+      if (start == sequence)
+        return false;
+
+      dest = value;
+      if (lock.EndRead(start)) {
+        sequence = start;
+        return true;
+      }
+    }
+  }
+};
+
+#endif
@@ -27,6 +27,8 @@ Copyright_License {
 #include "Thread/SuspensibleThread.hpp"
 #include "Thread/Trigger.hpp"
 
+#include <assert.h>
+
 /**
  * A thread which performs regular work in background.
  */
@@ -49,6 +51,19 @@ public:
   WorkerThread(unsigned period_min=0, unsigned idle_min=0,
                unsigned delay=0);
 
+  /**
+   * Change the timing parameters passed to the constructor.  This
+   * may only be called before the thread is started.
+   */
+  void SetPeriod(unsigned _period_min, unsigned _idle_min,
+                 unsigned _delay) {
+    assert(!IsDefined());
+
+    period_min = _period_min;
+    idle_min = _idle_min;
+    delay = _delay;
+  }
+
   /**
    * Wakes up the thread to do work, calls tick().
    */
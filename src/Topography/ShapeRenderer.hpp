@@ -30,6 +30,7 @@ Copyright_License {
 #include "Util/AllocatedArray.hpp"
 #include "Screen/Canvas.hpp"
 #include "Screen/Brush.hpp"
+#include "Projection/Projection.hpp"
 
 #include <assert.h>
 
@@ -77,6 +78,28 @@ public:
       AddPoint(pt);
   }
 
+  /**
+   * Converts the GeoPoints to screen coordinates (in one batch), and
+   * adds them like AddPointIfDistant() does.
+   *
+   * @param last always add the last point, even if it is close to
+   * the previous one
+   */
+  void AddGeoPointsIfDistant(const Projection &projection,
+                             const GeoPoint *src, unsigned n, bool last) {
+    assert(num_points + n <= points.size());
+
+    RasterPoint *const dest = points.begin() + num_points;
+    projection.GeoToScreen(src, dest, n);
+
+    /* filter in place; the write position never overtakes the read
+       position */
+    for (unsigned i = 0; i < n; ++i)
+      if (num_points == 0 || (last && i == n - 1) ||
+          manhattan_distance(points[num_points - 1], dest[i]) >= 8)
+        points[num_points++] = dest[i];
+  }
+
   void FinishPolyline(Canvas &canvas) {
     if (mode != OUTLINE) {
       canvas.Select(*pen);
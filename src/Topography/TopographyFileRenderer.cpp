@@ -258,12 +258,9 @@ TopographyFileRenderer::Paint(Canvas &canvas,
         unsigned msize = *lines;
         shape_renderer.Begin(msize);
 
-        const GeoPoint *end = points + msize - 1;
-        for (; points < end; ++points)
-          shape_renderer.AddPointIfDistant(projection.GeoToScreen(*points));
-
         // make sure we always draw the last point
-        shape_renderer.AddPoint(projection.GeoToScreen(*points));
+        shape_renderer.AddGeoPointsIfDistant(projection, points, msize, true);
+        points += msize;
 
         shape_renderer.FinishPolyline(canvas);
       }
@@ -305,12 +302,8 @@ TopographyFileRenderer::Paint(Canvas &canvas,
           continue;
 
         shape_renderer.Begin(msize);
-
-        for (unsigned i = 0; i < msize; ++i) {
-          GeoPoint g = geo_points[i];
-          shape_renderer.AddPointIfDistant(projection.GeoToScreen(g));
-        }
-
+        shape_renderer.AddGeoPointsIfDistant(projection, geo_points.begin(),
+                                             msize, false);
         shape_renderer.FinishPolygon(canvas);
       }
 #endif
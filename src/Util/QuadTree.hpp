@@ -31,10 +31,13 @@
 #define XCSOAR_QUAD_TREE_HPP
 
 #include "Util/NonCopyable.hpp"
+#include "Compiler.h"
 
 #include <utility>
 #include <limits>
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 #include <assert.h>
 
@@ -53,6 +56,10 @@
  * Elements may be removed at any time, but the bounds are not
  * modified then.
  *
+ * Optimise() bulk-loads the whole tree in one pass: the values are
+ * sorted along the tree's own subdivision (a Z-order curve) and each
+ * bucket is created exactly once.
+ *
  * @see http://en.wikipedia.org/wiki/Quadtree
  */
 template<typename T, typename Accessor,
@@ -101,6 +108,18 @@ public:
     return x * x;
   }
 
+  /**
+   * Calculate the square of a search range.  Unlike Square(), this
+   * does not overflow; ranges which are too large are clipped to
+   * max_distance().
+   */
+  gcc_const
+  static distance_type SquareRange(distance_type range) {
+    return range < (1u << (std::numeric_limits<distance_type>::digits / 2))
+      ? Square(range)
+      : max_distance();
+  }
+
   /**
    * A location on the plane.
    */
@@ -281,6 +300,24 @@ protected:
 
   typedef typename Alloc::template rebind<Leaf>::other LeafAllocator;
 
+  /**
+   * A Leaf and its position, used by the bulk loader.  Keeping a
+   * copy of the position here avoids dereferencing the Leaf while
+   * partitioning.
+   */
+  struct BulkItem {
+    Point position;
+    Leaf *leaf;
+
+    /**
+     * Constructor for the scratch buffer; the value is undefined.
+     */
+    BulkItem():position(0, 0) {}
+
+    explicit BulkItem(Leaf *_leaf)
+      :position(_leaf->GetPosition()), leaf(_leaf) {}
+  };
+
   struct LeafList {
     /* a linked list of values, or NULL if this is a splitted bucket */
     Leaf *head;
@@ -420,14 +457,14 @@ protected:
       distance_type nearest_square_distance = max_distance();
 
       for (const Leaf *i = head; i != NULL; i = i->next) {
-        if (!predicate(i->value))
+        distance_type square_distance = i->SquareDistanceTo(location);
+        if (square_distance > square_range ||
+            (nearest != NULL && square_distance >= nearest_square_distance) ||
+            !predicate(i->value))
           continue;
 
-        distance_type square_distance = i->SquareDistanceTo(location);
-        if (square_distance < nearest_square_distance) {
-          nearest_square_distance = square_distance;
-          nearest = i;
-        }
+        nearest_square_distance = square_distance;
+        nearest = i;
       }
 
       return std::make_pair(nearest, nearest_square_distance);
@@ -620,13 +657,27 @@ protected:
       children = NULL;
     }
 
-    void Optimise(const Rectangle &bounds,
-                  BucketAllocator &bucket_allocator) {
-      if (leaves.GetSize() < SPLIT_THRESHOLD)
+    /**
+     * Fill this empty bucket with the specified leaves, and create
+     * child buckets as needed.  The array is reordered along the
+     * subdivision of the tree, i.e. by the Z-order (Morton code) of
+     * the positions.  Each leaf list is linked in array order.
+     *
+     * @param scratch a buffer with the same size as the array
+     */
+    void BulkLoad(const Rectangle &bounds, BulkItem *begin, BulkItem *end,
+                  BulkItem *scratch, BucketAllocator &bucket_allocator) {
+      assert(IsEmpty());
+
+      if (unsigned(end - begin) < SPLIT_THRESHOLD || !bounds.CanSplit()) {
+        for (BulkItem *i = end; i != begin;)
+          AddHere((--i)->leaf);
         return;
+      }
 
-      Split(bounds.GetMiddle(), bucket_allocator);
-      children->Optimise(bounds, bucket_allocator);
+      children = bucket_allocator.allocate(1);
+      bucket_allocator.construct(children, QuadBucket(this));
+      children->BulkLoad(bounds, begin, end, scratch, bucket_allocator);
     }
 
     /**
@@ -696,7 +747,11 @@ protected:
     FindNearestIf(const Rectangle &bounds,
                   const Point location, distance_type square_range,
                   const P &predicate) const {
-      if (!bounds.IsWithinSquareRange(location, square_range))
+      /* empty bounds are unknown (a "flat" tree before Optimise()) or
+         degenerate; then this is the root bucket, and it is not
+         splitted, so the leaf list checks the range by itself */
+      if (!bounds.IsEmpty() &&
+          !bounds.IsWithinSquareRange(location, square_range))
         return std::make_pair(const_iterator(), max_distance());
 
       if (IsSplitted()) {
@@ -717,7 +772,9 @@ protected:
     void VisitWithinRange(const Rectangle &bounds,
                           const Point location, distance_type square_range,
                           V &visitor) const {
-      if (!bounds.IsWithinSquareRange(location, square_range))
+      /* see FindNearestIf() */
+      if (!bounds.IsEmpty() &&
+          !bounds.IsWithinSquareRange(location, square_range))
         return;
 
       if (IsSplitted())
@@ -737,8 +794,22 @@ protected:
         buckets[i].parent = parent;
     }
 
+    gcc_const
+    static unsigned GetIndex(bool right, bool bottom) {
+      return (bottom << 1) | right;
+    }
+
+    /**
+     * Returns the index of the child which contains the specified
+     * position.
+     */
+    gcc_const
+    static unsigned GetIndex(const Point position, const Point middle) {
+      return GetIndex(position.x >= middle.x, position.y >= middle.y);
+    }
+
     Bucket &Get(bool right, bool bottom) {
-      return buckets[(bottom << 1) | right];
+      return buckets[GetIndex(right, bottom)];
     }
 
     const Bucket *GetNext(const Bucket *bucket) {
@@ -789,15 +860,60 @@ protected:
       return Rectangle(middle.x, middle.y, r.right, r.bottom);
     }
 
-    void Optimise(const Rectangle &bounds, BucketAllocator &bucket_allocator) {
+    gcc_const
+    static Rectangle GetChildBounds(const Rectangle r, const Point middle,
+                                    unsigned i) {
+      switch (i) {
+      case 0:
+        return GetTopLeft(r, middle);
+
+      case 1:
+        return GetTopRight(r, middle);
+
+      case 2:
+        return GetBottomLeft(r, middle);
+
+      default:
+        return GetBottomRight(r, middle);
+      }
+    }
+
+    /**
+     * Distribute the items to the four children with a counting
+     * sort through the scratch buffer.  Unlike std::partition(), this
+     * does not branch on the (random) positions.
+     */
+    void BulkLoad(const Rectangle &bounds, BulkItem *begin, BulkItem *end,
+                  BulkItem *scratch, BucketAllocator &bucket_allocator) {
       const Point middle = bounds.GetMiddle();
 
-      buckets[0].Optimise(GetTopLeft(bounds, middle), bucket_allocator);
-      buckets[1].Optimise(GetTopRight(bounds, middle), bucket_allocator);
-      buckets[2].Optimise(GetBottomLeft(bounds, middle), bucket_allocator);
-      buckets[3].Optimise(GetBottomRight(bounds, middle), bucket_allocator);
+      unsigned count[N] = { 0, 0, 0, 0 };
+      for (const BulkItem *i = begin; i != end; ++i)
+        ++count[GetIndex(i->position, middle)];
+
+      BulkItem *dest[N];
+      dest[0] = scratch;
+      for (unsigned i = 1; i < N; ++i)
+        dest[i] = dest[i - 1] + count[i - 1];
+
+      for (const BulkItem *i = begin; i != end; ++i)
+        *dest[GetIndex(i->position, middle)]++ = *i;
+
+      std::copy(scratch, scratch + (end - begin), begin);
+
+      for (unsigned i = 0; i < N; ++i) {
+        BulkItem *const child_end = begin + count[i];
+        buckets[i].BulkLoad(GetChildBounds(bounds, middle, i),
+                            begin, child_end, scratch, bucket_allocator);
+        scratch += count[i];
+        begin = child_end;
+      }
     }
 
+    /**
+     * Search the children nearest-first, and narrow the search
+     * range after each hit, so farther children are skipped early.
+     */
     template<class P>
     std::pair<const_iterator, distance_type>
     FindNearestIf(const Rectangle &bounds,
@@ -805,32 +921,36 @@ protected:
                   const P &predicate) const {
       const Point middle = bounds.GetMiddle();
 
-      auto result =
-        buckets[0].FindNearestIf(GetTopLeft(bounds, middle),
-                                 location, square_range,
-                                 predicate);
-
-      square_range = result.second;
-      auto tmp =
-        buckets[1].FindNearestIf(GetTopRight(bounds, middle),
-                                 location, square_range,
-                                 predicate);
-      if (tmp.second < result.second)
-        result = tmp;
-
-      square_range = result.second;
-      tmp = buckets[2].FindNearestIf(GetBottomLeft(bounds, middle),
-                                     location, square_range,
-                                     predicate);
-      if (tmp.second < result.second)
-        result = tmp;
-
-      square_range = result.second;
-      tmp = buckets[3].FindNearestIf(GetBottomRight(bounds, middle),
-                                     location, square_range,
-                                     predicate);
-      if (tmp.second < result.second)
-        result = tmp;
+      Rectangle child_bounds[N];
+      distance_type child_distance[N];
+      unsigned order[N];
+      for (unsigned i = 0; i < N; ++i) {
+        child_bounds[i] = GetChildBounds(bounds, middle, i);
+        child_distance[i] = child_bounds[i].SquareDistanceTo(location);
+
+        /* insertion sort by distance */
+        unsigned j = i;
+        for (; j > 0 && child_distance[order[j - 1]] > child_distance[i]; --j)
+          order[j] = order[j - 1];
+        order[j] = i;
+      }
+
+      std::pair<const_iterator, distance_type> result(const_iterator(),
+                                                      max_distance());
+
+      for (unsigned k = 0; k < N; ++k) {
+        const unsigned i = order[k];
+        if (child_distance[i] > square_range)
+          /* this one and all following children are out of range */
+          break;
+
+        const auto tmp = buckets[i].FindNearestIf(child_bounds[i], location,
+                                                  square_range, predicate);
+        if (tmp.first != const_iterator() && tmp.second <= square_range) {
+          result = tmp;
+          square_range = tmp.second;
+        }
+      }
 
       return result;
     }
@@ -954,12 +1074,33 @@ public:
   }
 
   /**
-   * Rescan the bounds and rebuild the tree.
+   * Rescan the bounds and rebuild the tree.  This is a bulk load:
+   * all values are partitioned along the tree's subdivision in one
+   * pass, instead of splitting buckets one at a time.  References to
+   * values remain valid.
    */
   void Optimise() {
     Flatten();
-    if (ScanBounds())
-      root.Optimise(bounds, bucket_allocator);
+    ClearBounds();
+
+    if (root.leaves.IsEmpty())
+      return;
+
+    std::vector<BulkItem> items;
+    items.reserve(root.leaves.GetSize());
+
+    while (!root.leaves.IsEmpty()) {
+      items.push_back(BulkItem(root.leaves.Pop()));
+
+      if (items.size() == 1)
+        bounds.Set(items.front().position);
+      else
+        bounds.Scan(items.back().position);
+    }
+
+    std::vector<BulkItem> scratch(items.size());
+    root.BulkLoad(bounds, &items.front(), &items.front() + items.size(),
+                  &scratch.front(), bucket_allocator);
   }
 
   /**
@@ -1273,7 +1414,7 @@ public:
   std::pair<const_iterator, distance_type>
   FindNearestIf(const Point location, distance_type range,
                 const P &predicate) const {
-    return root.FindNearestIf(bounds, location, Square(range),
+    return root.FindNearestIf(bounds, location, SquareRange(range),
                               predicate);
   }
 
@@ -1288,7 +1429,8 @@ public:
   gcc_pure
   std::pair<const_iterator, distance_type>
   FindNearest(const Point location, distance_type range) const {
-    return root.FindNearestIf(bounds, location, range, AlwaysTrue());
+    return root.FindNearestIf(bounds, location, SquareRange(range),
+                              AlwaysTrue());
   }
 
   gcc_pure
@@ -1306,7 +1448,7 @@ public:
   template<class V>
   void VisitWithinRange(const Point location, distance_type range,
                         V &visitor) const {
-    root.VisitWithinRange(bounds, location, Square(range), visitor);
+    root.VisitWithinRange(bounds, location, SquareRange(range), visitor);
   }
 
   template<class V>
@@ -148,3 +148,44 @@ LengthUTF8(const char *p)
       ++n;
   return n;
 }
+
+unsigned
+NextUTF8(const char *&p)
+{
+  const unsigned char ch = *p;
+  if (ch < 0x80) {
+    /* ASCII */
+    if (ch != 0)
+      ++p;
+    return ch;
+  }
+
+  unsigned n, result;
+  if ((ch & 0xe0) == 0xc0) {
+    n = 1;
+    result = ch & 0x1f;
+  } else if ((ch & 0xf0) == 0xe0) {
+    n = 2;
+    result = ch & 0x0f;
+  } else if ((ch & 0xf8) == 0xf0) {
+    n = 3;
+    result = ch & 0x07;
+  } else {
+    /* continuation without a prefix, or a sequence which is too
+       long */
+    ++p;
+    return 0xfffd;
+  }
+
+  for (unsigned i = 1; i <= n; ++i) {
+    if (!IsContinuation(p[i])) {
+      p += i;
+      return 0xfffd;
+    }
+
+    result = (result << 6) | (p[i] & 0x3f);
+  }
+
+  p += n + 1;
+  return result;
+}
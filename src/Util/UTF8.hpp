@@ -63,4 +63,15 @@ gcc_pure
 size_t
 LengthUTF8(const char *p);
 
+/**
+ * Decode the UTF-8 character at the specified position, and advance
+ * the pointer to the next one.  Each malformed (or truncated)
+ * sequence is skipped and returned as one U+FFFD.
+ *
+ * @return the unicode code point, or 0 at the end of the string (in
+ * which case the pointer is not advanced)
+ */
+unsigned
+NextUTF8(const char *&p);
+
 #endif
@@ -135,7 +135,8 @@ SettingsLeave(const UISettings &old_ui_settings)
 
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
-    WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+    WaypointGlue::LoadWaypoints(way_points, terrain, file_cache,
+                                operation);
     WaypointDetails::ReadFileFromProfile(way_points, operation);
   }
 
@@ -179,7 +180,7 @@ SettingsLeave(const UISettings &old_ui_settings)
     airspace_database.clear();
     ReadAirspace(airspace_database, terrain,
                  CommonInterface::GetComputerSettings().pressure,
-                 operation);
+                 file_cache, operation);
   }
 
   if (DevicePortChanged)
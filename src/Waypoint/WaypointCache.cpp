@@ -0,0 +1,185 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WaypointCache.hpp"
+#include "Waypoint/Waypoints.hpp"
+
+#include <vector>
+#include <algorithm>
+
+struct WaypointCacheHeader {
+  enum {
+#ifdef FIXED_MATH
+    VERSION = 0x10,
+#else
+    VERSION = 0x11,
+#endif
+  };
+
+  unsigned version;
+
+  /** sizeof(TCHAR) and sizeof(WaypointCacheRecord), to detect
+      incompatible builds */
+  unsigned char_size, record_size;
+
+  unsigned num_waypoints, num_characters;
+};
+
+/**
+ * The fixed-size attributes of a waypoint.  The strings (name,
+ * comment, details) are stored in a separate character array, each
+ * one null-terminated.
+ */
+struct WaypointCacheRecord {
+  GeoPoint location;
+  fixed elevation;
+  unsigned original_id;
+  Runway runway;
+  RadioFrequency radio_frequency;
+  Waypoint::Type type;
+  Waypoint::Flags flags;
+  int8_t file_num;
+};
+
+struct WaypointIdCompare {
+  bool operator()(const Waypoint *a, const Waypoint *b) const {
+    return a->id < b->id;
+  }
+};
+
+static void
+AppendString(std::vector<TCHAR> &characters, const tstring &s)
+{
+  characters.insert(characters.end(), s.c_str(), s.c_str() + s.length() + 1);
+}
+
+bool
+SaveWaypointCache(FILE *file, const Waypoints &waypoints, unsigned first_id)
+{
+  /* restore the order in which the waypoints were appended */
+  std::vector<const Waypoint *> sorted;
+  for (auto i = waypoints.begin(), end = waypoints.end(); i != end; ++i)
+    if (i->id >= first_id)
+      sorted.push_back(&*i);
+
+  std::sort(sorted.begin(), sorted.end(), WaypointIdCompare());
+
+  std::vector<WaypointCacheRecord> records;
+  records.reserve(sorted.size());
+  std::vector<TCHAR> characters;
+
+  for (auto i = sorted.begin(); i != sorted.end(); ++i) {
+    const Waypoint &waypoint = **i;
+
+    WaypointCacheRecord record;
+    record.location = waypoint.location;
+    record.elevation = waypoint.elevation;
+    record.original_id = waypoint.original_id;
+    record.runway = waypoint.runway;
+    record.radio_frequency = waypoint.radio_frequency;
+    record.type = waypoint.type;
+    record.flags = waypoint.flags;
+    record.file_num = waypoint.file_num;
+    records.push_back(record);
+
+    AppendString(characters, waypoint.name);
+    AppendString(characters, waypoint.comment);
+    AppendString(characters, waypoint.details);
+  }
+
+  WaypointCacheHeader header;
+  header.version = WaypointCacheHeader::VERSION;
+  header.char_size = sizeof(TCHAR);
+  header.record_size = sizeof(WaypointCacheRecord);
+  header.num_waypoints = records.size();
+  header.num_characters = characters.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fwrite(records.data(), sizeof(records.front()), records.size(),
+           file) == records.size() &&
+    fwrite(characters.data(), sizeof(characters.front()), characters.size(),
+           file) == characters.size();
+}
+
+/**
+ * Returns the next null-terminated string from the character array,
+ * or NULL if the array is exhausted.
+ */
+static const TCHAR *
+NextString(const TCHAR *&p, const TCHAR *end)
+{
+  const TCHAR *s = p;
+  while (p < end)
+    if (*p++ == _T('\0'))
+      return s;
+
+  return NULL;
+}
+
+bool
+LoadWaypointCache(FILE *file, Waypoints &waypoints)
+{
+  WaypointCacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != WaypointCacheHeader::VERSION ||
+      header.char_size != sizeof(TCHAR) ||
+      header.record_size != sizeof(WaypointCacheRecord) ||
+      header.num_waypoints > 1000000 ||
+      header.num_characters > 100000000)
+    return false;
+
+  std::vector<WaypointCacheRecord> records(header.num_waypoints);
+  std::vector<TCHAR> characters(header.num_characters);
+
+  if (fread(records.data(), sizeof(records.front()), records.size(),
+            file) != records.size() ||
+      fread(characters.data(), sizeof(characters.front()), characters.size(),
+            file) != characters.size())
+    return false;
+
+  /* check the strings before modifying the #Waypoints object */
+  const TCHAR *const end = characters.data() + characters.size();
+  const TCHAR *p = characters.data();
+  for (unsigned i = 0; i < 3 * records.size(); ++i)
+    if (NextString(p, end) == NULL)
+      return false;
+
+  p = characters.data();
+  for (auto i = records.begin(); i != records.end(); ++i) {
+    Waypoint waypoint(i->location);
+    waypoint.elevation = i->elevation;
+    waypoint.original_id = i->original_id;
+    waypoint.runway = i->runway;
+    waypoint.radio_frequency = i->radio_frequency;
+    waypoint.type = i->type;
+    waypoint.flags = i->flags;
+    waypoint.file_num = i->file_num;
+    waypoint.name = NextString(p, end);
+    waypoint.comment = NextString(p, end);
+    waypoint.details = NextString(p, end);
+
+    waypoints.Append(waypoint);
+  }
+
+  return true;
+}
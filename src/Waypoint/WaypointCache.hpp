@@ -0,0 +1,53 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_WAYPOINT_CACHE_HPP
+#define XCSOAR_WAYPOINT_CACHE_HPP
+
+#include <stdio.h>
+
+class Waypoints;
+
+/**
+ * Write all waypoints with an id equal to or greater than the
+ * specified one to a cache file opened by FileCache::Save().  This
+ * is meant to be called right after a waypoint file has been parsed;
+ * the waypoint ids are allocated sequentially by Waypoints::Append().
+ *
+ * Only the attributes set by the waypoint file parsers are saved;
+ * the projection and the search trees are rebuilt by
+ * Waypoints::Optimise(), and the details (files, long descriptions)
+ * are attached later by WaypointDetails.
+ */
+bool
+SaveWaypointCache(FILE *file, const Waypoints &waypoints, unsigned first_id);
+
+/**
+ * Load a cache file opened by FileCache::Load(), and append all of
+ * its waypoints to the #Waypoints object, in the order they were
+ * parsed.  On error, the #Waypoints object is not modified.
+ */
+bool
+LoadWaypointCache(FILE *file, Waypoints &waypoints);
+
+#endif
@@ -116,3 +116,60 @@ WaypointFilter::Matches(const Waypoint &waypoint, GeoPoint location,
          (!positive(distance) || CompareName(waypoint)) &&
          CompareDirection(waypoint, location);
 }
+
+static gcc_constexpr_function unsigned
+TypeBit(TypeFilter type)
+{
+  return 1u << (unsigned)type;
+}
+
+unsigned
+WaypointFilter::GetTypeMask(const Waypoint &waypoint)
+{
+  unsigned mask = 0;
+
+  if (waypoint.IsAirport())
+    mask |= TypeBit(TypeFilter::AIRPORT);
+
+  if (waypoint.IsLandable())
+    mask |= TypeBit(TypeFilter::LANDABLE);
+
+  if (waypoint.IsTurnpoint())
+    mask |= TypeBit(TypeFilter::TURNPOINT);
+
+  if (waypoint.IsStartpoint())
+    mask |= TypeBit(TypeFilter::START);
+
+  if (waypoint.IsFinishpoint())
+    mask |= TypeBit(TypeFilter::FINISH);
+
+  if (waypoint.file_num == 1)
+    mask |= TypeBit(TypeFilter::FILE_1);
+  else if (waypoint.file_num == 2)
+    mask |= TypeBit(TypeFilter::FILE_2);
+
+  return mask;
+}
+
+unsigned
+WaypointFilter::GetTypeMask(TypeFilter type)
+{
+  switch (type) {
+  case TypeFilter::AIRPORT:
+  case TypeFilter::LANDABLE:
+  case TypeFilter::TURNPOINT:
+  case TypeFilter::START:
+  case TypeFilter::FINISH:
+  case TypeFilter::FILE_1:
+  case TypeFilter::FILE_2:
+    return TypeBit(type);
+
+  case TypeFilter::ALL:
+  case TypeFilter::FAI_TRIANGLE_LEFT:
+  case TypeFilter::FAI_TRIANGLE_RIGHT:
+  case TypeFilter::LAST_USED:
+    break;
+  }
+
+  return 0;
+}
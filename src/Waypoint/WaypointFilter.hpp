@@ -27,6 +27,7 @@ Copyright_License {
 #include "Util/StaticString.hpp"
 #include "Math/fixed.hpp"
 #include "Math/Angle.hpp"
+#include "Compiler.h"
 
 #include <stdint.h>
 
@@ -77,6 +78,22 @@ struct WaypointFilter
 
   bool Matches(const Waypoint &waypoint, GeoPoint location,
                const FAITrianglePointValidator &triangle_validator) const;
+
+  /**
+   * Returns a bit mask of all #TypeFilter values which match the
+   * specified waypoint.  Only filters which depend solely on the
+   * waypoint itself are included.
+   */
+  gcc_pure
+  static unsigned GetTypeMask(const Waypoint &waypoint);
+
+  /**
+   * Returns the bit a waypoint must have in its GetTypeMask() to pass
+   * the specified type filter, or 0 if the filter cannot be decided
+   * by the mask (e.g. #TypeFilter::ALL or the FAI triangle filters).
+   */
+  gcc_const
+  static unsigned GetTypeMask(TypeFilter type);
 };
 
 #endif
@@ -0,0 +1,543 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WaypointFilterIndex.hpp"
+#include "WaypointFilter.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Math/Earth.hpp"
+#include "Util/StringUtil.hpp"
+#include "Util/StaticString.hpp"
+
+#include <algorithm>
+#include <queue>
+
+#include <ctype.h>
+
+/**
+ * Don't make cells smaller than this, or a small waypoint file would
+ * produce a ridiculously fine grid.
+ */
+static const fixed MIN_CELL_SIZE = Angle::Degrees(fixed(0.01)).Radians();
+
+/**
+ * The direction filter accepts waypoints within this angle of the
+ * requested direction.  This is a little more than
+ * WaypointFilter::CompareDirection(), which does the final check.
+ */
+static const Angle DIRECTION_TOLERANCE = Angle::Degrees(fixed(20));
+
+/**
+ * Square of the cosine of #DIRECTION_TOLERANCE.
+ */
+static const fixed COS_SQUARE_TOLERANCE = sqr(DIRECTION_TOLERANCE.cos());
+
+/**
+ * Does the normalized form of the string (see
+ * NormalizeSearchString()) begin with the specified normalized
+ * prefix?  This normalizes only as much of the string as needed, and
+ * does not need a buffer.
+ */
+gcc_pure
+static bool
+NormalizedStartsWith(const TCHAR *string, const TCHAR *prefix)
+{
+  for (; !StringIsEmpty(prefix); ++string) {
+    if (StringIsEmpty(string))
+      return false;
+
+    if (static_cast<unsigned>(*string) < 128 && _istalnum(*string)) {
+      if ((TCHAR)_totupper(*string) != *prefix)
+        return false;
+
+      ++prefix;
+    }
+  }
+
+  return true;
+}
+
+WaypointFilterIndex::UnitVector::UnitVector(const GeoPoint &p)
+{
+  const auto lat = p.latitude.SinCos();
+  const auto lon = p.longitude.SinCos();
+  x = lat.second * lon.second;
+  y = lat.second * lon.first;
+  z = lat.first;
+}
+
+/**
+ * Convert an angular distance on the unit sphere to a square chord
+ * length.
+ */
+gcc_const
+static fixed
+AngleToSquareChord(fixed angle)
+{
+  return fixed_two - fixed_two * cos(angle);
+}
+
+/**
+ * Calculates the distance between a value and an interval, or zero
+ * if the value is inside the interval.
+ */
+gcc_const
+static fixed
+IntervalDistance(fixed value, fixed min, fixed max)
+{
+  if (value < min)
+    return min - value;
+  if (value > max)
+    return value - max;
+  return fixed_zero;
+}
+
+/**
+ * Like IntervalDistance(), but for longitudes, which wrap around.
+ */
+gcc_const
+static fixed
+LongitudeIntervalDistance(fixed value, fixed min, fixed max)
+{
+  return std::min(IntervalDistance(value, min, max),
+                  std::min(IntervalDistance(value + fixed_two_pi, min, max),
+                           IntervalDistance(value - fixed_two_pi, min, max)));
+}
+
+void
+WaypointFilterIndex::Clear()
+{
+  waypoints = NULL;
+  items.clear();
+  cells.clear();
+  columns = rows = 0;
+}
+
+unsigned
+WaypointFilterIndex::GetColumn(fixed longitude) const
+{
+  assert(columns > 0);
+
+  if (longitude <= west)
+    return 0;
+
+  const unsigned column = (unsigned)((longitude - west) / cell_size);
+  return std::min(column, columns - 1);
+}
+
+unsigned
+WaypointFilterIndex::GetRow(fixed latitude) const
+{
+  assert(rows > 0);
+
+  if (latitude <= south)
+    return 0;
+
+  const unsigned row = (unsigned)((latitude - south) / cell_size);
+  return std::min(row, rows - 1);
+}
+
+void
+WaypointFilterIndex::Update(const Waypoints &_waypoints)
+{
+  if (waypoints == &_waypoints && serial == _waypoints.GetSerial())
+    return;
+
+  Clear();
+
+  waypoints = &_waypoints;
+  serial = _waypoints.GetSerial();
+
+  if (_waypoints.IsEmpty())
+    return;
+
+  fixed east = fixed_zero, north = fixed_zero;
+  bool first = true;
+  for (auto it = _waypoints.begin(), end = _waypoints.end();
+       it != end; ++it) {
+    const fixed longitude = it->location.longitude.Radians();
+    const fixed latitude = it->location.latitude.Radians();
+
+    if (first) {
+      west = east = longitude;
+      south = north = latitude;
+      first = false;
+    } else {
+      west = std::min(west, longitude);
+      east = std::max(east, longitude);
+      south = std::min(south, latitude);
+      north = std::max(north, latitude);
+    }
+  }
+
+  const unsigned n = _waypoints.size();
+
+  /* aim for about one waypoint per cell; densely populated areas
+     will have more, but the type masks and the best-first search
+     keep that cheap */
+  const fixed width = east - west, height = north - south;
+  cell_size = std::max(sqrt(width * height / n), MIN_CELL_SIZE);
+  columns = (unsigned)(width / cell_size) + 1;
+  rows = (unsigned)(height / cell_size) + 1;
+
+  /* counting sort: order the items by cell */
+
+  cells.resize(columns * rows);
+  for (auto i = cells.begin(), end = cells.end(); i != end; ++i) {
+    i->begin = i->end = 0;
+    i->type_mask = 0;
+  }
+
+  std::vector<unsigned> item_cells;
+  item_cells.reserve(n);
+
+  for (auto it = _waypoints.begin(), end = _waypoints.end();
+       it != end; ++it) {
+    const unsigned index = GetRow(it->location.latitude.Radians()) * columns +
+      GetColumn(it->location.longitude.Radians());
+    item_cells.push_back(index);
+
+    Cell &cell = cells[index];
+    ++cell.end;
+    cell.type_mask |= WaypointFilter::GetTypeMask(*it);
+  }
+
+  unsigned position = 0;
+  for (auto i = cells.begin(), end = cells.end(); i != end; ++i) {
+    const unsigned size = i->end;
+    i->begin = i->end = position;
+    position += size;
+  }
+
+  items.resize(n);
+
+  auto index = item_cells.begin();
+  for (auto it = _waypoints.begin(), end = _waypoints.end();
+       it != end; ++it, ++index) {
+    Item &item = items[cells[*index].end++];
+    item.waypoint = &*it;
+    item.vector = UnitVector(it->location);
+    item.type_mask = WaypointFilter::GetTypeMask(*it);
+  }
+}
+
+/**
+ * Evaluates a #WaypointFilterIndex::Query for one waypoint.
+ *
+ * Distances are compared as square chord lengths between unit
+ * vectors, which is monotonic with the great circle distance.  The
+ * initial great circle bearing is the direction of the waypoint
+ * vector projected on the tangent plane at the search location, so
+ * no trigonometric function is needed per waypoint.
+ */
+class WaypointFilterIndex::Matcher {
+  UnitVector origin;
+
+  /** unit vectors pointing east and north at #origin */
+  UnitVector east, north;
+
+  bool limited;
+  fixed square_range;
+
+  unsigned type_mask;
+
+  bool have_name;
+
+  /**
+   * The normalized name prefix.  The waypoint dialog limits the name
+   * filter to WaypointFilter::NAME_LENGTH characters.
+   */
+  StaticString<WaypointFilter::NAME_LENGTH + 1> name_prefix;
+
+  bool have_direction;
+  fixed direction_east, direction_north;
+
+public:
+  Matcher(const Query &query)
+    :origin(query.location),
+     limited(positive(query.range) && query.range < fixed_pi * REARTH),
+     square_range(AngleToSquareChord(query.range / REARTH)),
+     type_mask(query.type_mask),
+     have_name(query.name_prefix != NULL &&
+               !StringIsEmpty(query.name_prefix)),
+     have_direction(!negative(query.direction.Native())) {
+    const auto lat = query.location.latitude.SinCos();
+    const auto lon = query.location.longitude.SinCos();
+    east.x = -lon.first;
+    east.y = lon.second;
+    east.z = fixed_zero;
+    north.x = -lat.first * lon.second;
+    north.y = -lat.first * lon.first;
+    north.z = lat.second;
+
+    if (have_name) {
+      const StaticString<WaypointFilter::NAME_LENGTH + 1>
+        prefix(query.name_prefix);
+      NormalizeSearchString(name_prefix.buffer(), prefix.c_str());
+    }
+
+    if (have_direction) {
+      const auto sc = query.direction.SinCos();
+      direction_east = sc.first;
+      direction_north = sc.second;
+    }
+  }
+
+  bool IsLimited() const {
+    return limited;
+  }
+
+  fixed GetSquareRange() const {
+    return square_range;
+  }
+
+  bool HasName() const {
+    return have_name;
+  }
+
+  bool CheckTypeMask(unsigned mask) const {
+    return type_mask == 0 || (mask & type_mask) != 0;
+  }
+
+  /**
+   * Check the location of a waypoint and calculate its distance.
+   *
+   * @return false if the waypoint is out of range or not in the
+   * requested direction
+   */
+  bool CheckLocation(const UnitVector &v, fixed &square_distance_r) const {
+    const fixed square_distance = sqr(v.x - origin.x) +
+      sqr(v.y - origin.y) + sqr(v.z - origin.z);
+    if (limited && square_distance > square_range)
+      return false;
+
+    if (have_direction) {
+      const fixed e = v.x * east.x + v.y * east.y;
+      const fixed n = v.x * north.x + v.y * north.y + v.z * north.z;
+      const fixed dot = e * direction_east + n * direction_north;
+      if (negative(dot) ||
+          sqr(dot) < (sqr(e) + sqr(n)) * COS_SQUARE_TOLERANCE)
+        return false;
+    }
+
+    square_distance_r = square_distance;
+    return true;
+  }
+
+  gcc_pure
+  bool CheckName(const Waypoint &wp) const {
+    if (!have_name)
+      return true;
+
+    return NormalizedStartsWith(wp.name.c_str(), name_prefix.c_str());
+  }
+};
+
+unsigned
+WaypointFilterIndex::VisitNearest(const Query &query,
+                                  WaypointVisitor &visitor,
+                                  unsigned max_results) const
+{
+  if (items.empty() || max_results == 0)
+    return 0;
+
+  const Matcher matcher(query);
+
+  if (matcher.HasName() && !matcher.IsLimited())
+    /* without a range, the name tree is the better index */
+    return VisitNamePrefix(query, visitor, max_results);
+
+  const fixed longitude = query.location.longitude.Radians();
+  const fixed latitude = query.location.latitude.Radians();
+
+  /* determine the cells which may contain matches */
+
+  unsigned min_column = 0, max_column = columns - 1;
+  unsigned min_row = 0, max_row = rows - 1;
+
+  if (matcher.IsLimited()) {
+    const fixed range = query.range / REARTH;
+    min_row = GetRow(latitude - range);
+    max_row = GetRow(latitude + range);
+
+    if (range < fixed_half_pi - fabs(latitude)) {
+      /* the search circle doesn't contain a pole; calculate the
+         maximum longitude difference within it */
+      const fixed range_longitude = asin(sin(range) / cos(latitude));
+      if (longitude - range_longitude > -fixed_pi &&
+          longitude + range_longitude < fixed_pi) {
+        min_column = GetColumn(longitude - range_longitude);
+        max_column = GetColumn(longitude + range_longitude);
+      }
+    }
+  }
+
+  /* the great circle distance between the search location and a
+     point in a cell is at least the latitude difference, and at least
+     the distance to the meridian through the search location, which
+     is asin(cos(point latitude) * sin(longitude difference)); compare
+     the cosines of these lower bounds to avoid calling asin() per
+     cell */
+
+  std::vector<fixed> column_sin_dlon;
+  column_sin_dlon.reserve(max_column - min_column + 1);
+  for (unsigned column = min_column; column <= max_column; ++column) {
+    const fixed cell_west = west + column * cell_size;
+    const fixed dlon = LongitudeIntervalDistance(longitude, cell_west,
+                                                 cell_west + cell_size);
+    /* beyond 90 degrees, the meridian distance is not monotonic;
+       don't bother */
+    column_sin_dlon.push_back(dlon < fixed_half_pi ? sin(dlon) : fixed_zero);
+  }
+
+  std::vector<CellCandidate> candidate_cells;
+  for (unsigned row = min_row; row <= max_row; ++row) {
+    const fixed cell_south = south + row * cell_size;
+    const fixed cell_north = cell_south + cell_size;
+    const fixed cos_dlat =
+      cos(IntervalDistance(latitude, cell_south, cell_north));
+    const fixed cos_max_latitude =
+      cos(std::min(std::max(fabs(cell_south), fabs(cell_north)),
+                   fixed_half_pi));
+
+    for (unsigned column = min_column; column <= max_column; ++column) {
+      const unsigned index = row * columns + column;
+      const Cell &cell = cells[index];
+      if (cell.IsEmpty() || !matcher.CheckTypeMask(cell.type_mask))
+        continue;
+
+      const fixed sin_meridian_distance =
+        cos_max_latitude * column_sin_dlon[column - min_column];
+      const fixed cos_distance =
+        std::min(cos_dlat, sqrt(fixed_one - sqr(sin_meridian_distance)));
+
+      CellCandidate candidate;
+      candidate.square_distance = fixed_two - fixed_two * cos_distance;
+      if (matcher.IsLimited() &&
+          candidate.square_distance > matcher.GetSquareRange())
+        continue;
+
+      candidate.index = index;
+      candidate_cells.push_back(candidate);
+    }
+  }
+
+  std::sort(candidate_cells.begin(), candidate_cells.end());
+
+  /* best-first search: a pending waypoint may be emitted as soon as
+     it is nearer than the lower bound of the next cell */
+
+  std::priority_queue<Candidate> pending;
+  unsigned n = 0;
+
+  for (auto i = candidate_cells.begin(), end = candidate_cells.end();
+       i != end; ++i) {
+    while (!pending.empty() &&
+           pending.top().square_distance <= i->square_distance) {
+      visitor.Visit(*pending.top().waypoint);
+      pending.pop();
+      if (++n == max_results)
+        return n;
+    }
+
+    const Cell &cell = cells[i->index];
+    for (auto j = items.begin() + cell.begin, jend = items.begin() + cell.end;
+         j != jend; ++j) {
+      Candidate candidate;
+      if (!matcher.CheckTypeMask(j->type_mask) ||
+          !matcher.CheckLocation(j->vector, candidate.square_distance) ||
+          !matcher.CheckName(*j->waypoint))
+        continue;
+
+      candidate.waypoint = j->waypoint;
+      pending.push(candidate);
+    }
+  }
+
+  while (!pending.empty()) {
+    visitor.Visit(*pending.top().waypoint);
+    pending.pop();
+    if (++n == max_results)
+      break;
+  }
+
+  return n;
+}
+
+class WaypointFilterIndex::CandidateCollector : public WaypointVisitor {
+  std::vector<Candidate> &candidates;
+  const Matcher &matcher;
+
+public:
+  CandidateCollector(std::vector<Candidate> &_candidates,
+                     const Matcher &_matcher)
+    :candidates(_candidates), matcher(_matcher) {}
+
+  virtual void Visit(const Waypoint &wp) {
+    Candidate candidate;
+    if (!matcher.CheckTypeMask(WaypointFilter::GetTypeMask(wp)) ||
+        !matcher.CheckLocation(UnitVector(wp.location),
+                               candidate.square_distance))
+      return;
+
+    candidate.waypoint = &wp;
+    candidates.push_back(candidate);
+  }
+};
+
+/**
+ * Orders #Candidate objects by increasing distance (the opposite of
+ * its operator<()).
+ */
+struct NearerCandidate {
+  template<typename T>
+  bool operator()(const T &a, const T &b) const {
+    return a.square_distance < b.square_distance;
+  }
+};
+
+unsigned
+WaypointFilterIndex::VisitNamePrefix(const Query &query,
+                                     WaypointVisitor &visitor,
+                                     unsigned max_results) const
+{
+  assert(waypoints != NULL);
+
+  /* the name tree checks the name, the collector doesn't need to */
+  Query query2 = query;
+  query2.name_prefix = NULL;
+  const Matcher matcher(query2);
+
+  std::vector<Candidate> candidates;
+  CandidateCollector collector(candidates, matcher);
+  waypoints->VisitNamePrefix(query.name_prefix, collector);
+
+  const unsigned n = std::min(max_results, (unsigned)candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + n,
+                    candidates.end(), NearerCandidate());
+
+  for (unsigned i = 0; i < n; ++i)
+    visitor.Visit(*candidates[i].waypoint);
+
+  return n;
+}
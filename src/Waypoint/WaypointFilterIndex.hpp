@@ -0,0 +1,208 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_WAYPOINT_FILTER_INDEX_HPP
+#define XCSOAR_WAYPOINT_FILTER_INDEX_HPP
+
+#include "Util/NonCopyable.hpp"
+#include "Util/Serial.hpp"
+#include "Math/fixed.hpp"
+#include "Math/Angle.hpp"
+#include "Engine/Navigation/GeoPoint.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <tchar.h>
+
+struct Waypoint;
+class Waypoints;
+class WaypointVisitor;
+
+/**
+ * A uniform latitude/longitude grid over all waypoints, which
+ * answers the combined range/type/name queries of the waypoint list
+ * without visiting every waypoint.
+ *
+ * Each grid cell stores the bitwise "or" of the
+ * WaypointFilter::GetTypeMask() values of its waypoints, so cells
+ * without a matching waypoint are skipped entirely.  A name prefix
+ * is resolved through the name tree of #Waypoints instead.
+ *
+ * Matches are passed to the visitor ordered by increasing distance
+ * (best-first search over the cells), which means the caller neither
+ * has to sort the result nor wait for the whole grid to be scanned
+ * when it needs only the nearest few.
+ *
+ * The index is rebuilt by Update() whenever the #Waypoints serial
+ * changes.
+ */
+class WaypointFilterIndex : private NonCopyable {
+public:
+  struct Query {
+    GeoPoint location;
+
+    /**
+     * The maximum distance [m]; zero or negative means unlimited.
+     */
+    fixed range;
+
+    /**
+     * A waypoint must have at least one of these bits in its
+     * WaypointFilter::GetTypeMask(); 0 disables type filtering.
+     */
+    unsigned type_mask;
+
+    /**
+     * Only consider waypoints with this name prefix (compared
+     * case-insensitively, ignoring punctuation); NULL or empty
+     * disables name filtering.
+     */
+    const TCHAR *name_prefix;
+
+    /**
+     * Only consider waypoints roughly in this direction, seen from
+     * #location; a negative value disables direction filtering.
+     */
+    Angle direction;
+
+    Query(const GeoPoint &_location)
+      :location(_location), range(fixed_zero), type_mask(0),
+       name_prefix(NULL), direction(Angle::Native(fixed_minus_one)) {}
+  };
+
+private:
+  /**
+   * A point on the unit sphere.
+   */
+  struct UnitVector {
+    fixed x, y, z;
+
+    UnitVector() = default;
+    explicit UnitVector(const GeoPoint &p);
+  };
+
+  struct Item {
+    const Waypoint *waypoint;
+
+    UnitVector vector;
+
+    unsigned type_mask;
+  };
+
+  struct Cell {
+    /** the range of this cell's waypoints in #items */
+    unsigned begin, end;
+
+    /** the combined type mask of all waypoints in this cell */
+    unsigned type_mask;
+
+    bool IsEmpty() const {
+      return begin == end;
+    }
+  };
+
+  /**
+   * A candidate cell of a query, with the lower bound of the (square
+   * chord) distance between the search location and any point of the
+   * cell.
+   */
+  struct CellCandidate {
+    fixed square_distance;
+    unsigned index;
+
+    bool operator<(const CellCandidate &other) const {
+      return square_distance < other.square_distance;
+    }
+  };
+
+  /**
+   * A matching waypoint of a query which has not been passed to the
+   * visitor yet.
+   */
+  struct Candidate {
+    fixed square_distance;
+    const Waypoint *waypoint;
+
+    /** reversed, to make std::priority_queue a min-heap */
+    bool operator<(const Candidate &other) const {
+      return square_distance > other.square_distance;
+    }
+  };
+
+  class Matcher;
+  class CandidateCollector;
+
+  const Waypoints *waypoints;
+  Serial serial;
+
+  /** the south-west corner of the grid [radians] */
+  fixed west, south;
+
+  /** the edge length of one cell [radians] */
+  fixed cell_size;
+
+  unsigned columns, rows;
+
+  std::vector<Item> items;
+  std::vector<Cell> cells;
+
+public:
+  WaypointFilterIndex():waypoints(NULL), columns(0), rows(0) {}
+
+  /**
+   * Rebuild the index if the specified #Waypoints object is not the
+   * one it was built from, or if it has been modified since.
+   */
+  void Update(const Waypoints &waypoints);
+
+  void Clear();
+
+  bool IsEmpty() const {
+    return items.empty();
+  }
+
+  /**
+   * Pass all waypoints matching the query to the visitor, nearest
+   * first.  The result is a superset of what WaypointFilter would
+   * accept, because the direction and distance checks are
+   * approximations.
+   *
+   * @param max_results stop after this number of waypoints
+   * @return the number of waypoints passed to the visitor
+   */
+  unsigned VisitNearest(const Query &query, WaypointVisitor &visitor,
+                        unsigned max_results = unsigned(-1)) const;
+
+private:
+  gcc_pure
+  unsigned GetColumn(fixed longitude) const;
+
+  gcc_pure
+  unsigned GetRow(fixed latitude) const;
+
+  unsigned VisitNamePrefix(const Query &query, WaypointVisitor &visitor,
+                           unsigned max_results) const;
+};
+
+#endif
@@ -34,6 +34,9 @@ Copyright_License {
 #include "IO/TextWriter.hpp"
 #include "OS/PathName.hpp"
 #include "Waypoint/WaypointWriter.hpp"
+#include "Waypoint/WaypointCache.hpp"
+#include "IO/FileCache.hpp"
+#include "Util/StaticString.hpp"
 #include "Operation/Operation.hpp"
 
 #include <windef.h> /* for MAX_PATH */
@@ -82,16 +85,73 @@ WaypointGlue::IsWritable()
   return IsWritable(1) || IsWritable(2) || IsWritable(3);
 }
 
+/**
+ * Generate a cache file name which is unique for each configured
+ * waypoint file.
+ */
+static void
+MakeCacheName(StaticString<64> &buffer, const TCHAR *path, int file_num)
+{
+  const TCHAR *base = BaseName(path);
+  buffer.Format(_T("waypoints%d-%s"), file_num,
+                base != NULL ? base : _T(""));
+}
+
+static bool
+LoadWaypointCacheFile(Waypoints &waypoints, const TCHAR *path, int file_num,
+                      FileCache &cache)
+{
+  StaticString<64> name;
+  MakeCacheName(name, path, file_num);
+
+  FILE *file = cache.Load(name, path);
+  if (file == NULL)
+    return false;
+
+  bool success = LoadWaypointCache(file, waypoints);
+  fclose(file);
+  if (!success)
+    cache.Flush(name);
+
+  return success;
+}
+
+static void
+SaveWaypointCacheFile(const Waypoints &waypoints, unsigned first_id,
+                      const TCHAR *path, int file_num, FileCache &cache)
+{
+  StaticString<64> name;
+  MakeCacheName(name, path, file_num);
+
+  FILE *file = cache.Save(name, path);
+  if (file == NULL)
+    return;
+
+  if (SaveWaypointCache(file, waypoints, first_id))
+    cache.Commit(name, file);
+  else
+    cache.Cancel(name, file);
+}
+
 static bool
 LoadWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
-                 const RasterTerrain *terrain, OperationEnvironment &operation)
+                 const RasterTerrain *terrain, FileCache *cache,
+                 OperationEnvironment &operation)
 {
+  if (cache != NULL &&
+      LoadWaypointCacheFile(waypoints, path, file_num, *cache))
+    return true;
+
   WaypointReader reader(path, file_num);
   if (reader.Error()) {
     LogStartUp(_T("Failed to open waypoint file: %s"), path);
     return false;
   }
 
+  /* waypoint ids are allocated sequentially, and nothing has been
+     removed since Waypoints::Clear() */
+  const unsigned first_id = waypoints.size() + 1;
+
   // parse the file
   reader.SetTerrain(terrain);
   if (!reader.Parse(waypoints, operation)) {
@@ -99,12 +159,18 @@ LoadWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
     return false;
   }
 
+  /* don't cache files which have waypoints without elevation,
+     because their parser result depends on the terrain */
+  if (cache != NULL && !reader.NeedsTerrain())
+    SaveWaypointCacheFile(waypoints, first_id, path, file_num, *cache);
+
   return true;
 }
 
 bool
 WaypointGlue::LoadWaypoints(Waypoints &way_points,
                             const RasterTerrain *terrain,
+                            FileCache *cache,
                             OperationEnvironment &operation)
 {
   LogStartUp(_T("ReadWaypoints"));
@@ -119,15 +185,15 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
 
   // ### FIRST FILE ###
   if (Profile::GetPath(szProfileWaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 1, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 1, terrain, cache, operation);
 
   // ### SECOND FILE ###
   if (Profile::GetPath(szProfileAdditionalWaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 2, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 2, terrain, cache, operation);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   if (Profile::GetPath(szProfileWatchedWaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 3, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 3, terrain, cache, operation);
 
   // ### MAP/FOURTH FILE ###
 
@@ -136,10 +202,10 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
     TCHAR *tail = path + _tcslen(path);
 
     _tcscpy(tail, _T("/waypoints.xcw"));
-    found |= LoadWaypointFile(way_points, path, 0, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 0, terrain, cache, operation);
 
     _tcscpy(tail, _T("/waypoints.cup"));
-    found |= LoadWaypointFile(way_points, path, 0, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 0, terrain, cache, operation);
   }
 
   // Optimise the waypoint list after attaching new waypoints
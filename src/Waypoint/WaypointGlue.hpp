@@ -29,6 +29,7 @@ Copyright_License {
 struct Waypoint;
 class Waypoints;
 class RasterTerrain;
+class FileCache;
 class OperationEnvironment;
 struct ComputerSettings;
 struct PlacesOfInterestSettings;
@@ -100,9 +101,12 @@ namespace WaypointGlue {
    * specified waypoint list
    * @param way_points The waypoint list to fill
    * @param terrain RasterTerrain (for automatic waypoint height)
+   * @param cache if not NULL, then the parsed waypoints of each file
+   * are cached, and the file is not parsed again until it is modified
    */
   bool LoadWaypoints(Waypoints &way_points,
                      const RasterTerrain *terrain,
+                     FileCache *cache,
                      OperationEnvironment &operation);
 
   bool SaveWaypoints(const Waypoints &way_points);
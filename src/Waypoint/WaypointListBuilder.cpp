@@ -24,6 +24,7 @@ Copyright_License {
 #include "WaypointListBuilder.hpp"
 #include "WaypointList.hpp"
 #include "WaypointFilter.hpp"
+#include "WaypointFilterIndex.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 
 void WaypointListBuilder::Visit(const Waypoints &waypoints) {
@@ -33,6 +34,17 @@ void WaypointListBuilder::Visit(const Waypoints &waypoints) {
     waypoints.VisitNamePrefix(filter.name, *this);
 }
 
+void WaypointListBuilder::Visit(const WaypointFilterIndex &index) {
+  /* the index yields a superset of what Matches() accepts */
+  WaypointFilterIndex::Query query(location);
+  query.range = filter.distance;
+  query.type_mask = WaypointFilter::GetTypeMask(filter.type_index);
+  query.name_prefix = filter.name;
+  query.direction = filter.direction;
+
+  index.VisitNearest(query, *this);
+}
+
 void WaypointListBuilder::Visit(const Waypoint &waypoint) {
   if (filter.Matches(waypoint, location, triangle_validator))
     list.push_back(WaypointListItem(waypoint));
@@ -31,6 +31,7 @@ Copyright_License {
 struct WaypointFilter;
 class WaypointList;
 class Waypoints;
+class WaypointFilterIndex;
 struct Waypoint;
 
 class WaypointListBuilder:
@@ -49,6 +50,12 @@ public:
      triangle_validator(ordered_task, ordered_task_index) {}
 
   void Visit(const Waypoints &waypoints);
+
+  /**
+   * Like Visit(const Waypoints &), but let the index pre-filter the
+   * waypoints.  The resulting list is ordered by distance.
+   */
+  void Visit(const WaypointFilterIndex &index);
   void Visit(const Waypoint &waypoint);
 };
 
@@ -86,6 +86,14 @@ public:
    */
   bool Parse(Waypoints &way_points, OperationEnvironment &operation);
 
+  /**
+   * Does the result of Parse() depend on the terrain?  See
+   * WaypointReaderBase::NeedsTerrain().
+   */
+  bool NeedsTerrain() const {
+    return reader != NULL && reader->NeedsTerrain();
+  }
+
   /**
    * Returns whether there is a valid internal reader
    * that can be used for parsing the waypoint file.
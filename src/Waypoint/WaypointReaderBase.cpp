@@ -27,6 +27,7 @@ Copyright_License {
 #include "Waypoint/Waypoint.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "IO/FileLineReader.hpp"
+#include "IO/MappedLineReader.hpp"
 #include "IO/ZipLineReader.hpp"
 #include "Operation/Operation.hpp"
 
@@ -36,7 +37,8 @@ WaypointReaderBase::WaypointReaderBase(const TCHAR* file_name, const int _file_n
                            bool _compressed):
   file_num(_file_num),
   terrain(NULL),
-  compressed(_compressed)
+  compressed(_compressed),
+  needs_terrain(false)
 {
   _tcscpy(file, file_name);
 }
@@ -160,6 +162,7 @@ WaypointReaderBase::CheckAltitude(Waypoint &new_waypoint,
 bool
 WaypointReaderBase::CheckAltitude(Waypoint &new_waypoint) const
 {
+  needs_terrain = true;
   return CheckAltitude(new_waypoint, terrain);
 }
 
@@ -190,6 +193,13 @@ WaypointReaderBase::Parse(Waypoints &way_points,
     return false;
 
   if (!compressed) {
+    // Try to map the waypoint file into memory
+    MappedLineReader mapped_reader(file, ConvertLineReader::AUTO);
+    if (!mapped_reader.error()) {
+      Parse(way_points, mapped_reader, operation);
+      return true;
+    }
+
     // Try to open waypoint file
     FileLineReader reader(file, ConvertLineReader::AUTO);
     if (reader.error())
@@ -41,6 +41,13 @@ protected:
   const RasterTerrain* terrain;
   bool compressed;
 
+  /**
+   * Did the file contain waypoints without an elevation?  These have
+   * been looked up in the terrain (or skipped if there was no
+   * terrain), i.e. the result of Parse() depends on the terrain.
+   */
+  mutable bool needs_terrain;
+
 protected:
   WaypointReaderBase(const TCHAR* file_name, const int _file_num,
                bool _compressed = false);
@@ -67,6 +74,10 @@ public:
     terrain = _terrain;
   }
 
+  bool NeedsTerrain() const {
+    return needs_terrain;
+  }
+
 protected:
   static bool CheckAltitude(Waypoint &new_waypoint, const RasterTerrain *terrain);
   bool CheckAltitude(Waypoint &new_waypoint) const;
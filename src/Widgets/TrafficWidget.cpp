@@ -41,6 +41,8 @@
 #include "Formatter/UserUnits.hpp"
 #include "Input/InputEvents.hpp"
 #include "Interface.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Components.hpp"
 
 /**
  * A Window which renders FLARM traffic, with user interaction.
@@ -63,7 +65,7 @@ protected:
   void CalcAutoZoom();
 
 public:
-  void Update(Angle new_direction, const TrafficList &new_data,
+  void Update(Angle new_direction, const TrafficStore &new_data,
               const TeamCodeSettings &new_settings);
   void UpdateTaskDirection(bool show_task_direction, Angle bearing);
 
@@ -188,7 +190,7 @@ FlarmTrafficControl2::CalcAutoZoom()
 }
 
 void
-FlarmTrafficControl2::Update(Angle new_direction, const TrafficList &new_data,
+FlarmTrafficControl2::Update(Angle new_direction, const TrafficStore &new_data,
                             const TeamCodeSettings &new_settings)
 {
   FlarmTrafficWindow::Update(new_direction, new_data, new_settings);
@@ -499,9 +501,11 @@ TrafficWidget::Update()
     wf->SetModalResult(mrOK);
 #endif
 
-  view->Update(basic.track,
-               basic.flarm.traffic,
-               CommonInterface::GetComputerSettings().team_code);
+  {
+    ProtectedTrafficStore::Lease store(device_blackboard->GetTrafficStore());
+    view->Update(basic.track, store,
+                 CommonInterface::GetComputerSettings().team_code);
+  }
 
   view->UpdateTaskDirection(calculated.task_stats.task_valid &&
                             calculated.task_stats.current_leg.solution_remaining.IsOk(),
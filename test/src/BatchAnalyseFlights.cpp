@@ -0,0 +1,652 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Analyses all IGC files in a directory concurrently, and writes one
+ * consolidated result file (CSV or JSON, depending on the extension
+ * of OUTPUT).  Each flight gets an exhaustive OLC Plus optimisation
+ * and, if a task file is given, is scored against that task.
+ *
+ * The flights are distributed over one worker per CPU.  The workers
+ * are processes, not threads, because #Trace allocates from a
+ * process-wide allocator which is not thread-safe.  Each worker has
+ * its own queue in shared memory; a worker which runs out of flights
+ * steals from the others, so a few long flights do not leave the
+ * other workers idle.
+ */
+
+#include "Contest/ContestManager.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/TaskEvents.hpp"
+#include "Engine/Task/Tasks/OrderedTask.hpp"
+#include "Task/TaskFile.hpp"
+#include "NMEA/Aircraft.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "Util/tstring.hpp"
+#include "DebugReplay.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <string.h>
+#include <errno.h>
+#endif
+
+static const unsigned MAX_WORKERS = 64;
+
+struct Flight {
+  tstring path;
+
+  /** the file size, used to schedule long flights first */
+  uint64_t size;
+
+  bool operator<(const Flight &other) const {
+    return size != other.size ? size > other.size : path < other.path;
+  }
+};
+
+/**
+ * The analysis result of one flight.  This is written by the worker
+ * into shared memory, and therefore must not contain pointers.
+ */
+struct FlightResult {
+  bool valid;
+
+  unsigned n_fixes;
+
+  /** the duration of the analysis [us] */
+  uint64_t duration_us;
+
+  /** OLC Plus: classic, triangle, plus */
+  ContestResult contest[3];
+
+  bool task_started, task_finished;
+  fixed task_distance, task_time;
+
+  void Clear() {
+    valid = false;
+    n_fixes = 0;
+    duration_us = 0;
+    for (unsigned i = 0; i < 3; ++i)
+      contest[i].Reset();
+    task_started = task_finished = false;
+    task_distance = task_time = fixed_zero;
+  }
+
+  fixed GetTaskSpeed() const {
+    return task_finished && positive(task_time)
+      ? task_distance / task_time
+      : fixed_zero;
+  }
+};
+
+/**
+ * The job slots of one worker.  The owner takes
+ * jobs from the head (the longest flights come first), and other
+ * workers steal from the tail.  All access is protected by a spin
+ * lock, because the queues live in memory shared between processes.
+ */
+struct WorkQueue {
+  int lock;
+  unsigned head, tail;
+
+  void Lock() {
+    while (__sync_lock_test_and_set(&lock, 1))
+      while (*(volatile int *)&lock) {}
+  }
+
+  void Unlock() {
+    __sync_lock_release(&lock);
+  }
+
+  bool PopHead(unsigned &job) {
+    Lock();
+    const bool found = head < tail;
+    if (found)
+      job = head++;
+    Unlock();
+    return found;
+  }
+
+  bool PopTail(unsigned &job) {
+    Lock();
+    const bool found = head < tail;
+    if (found)
+      job = --tail;
+    Unlock();
+    return found;
+  }
+};
+
+/**
+ * The state shared by all workers.  #results is indexed by job
+ * number, and each entry is written by exactly one worker.
+ */
+struct SharedState {
+  unsigned n_workers;
+  WorkQueue queues[MAX_WORKERS];
+
+  FlightResult results[1];
+
+  static size_t GetSize(unsigned n_jobs) {
+    return sizeof(SharedState) + (n_jobs - 1) * sizeof(FlightResult);
+  }
+
+  /**
+   * Distribute the jobs 0..n-1 round-robin: slot k of queue i is
+   * job i + k * n_workers.  The jobs are sorted by decreasing size,
+   * so the head of each queue is its longest flight.
+   */
+  void Fill(unsigned n_jobs) {
+    for (unsigned i = 0; i < n_workers; ++i) {
+      queues[i].lock = 0;
+      queues[i].head = 0;
+      queues[i].tail = (n_jobs - i + n_workers - 1) / n_workers;
+    }
+
+    for (unsigned i = 0; i < n_jobs; ++i)
+      results[i].Clear();
+  }
+
+  unsigned ToJob(unsigned worker, unsigned slot) const {
+    return worker + slot * n_workers;
+  }
+
+  /**
+   * @return false if there are no more jobs
+   */
+  bool Pop(unsigned worker, unsigned &job) {
+    unsigned slot;
+    if (queues[worker].PopHead(slot)) {
+      job = ToJob(worker, slot);
+      return true;
+    }
+
+    for (unsigned i = 1; i < n_workers; ++i) {
+      const unsigned victim = (worker + i) % n_workers;
+      if (queues[victim].PopTail(slot)) {
+        job = ToJob(victim, slot);
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+static SharedState *
+AllocateSharedState(unsigned n_jobs)
+{
+  const size_t size = SharedState::GetSize(n_jobs);
+#ifdef HAVE_POSIX
+  void *p = mmap(NULL, size, PROT_READ|PROT_WRITE,
+                 MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+  return p != MAP_FAILED ? (SharedState *)p : NULL;
+#else
+  return (SharedState *)malloc(size);
+#endif
+}
+
+static void
+FreeSharedState(SharedState *state, unsigned n_jobs)
+{
+#ifdef HAVE_POSIX
+  munmap(state, SharedState::GetSize(n_jobs));
+#else
+  free(state);
+#endif
+}
+
+/**
+ * The data which is loaded once and used read-only by all workers.
+ */
+struct BatchContext {
+  const std::vector<Flight> &flights;
+
+  const Waypoints &waypoints;
+
+  TaskBehaviour task_behaviour;
+
+  /** the task all flights are scored against; NULL if none */
+  const OrderedTask *task;
+
+  SharedState &state;
+
+  BatchContext(const std::vector<Flight> &_flights,
+               const Waypoints &_waypoints, SharedState &_state)
+    :flights(_flights), waypoints(_waypoints), task(NULL), state(_state) {
+    task_behaviour.SetDefaults();
+  }
+};
+
+/**
+ * The per-worker analysis state.  The (rather large) traces are
+ * allocated once per worker and reused for all of its flights.
+ */
+class FlightAnalyser {
+  const BatchContext &context;
+
+  Trace full_trace, sprint_trace;
+  ContestManager contest;
+
+  TaskEvents task_events;
+
+public:
+  FlightAnalyser(const BatchContext &_context)
+    :context(_context),
+     full_trace(60, Trace::null_time, 256), sprint_trace(0, 9000, 64),
+     contest(OLC_Plus, full_trace, sprint_trace) {}
+
+  void Analyse(const TCHAR *path, FlightResult &result);
+};
+
+void
+FlightAnalyser::Analyse(const TCHAR *path, FlightResult &result)
+{
+  const uint64_t start = MonotonicClockUS();
+
+  DebugReplay *replay = CreateDebugReplayIGC(NarrowPathName(path));
+  if (replay == NULL)
+    return;
+
+  full_trace.clear();
+  sprint_trace.clear();
+  contest.Reset();
+
+  TaskManager *task_manager = NULL;
+  if (context.task != NULL) {
+    task_manager = new TaskManager(context.task_behaviour, context.waypoints);
+    task_manager->SetTaskEvents(task_events);
+    task_manager->SetGlidePolar(GlidePolar(fixed(2)));
+
+    OrderedTask *task = context.task->Clone(context.task_behaviour);
+    task_manager->Commit(*task);
+    delete task;
+
+    task_manager->Resume();
+  }
+
+  AircraftState last_state;
+  bool have_last_state = false;
+
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    if (!basic.time_available || !basic.location_available)
+      continue;
+
+    const AircraftState state = ToAircraftState(basic, replay->Calculated());
+    full_trace.push_back(state);
+    sprint_trace.push_back(state);
+
+    if (task_manager != NULL && have_last_state &&
+        state.time > last_state.time) {
+      task_manager->Update(state, last_state);
+      task_manager->UpdateIdle(state);
+      task_manager->GetTaskAdvance().set_armed(true);
+    }
+
+    last_state = state;
+    have_last_state = true;
+    ++result.n_fixes;
+  }
+
+  delete replay;
+
+  contest.SolveExhaustive();
+
+  const ContestStatistics &stats = contest.GetStats();
+  for (unsigned i = 0; i < 3; ++i)
+    result.contest[i] = stats.result[i];
+
+  if (task_manager != NULL) {
+    const TaskStats &task_stats = task_manager->GetStats();
+    result.task_started = task_stats.task_started;
+    result.task_finished = task_stats.task_finished;
+    result.task_distance = task_stats.distance_scored;
+    result.task_time = task_stats.total.time_elapsed;
+    delete task_manager;
+  }
+
+  result.valid = true;
+  result.duration_us = MonotonicClockUS() - start;
+}
+
+static void
+RunWorker(const BatchContext &context, unsigned worker)
+{
+  FlightAnalyser analyser(context);
+
+  unsigned job;
+  while (context.state.Pop(worker, job))
+    analyser.Analyse(context.flights[job].path.c_str(),
+                     context.state.results[job]);
+}
+
+/**
+ * Run all workers and wait for them to finish.
+ *
+ * @return the number of workers which did not exit normally
+ */
+static unsigned
+RunWorkers(const BatchContext &context)
+{
+#ifdef HAVE_POSIX
+  const unsigned n_workers = context.state.n_workers;
+  std::vector<pid_t> pids;
+
+  for (unsigned i = 0; i < n_workers; ++i) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      RunWorker(context, i);
+      _exit(EXIT_SUCCESS);
+    } else if (pid < 0) {
+      fprintf(stderr, "Failed to fork worker %u: %s\n", i, strerror(errno));
+      break;
+    } else
+      pids.push_back(pid);
+  }
+
+  if (pids.size() < n_workers)
+    /* this process takes the place of the first worker which could
+       not be forked, and steals the jobs of the others */
+    RunWorker(context, pids.size());
+
+  unsigned n_abnormal = 0;
+  for (unsigned i = 0; i < pids.size(); ++i) {
+    int status;
+    if (waitpid(pids[i], &status, 0) < 0) {
+      fprintf(stderr, "Failed to wait for worker %u: %s\n",
+              i, strerror(errno));
+      ++n_abnormal;
+    } else if (!WIFEXITED(status)) {
+      if (WIFSIGNALED(status))
+        fprintf(stderr, "Worker %u was killed by signal %d\n",
+                i, WTERMSIG(status));
+      else
+        fprintf(stderr, "Worker %u terminated abnormally\n", i);
+      ++n_abnormal;
+    } else if (WEXITSTATUS(status) != EXIT_SUCCESS) {
+      fprintf(stderr, "Worker %u exited with status %d\n",
+              i, WEXITSTATUS(status));
+      ++n_abnormal;
+    }
+  }
+
+  return n_abnormal;
+#else
+  RunWorker(context, 0);
+  return 0;
+#endif
+}
+
+class IGCCollector : public File::Visitor {
+  std::vector<Flight> &flights;
+
+public:
+  IGCCollector(std::vector<Flight> &_flights):flights(_flights) {}
+
+  virtual void Visit(const TCHAR *path, const TCHAR *filename) {
+    Flight flight;
+    flight.path = path;
+    flight.size = 0;
+
+#ifdef HAVE_POSIX
+    struct stat st;
+    if (stat(NarrowPathName(path), &st) == 0)
+      flight.size = st.st_size;
+#endif
+
+    flights.push_back(flight);
+  }
+};
+
+static unsigned
+GetWorkerCount(unsigned n_flights)
+{
+#ifdef HAVE_POSIX
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned n_workers = n > 0 ? (unsigned)n : 1;
+#else
+  unsigned n_workers = 1;
+#endif
+
+  n_workers = std::min(n_workers, MAX_WORKERS);
+  n_workers = std::min(n_workers, n_flights);
+  return n_workers;
+}
+
+static const char *const contest_names[3] = {
+  "classic", "triangle", "plus",
+};
+
+/**
+ * Write a quoted CSV field, doubling the quotes in it.
+ */
+static void
+WriteCSVString(FILE *file, const char *value)
+{
+  fputc('"', file);
+  for (const char *p = value; *p != 0; ++p) {
+    if (*p == '"')
+      fputc('"', file);
+    fputc(*p, file);
+  }
+  fputc('"', file);
+}
+
+/**
+ * Write a JSON string literal, escaping quotes, backslashes (e.g. in
+ * Windows paths) and control characters.
+ */
+static void
+WriteJSONString(FILE *file, const char *value)
+{
+  fputc('"', file);
+  for (const char *p = value; *p != 0; ++p) {
+    const unsigned char ch = *p;
+    if (ch == '"' || ch == '\\') {
+      fputc('\\', file);
+      fputc(ch, file);
+    } else if (ch < 0x20)
+      fprintf(file, "\\u%04x", ch);
+    else
+      fputc(ch, file);
+  }
+  fputc('"', file);
+}
+
+static void
+WriteCSV(FILE *file, const std::vector<Flight> &flights,
+         const FlightResult *results)
+{
+  fprintf(file, "file,valid,fixes,analysis_ms");
+  for (unsigned i = 0; i < 3; ++i)
+    fprintf(file, ",%s_score,%s_distance,%s_speed",
+            contest_names[i], contest_names[i], contest_names[i]);
+  fprintf(file, ",task_started,task_finished,task_distance,task_time,"
+          "task_speed\n");
+
+  for (unsigned i = 0; i < flights.size(); ++i) {
+    const FlightResult &result = results[i];
+
+    WriteCSVString(file,
+                   (const char *)NarrowPathName(flights[i].path.c_str()));
+    fprintf(file, ",%d,%u,%.1f",
+            result.valid, result.n_fixes, result.duration_us / 1000.);
+    for (unsigned j = 0; j < 3; ++j)
+      fprintf(file, ",%.2f,%.0f,%.2f",
+              (double)result.contest[j].score,
+              (double)result.contest[j].distance,
+              (double)result.contest[j].speed);
+    fprintf(file, ",%d,%d,%.0f,%.0f,%.2f\n",
+            result.task_started, result.task_finished,
+            (double)result.task_distance, (double)result.task_time,
+            (double)result.GetTaskSpeed());
+  }
+}
+
+static void
+WriteJSON(FILE *file, const std::vector<Flight> &flights,
+          const FlightResult *results, unsigned n_workers, double wall_s)
+{
+  fprintf(file, "{\n  \"workers\": %u,\n  \"wall_s\": %.3f,\n"
+          "  \"flights_per_minute\": %.1f,\n  \"flights\": [\n",
+          n_workers, wall_s,
+          wall_s > 0 ? flights.size() * 60. / wall_s : 0.);
+
+  for (unsigned i = 0; i < flights.size(); ++i) {
+    const FlightResult &result = results[i];
+
+    fprintf(file, "    { \"file\": ");
+    WriteJSONString(file,
+                    (const char *)NarrowPathName(flights[i].path.c_str()));
+    fprintf(file, ", \"valid\": %s, \"fixes\": %u, "
+            "\"analysis_ms\": %.1f,\n      \"contest\": {",
+            result.valid ? "true" : "false", result.n_fixes,
+            result.duration_us / 1000.);
+
+    for (unsigned j = 0; j < 3; ++j)
+      fprintf(file, "%s \"%s\": { \"score\": %.2f, \"distance\": %.0f, "
+              "\"speed\": %.2f }",
+              j > 0 ? "," : "", contest_names[j],
+              (double)result.contest[j].score,
+              (double)result.contest[j].distance,
+              (double)result.contest[j].speed);
+
+    fprintf(file, " },\n      \"task\": { \"started\": %s, \"finished\": %s, "
+            "\"distance\": %.0f, \"time\": %.0f, \"speed\": %.2f } }%s\n",
+            result.task_started ? "true" : "false",
+            result.task_finished ? "true" : "false",
+            (double)result.task_distance, (double)result.task_time,
+            (double)result.GetTaskSpeed(),
+            i + 1 < flights.size() ? "," : "");
+  }
+
+  fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "DIRECTORY OUTPUT.{csv,json} [TASK]");
+  const tstring directory = args.ExpectNextT();
+  const char *output_path = args.ExpectNext();
+  const tstring task_path = args.IsEmpty() ? tstring() : args.ExpectNextT();
+  args.ExpectEnd();
+
+  const bool json = MatchesExtension(output_path, ".json");
+  if (!json && !MatchesExtension(output_path, ".csv")) {
+    fprintf(stderr, "Output file must be .csv or .json\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Flight> flights;
+  IGCCollector collector(flights);
+  Directory::VisitSpecificFiles(directory.c_str(), _T("*.igc"), collector);
+
+  if (flights.empty()) {
+    fprintf(stderr, "No IGC files found\n");
+    return EXIT_FAILURE;
+  }
+
+  /* longest flights first, so the short ones fill the gaps at the
+     end */
+  std::sort(flights.begin(), flights.end());
+
+  const unsigned n_flights = flights.size();
+  SharedState *state = AllocateSharedState(n_flights);
+  if (state == NULL) {
+    fprintf(stderr, "Failed to allocate shared memory\n");
+    return EXIT_FAILURE;
+  }
+
+  state->n_workers = GetWorkerCount(n_flights);
+  state->Fill(n_flights);
+
+  /* the task (and the waypoints it may refer to) are loaded only once
+     and shared by all workers */
+  const Waypoints waypoints;
+  BatchContext context(flights, waypoints, *state);
+
+  OrderedTask *task = NULL;
+  if (!task_path.empty()) {
+    task = TaskFile::GetTask(task_path.c_str(), context.task_behaviour,
+                             NULL, 0);
+    if (task == NULL) {
+      fprintf(stderr, "Failed to load task\n");
+      return EXIT_FAILURE;
+    }
+
+    context.task = task;
+  }
+
+  const uint64_t start = MonotonicClockUS();
+  const unsigned n_abnormal = RunWorkers(context);
+  const double wall_s = (MonotonicClockUS() - start) / 1000000.;
+
+  delete task;
+
+  FILE *file = fopen(output_path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "Failed to create %s\n", output_path);
+    return EXIT_FAILURE;
+  }
+
+  if (json)
+    WriteJSON(file, flights, state->results, state->n_workers, wall_s);
+  else
+    WriteCSV(file, flights, state->results);
+
+  fclose(file);
+
+  unsigned n_valid = 0;
+  for (unsigned i = 0; i < n_flights; ++i)
+    if (state->results[i].valid)
+      ++n_valid;
+
+  printf("%u flights (%u failed) in %.2f s with %u workers: "
+         "%.1f flights/minute\n",
+         n_flights, n_flights - n_valid, wall_s, state->n_workers,
+         wall_s > 0 ? n_flights * 60. / wall_s : 0.);
+  if (n_abnormal > 0)
+    printf("%u of %u workers exited abnormally; "
+           "flights which were not analysed are reported as failed\n",
+           n_abnormal, state->n_workers);
+
+  FreeSharedState(state, n_flights);
+
+  return EXIT_SUCCESS;
+}
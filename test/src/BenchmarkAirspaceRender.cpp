@@ -0,0 +1,252 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares clipping and projecting airspace polygons for every frame
+ * (as AirspaceRenderer did before #AirspaceRenderCache) with the
+ * cache, on a synthetic set of dense airspaces and a map which is
+ * panned and zoomed like during a flight.
+ */
+
+#include "Renderer/AirspaceRenderCache.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Geo/GeoClip.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspaceVisitor.hpp"
+#include "Navigation/SearchPointVector.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "OS/Clock.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const unsigned NUM_AIRSPACES = 2000;
+static const unsigned NUM_VERTICES = 64;
+static const unsigned NUM_FRAMES = 1000;
+
+static const GeoPoint center(Angle::Degrees(fixed(7.7061111111111114)),
+                             Angle::Degrees(fixed(51.051944444444445)));
+
+static double
+Random(double min, double max)
+{
+  return min + (max - min) * rand() / RAND_MAX;
+}
+
+/**
+ * Creates irregular polygons of 2 to 20 km radius within one degree
+ * of #center.
+ */
+static void
+CreateAirspaces(Airspaces &airspaces)
+{
+  srand(42);
+
+  for (unsigned i = 0; i < NUM_AIRSPACES; ++i) {
+    const double longitude = center.longitude.Degrees() + Random(-1, 1);
+    const double latitude = center.latitude.Degrees() + Random(-1, 1);
+    const double radius = Random(2000, 20000) / 111000;
+
+    std::vector<GeoPoint> points;
+    points.reserve(NUM_VERTICES);
+    for (unsigned j = 0; j < NUM_VERTICES; ++j) {
+      const Angle angle = Angle::FullCircle() * fixed(j) / NUM_VERTICES;
+      const double r = radius * Random(0.8, 1.2);
+      points.push_back(GeoPoint(Angle::Degrees(fixed(longitude +
+                                                     r * angle.cos())),
+                                Angle::Degrees(fixed(latitude +
+                                                     r * angle.sin()))));
+    }
+
+    airspaces.Add(new AirspacePolygon(points));
+  }
+
+  airspaces.Optimise();
+}
+
+static void
+InitProjection(WindowProjection &projection)
+{
+  projection.SetScreenSize(640, 480);
+  projection.SetScreenOrigin(320, 240);
+  projection.SetGeoLocation(center);
+  projection.SetScaleFromRadius(fixed(25000));
+  projection.UpdateScreenBounds();
+}
+
+/**
+ * Move the map like during a flight: a small pan in every other
+ * frame, a turn and a zoom change every 100 frames.
+ */
+static void
+NextFrame(WindowProjection &projection, unsigned i)
+{
+  if (i % 100 == 0) {
+    projection.SetScaleFromRadius(i % 200 == 0 ? fixed(25000) : fixed(40000));
+  } else if (i % 2 == 1) {
+    /* fly a square, so the map stays above the airspaces */
+    static const int dx[4] = { 3, 0, -3, 0 };
+    static const int dy[4] = { 0, -3, 0, 3 };
+
+    RasterPoint pt = projection.GetScreenOrigin();
+    pt.x += dx[(i / 100) % 4];
+    pt.y += dy[(i / 100) % 4];
+    projection.SetGeoLocation(projection.ScreenToGeo(pt.x, pt.y));
+  } else
+    return;
+
+  projection.UpdateScreenBounds();
+}
+
+class PolygonCollector : public AirspaceVisitor {
+public:
+  std::vector<const AirspacePolygon *> polygons;
+
+protected:
+  virtual void Visit(const AirspaceCircle &as) {}
+
+  virtual void Visit(const AirspacePolygon &as) {
+    polygons.push_back(&as);
+  }
+};
+
+static void
+CollectPolygons(const Airspaces &airspaces,
+                const WindowProjection &projection,
+                PolygonCollector &collector)
+{
+  collector.polygons.clear();
+  airspaces.VisitWithinRange(projection.GetGeoScreenCenter(),
+                             projection.GetScreenDistanceMeters(),
+                             collector);
+}
+
+/**
+ * Clip and project all polygons, like MapCanvas::PreparePolygon().
+ *
+ * @return the number of projected points
+ */
+static unsigned
+RenderUncached(const Airspaces &airspaces, const WindowProjection &projection)
+{
+  PolygonCollector collector;
+  CollectPolygons(airspaces, projection, collector);
+
+  const GeoClip clip(projection.GetScreenBounds().Scale(fixed(1.1)));
+  AllocatedArray<GeoPoint> geo_points;
+  AllocatedArray<RasterPoint> raster_points;
+
+  unsigned total = 0;
+  for (auto i = collector.polygons.begin(), end = collector.polygons.end();
+       i != end; ++i) {
+    const SearchPointVector &points = (*i)->GetPoints();
+    unsigned num_points = points.size();
+
+    geo_points.GrowDiscard(num_points * 3);
+    for (unsigned j = 0; j < num_points; ++j)
+      geo_points[j] = points[j].get_location();
+
+    num_points = clip.ClipPolygon(geo_points.begin(),
+                                  geo_points.begin(), num_points);
+    if (num_points < 3)
+      continue;
+
+    raster_points.GrowDiscard(num_points);
+    projection.GeoToScreen(geo_points.begin(), raster_points.begin(),
+                           num_points);
+    total += num_points;
+  }
+
+  return total;
+}
+
+static unsigned
+RenderCached(AirspaceRenderCache &cache, const Airspaces &airspaces,
+             const WindowProjection &projection)
+{
+  cache.Begin(airspaces, projection);
+
+  PolygonCollector collector;
+  CollectPolygons(airspaces, projection, collector);
+
+  unsigned total = 0;
+  for (auto i = collector.polygons.begin(), end = collector.polygons.end();
+       i != end; ++i) {
+    const AirspaceRenderCache::Shape *shape = cache.Get(**i);
+    if (shape == NULL)
+      continue;
+
+    const RasterPoint *points = cache.GetScreenPoints(*shape);
+    (void)points;
+    total += shape->num_points;
+  }
+
+  return total;
+}
+
+int main(int argc, char **argv)
+{
+  Airspaces airspaces;
+  CreateAirspaces(airspaces);
+  printf("%u airspaces with %u vertices each\n",
+         NUM_AIRSPACES, NUM_VERTICES);
+
+  WindowProjection projection;
+  InitProjection(projection);
+
+  unsigned uncached_points = 0;
+  uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < NUM_FRAMES; ++i) {
+    NextFrame(projection, i);
+    uncached_points += RenderUncached(airspaces, projection);
+  }
+  const double uncached_ms = (MonotonicClockUS() - start) / 1000. / NUM_FRAMES;
+
+  InitProjection(projection);
+
+  AirspaceRenderCache cache;
+  unsigned cached_points = 0;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < NUM_FRAMES; ++i) {
+    NextFrame(projection, i);
+    cached_points += RenderCached(cache, airspaces, projection);
+  }
+  const double cached_ms = (MonotonicClockUS() - start) / 1000. / NUM_FRAMES;
+
+  const AirspaceRenderCache::Statistics &statistics = cache.GetStatistics();
+
+  printf("uncached: %8.3f ms/frame (%u points)\n",
+         uncached_ms, uncached_points);
+  printf("cached:   %8.3f ms/frame (%u points)\n",
+         cached_ms, cached_points);
+  printf("frames: %u unchanged, %u translated, %u flushed\n",
+         statistics.unchanged, statistics.translated, statistics.flushed);
+  printf("shapes: %u hits, %u misses, %u cached at the end\n",
+         statistics.hits, statistics.misses, (unsigned)cache.size());
+
+  return 0;
+}
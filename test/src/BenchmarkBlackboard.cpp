@@ -0,0 +1,293 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Models the data exchange between the threads which share the
+ * DeviceBlackboard (device input, MergeThread, CalculationThread,
+ * DrawThread and the main thread), once with the old scheme (every
+ * thread copies MoreData/DerivedInfo while holding the blackboard
+ * mutex) and once with the #SeqLock publication.  It reports how
+ * long the device input thread waits for the mutex, and how many
+ * bytes are copied per second (in total and while holding the
+ * mutex).
+ */
+
+#include "Thread/SeqLock.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Thread.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "ComputerSettings.hpp"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * Stand-ins for the blackboard structs, with the same size.
+ */
+template<unsigned size>
+struct Blob {
+  char data[size];
+};
+
+typedef Blob<sizeof(NMEAInfo)> NMEABlob;
+typedef Blob<sizeof(MoreData)> BasicBlob;
+typedef Blob<sizeof(DerivedInfo)> CalculatedBlob;
+typedef Blob<sizeof(ComputerSettings)> SettingsBlob;
+
+static const unsigned DURATION_MS = 2000;
+
+static bool use_seqlock;
+static volatile bool running;
+
+/* the DeviceBlackboard */
+static Mutex mutex;
+static NMEABlob per_device_data, real_data;
+static BasicBlob gps_info;
+static CalculatedBlob calculated_info;
+static SettingsBlob computer_settings;
+static SeqLocked<BasicBlob> published_basic;
+static SeqLocked<CalculatedBlob> published_calculated;
+
+static unsigned calculated_sequence;
+
+/* statistics; they have their own mutex, to avoid disturbing the
+   measurement */
+static Mutex statistics_mutex;
+static uint64_t bytes_copied, bytes_copied_locked;
+static unsigned retries;
+
+static void
+CountCopy(unsigned size, bool locked, unsigned n_retries=0)
+{
+  ScopeLock protect(statistics_mutex);
+  bytes_copied += size * (n_retries + 1);
+  if (locked)
+    bytes_copied_locked += size * (n_retries + 1);
+  retries += n_retries;
+}
+
+template<typename T>
+static void
+ReadPublished(const SeqLocked<T> &src, T &dest)
+{
+  const unsigned n = src.Read(dest);
+  CountCopy(sizeof(T), false, n);
+}
+
+template<typename T>
+static void
+WritePublished(SeqLocked<T> &dest, const T &src)
+{
+  dest.Write(src);
+  CountCopy(sizeof(T), false);
+}
+
+class PeriodicThread : public Thread {
+  unsigned period_ms;
+
+public:
+  PeriodicThread(unsigned _period_ms):period_ms(_period_ms) {}
+
+protected:
+  virtual void Tick() = 0;
+
+  virtual void Run() {
+    while (running) {
+      Tick();
+      Sleep(period_ms);
+    }
+  }
+};
+
+/**
+ * Parses NMEA sentences into per_device_data, i.e. it holds the
+ * mutex only briefly, but it suffers when others hold it for long.
+ */
+class DeviceThread : public PeriodicThread {
+public:
+  unsigned locks;
+  uint64_t wait_us, max_wait_us;
+
+  DeviceThread():PeriodicThread(1), locks(0), wait_us(0), max_wait_us(0) {}
+
+protected:
+  virtual void Tick() {
+    const uint64_t start = MonotonicClockUS();
+    mutex.Lock();
+    const uint64_t wait = MonotonicClockUS() - start;
+
+    ++locks;
+    wait_us += wait;
+    if (wait > max_wait_us)
+      max_wait_us = wait;
+
+    ++per_device_data.data[locks % sizeof(per_device_data.data)];
+    mutex.Unlock();
+  }
+};
+
+class MergeThread : public PeriodicThread {
+public:
+  MergeThread():PeriodicThread(5) {}
+
+protected:
+  virtual void Tick() {
+    ScopeLock protect(mutex);
+
+    if (use_seqlock &&
+        published_calculated.ReadIfModified(calculated_info,
+                                            calculated_sequence))
+      CountCopy(sizeof(calculated_info), true);
+
+    real_data = per_device_data;
+    CountCopy(sizeof(real_data), true);
+    memcpy(gps_info.data, real_data.data, sizeof(real_data));
+    CountCopy(sizeof(real_data), true);
+
+    if (use_seqlock) {
+      published_basic.Write(gps_info);
+      CountCopy(sizeof(gps_info), true);
+    }
+  }
+};
+
+class CalculationThread : public PeriodicThread {
+  BasicBlob basic;
+  CalculatedBlob calculated;
+
+public:
+  CalculationThread():PeriodicThread(10) {}
+
+protected:
+  virtual void Tick() {
+    if (use_seqlock) {
+      ReadPublished(published_basic, basic);
+    } else {
+      ScopeLock protect(mutex);
+      basic = gps_info;
+      CountCopy(sizeof(basic), true);
+    }
+
+    /* the calculations */
+    ++calculated.data[basic.data[0] % sizeof(calculated.data)];
+
+    if (use_seqlock) {
+      WritePublished(published_calculated, calculated);
+    } else {
+      ScopeLock protect(mutex);
+      calculated_info = calculated;
+      CountCopy(sizeof(calculated), true);
+    }
+  }
+};
+
+/**
+ * The DrawThread and the main thread: they copy both structs.
+ */
+class ReaderThread : public PeriodicThread {
+  BasicBlob basic;
+  CalculatedBlob calculated;
+  SettingsBlob settings;
+  bool write_settings;
+
+public:
+  ReaderThread(bool _write_settings)
+    :PeriodicThread(10), write_settings(_write_settings) {}
+
+protected:
+  virtual void Tick() {
+    if (use_seqlock) {
+      ReadPublished(published_basic, basic);
+      ReadPublished(published_calculated, calculated);
+    } else {
+      ScopeLock protect(mutex);
+      basic = gps_info;
+      calculated = calculated_info;
+      CountCopy(sizeof(basic) + sizeof(calculated), true);
+    }
+
+    if (write_settings) {
+      ScopeLock protect(mutex);
+      computer_settings = settings;
+      CountCopy(sizeof(settings), true);
+    }
+  }
+};
+
+static void
+Run(bool seqlock)
+{
+  use_seqlock = seqlock;
+  running = true;
+  bytes_copied = bytes_copied_locked = 0;
+  retries = 0;
+  calculated_sequence = 0;
+
+  DeviceThread device;
+  MergeThread merge;
+  CalculationThread calculation;
+  ReaderThread draw(false), main(true);
+
+  device.Start();
+  merge.Start();
+  calculation.Start();
+  draw.Start();
+  main.Start();
+
+  Sleep(DURATION_MS);
+  running = false;
+
+  device.Join();
+  merge.Join();
+  calculation.Join();
+  draw.Join();
+  main.Join();
+
+  const double seconds = DURATION_MS / 1000.;
+  printf("%-8s %10.1f %10.2f %10u %12.1f %12.1f %8u\n",
+         seqlock ? "seqlock" : "mutex",
+         device.locks / seconds,
+         device.wait_us / seconds / 1000.,
+         (unsigned)device.max_wait_us,
+         bytes_copied / seconds / 1024.,
+         bytes_copied_locked / seconds / 1024.,
+         retries);
+}
+
+int main(int argc, char **argv)
+{
+  printf("MoreData: %u bytes, DerivedInfo: %u bytes\n",
+         (unsigned)sizeof(MoreData), (unsigned)sizeof(DerivedInfo));
+  printf("%-8s %10s %10s %10s %12s %12s %8s\n",
+         "scheme", "locks/s", "wait ms/s", "max us",
+         "copied kB/s", "locked kB/s", "retries");
+
+  Run(false);
+  Run(true);
+
+  return 0;
+}
@@ -0,0 +1,185 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the time needed to parse a waypoint or airspace file with
+ * the time needed to load the parser result from the cache (see
+ * WaypointCache.hpp and AirspaceCache.hpp).
+ */
+
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/WaypointReader.hpp"
+#include "Airspace/AirspaceCache.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "IO/MappedLineReader.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Operation/Operation.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+static const unsigned ITERATIONS = 5;
+
+struct Result {
+  uint64_t parse, optimise, save, load;
+
+  Result():parse(-1), optimise(-1), save(-1), load(-1) {}
+
+  static void Update(uint64_t &best, uint64_t start) {
+    const uint64_t duration = MonotonicClockUS() - start;
+    if (duration < best)
+      best = duration;
+  }
+
+  void Print(unsigned count, long cache_size) const {
+    printf("%u items, cache file %ld kB\n", count, cache_size / 1024);
+    printf("parse:      %8.2f ms\n", parse / 1000.);
+    printf("cache save: %8.2f ms\n", save / 1000.);
+    printf("cache load: %8.2f ms (%.1fx faster than parsing)\n",
+           load / 1000., (double)parse / (load > 0 ? load : 1));
+    printf("optimise:   %8.2f ms (after both)\n", optimise / 1000.);
+  }
+};
+
+static bool
+BenchmarkWaypoints(const TCHAR *path)
+{
+  NullOperationEnvironment operation;
+  FILE *file = tmpfile();
+  if (file == NULL)
+    return false;
+
+  Result result;
+  unsigned count = 0;
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    Waypoints waypoints;
+    uint64_t start = MonotonicClockUS();
+    WaypointReader reader(path, 1);
+    if (reader.Error() || !reader.Parse(waypoints, operation)) {
+      fprintf(stderr, "Failed to parse the waypoint file\n");
+      return false;
+    }
+    Result::Update(result.parse, start);
+
+    rewind(file);
+    start = MonotonicClockUS();
+    if (!SaveWaypointCache(file, waypoints, 1)) {
+      fprintf(stderr, "Failed to save the cache\n");
+      return false;
+    }
+    fflush(file);
+    Result::Update(result.save, start);
+
+    start = MonotonicClockUS();
+    waypoints.Optimise();
+    Result::Update(result.optimise, start);
+    count = waypoints.size();
+  }
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    Waypoints waypoints;
+    rewind(file);
+    const uint64_t start = MonotonicClockUS();
+    if (!LoadWaypointCache(file, waypoints)) {
+      fprintf(stderr, "Failed to load the cache\n");
+      return false;
+    }
+    Result::Update(result.load, start);
+  }
+
+  result.Print(count, ftell(file));
+  fclose(file);
+  return true;
+}
+
+static bool
+BenchmarkAirspaces(const TCHAR *path)
+{
+  NullOperationEnvironment operation;
+  FILE *file = tmpfile();
+  if (file == NULL)
+    return false;
+
+  Result result;
+  unsigned count = 0;
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    Airspaces airspaces;
+    uint64_t start = MonotonicClockUS();
+    MappedLineReader reader(path, ConvertLineReader::AUTO);
+    AirspaceParser parser(airspaces);
+    if (reader.error() || !parser.Parse(reader, operation)) {
+      fprintf(stderr, "Failed to parse the airspace file\n");
+      return false;
+    }
+    Result::Update(result.parse, start);
+
+    rewind(file);
+    start = MonotonicClockUS();
+    if (!SaveAirspaceCache(file, airspaces, 0)) {
+      fprintf(stderr, "Failed to save the cache\n");
+      return false;
+    }
+    fflush(file);
+    Result::Update(result.save, start);
+
+    start = MonotonicClockUS();
+    airspaces.Optimise();
+    Result::Update(result.optimise, start);
+    count = airspaces.size();
+  }
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    Airspaces airspaces;
+    rewind(file);
+    const uint64_t start = MonotonicClockUS();
+    if (!LoadAirspaceCache(file, airspaces)) {
+      fprintf(stderr, "Failed to load the cache\n");
+      return false;
+    }
+    Result::Update(result.load, start);
+  }
+
+  result.Print(count, ftell(file));
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 3 ||
+      (strcmp(argv[1], "waypoints") != 0 && strcmp(argv[1], "airspace") != 0)) {
+    fprintf(stderr, "Usage: %s waypoints|airspace PATH\n", argv[0]);
+    return 1;
+  }
+
+  PathName path(argv[2]);
+  const bool success = strcmp(argv[1], "waypoints") == 0
+    ? BenchmarkWaypoints(path)
+    : BenchmarkAirspaces(path);
+  return success ? 0 : 2;
+}
@@ -0,0 +1,163 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Measures loading a (large) FLARMnet file, both by parsing it and
+ * by mapping the cache file, and compares the lookup latency of
+ * #FlarmDatabase with a linear search.
+ */
+
+#include "FLARM/FlarmNetReader.hpp"
+#include "FLARM/Database.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Util/Macros.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <windef.h> /* for MAX_PATH */
+
+static const unsigned ITERATIONS = 1000;
+
+static const TCHAR *const cache_name = _T("flarmnet-benchmark");
+
+/**
+ * The call sign lookup as it was before the sorted index.
+ */
+static unsigned
+FindIdsLinear(const FlarmDatabase &database, const TCHAR *cn,
+              bool prefix)
+{
+  const size_t length = _tcslen(cn);
+  unsigned count = 0;
+  for (auto i = database.begin(), end = database.end(); i != end; ++i)
+    if (prefix
+        ? _tcsncmp(i->callsign, cn, length) == 0
+        : _tcscmp(i->callsign, cn) == 0)
+      ++count;
+
+  return count;
+}
+
+static void
+BenchmarkCallSign(const FlarmDatabase &database, const TCHAR *cn,
+                  bool prefix)
+{
+  unsigned linear_results = 0;
+  uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    linear_results = FindIdsLinear(database, cn, prefix);
+  const double linear_us = double(MonotonicClockUS() - start) / ITERATIONS;
+
+  FlarmId ids[64];
+  unsigned results = 0;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    results = prefix
+      ? database.FindIdsByCallSignPrefix(cn, ids, ARRAY_SIZE(ids))
+      : database.FindIdsByCallSign(cn, ids, ARRAY_SIZE(ids));
+  const double index_us = double(MonotonicClockUS() - start) / ITERATIONS;
+
+  /* the index returns at most ARRAY_SIZE(ids) results */
+  _tprintf(_T("%-8s %-6s %8u %8u %12.2f %12.2f\n"),
+           prefix ? _T("prefix") : _T("exact"), cn,
+           linear_results, results, linear_us, index_us);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s PATH CACHE_DIR\n", argv[0]);
+    return 1;
+  }
+
+  PathName path(argv[1]);
+  PathName cache_path(argv[2]);
+  FileCache cache(cache_path);
+
+  FlarmDatabase parsed;
+  uint64_t start = MonotonicClockUS();
+  unsigned n = FlarmNetReader::LoadFile(path, parsed);
+  printf("parse: %u records in %.2f ms\n",
+         n, (MonotonicClockUS() - start) / 1000.);
+
+  if (parsed.IsEmpty()) {
+    fprintf(stderr, "No records\n");
+    return 1;
+  }
+
+  start = MonotonicClockUS();
+  FILE *file = cache.Save(cache_name, path);
+  if (file == NULL || !parsed.Save(file) ||
+      !cache.Commit(cache_name, file)) {
+    fprintf(stderr, "Failed to write the cache file\n");
+    return 1;
+  }
+  printf("cache save: %.2f ms\n", (MonotonicClockUS() - start) / 1000.);
+
+  FlarmDatabase mapped;
+  TCHAR buffer[MAX_PATH];
+  start = MonotonicClockUS();
+  const TCHAR *cache_file = cache.LoadPath(cache_name, path, buffer);
+  if (cache_file == NULL ||
+      !mapped.Map(cache_file, FileCache::HEADER_SIZE)) {
+    fprintf(stderr, "Failed to map the cache file\n");
+    return 1;
+  }
+  printf("cache map: %u records in %.2f ms\n",
+         mapped.GetCount(), (MonotonicClockUS() - start) / 1000.);
+
+  /* look up every n-th id */
+  std::vector<FlarmId> ids;
+  for (unsigned i = 0; i < mapped.GetCount(); i += 7)
+    ids.push_back(mapped.begin()[i].GetId());
+
+  unsigned found = 0;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    for (auto j = ids.begin(), end = ids.end(); j != end; ++j)
+      if (mapped.FindRecordById(*j) != NULL)
+        ++found;
+  printf("id lookup: %.3f us (%u found)\n",
+         double(MonotonicClockUS() - start) / ITERATIONS / ids.size(),
+         found / ITERATIONS);
+
+  /* use call signs which occur in the file */
+  const FlarmRecord &sample = mapped.begin()[mapped.GetCount() / 2];
+  TCHAR exact[8], prefix[2];
+  _tcscpy(exact, sample.callsign);
+  prefix[0] = exact[0];
+  prefix[1] = _T('\0');
+
+  printf("%-8s %-6s %8s %8s %12s %12s\n", "search", "cn", "results",
+         "returned", "linear [us]", "index [us]");
+  BenchmarkCallSign(mapped, exact, false);
+  BenchmarkCallSign(mapped, prefix, true);
+  BenchmarkCallSign(mapped, _T("ZZZ"), false);
+
+  cache.Flush(cache_name);
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the throughput of the G record digest: four independent
+ * MD5 objects fed one character at a time (as #GRecord did before
+ * #MD5x4), and the current #GRecord implementation.  Both must yield
+ * the same digest.
+ */
+
+#include "Logger/LoggerGRecord.hpp"
+#include "Logger/MD5.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Clock.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+static const unsigned ITERATIONS = 10;
+
+/**
+ * The G record calculation as it was before #MD5x4 (key #2).
+ */
+static void
+LegacyDigest(const std::vector<std::string> &lines, char *output)
+{
+  MD5 md5[4];
+  md5[0].InitKey(0x1C80A301, 0x9EB30b89, 0x39CB2Afe, 0x0D0FEA76);
+  md5[1].InitKey(0x48327203, 0x3948ebea, 0x9a9b9c9e, 0xb3bed89a);
+  md5[2].InitKey(0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476);
+  md5[3].InitKey(0xc8e899e8, 0x9321c28a, 0x438eba12, 0x8cbe0aee);
+
+  for (auto i = lines.begin(), end = lines.end(); i != end; ++i) {
+    const char *line = i->c_str();
+    if (line[0] == 'G' ||
+        (line[0] == 'H' && (line[1] == 'O' || line[1] == 'P')) ||
+        (line[0] == 'L' && memcmp(line + 1, XCSOAR_IGC_CODE, 3) != 0))
+      continue;
+
+    for (unsigned j = 0; j < 4; ++j)
+      md5[j].AppendString((const unsigned char *)line, true);
+  }
+
+  for (unsigned j = 0; j < 4; ++j) {
+    md5[j].Finalize();
+    md5[j].GetDigest(output + j * 32);
+  }
+}
+
+static void
+CurrentDigest(const std::vector<std::string> &lines, char *output)
+{
+  GRecord grecord;
+  grecord.Initialize();
+
+  for (auto i = lines.begin(), end = lines.end(); i != end; ++i)
+    grecord.AppendRecordToBuffer(i->c_str());
+
+  grecord.FinalizeBuffer();
+  grecord.GetDigest(output);
+}
+
+static void
+Report(const char *name, uint64_t duration_us, size_t bytes)
+{
+  const double seconds = duration_us / 1000000. / ITERATIONS;
+  printf("%-16s %10.2f ms %10.1f MB/s\n", name, seconds * 1000,
+         bytes / seconds / (1024 * 1024));
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s FILE.igc\n", argv[0]);
+    return 1;
+  }
+
+  const char *path = argv[1];
+
+  std::vector<std::string> lines;
+  size_t bytes = 0;
+
+  {
+    FileLineReaderA reader(path);
+    if (reader.error()) {
+      fprintf(stderr, "Failed to open %s\n", path);
+      return 1;
+    }
+
+    const char *line;
+    while ((line = reader.read()) != NULL) {
+      lines.push_back(line);
+      bytes += lines.back().length();
+    }
+  }
+
+  printf("%u lines, %lu bytes\n", (unsigned)lines.size(),
+         (unsigned long)bytes);
+
+  char legacy[GRecord::DIGEST_LENGTH * 2 + 1];
+  uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    LegacyDigest(lines, legacy);
+  Report("legacy", MonotonicClockUS() - start, bytes);
+
+  char current[GRecord::DIGEST_LENGTH * 2 + 1];
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    CurrentDigest(lines, current);
+  Report("MD5x4", MonotonicClockUS() - start, bytes);
+
+  /* the whole file, including I/O, as in VerifyGRecord */
+  bool verified = false;
+  start = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    GRecord grecord;
+    grecord.Initialize();
+    grecord.SetFileName(path);
+    verified = grecord.VerifyGRecordInFile();
+  }
+  Report("verify file", MonotonicClockUS() - start, bytes);
+
+  printf("G record %s\n", verified ? "ok" : "NOT ok");
+
+  if (strcmp(legacy, current) != 0) {
+    fprintf(stderr, "Digest mismatch:\n%s\n%s\n", legacy, current);
+    return 2;
+  }
+
+  printf("digest %s\n", current);
+  return 0;
+}
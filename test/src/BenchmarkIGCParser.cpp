@@ -0,0 +1,200 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the throughput of the IGC "B" record parsers: the sscanf()
+ * based parser as it was before #IGCFixReader, the current line
+ * parser, and #IGCFixReader on a memory-mapped file.
+ */
+
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFixReader.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+
+#include <stdio.h>
+
+static const unsigned ITERATIONS = 10;
+
+/**
+ * The "B" record parser as it was before #IGCFixReader (without
+ * the extensions).
+ */
+static bool
+LegacyParseFix(const char *buffer, IGCFix &fix)
+{
+  if (*buffer != 'B')
+    return false;
+
+  unsigned hour, minute, second;
+  if (sscanf(buffer + 1, "%02u%02u%02u", &hour, &minute, &second) != 3)
+    return false;
+
+  fix.time = BrokenTime(hour, minute, second);
+  if (!fix.time.Plausible())
+    return false;
+
+  char valid_char;
+  int gps_altitude, pressure_altitude;
+  if (sscanf(buffer + 24, "%c%05d%05d",
+             &valid_char, &pressure_altitude, &gps_altitude) != 3)
+    return false;
+
+  fix.gps_valid = valid_char == 'A';
+  fix.gps_altitude = gps_altitude;
+  fix.pressure_altitude = pressure_altitude;
+
+  unsigned lat_degrees, lat_minutes, lon_degrees, lon_minutes;
+  char lat_char, lon_char;
+  if (sscanf(buffer + 7, "%02u%05u%c%03u%05u%c",
+             &lat_degrees, &lat_minutes, &lat_char,
+             &lon_degrees, &lon_minutes, &lon_char) != 6)
+    return false;
+
+  fix.location.latitude = Angle::Degrees(fixed(lat_degrees) +
+                                         fixed(lat_minutes) / 60000);
+  if (lat_char == 'S')
+    fix.location.latitude.Flip();
+
+  fix.location.longitude = Angle::Degrees(fixed(lon_degrees) +
+                                          fixed(lon_minutes) / 60000);
+  if (lon_char == 'W')
+    fix.location.longitude.Flip();
+
+  return true;
+}
+
+static unsigned long
+ReadLegacy(const TCHAR *path, size_t &size)
+{
+  FileLineReaderA reader(path);
+  if (reader.error())
+    return 0;
+
+  size = reader.size();
+
+  unsigned long n = 0;
+  const char *line;
+  while ((line = reader.read()) != NULL) {
+    IGCFix fix;
+    if (LegacyParseFix(line, fix))
+      ++n;
+  }
+
+  return n;
+}
+
+static unsigned long
+ReadLines(const TCHAR *path, size_t &size)
+{
+  FileLineReaderA reader(path);
+  if (reader.error())
+    return 0;
+
+  size = reader.size();
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  unsigned long n = 0;
+  const char *line;
+  while ((line = reader.read()) != NULL) {
+    if (line[0] == 'I')
+      IGCParseExtensions(line, extensions);
+    else {
+      IGCFix fix;
+      if (IGCParseFix(line, extensions, fix))
+        ++n;
+    }
+  }
+
+  return n;
+}
+
+static unsigned long
+ReadMapped(const TCHAR *path, size_t &size)
+{
+  IGCFixReader reader(path);
+  if (reader.error())
+    return 0;
+
+  size = reader.GetSize();
+
+  IGCFix fixes[256];
+  unsigned long n = 0;
+  unsigned batch;
+  while ((batch = reader.Read(fixes, 256)) > 0)
+    n += batch;
+
+  return n;
+}
+
+static void
+Benchmark(const char *name, const TCHAR *path,
+          unsigned long (*function)(const TCHAR *path, size_t &size))
+{
+  unsigned long fixes = 0;
+  size_t size = 0;
+  uint64_t best = uint64_t(-1);
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    const uint64_t start = MonotonicClockUS();
+    fixes = function(path, size);
+    const uint64_t duration = MonotonicClockUS() - start;
+    if (duration < best)
+      best = duration;
+  }
+
+  if (fixes == 0) {
+    printf("%-20s failed\n", name);
+    return;
+  }
+
+  if (best == 0)
+    best = 1;
+
+  printf("%-20s %10.2f ms %10.1f MB/s %10.2f Mfixes/s (%lu fixes)\n", name,
+         best / 1000., (double)size / best, (double)fixes / best, fixes);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s PATH...\n", argv[0]);
+    return 1;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    PathName path(argv[i]);
+    printf("%s\n", argv[i]);
+
+    Benchmark("sscanf (legacy)", path, ReadLegacy);
+    Benchmark("FileLineReaderA", path, ReadLines);
+    Benchmark("IGCFixReader", path, ReadMapped);
+  }
+
+  return 0;
+}
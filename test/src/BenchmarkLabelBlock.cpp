@@ -0,0 +1,151 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Places thousands of label rectangles on a screen with #LabelBlock,
+ * and compares it with a linear search over all labels.
+ */
+
+#include "Screen/LabelBlock.hpp"
+#include "OS/Clock.hpp"
+#include "Util/Macros.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const unsigned ITERATIONS = 20;
+
+struct ScreenSetup {
+  unsigned width, height;
+  unsigned num_labels;
+};
+
+static const ScreenSetup setups[] = {
+  { 320, 240, 500 },
+  { 640, 480, 2000 },
+  { 800, 480, 5000 },
+  { 1920, 1080, 5000 },
+  { 1920, 1080, 20000 },
+};
+
+static bool
+Overlaps(const PixelRect &a, const PixelRect &b)
+{
+  return a.left < b.right && a.right > b.left &&
+    a.top < b.bottom && a.bottom > b.top;
+}
+
+static unsigned
+PlaceLinear(const std::vector<PixelRect> &labels)
+{
+  std::vector<PixelRect> accepted;
+
+  for (auto i = labels.begin(), end = labels.end(); i != end; ++i) {
+    bool free = true;
+    for (auto j = accepted.begin(), end2 = accepted.end(); j != end2; ++j) {
+      if (Overlaps(*i, *j)) {
+        free = false;
+        break;
+      }
+    }
+
+    if (free)
+      accepted.push_back(*i);
+  }
+
+  return accepted.size();
+}
+
+static unsigned
+PlaceGrid(LabelBlock &block, const ScreenSetup &setup,
+          const std::vector<PixelRect> &labels)
+{
+  block.reset(setup.width, setup.height);
+
+  unsigned n = 0;
+  for (auto i = labels.begin(), end = labels.end(); i != end; ++i)
+    if (block.check(*i))
+      ++n;
+
+  return n;
+}
+
+/**
+ * Generate labels of typical waypoint name size, partially outside
+ * of the screen, like the map does.
+ */
+static void
+GenerateLabels(std::vector<PixelRect> &labels, const ScreenSetup &setup)
+{
+  labels.clear();
+
+  for (unsigned i = 0; i < setup.num_labels; ++i) {
+    PixelRect rc;
+    rc.left = rand() % (setup.width + 40) - 20;
+    rc.top = rand() % (setup.height + 20) - 10;
+    rc.right = rc.left + 30 + rand() % 100;
+    rc.bottom = rc.top + 16;
+    labels.push_back(rc);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  srand(42);
+
+  LabelBlock block;
+  std::vector<PixelRect> labels;
+
+  printf("%-10s %8s %8s %12s %12s\n", "screen", "labels", "placed",
+         "linear [ms]", "grid [ms]");
+
+  for (unsigned i = 0; i < ARRAY_SIZE(setups); ++i) {
+    const ScreenSetup &setup = setups[i];
+    GenerateLabels(labels, setup);
+
+    unsigned linear_placed = 0;
+    uint64_t start = MonotonicClockUS();
+    for (unsigned j = 0; j < ITERATIONS; ++j)
+      linear_placed = PlaceLinear(labels);
+    const double linear_ms = (MonotonicClockUS() - start) / 1000. / ITERATIONS;
+
+    unsigned grid_placed = 0;
+    start = MonotonicClockUS();
+    for (unsigned j = 0; j < ITERATIONS; ++j)
+      grid_placed = PlaceGrid(block, setup, labels);
+    const double grid_ms = (MonotonicClockUS() - start) / 1000. / ITERATIONS;
+
+    char screen[32];
+    snprintf(screen, sizeof(screen), "%ux%u", setup.width, setup.height);
+
+    printf("%-10s %8u %8u %12.3f %12.3f", screen, setup.num_labels,
+           grid_placed, linear_ms, grid_ms);
+    if (grid_placed != linear_placed)
+      printf(" (linear: %u placed)", linear_placed);
+    printf("\n");
+  }
+
+  return 0;
+}
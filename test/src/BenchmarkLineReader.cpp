@@ -0,0 +1,112 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the throughput of the line readers on (large) text files,
+ * e.g. OpenAir and SeeYou CUP files.
+ */
+
+#include "IO/FileLineReader.hpp"
+#include "IO/MappedLineReader.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+
+#include <stdio.h>
+
+static const unsigned ITERATIONS = 10;
+
+/**
+ * Read all lines and return the number of characters, to make sure
+ * the compiler cannot optimise the loop away.
+ */
+template<typename R>
+static unsigned long
+ReadAll(R &reader)
+{
+  unsigned long n = 0;
+  const auto *line = reader.read();
+  for (; line != NULL; line = reader.read())
+    n += line[0] != 0;
+  return n;
+}
+
+/**
+ * The waypoint and airspace parsers use ConvertLineReader::AUTO.
+ */
+struct AutoFileLineReader : public FileLineReader {
+  AutoFileLineReader(const TCHAR *path)
+    :FileLineReader(path, ConvertLineReader::AUTO) {}
+};
+
+struct AutoMappedLineReader : public MappedLineReader {
+  AutoMappedLineReader(const TCHAR *path)
+    :MappedLineReader(path, ConvertLineReader::AUTO) {}
+};
+
+template<typename R>
+static void
+Benchmark(const char *name, const TCHAR *path)
+{
+  unsigned long lines = 0;
+  long size = 0;
+  uint64_t best = uint64_t(-1);
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    const uint64_t start = MonotonicClockUS();
+    R reader(path);
+    if (reader.error()) {
+      printf("%-20s failed to open\n", name);
+      return;
+    }
+
+    lines = ReadAll(reader);
+    size = reader.size();
+
+    const uint64_t duration = MonotonicClockUS() - start;
+    if (duration < best)
+      best = duration;
+  }
+
+  printf("%-20s %10.2f ms %10.1f MB/s (%lu lines)\n", name,
+         best / 1000., (double)size / (best > 0 ? best : 1), lines);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s PATH...\n", argv[0]);
+    return 1;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    PathName path(argv[i]);
+    printf("%s\n", argv[i]);
+
+    Benchmark<FileLineReaderA>("FileLineReaderA", path);
+    Benchmark<MappedLineReaderA>("MappedLineReaderA", path);
+    Benchmark<AutoFileLineReader>("FileLineReader", path);
+    Benchmark<AutoMappedLineReader>("MappedLineReader", path);
+  }
+
+  return 0;
+}
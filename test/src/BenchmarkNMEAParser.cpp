@@ -0,0 +1,130 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the throughput of the NMEA parser (and optionally a device
+ * driver) on a recorded NMEA log file.
+ */
+
+#include "Device/Parser.hpp"
+#include "Device/Driver.hpp"
+#include "Device/Register.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "Profile/DeviceConfig.hpp"
+#include "NMEA/Info.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Util/StringUtil.hpp"
+
+#include <vector>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** repeat the whole log until at least this much time has passed */
+static const uint64_t MIN_DURATION_US = 2000000;
+
+int main(int argc, char **argv)
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s PATH [DRIVER]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *file = fopen(argv[1], "r");
+  if (file == NULL) {
+    fprintf(stderr, "Failed to open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> lines;
+  size_t bytes = 0;
+
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), file) != NULL) {
+    TrimRight(buffer);
+    if (*buffer != 0) {
+      lines.push_back(buffer);
+      bytes += lines.back().length();
+    }
+  }
+
+  fclose(file);
+
+  if (lines.empty()) {
+    fprintf(stderr, "No sentences\n");
+    return EXIT_FAILURE;
+  }
+
+  Device *device = NULL;
+  NullPort port;
+  if (argc == 3) {
+    PathName driver_name(argv[2]);
+    const struct DeviceRegister *driver = FindDriverByName(driver_name);
+    if (driver == NULL) {
+      fprintf(stderr, "No such driver: %s\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+
+    DeviceConfig config;
+    config.Clear();
+
+    if (driver->CreateOnPort != NULL)
+      device = driver->CreateOnPort(config, port);
+  }
+
+  NMEAParser parser;
+
+  NMEAInfo data;
+  data.Reset();
+  data.clock = fixed_one;
+
+  unsigned passes = 0, parsed = 0;
+  const uint64_t start = MonotonicClockUS();
+  uint64_t duration;
+
+  do {
+    parsed = 0;
+    for (auto i = lines.begin(), end = lines.end(); i != end; ++i) {
+      const char *line = i->c_str();
+      if ((device != NULL && device->ParseNMEA(line, data)) ||
+          parser.ParseLine(line, data))
+        ++parsed;
+    }
+
+    ++passes;
+    duration = MonotonicClockUS() - start;
+  } while (duration < MIN_DURATION_US);
+
+  const double seconds = duration / 1000000.;
+  const double sentences = (double)lines.size() * passes;
+
+  printf("%u sentences (%u parsed), %u passes in %.2f s\n",
+         (unsigned)lines.size(), parsed, passes, seconds);
+  printf("%.0f sentences/s, %.1f MB/s\n",
+         sentences / seconds, bytes * passes / seconds / 1000000.);
+
+  delete device;
+  return EXIT_SUCCESS;
+}
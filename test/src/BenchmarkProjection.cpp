@@ -23,33 +23,78 @@ Copyright_License {
 
 #include "Projection/Projection.hpp"
 #include "Screen/Layout.hpp"
+#include "OS/Clock.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
 
 unsigned Layout::scale_1024 = 1024;
 
 class TestProjection : public Projection {
 public:
   TestProjection() {
-    SetScreenOrigin(0, 0);
+    SetScreenOrigin(320, 240);
     SetScale(fixed(640) / (fixed(100) * 2));
     SetGeoLocation(GeoPoint(Angle::Degrees(fixed(7.7061111111111114)),
                             Angle::Degrees(fixed(51.051944444444445))));
+    SetScreenAngle(Angle::Degrees(fixed(30)));
   }
 };
 
+static const unsigned NUM_POINTS = 4096;
+static const unsigned ITERATIONS = 4096;
+
+static GeoPoint geo_points[NUM_POINTS];
+static RasterPoint scalar_points[NUM_POINTS], batch_points[NUM_POINTS];
+
+static double
+Mpps(uint64_t duration_us)
+{
+  return (double)NUM_POINTS * ITERATIONS / duration_us;
+}
+
 int main(int argc, char **argv)
 {
   TestProjection projection;
 
-  GeoPoint gp = GeoPoint(Angle::Degrees(fixed(7.7061111111111114)),
-                         Angle::Degrees(fixed(51.051944444444445)));
+  /* random points within one degree of the screen origin */
+  srand(42);
+  for (unsigned i = 0; i < NUM_POINTS; ++i)
+    geo_points[i] =
+      GeoPoint(Angle::Degrees(fixed(7.7061111111111114 +
+                                    2. * rand() / RAND_MAX - 1)),
+               Angle::Degrees(fixed(51.051944444444445 +
+                                    2. * rand() / RAND_MAX - 1)));
+
   long x = 0, y = 0;
-  for (unsigned i = 64 * 1024 * 1024; i-- > 0;) {
-    RasterPoint rp = projection.GeoToScreen(gp);
+
+  uint64_t start = MonotonicClockUS();
+  for (unsigned j = 0; j < ITERATIONS; ++j) {
+    for (unsigned i = 0; i < NUM_POINTS; ++i)
+      scalar_points[i] = projection.GeoToScreen(geo_points[i]);
 
     /* prevent gcc from optimizing this loop away */
-    x += rp.x;
-    y += rp.y;
+    x += scalar_points[j % NUM_POINTS].x;
+  }
+  const uint64_t scalar_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (unsigned j = 0; j < ITERATIONS; ++j) {
+    projection.GeoToScreen(geo_points, batch_points, NUM_POINTS);
+    y += batch_points[j % NUM_POINTS].y;
   }
+  const uint64_t batch_us = MonotonicClockUS() - start;
+
+  unsigned mismatches = 0;
+  for (unsigned i = 0; i < NUM_POINTS; ++i)
+    if (scalar_points[i].x != batch_points[i].x ||
+        scalar_points[i].y != batch_points[i].y)
+      ++mismatches;
+
+  printf("scalar: %.1f Mpoints/s\n", Mpps(scalar_us));
+  printf("batch:  %.1f Mpoints/s\n", Mpps(batch_us));
+  if (mismatches > 0)
+    printf("%u of %u points differ\n", mismatches, NUM_POINTS);
 
-  return x + y;
+  return (x + y) == 0x7fffffff;
 }
@@ -0,0 +1,392 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays a flight through the full #GlideComputer as fast as
+ * possible, with the waypoints, airspaces, terrain, task and
+ * settings of a profile, and reports the time spent in each
+ * calculation stage, the peak memory usage and the number of fixes
+ * per second.  With JSON_FILE, the results are also written in JSON
+ * format, for tracking performance regressions.
+ *
+ * The task is loaded from "Default.tsk" in the directory of the
+ * profile, which is used as the data path.
+ */
+
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/Tasks/OrderedTask.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "Waypoint/WaypointGlue.hpp"
+#include "Airspace/AirspaceGlue.hpp"
+#include "Atmosphere/Pressure.hpp"
+#include "Profile/Profile.hpp"
+#include "Profile/ComputerProfile.hpp"
+#include "Plane/Plane.hpp"
+#include "Plane/PlaneGlue.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Operation/Operation.hpp"
+#include "LocalPath.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "GPSClock.hpp"
+#include "DebugReplay.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef HAVE_POSIX
+#include <sys/resource.h>
+#endif
+
+/* fake symbols: */
+
+#include "ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+#include "LocalTime.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Look/AirspaceLook.hpp"
+
+void ConditionMonitorsUpdate(const GlideComputer &cmp) {}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+bool
+InputEvents::processNmea(unsigned key)
+{
+  return true;
+}
+
+int GetUTCOffset() { return 0; }
+
+void
+DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const fixed alt)
+{
+}
+
+/* Profile/AirspaceConfig.cpp loads the airspace renderer settings,
+   too */
+
+const Color AirspaceLook::preset_colors[NUMAIRSPACECOLORS] = {};
+
+bool
+Profile::GetColor(const TCHAR *key, Color &value)
+{
+  return false;
+}
+
+void
+Profile::SetColor(const TCHAR *key, const Color value)
+{
+}
+
+/* done with fake symbols. */
+
+/**
+ * The wall clock and CPU time of one benchmark phase.
+ */
+class PhaseTimer {
+  uint64_t start_wall, start_cpu;
+
+public:
+  PhaseTimer():start_wall(MonotonicClockUS()), start_cpu(GetCPUTime()) {}
+
+  double GetWallMS() const {
+    return (MonotonicClockUS() - start_wall) / 1000.;
+  }
+
+  double GetCPUMS() const {
+    return (GetCPUTime() - start_cpu) / 1000.;
+  }
+
+  /**
+   * Returns the CPU time consumed by this process [us].
+   */
+  static uint64_t GetCPUTime() {
+#ifdef HAVE_POSIX
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+      + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+    return MonotonicClockUS();
+#endif
+  }
+};
+
+/**
+ * Returns the peak resident set size of this process [kB], or 0 if
+ * unknown.
+ */
+static unsigned long
+GetPeakMemory()
+{
+#ifdef HAVE_POSIX
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#else
+  return 0;
+#endif
+}
+
+struct LoadTimes {
+  double terrain, waypoints, airspace, task;
+};
+
+static RasterTerrain *terrain;
+
+static void
+LoadFiles(Waypoints &way_points, Airspaces &airspace_database,
+          ProtectedTaskManager &protected_task_manager,
+          const ComputerSettings &settings, LoadTimes &times)
+{
+  NullOperationEnvironment operation;
+
+  PhaseTimer timer;
+  terrain = RasterTerrain::OpenTerrain(NULL, operation);
+  times.terrain = timer.GetWallMS();
+
+  timer = PhaseTimer();
+  WaypointGlue::LoadWaypoints(way_points, terrain, NULL, operation);
+  way_points.Optimise();
+  times.waypoints = timer.GetWallMS();
+
+  timer = PhaseTimer();
+  ReadAirspace(airspace_database, terrain, settings.pressure, NULL, operation);
+  times.airspace = timer.GetWallMS();
+
+  timer = PhaseTimer();
+  OrderedTask *task =
+    protected_task_manager.TaskCreateDefault(&way_points,
+                                             TaskFactoryType::RACING);
+  protected_task_manager.TaskCommit(*task);
+  delete task;
+  times.task = timer.GetWallMS();
+}
+
+struct ReplayResult {
+  unsigned n_fixes;
+
+  /** the duration of the flight [s] */
+  double flight_duration;
+
+  double wall_ms, cpu_ms;
+
+  /** the wall time of the final exhaustive contest pass */
+  double exhaustive_ms;
+
+  double GetFixesPerSecond() const {
+    return wall_ms > 0 ? n_fixes * 1000. / wall_ms : 0.;
+  }
+};
+
+static void
+Replay(DebugReplay &replay, GlideComputer &glide_computer,
+       const ComputerSettings &settings, ReplayResult &result)
+{
+  /* the replay runs much faster than real time, so the periodic
+     stages are scheduled by GPS time instead of the wall clock used
+     by GlideComputer::ProcessScheduled() */
+  GPSClock idle_clock(fixed(settings.rate.idle_period) / 1000);
+
+  result.n_fixes = 0;
+  fixed first_time = fixed_minus_one, last_time = fixed_zero;
+
+  const PhaseTimer timer;
+
+  while (replay.Next()) {
+    const MoreData &basic = replay.Basic();
+    if (!basic.time_available)
+      continue;
+
+    if (negative(first_time))
+      first_time = basic.time;
+    last_time = basic.time;
+
+    glide_computer.ReadBlackboard(basic);
+    glide_computer.ProcessGPS();
+
+    if (idle_clock.CheckAdvance(basic.time))
+      glide_computer.ProcessIdle();
+
+    ++result.n_fixes;
+  }
+
+  result.wall_ms = timer.GetWallMS();
+  result.cpu_ms = timer.GetCPUMS();
+  result.flight_duration = negative(first_time)
+    ? 0. : (double)(last_time - first_time);
+}
+
+static void
+PrintResult(const ReplayResult &result, const LoadTimes &times,
+            const StageScheduler &scheduler)
+{
+  printf("load: terrain %.1f ms, waypoints %.1f ms, airspace %.1f ms, "
+         "task %.1f ms\n",
+         times.terrain, times.waypoints, times.airspace, times.task);
+  printf("%u fixes (%.0f s of flight) in %.1f ms (%.1f ms CPU), "
+         "%.0f fixes/s\n",
+         result.n_fixes, result.flight_duration,
+         result.wall_ms, result.cpu_ms, result.GetFixesPerSecond());
+  printf("final contest pass: %.1f ms\n", result.exhaustive_ms);
+  printf("peak memory: %lu kB\n", GetPeakMemory());
+
+  printf("%-12s %8s %12s %10s %10s\n",
+         "stage", "calls", "total [ms]", "avg [us]", "max [us]");
+
+  for (unsigned i = 0; i < scheduler.size(); ++i) {
+    const StageScheduler::Statistics stats = scheduler.GetStatistics(i);
+    printf("%-12s %8u %12.1f %10u %10lu\n",
+           scheduler.GetName(i), stats.count, stats.total_us / 1000.,
+           stats.GetAverageUS(), (unsigned long)stats.max_us);
+  }
+}
+
+static bool
+WriteJSON(const char *path, const char *profile,
+          const ReplayResult &result, const LoadTimes &times,
+          const StageScheduler &scheduler)
+{
+  FILE *file = fopen(path, "w");
+  if (file == NULL)
+    return false;
+
+  fprintf(file, "{\n");
+  fprintf(file, "  \"profile\": \"%s\",\n", profile);
+  fprintf(file, "  \"fixes\": %u,\n", result.n_fixes);
+  fprintf(file, "  \"flight_duration_s\": %.0f,\n", result.flight_duration);
+  fprintf(file, "  \"wall_ms\": %.3f,\n", result.wall_ms);
+  fprintf(file, "  \"cpu_ms\": %.3f,\n", result.cpu_ms);
+  fprintf(file, "  \"fixes_per_second\": %.1f,\n",
+          result.GetFixesPerSecond());
+  fprintf(file, "  \"exhaustive_contest_ms\": %.3f,\n",
+          result.exhaustive_ms);
+  fprintf(file, "  \"peak_memory_kb\": %lu,\n", GetPeakMemory());
+  fprintf(file, "  \"load_ms\": { \"terrain\": %.3f, \"waypoints\": %.3f, "
+          "\"airspace\": %.3f, \"task\": %.3f },\n",
+          times.terrain, times.waypoints, times.airspace, times.task);
+  fprintf(file, "  \"stages\": [\n");
+
+  for (unsigned i = 0; i < scheduler.size(); ++i) {
+    const StageScheduler::Statistics stats = scheduler.GetStatistics(i);
+    fprintf(file, "    { \"name\": \"%s\", \"calls\": %u, "
+            "\"total_ms\": %.3f, \"avg_us\": %u, \"max_us\": %lu }%s\n",
+            scheduler.GetName(i), stats.count, stats.total_us / 1000.,
+            stats.GetAverageUS(), (unsigned long)stats.max_us,
+            i + 1 < scheduler.size() ? "," : "");
+  }
+
+  fprintf(file, "  ]\n");
+  fprintf(file, "}\n");
+
+  return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "PROFILE {DRIVER FILE | FILE.igc} [JSON_FILE]");
+
+  const char *profile = args.PeekNext();
+  const tstring profile_path = args.ExpectNextT();
+
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  const char *json_path = args.IsEmpty() ? NULL : args.GetNext();
+  args.ExpectEnd();
+
+  /* the profile's directory is the data path, for resolving the
+     file names in the profile and the default task */
+  TCHAR data_path[MAX_PATH];
+  SetPrimaryDataPath(DirName(profile_path.c_str(), data_path));
+
+  Profile::LoadFile(profile_path.c_str());
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  Profile::Load(settings);
+
+  Plane plane;
+  PlaneGlue::FromProfile(plane);
+
+  GlidePolar &glide_polar = settings.polar.glide_polar_task;
+  glide_polar = GlidePolar(fixed_zero);
+  glide_polar.SetMC(settings.task.safety_mc);
+  PlaneGlue::Synchronize(plane, settings, glide_polar);
+
+  Waypoints way_points;
+
+  TaskManager task_manager(settings.task, way_points);
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+  task_manager.SetGlidePolar(glide_polar);
+
+  Airspaces airspace_database;
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  LoadTimes times;
+  LoadFiles(way_points, airspace_database, protected_task_manager,
+            settings, times);
+
+  GlideComputer glide_computer(way_points, airspace_database,
+                               protected_task_manager,
+                               task_events);
+  glide_computer.ReadComputerSettings(settings);
+  glide_computer.SetTerrain(terrain);
+  glide_computer.Initialise();
+
+  ReplayResult result;
+  Replay(*replay, glide_computer, settings, result);
+  delete replay;
+
+  const PhaseTimer exhaustive_timer;
+  glide_computer.ProcessExhaustive();
+  result.exhaustive_ms = exhaustive_timer.GetWallMS();
+
+  const StageScheduler &scheduler = glide_computer.GetScheduler();
+  PrintResult(result, times, scheduler);
+
+  if (json_path != NULL &&
+      !WriteJSON(json_path, profile, result, times, scheduler)) {
+    fprintf(stderr, "Failed to write %s\n", json_path);
+    return EXIT_FAILURE;
+  }
+
+  delete terrain;
+
+  return EXIT_SUCCESS;
+}
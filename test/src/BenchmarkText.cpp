@@ -0,0 +1,169 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Draws a typical set of map labels (several hundred waypoint names)
+ * repeatedly, and reports the time per frame and the memory occupied
+ * by the text cache.
+ */
+
+#include "Screen/SingleWindow.hpp"
+#include "Screen/Canvas.hpp"
+#include "Screen/Font.hpp"
+#include "Screen/Init.hpp"
+#include "OS/Clock.hpp"
+#include "Util/StaticString.hpp"
+#include "Util/Macros.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/Cache.hpp"
+#endif
+
+#include <stdio.h>
+
+static const unsigned NUM_LABELS = 500;
+static const unsigned NUM_FRAMES = 100;
+
+static const TCHAR *const syllables[] = {
+  _T("Alt"), _T("Berg"), _T("Bad"), _T("Dorf"), _T("Feld"), _T("Hau"),
+  _T("sen"), _T("heim"), _T("ingen"), _T("Kir"), _T("chen"), _T("Lau"),
+  _T("Mar"), _T("Neu"), _T("Ober"), _T("Ried"), _T("stadt"), _T("Wald"),
+  _T("burg"), _T("ach"), _T("tal"), _T("Unter"), _T("hof"), _T("See"),
+};
+
+class BenchmarkWindow : public SingleWindow {
+  Font font;
+
+  StaticString<32> labels[NUM_LABELS];
+  RasterPoint positions[NUM_LABELS];
+
+  bool done;
+
+public:
+  BenchmarkWindow():done(false) {
+    /* a simple linear congruential generator, so all runs draw the
+       same labels */
+    unsigned seed = 42;
+
+    for (unsigned i = 0; i < NUM_LABELS; ++i) {
+      StaticString<32> &label = labels[i];
+      label.clear();
+
+      seed = seed * 1103515245 + 12345;
+      const unsigned n = 2 + (seed >> 16) % 3;
+      for (unsigned j = 0; j < n; ++j) {
+        seed = seed * 1103515245 + 12345;
+        label.append(syllables[(seed >> 16) % ARRAY_SIZE(syllables)]);
+      }
+
+      seed = seed * 1103515245 + 12345;
+      if ((seed >> 16) % 2 == 0) {
+        /* arrival altitude, as shown for landables */
+        seed = seed * 1103515245 + 12345;
+        label.AppendFormat(_T(":%u"), (seed >> 16) % 3000);
+      }
+
+      seed = seed * 1103515245 + 12345;
+      positions[i].x = (seed >> 16) % 600;
+      seed = seed * 1103515245 + 12345;
+      positions[i].y = (seed >> 16) % 440;
+    }
+  }
+
+  void set(PixelRect rc) {
+    SingleWindow::set(_T("BenchmarkText"), _T("BenchmarkText"), rc);
+    font.Set(_T("Droid Sans"), 16);
+  }
+
+private:
+  void DrawFrame(Canvas &canvas) {
+    canvas.ClearWhite();
+    canvas.Select(font);
+    canvas.SetTextColor(COLOR_BLACK);
+    canvas.SetBackgroundColor(COLOR_WHITE);
+
+    for (unsigned i = 0; i < NUM_LABELS; ++i) {
+      const TCHAR *label = labels[i];
+      const RasterPoint p = positions[i];
+
+      /* the label renderer measures each label before drawing it */
+      const PixelSize size = canvas.CalcTextSize(label);
+
+      if (i % 2 == 0) {
+        canvas.SetBackgroundOpaque();
+        canvas.text(p.x - size.cx / 2, p.y, label);
+      } else {
+        canvas.SetBackgroundTransparent();
+        canvas.text_transparent(p.x - size.cx / 2, p.y, label);
+      }
+    }
+
+#ifdef ENABLE_OPENGL
+    glFinish();
+#endif
+  }
+
+protected:
+  virtual void OnPaint(Canvas &canvas) {
+    if (done) {
+      SingleWindow::OnPaint(canvas);
+      return;
+    }
+
+    done = true;
+
+    uint64_t start = MonotonicClockUS();
+    DrawFrame(canvas);
+    const double first_ms = (MonotonicClockUS() - start) / 1000.;
+
+    start = MonotonicClockUS();
+    for (unsigned i = 0; i < NUM_FRAMES; ++i)
+      DrawFrame(canvas);
+    const double frame_ms =
+      (MonotonicClockUS() - start) / 1000. / NUM_FRAMES;
+
+    printf("%u labels\n", NUM_LABELS);
+    printf("first frame: %.3f ms\n", first_ms);
+    printf("frame: %.3f ms\n", frame_ms);
+#if defined(ENABLE_OPENGL) && !defined(ANDROID)
+    printf("glyph atlas memory: %u bytes\n",
+           (unsigned)TextCache::GetMemoryUsage());
+#endif
+
+    SingleWindow::OnPaint(canvas);
+    PostQuit();
+  }
+};
+
+int main(int argc, char **argv)
+{
+  ScreenGlobalInit screen_init;
+
+  BenchmarkWindow window;
+  window.set(PixelRect{0, 0, 640, 480});
+  window.Show();
+
+  window.RunEventLoop();
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the waypoint list filter with and without
+ * #WaypointFilterIndex on a (large) waypoint file.
+ */
+
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/WaypointFilter.hpp"
+#include "Waypoint/WaypointFilterIndex.hpp"
+#include "Waypoint/WaypointList.hpp"
+#include "Waypoint/WaypointListBuilder.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Operation/Operation.hpp"
+#include "Util/Macros.hpp"
+
+#include <stdio.h>
+
+static const unsigned ITERATIONS = 100;
+
+struct FilterSetup {
+  const char *description;
+  const TCHAR *name;
+  unsigned distance;
+  int direction;
+  TypeFilter type;
+};
+
+static const FilterSetup setups[] = {
+  { "50 km", _T(""), 50000, -1, TypeFilter::ALL },
+  { "250 km", _T(""), 250000, -1, TypeFilter::ALL },
+  { "1000 km", _T(""), 1000000, -1, TypeFilter::ALL },
+  { "250 km airports", _T(""), 250000, -1, TypeFilter::AIRPORT },
+  { "1000 km landables", _T(""), 1000000, -1, TypeFilter::LANDABLE },
+  { "250 km name 'S'", _T("S"), 250000, -1, TypeFilter::ALL },
+  { "direction 90", _T(""), 0, 90, TypeFilter::ALL },
+  { "direction 90 airports", _T(""), 0, 90, TypeFilter::AIRPORT },
+};
+
+static void
+ToFilter(WaypointFilter &filter, const FilterSetup &setup)
+{
+  filter.name = setup.name;
+  filter.distance = fixed(setup.distance);
+  filter.direction = setup.direction < 0
+    ? Angle::Degrees(fixed_minus_one)
+    : Angle::Degrees(fixed(setup.direction));
+  filter.type_index = setup.type;
+}
+
+/**
+ * The waypoint list filter as it was before #WaypointFilterIndex.
+ */
+static unsigned
+FilterLinear(const Waypoints &waypoints, const WaypointFilter &filter,
+             const GeoPoint &location)
+{
+  WaypointList list;
+  WaypointListBuilder builder(filter, location, list, NULL, 0);
+  builder.Visit(waypoints);
+  list.SortByDistance(location);
+  return list.size();
+}
+
+static unsigned
+FilterIndexed(const WaypointFilterIndex &index, const WaypointFilter &filter,
+              const GeoPoint &location)
+{
+  WaypointList list;
+  WaypointListBuilder builder(filter, location, list, NULL, 0);
+  builder.Visit(index);
+  return list.size();
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s PATH\n", argv[0]);
+    return 1;
+  }
+
+  Waypoints waypoints;
+
+  PathName path(argv[1]);
+  WaypointReader parser(path, 0);
+  if (parser.Error()) {
+    fprintf(stderr, "WayPointParser::SetFile() has failed\n");
+    return 1;
+  }
+
+  NullOperationEnvironment operation;
+  if (!parser.Parse(waypoints, operation)) {
+    fprintf(stderr, "WayPointParser::Parse() has failed\n");
+    return 1;
+  }
+
+  waypoints.Optimise();
+  if (waypoints.IsEmpty()) {
+    fprintf(stderr, "No waypoints\n");
+    return 1;
+  }
+
+  printf("%u waypoints\n", waypoints.size());
+
+  WaypointFilterIndex index;
+  uint64_t start = MonotonicClockUS();
+  index.Update(waypoints);
+  printf("index build: %.2f ms\n",
+         (MonotonicClockUS() - start) / 1000.);
+
+  /* search around the centroid of all waypoints */
+  fixed longitude = fixed_zero, latitude = fixed_zero;
+  for (auto i = waypoints.begin(), end = waypoints.end(); i != end; ++i) {
+    longitude += i->location.longitude.Degrees();
+    latitude += i->location.latitude.Degrees();
+  }
+
+  const GeoPoint location(Angle::Degrees(longitude / waypoints.size()),
+                          Angle::Degrees(latitude / waypoints.size()));
+
+  printf("%-24s %8s %12s %12s\n", "filter", "results",
+         "linear [ms]", "index [ms]");
+
+  for (unsigned i = 0; i < ARRAY_SIZE(setups); ++i) {
+    WaypointFilter filter;
+    ToFilter(filter, setups[i]);
+
+    unsigned linear_results = 0;
+    start = MonotonicClockUS();
+    for (unsigned j = 0; j < ITERATIONS; ++j)
+      linear_results = FilterLinear(waypoints, filter, location);
+    const double linear_ms = (MonotonicClockUS() - start) / 1000. / ITERATIONS;
+
+    unsigned index_results = 0;
+    start = MonotonicClockUS();
+    for (unsigned j = 0; j < ITERATIONS; ++j)
+      index_results = FilterIndexed(index, filter, location);
+    const double index_ms = (MonotonicClockUS() - start) / 1000. / ITERATIONS;
+
+    printf("%-24s %8u %12.3f %12.3f", setups[i].description,
+           index_results, linear_ms, index_ms);
+    if (index_results != linear_results)
+      printf(" (linear: %u results)", linear_results);
+    printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the load time of a (large) waypoint file and the latency
+ * of Waypoints::GetNearest() and Waypoints::GetNearestLandable().
+ */
+
+#include "Waypoint/WaypointReader.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Operation/Operation.hpp"
+#include "Util/Macros.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+
+/** the number of search locations */
+static const unsigned NUM_QUERIES = 10000;
+
+static const unsigned ranges[] = { 5000, 20000, 100000 };
+
+static bool
+Load(Waypoints &waypoints, const char *_path)
+{
+  PathName path(_path);
+  WaypointReader parser(path, 0);
+  if (parser.Error()) {
+    fprintf(stderr, "WayPointParser::SetFile() has failed\n");
+    return false;
+  }
+
+  NullOperationEnvironment operation;
+  if (!parser.Parse(waypoints, operation)) {
+    fprintf(stderr, "WayPointParser::Parse() has failed\n");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Generate search locations near the waypoints, i.e. where the
+ * waypoint density is realistic.
+ */
+static void
+GetQueryLocations(const Waypoints &waypoints, std::vector<GeoPoint> &result)
+{
+  const unsigned step = std::max(waypoints.size() / NUM_QUERIES, 1u);
+  const Angle offset = Angle::Degrees(fixed(0.05));
+
+  unsigned n = 0;
+  for (auto i = waypoints.begin(), end = waypoints.end();
+       i != end && result.size() < NUM_QUERIES; ++i, ++n)
+    if (n % step == 0)
+      result.push_back(GeoPoint(i->location.longitude + offset,
+                                i->location.latitude - offset));
+}
+
+static void
+BenchmarkQueries(const Waypoints &waypoints,
+                 const std::vector<GeoPoint> &locations)
+{
+  const unsigned n = locations.size();
+
+  for (unsigned r = 0; r < ARRAY_SIZE(ranges); ++r) {
+    const fixed range(ranges[r]);
+
+    unsigned found = 0;
+    uint64_t start = MonotonicClockUS();
+    for (auto i = locations.begin(), end = locations.end(); i != end; ++i)
+      if (waypoints.GetNearest(*i, range) != NULL)
+        ++found;
+    const double nearest_us = double(MonotonicClockUS() - start) / n;
+
+    unsigned found_landable = 0;
+    start = MonotonicClockUS();
+    for (auto i = locations.begin(), end = locations.end(); i != end; ++i)
+      if (waypoints.GetNearestLandable(*i, range) != NULL)
+        ++found_landable;
+    const double landable_us = double(MonotonicClockUS() - start) / n;
+
+    printf("%4u km  GetNearest %8.2f us (%u hits)  "
+           "GetNearestLandable %8.2f us (%u hits)\n",
+           ranges[r] / 1000, nearest_us, found,
+           landable_us, found_landable);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s PATH\n", argv[0]);
+    return 1;
+  }
+
+  Waypoints waypoints;
+
+  uint64_t start = MonotonicClockUS();
+  if (!Load(waypoints, argv[1]))
+    return 1;
+
+  const double parse_ms = (MonotonicClockUS() - start) / 1000.;
+
+  start = MonotonicClockUS();
+  waypoints.Optimise();
+  const double optimise_ms = (MonotonicClockUS() - start) / 1000.;
+
+  if (waypoints.IsEmpty()) {
+    fprintf(stderr, "No waypoints\n");
+    return 1;
+  }
+
+  printf("%u waypoints\n", waypoints.size());
+  printf("parse: %.2f ms, optimise: %.2f ms\n", parse_ms, optimise_ms);
+
+  std::vector<GeoPoint> locations;
+  GetQueryLocations(waypoints, locations);
+
+  BenchmarkQueries(waypoints, locations);
+
+  return 0;
+}
@@ -228,21 +228,24 @@ DebugReplayIGC::CopyFromFix(const IGCFix &fix)
 }
 
 DebugReplay *
-CreateDebugReplay(Args &args)
+CreateDebugReplayIGC(const char *input_file)
 {
-  if (!args.IsEmpty() && MatchesExtension(args.PeekNext(), ".igc")) {
-    const char *input_file = args.ExpectNext();
-
-    FileLineReaderA *reader = new FileLineReaderA(input_file);
-    if (reader->error()) {
-      delete reader;
-      fprintf(stderr, "Failed to open %s\n", input_file);
-      return NULL;
-    }
-
-    return new DebugReplayIGC(reader);
+  FileLineReaderA *reader = new FileLineReaderA(input_file);
+  if (reader->error()) {
+    delete reader;
+    fprintf(stderr, "Failed to open %s\n", input_file);
+    return NULL;
   }
 
+  return new DebugReplayIGC(reader);
+}
+
+DebugReplay *
+CreateDebugReplay(Args &args)
+{
+  if (!args.IsEmpty() && MatchesExtension(args.PeekNext(), ".igc"))
+    return CreateDebugReplayIGC(args.ExpectNext());
+
   const tstring driver_name = args.ExpectNextT();
 
   const struct DeviceRegister *driver = FindDriverByName(driver_name.c_str());
@@ -92,4 +92,12 @@ protected:
 DebugReplay *
 CreateDebugReplay(Args &args);
 
+/**
+ * Open an IGC file for replay.
+ *
+ * @return NULL on error
+ */
+DebugReplay *
+CreateDebugReplayIGC(const char *input_file);
+
 #endif
@@ -49,6 +49,21 @@ public:
     handler = this;
   }
 
+  /**
+   * Send a PFLAA sentence describing one (synthetic) target.
+   */
+  bool SendPFLAA(unsigned alarm_level, int relative_north, int relative_east,
+                 int relative_vertical, uint32_t id, unsigned track,
+                 int turn_rate, unsigned speed, double climb_rate,
+                 unsigned type) {
+    char buffer[128];
+    snprintf(buffer, ARRAY_SIZE(buffer),
+             "PFLAA,%u,%d,%d,%d,2,%06X,%u,%d,%u,%.1f,%u",
+             alarm_level, relative_north, relative_east, relative_vertical,
+             (unsigned)id, track, turn_rate, speed, climb_rate, type);
+    return PortWriteNMEA(*port, buffer, *env);
+  }
+
 private:
   void PFLAC_S(NMEAInputLine &line) {
     char name[64];
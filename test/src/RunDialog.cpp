@@ -35,6 +35,7 @@ Copyright_License {
 #include "OS/PathName.hpp"
 #include "OS/FileUtil.hpp"
 #include "Look/DialogLook.hpp"
+#include "OS/Clock.hpp"
 
 #include <tchar.h>
 #include <stdio.h>
@@ -94,14 +95,18 @@ WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 #endif
 
   if (argc < 2) {
-    fprintf(stderr, "Usage: RunDialog XMLFILE [-portrait]\n");
+    fprintf(stderr, "Usage: RunDialog XMLFILE [-portrait] [-benchmark]\n");
     return 1;
   }
 
   PixelRect screen_rc{0, 0, 320, 240};
-  if (argc > 2 && _tcscmp(argv[2], _T("-portrait")) == 0) {
-    screen_rc.right = 240;
-    screen_rc.bottom = 320;
+  bool benchmark = false;
+  for (int i = 2; i < argc; ++i) {
+    if (_tcscmp(argv[i], _T("-portrait")) == 0) {
+      screen_rc.right = 240;
+      screen_rc.bottom = 320;
+    } else if (_tcscmp(argv[i], _T("-benchmark")) == 0)
+      benchmark = true;
   }
 
   ScreenGlobalInit screen_init;
@@ -120,16 +125,39 @@ WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
                          Fonts::map_bold, Fonts::map_bold);
   SetXMLDialogLook(dialog_look);
 
-  WndForm *form = LoadDialog(NULL, main_window, argv[1]);
-  if (form == NULL) {
-    fprintf(stderr, "Failed to load resource '%s'\n",
-            (const char *)NarrowPathName(argv[1]));
-    return 1;
+  if (benchmark) {
+    /* measure how long it takes to open the dialog, with and without
+       the cache of parsed dialog resources */
+    static const unsigned ITERATIONS = 100;
+
+    uint64_t start = MonotonicClockUS();
+    for (unsigned i = 0; i < ITERATIONS; ++i) {
+      FlushXMLDialogCache();
+      delete LoadDialog(NULL, main_window, argv[1]);
+    }
+    const double uncached_ms = (MonotonicClockUS() - start) / 1000.
+      / ITERATIONS;
+
+    start = MonotonicClockUS();
+    for (unsigned i = 0; i < ITERATIONS; ++i)
+      delete LoadDialog(NULL, main_window, argv[1]);
+    const double cached_ms = (MonotonicClockUS() - start) / 1000.
+      / ITERATIONS;
+
+    printf("open dialog: %.3f ms (parsed), %.3f ms (cached)\n",
+           uncached_ms, cached_ms);
+  } else {
+    WndForm *form = LoadDialog(NULL, main_window, argv[1]);
+    if (form == NULL) {
+      fprintf(stderr, "Failed to load resource '%s'\n",
+              (const char *)NarrowPathName(argv[1]));
+      return 1;
+    }
+
+    form->ShowModal();
+    delete form;
   }
 
-  form->ShowModal();
-  delete form;
-
   Fonts::Deinitialize();
 
   return 0;
@@ -0,0 +1,179 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Feeds a replay through #GlideComputer the way the
+ * CalculationThread does, and prints the CPU time spent in each
+ * calculation stage.  Pass a task period [ms] to enable the high
+ * rate mode.
+ *
+ * To give the task stage something to do, a "goto" task to a point
+ * 20 km north of the first fix is started.
+ */
+
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "GPSClock.hpp"
+#include "OS/Args.hpp"
+#include "DebugReplay.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* fake symbols: */
+
+#include "ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+#include "LocalTime.hpp"
+#include "Task/TaskFile.hpp"
+
+OrderedTask *
+TaskFile::GetTask(const TCHAR *path, const TaskBehaviour &task_behaviour,
+                  const Waypoints *waypoints, unsigned index)
+{
+  return NULL;
+}
+
+void ConditionMonitorsUpdate(const GlideComputer &cmp) {}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+bool
+InputEvents::processNmea(unsigned key)
+{
+  return true;
+}
+
+int GetUTCOffset() { return 0; }
+
+/* done with fake symbols. */
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "DRIVER FILE [TASK_PERIOD_MS]");
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+
+  if (!args.IsEmpty()) {
+    settings.rate.high_rate_enabled = true;
+    settings.rate.task_period = atoi(args.GetNext());
+  }
+
+  args.ExpectEnd();
+
+  Waypoints way_points;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, way_points);
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  Airspaces airspace_database;
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(way_points, airspace_database,
+                               protected_task_manager,
+                               task_events);
+  glide_computer.ReadComputerSettings(settings);
+  glide_computer.SetTerrain(NULL);
+  glide_computer.Initialise();
+
+  /* the replay runs much faster than real time, so the periodic
+     stages are scheduled by GPS time instead of the wall clock used
+     by GlideComputer::ProcessScheduled() */
+  GPSClock idle_clock(fixed(settings.rate.idle_period) / 1000);
+
+  unsigned n_fixes = 0;
+  fixed first_time = fixed_minus_one, last_time = fixed_zero;
+
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    if (!basic.time_available)
+      continue;
+
+    if (negative(first_time)) {
+      if (!basic.location_available)
+        continue;
+
+      first_time = basic.time;
+
+      const GeoPoint destination =
+        GeoVector(fixed(20000), Angle::Zero()).EndPoint(basic.location);
+      const unsigned id =
+        way_points.Append(way_points.Create(destination)).id;
+      way_points.Optimise();
+      protected_task_manager.DoGoto(*way_points.LookupId(id));
+    }
+
+    last_time = basic.time;
+
+    glide_computer.ReadBlackboard(basic);
+    glide_computer.ProcessGPS();
+
+    if (idle_clock.CheckAdvance(basic.time))
+      glide_computer.ProcessIdle();
+
+    ++n_fixes;
+  }
+
+  delete replay;
+
+  const double duration = negative(first_time)
+    ? 0. : (double)(last_time - first_time);
+
+  printf("%u fixes in %.0f s (%.1f Hz), %s\n", n_fixes, duration,
+         duration > 0 ? n_fixes / duration : 0.,
+         settings.rate.high_rate_enabled ? "high rate mode" : "normal mode");
+  printf("%-12s %8s %12s %10s %10s %8s %8s\n",
+         "stage", "calls", "total [ms]", "avg [us]", "max [us]",
+         "overruns", "cpu [%]");
+
+  const StageScheduler &scheduler = glide_computer.GetScheduler();
+  for (unsigned i = 0; i < scheduler.size(); ++i) {
+    const StageScheduler::Statistics stats = scheduler.GetStatistics(i);
+
+    printf("%-12s %8u %12.1f %10u %10lu %8u %8.3f\n",
+           scheduler.GetName(i), stats.count, stats.total_us / 1000.,
+           stats.GetAverageUS(), (unsigned long)stats.max_us,
+           stats.overruns,
+           duration > 0 ? stats.total_us / (duration * 1e4) : 0.);
+  }
+
+  return EXIT_SUCCESS;
+}
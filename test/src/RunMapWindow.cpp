@@ -178,7 +178,7 @@ LoadFiles(ComputerSettings &settings)
 
   terrain = RasterTerrain::OpenTerrain(NULL, operation);
 
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, NULL, operation);
   WaypointGlue::SetHome(way_points, terrain, settings, NULL, false);
 
   TLineReader *reader = OpenConfiguredTextFile(szProfileAirspaceFile,
@@ -95,13 +95,32 @@ Test2()
   ok1(!line.ReadChecked(temp_int) && temp_int == 42);
 }
 
+static void
+Test3()
+{
+  CSVLine line("$GPRMC,,RMC,RMCX");
+
+  // Test ReadView()
+  size_t length;
+  const char *p = line.ReadView(length);
+  ok1(length == 6 && memcmp(p, "$GPRMC", 6) == 0);
+
+  p = line.ReadView(length);
+  ok1(length == 0);
+
+  // Test ReadCompare() with a prefix and an extension
+  ok1(line.ReadCompare("RMC"));
+  ok1(!line.ReadCompare("RMC"));
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(19);
+  plan_tests(23);
 
   Test1();
   Test2();
+  Test3();
 
   return exit_status();
 }
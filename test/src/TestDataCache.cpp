@@ -0,0 +1,163 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/WaypointReader.hpp"
+#include "Airspace/AirspaceCache.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+static bool
+Equals(const Waypoint &a, const Waypoint &b)
+{
+  return a.location == b.location && a.elevation == b.elevation &&
+    a.original_id == b.original_id && a.type == b.type &&
+    a.file_num == b.file_num &&
+    a.flags.turn_point == b.flags.turn_point &&
+    a.flags.home == b.flags.home &&
+    memcmp(&a.runway, &b.runway, sizeof(a.runway)) == 0 &&
+    memcmp(&a.radio_frequency, &b.radio_frequency,
+           sizeof(a.radio_frequency)) == 0 &&
+    a.name == b.name && a.comment == b.comment && a.details == b.details;
+}
+
+static void
+TestWaypoints()
+{
+  Waypoints original, cached;
+  NullOperationEnvironment operation;
+
+  WaypointReader reader(_T("test/data/waypoints.cup"), 1);
+  ok1(!reader.Error());
+  ok1(reader.Parse(original, operation));
+  ok1(!reader.NeedsTerrain());
+  original.Optimise();
+
+  FILE *file = tmpfile();
+  ok1(SaveWaypointCache(file, original, 1));
+  rewind(file);
+  ok1(LoadWaypointCache(file, cached));
+  fclose(file);
+  cached.Optimise();
+
+  ok1(!original.IsEmpty());
+  ok1(cached.size() == original.size());
+
+  bool equal = true;
+  for (auto i = original.begin(); i != original.end(); ++i) {
+    const Waypoint *other = cached.LookupId(i->id);
+    if (other == NULL || !Equals(*i, *other))
+      equal = false;
+  }
+
+  ok1(equal);
+}
+
+static bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b)
+{
+  if (a.GetShape() != b.GetShape() || a.GetType() != b.GetType() ||
+      a.GetName() != tstring(b.GetName()) ||
+      a.GetRadioText() != b.GetRadioText() ||
+      !a.GetDays().equals(b.GetDays()) ||
+      a.GetBase().type != b.GetBase().type ||
+      a.GetBase().altitude != b.GetBase().altitude ||
+      a.GetBase().flight_level != b.GetBase().flight_level ||
+      a.GetTop().type != b.GetTop().type ||
+      a.GetTop().altitude != b.GetTop().altitude ||
+      a.GetTop().flight_level != b.GetTop().flight_level ||
+      a.GetPoints().size() != b.GetPoints().size())
+    return false;
+
+  for (unsigned i = 0; i < a.GetPoints().size(); ++i)
+    if (a.GetPoints()[i].get_location() != b.GetPoints()[i].get_location())
+      return false;
+
+  return true;
+}
+
+static void
+TestAirspaces()
+{
+  Airspaces original, cached;
+  NullOperationEnvironment operation;
+
+  FileLineReader reader(_T("test/data/airspace/openair.txt"),
+                        ConvertLineReader::AUTO);
+  ok1(!reader.error());
+
+  AirspaceParser parser(original);
+  ok1(parser.Parse(reader, operation));
+
+  FILE *file = tmpfile();
+  ok1(SaveAirspaceCache(file, original, 0));
+  rewind(file);
+  ok1(LoadAirspaceCache(file, cached));
+  fclose(file);
+
+  ok1(original.GetPendingCount() > 0);
+  ok1(cached.GetPendingCount() == original.GetPendingCount());
+
+  bool equal = true;
+  for (unsigned i = 0; i < original.GetPendingCount(); ++i)
+    if (!Equals(original.GetPending(i), cached.GetPending(i)))
+      equal = false;
+
+  ok1(equal);
+
+  /* a truncated file must be rejected without modifying the
+     Airspaces object */
+  file = tmpfile();
+  ok1(SaveAirspaceCache(file, original, 0));
+  fflush(file);
+  rewind(file);
+  char buffer[256];
+  size_t length = fread(buffer, 1, sizeof(buffer), file);
+  fclose(file);
+
+  file = tmpfile();
+  fwrite(buffer, 1, length, file);
+  rewind(file);
+  Airspaces truncated;
+  ok1(!LoadAirspaceCache(file, truncated));
+  ok1(truncated.empty());
+  fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(18);
+
+  TestWaypoints();
+  TestAirspaces();
+
+  return exit_status();
+}
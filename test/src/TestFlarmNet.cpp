@@ -20,17 +20,21 @@
 }
 */
 
+
 #include "FLARM/FlarmNet.hpp"
+#include "FLARM/FlarmNetReader.hpp"
+#include "FLARM/Database.hpp"
 #include "FLARM/FlarmId.hpp"
+#include "IO/FileCache.hpp"
 #include "TestUtil.hpp"
 
-int main(int argc, char **argv)
-{
-  plan_tests(15);
+#include <windef.h> /* for MAX_PATH */
 
-  int count = FlarmNet::LoadFile(_T("test/data/flarmnet/data.fln"));
-  ok1(count == 6);
+static const TCHAR *const path = _T("test/data/flarmnet/data.fln");
 
+static void
+TestLookups()
+{
   FlarmId id = FlarmId::Parse("DDA85C", NULL);
 
   const FlarmRecord *record = FlarmNet::FindRecordById(id);
@@ -73,6 +77,105 @@ int main(int argc, char **argv)
   ok1(foundDDA85C);
   ok1(foundDDA896);
 
+  /* the result size is limited */
+  ok1(FlarmNet::FindIdsByCallSign(_T("TH"), ids, 1) == 1);
+  ok1(FlarmNet::FindRecordsByCallSign(_T("TH"), array, 1) == 1);
+
+  ok1(FlarmNet::FindFirstRecordByCallSign(_T("L1")) != NULL);
+  ok1(FlarmNet::FindFirstRecordByCallSign(_T("L")) == NULL);
+  ok1(FlarmNet::FindRecordById(FlarmId::Parse("DDA858", NULL)) == NULL);
+
+  /* prefix search */
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T("T"), ids, 3) == 2);
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T("TH"), ids, 3) == 2);
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T("L"), ids, 3) == 1);
+  ok1(ids[0] == FlarmId::Parse("DDA85A", NULL));
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T("THX"), ids, 3) == 0);
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T("X"), ids, 3) == 0);
+  ok1(FlarmNet::FindIdsByCallSignPrefix(_T(""), ids, 3) == 0);
+}
+
+static void
+TestDatabase(FileCache &cache)
+{
+  FlarmDatabase database;
+  ok1(database.IsEmpty());
+  ok1(FlarmNetReader::LoadFile(path, database) == 6);
+  ok1(database.GetCount() == 6);
+
+  /* duplicate ids are ignored */
+  FlarmRecord record = *database.FindRecordById(FlarmId::Parse("DDA85C",
+                                                               NULL));
+  record.callsign = _T("XX");
+  database.Insert(record);
+  database.Optimise();
+  ok1(database.GetCount() == 6);
+  ok1(_tcscmp(database.FindRecordById(FlarmId::Parse("DDA85C",
+                                                     NULL))->callsign,
+              _T("TH")) == 0);
+
+  FILE *file = cache.Save(_T("flarmnet-test"), path);
+  ok1(file != NULL);
+  ok1(database.Save(file));
+  ok1(cache.Commit(_T("flarmnet-test"), file));
+
+  TCHAR buffer[MAX_PATH];
+  const TCHAR *cache_path = cache.LoadPath(_T("flarmnet-test"), path, buffer);
+  ok1(cache_path != NULL);
+
+  FlarmDatabase mapped;
+  ok1(mapped.Map(cache_path, FileCache::HEADER_SIZE));
+  ok1(mapped.GetCount() == 6);
+  ok1(mapped.end() - mapped.begin() == 6);
+
+  const FlarmRecord *r = mapped.FindRecordById(FlarmId::Parse("DDA896",
+                                                              NULL));
+  ok1(r != NULL && _tcscmp(r->registration, _T("D-5799")) == 0);
+
+  FlarmId ids[3];
+  ok1(mapped.FindIdsByCallSignPrefix(_T("M"), ids, 3) == 1);
+  ok1(ids[0] == FlarmId::Parse("DDA857", NULL));
+
+  /* a mapped database can still be modified */
+  record.id = _T("DDA999");
+  record.callsign = _T("MX");
+  mapped.Insert(record);
+  mapped.Optimise();
+  ok1(mapped.GetCount() == 7);
+  ok1(mapped.FindIdsByCallSignPrefix(_T("M"), ids, 3) == 2);
+
+  /* a corrupt image is rejected */
+  ok1(!mapped.Map(cache_path, FileCache::HEADER_SIZE + sizeof(unsigned)));
+  ok1(!mapped.Map(_T("test/data/flarmnet/does-not-exist")));
+
+  cache.Flush(_T("flarmnet-test"));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(101);
+
+  int count = FlarmNet::LoadFile(path);
+  ok1(count == 6);
+  TestLookups();
+
+  FileCache cache(_T("output/cache"));
+  cache.Flush(_T("flarmnet"));
+
+  /* the first load parses the file and writes the cache file */
+  count = FlarmNet::LoadFile(path, &cache);
+  ok1(count == 6);
+  TestLookups();
+
+  /* the second load maps the cache file */
+  TCHAR buffer[MAX_PATH];
+  ok1(cache.LoadPath(_T("flarmnet"), path, buffer) != NULL);
+  count = FlarmNet::LoadFile(path, &cache);
+  ok1(count == 6);
+  TestLookups();
+
+  TestDatabase(cache);
+
   FlarmNet::Destroy();
 
   return exit_status();
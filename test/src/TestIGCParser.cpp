@@ -25,6 +25,8 @@
 #include "IGC/IGCFix.hpp"
 #include "IGC/IGCHeader.hpp"
 #include "IGC/IGCDeclaration.hpp"
+#include "IGC/IGCFixReader.hpp"
+#include "IO/FileLineReader.hpp"
 #include "DateTime.hpp"
 #include "TestUtil.hpp"
 
@@ -164,6 +166,24 @@ TestFix()
   ok1(equals(fix.location, -51.05195, -7.70611667));
   ok1(fix.pressure_altitude == 10490);
   ok1(fix.gps_altitude == 7);
+
+  ok1(IGCParseFix("B1122385103117N00742367EA-0012-0003", fix));
+  ok1(fix.pressure_altitude == -12);
+  ok1(fix.gps_altitude == -3);
+
+  ok1(!IGCParseFix("B1122385103117N00742367EA-00X2-0003", fix));
+
+  IGCExtensions extensions;
+  ok1(IGCParseExtensions("I023638FXA3941ENL", extensions));
+  ok1(IGCParseFix("B1122385103117N00742367EA0049000487002097",
+                  extensions, fix));
+  ok1(fix.enl == 97);
+
+  /* not null-terminated: the extension is beyond the given length */
+  ok1(IGCParseFix("B1122385103117N00742367EA0049000487002097", 38,
+                  extensions, fix));
+  ok1(fix.enl == -1);
+  ok1(fix.gps_altitude == 487);
 }
 
 static void
@@ -244,9 +264,75 @@ TestDeclarationTurnpoint()
   ok1(tp.name.empty());
 }
 
+static bool
+operator==(const IGCFix &a, const IGCFix &b)
+{
+  return a.time == b.time && a.location == b.location &&
+    a.gps_valid == b.gps_valid &&
+    a.gps_altitude == b.gps_altitude &&
+    a.pressure_altitude == b.pressure_altitude &&
+    a.enl == b.enl && a.rpm == b.rpm && a.hdm == b.hdm && a.hdt == b.hdt &&
+    a.trm == b.trm && a.trt == b.trt && a.gsp == b.gsp && a.ias == b.ias &&
+    a.tas == b.tas && a.siu == b.siu;
+}
+
+/**
+ * Compare #IGCFixReader with parsing the file line by line.
+ */
+static void
+TestFixReader(const TCHAR *path)
+{
+  FileLineReaderA lines(path);
+  IGCFixReader reader(path);
+  if (lines.error() || reader.error()) {
+    skip(2, 0, "file not found");
+    return;
+  }
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  static const unsigned BATCH = 64;
+  IGCFix batch[BATCH];
+  unsigned batch_size = 0, batch_position = 0;
+
+  unsigned n_fixes = 0;
+  bool equal = true;
+
+  const char *line;
+  while ((line = lines.read()) != NULL) {
+    if (line[0] == 'I') {
+      IGCParseExtensions(line, extensions);
+      continue;
+    }
+
+    IGCFix expected;
+    if (!IGCParseFix(line, extensions, expected))
+      continue;
+
+    if (batch_position == batch_size) {
+      batch_size = reader.Read(batch, BATCH);
+      batch_position = 0;
+      if (batch_size == 0) {
+        equal = false;
+        break;
+      }
+    }
+
+    if (!(batch[batch_position++] == expected))
+      equal = false;
+
+    ++n_fixes;
+  }
+
+  IGCFix fix;
+  ok1(equal && batch_position == batch_size && !reader.Read(fix));
+  ok1(n_fixes > 1000);
+}
+
 int main(int argc, char **argv)
 {
-  plan_tests(136);
+  plan_tests(155);
 
   TestHeader();
   TestDate();
@@ -257,5 +343,15 @@ int main(int argc, char **argv)
   TestDeclarationHeader();
   TestDeclarationTurnpoint();
 
+  TestFixReader(_T("test/data/0asljd01.igc"));
+  TestFixReader(_T("test/data/01lz1hq1.igc"));
+  TestFixReader(_T("test/data/apf-bug554.igc"));
+
+  IGCFixReader reader(_T("test/data/0asljd01.igc"));
+  IGCFix fix;
+  ok1(!reader.error() && reader.Read(fix));
+  ok1(reader.GetDate() == BrokenDate(2010, 10, 28));
+  ok1(reader.GetExtensions().size() == 7);
+
   return exit_status();
 }
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Job/Pool.hpp"
+#include "Job/Job.hpp"
+#include "Thread/Mutex.hpp"
+#include "OS/Sleep.h"
+#include "Util/StringUtil.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * Records the order in which jobs finish.
+ */
+static Mutex sequence_mutex;
+static unsigned sequence;
+
+class TestJob : public Job {
+  const TestJob *dependency;
+
+public:
+  unsigned finished;
+  bool dependency_was_finished;
+
+  TestJob(const TestJob *_dependency=NULL)
+    :dependency(_dependency), finished(0), dependency_was_finished(false) {}
+
+  virtual void Run(OperationEnvironment &env) {
+    sequence_mutex.Lock();
+    dependency_was_finished = dependency == NULL || dependency->finished > 0;
+    sequence_mutex.Unlock();
+
+    env.SetText(_T("Testing"));
+    env.SetProgressRange(10);
+    for (unsigned i = 0; i < 10; ++i) {
+      env.SetProgressPosition(i);
+      Sleep(2);
+    }
+
+    sequence_mutex.Lock();
+    finished = ++sequence;
+    sequence_mutex.Unlock();
+  }
+};
+
+class TestOperationEnvironment : public NullOperationEnvironment {
+public:
+  bool cancel;
+  unsigned n_texts, range, position;
+
+  TestOperationEnvironment(bool _cancel=false)
+    :cancel(_cancel), n_texts(0), range(0), position(0) {}
+
+  virtual bool IsCancelled() const {
+    return cancel;
+  }
+
+  virtual void SetText(const TCHAR *text) {
+    ++n_texts;
+  }
+
+  virtual void SetProgressRange(unsigned _range) {
+    range = _range;
+  }
+
+  virtual void SetProgressPosition(unsigned _position) {
+    position = _position;
+  }
+};
+
+static void
+TestDependencies()
+{
+  TestJob a, b(&a), c, d(&b);
+
+  JobPool pool;
+  const unsigned ia = pool.Add(a, _T("a"));
+  const unsigned ib = pool.Add(b, _T("b"));
+  const unsigned ic = pool.Add(c, _T("c"));
+  const unsigned id = pool.Add(d, _T("d"));
+  pool.Depend(ib, ia);
+  pool.Depend(id, ib);
+  pool.Depend(id, ic);
+
+  TestOperationEnvironment env;
+  ok1(pool.Run(env, 2));
+
+  ok1(a.finished > 0 && b.finished > 0 && c.finished > 0 && d.finished > 0);
+  ok1(b.finished > a.finished);
+  ok1(d.finished > b.finished);
+  ok1(d.finished > c.finished);
+  ok1(a.dependency_was_finished && b.dependency_was_finished &&
+      d.dependency_was_finished);
+
+  ok1(pool.GetDuration(ia) > 0);
+  ok1(pool.GetDuration(id) > 0);
+  ok1(StringIsEqual(pool.GetName(ic), _T("c")));
+
+  ok1(env.n_texts > 0);
+  ok1(env.range > 0);
+  ok1(env.position == env.range);
+}
+
+static void
+TestCancel()
+{
+  TestJob a, b(&a);
+
+  JobPool pool;
+  const unsigned ia = pool.Add(a, _T("a"));
+  const unsigned ib = pool.Add(b, _T("b"));
+  pool.Depend(ib, ia);
+
+  TestOperationEnvironment env(true);
+  ok1(!pool.Run(env, 2));
+  ok1(a.finished == 0 && b.finished == 0);
+  ok1(pool.GetDuration(ia) == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(15);
+
+  TestDependencies();
+  TestCancel();
+
+  return exit_status();
+}
@@ -0,0 +1,134 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Screen/LabelBlock.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <stdlib.h>
+
+static PixelRect
+MakeRect(int left, int top, int right, int bottom)
+{
+  PixelRect rc;
+  rc.left = left;
+  rc.top = top;
+  rc.right = right;
+  rc.bottom = bottom;
+  return rc;
+}
+
+static bool
+Overlaps(const PixelRect &a, const PixelRect &b)
+{
+  return a.left < b.right && a.right > b.left &&
+    a.top < b.bottom && a.bottom > b.top;
+}
+
+/**
+ * The trivial implementation: compare with all accepted rectangles.
+ */
+static bool
+CheckLinear(std::vector<PixelRect> &accepted, const PixelRect &rc)
+{
+  for (auto i = accepted.begin(), end = accepted.end(); i != end; ++i)
+    if (Overlaps(*i, rc))
+      return false;
+
+  accepted.push_back(rc);
+  return true;
+}
+
+static void
+TestBasic()
+{
+  LabelBlock block;
+  block.reset(640, 480);
+
+  ok1(block.check(MakeRect(10, 10, 100, 30)));
+  ok1(!block.check(MakeRect(50, 20, 150, 40)));
+
+  /* touching edges don't overlap */
+  ok1(block.check(MakeRect(100, 10, 200, 30)));
+  ok1(block.check(MakeRect(10, 30, 100, 50)));
+
+  /* a rectangle spanning many cells */
+  ok1(block.check(MakeRect(300, 100, 600, 400)));
+  ok1(!block.check(MakeRect(400, 200, 410, 210)));
+
+  /* outside of the screen */
+  ok1(block.check(MakeRect(-50, -20, -10, -5)));
+  ok1(!block.check(MakeRect(-30, -10, -20, 0)));
+  ok1(block.check(MakeRect(700, 500, 800, 520)));
+  ok1(!block.check(MakeRect(650, 490, 710, 510)));
+
+  ok1(block.size() == 6);
+
+  block.reset(640, 480);
+  ok1(block.size() == 0);
+  ok1(block.check(MakeRect(50, 20, 150, 40)));
+}
+
+static void
+TestRandom(unsigned width, unsigned height)
+{
+  LabelBlock block;
+  std::vector<PixelRect> accepted;
+
+  bool equal = true;
+
+  for (unsigned frame = 0; frame < 4; ++frame) {
+    block.reset(width, height);
+    accepted.clear();
+
+    for (unsigned i = 0; i < 2000; ++i) {
+      const int x = rand() % (width + 200) - 100;
+      const int y = rand() % (height + 100) - 50;
+      const PixelRect rc = MakeRect(x, y, x + 20 + rand() % 150,
+                                    y + 10 + rand() % 20);
+
+      if (block.check(rc) != CheckLinear(accepted, rc))
+        equal = false;
+    }
+
+    if (block.size() != accepted.size())
+      equal = false;
+  }
+
+  ok1(equal);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(16);
+
+  TestBasic();
+
+  srand(42);
+  TestRandom(640, 480);
+  TestRandom(1920, 1080);
+  TestRandom(8000, 100);
+
+  return exit_status();
+}
@@ -0,0 +1,99 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IO/MappedLineReader.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+static const TCHAR *const files[] = {
+  /* CRLF line endings */
+  _T("test/data/waypoints.cup"),
+  /* LF line endings */
+  _T("test/data/AirspaceAus-DAA.txt"),
+  /* last line not terminated */
+  _T("test/data/airspace/openair.txt"),
+  _T("test/data/test.plr"),
+  /* non-ASCII characters */
+  _T("test/data/waypoints_compe_geo.wpt"),
+};
+
+/**
+ * Does MappedLineReaderA return the same lines as FileLineReaderA?
+ */
+static bool
+CompareNarrow(const TCHAR *path)
+{
+  MappedLineReaderA mapped(path);
+  FileLineReaderA file(path);
+  if (mapped.error() || file.error())
+    return false;
+
+  while (true) {
+    const char *a = mapped.read(), *b = file.read();
+    if (a == NULL || b == NULL)
+      return a == b && mapped.tell() == mapped.size();
+
+    if (strcmp(a, b) != 0)
+      return false;
+  }
+}
+
+/**
+ * Does MappedLineReader return the same lines as FileLineReader?
+ */
+static bool
+CompareWide(const TCHAR *path)
+{
+  MappedLineReader mapped(path, ConvertLineReader::AUTO);
+  FileLineReader file(path, ConvertLineReader::AUTO);
+  if (mapped.error() || file.error())
+    return false;
+
+  while (true) {
+    const TCHAR *a = mapped.read(), *b = file.read();
+    if (a == NULL || b == NULL)
+      return a == b && mapped.tell() == mapped.size();
+
+    if (_tcscmp(a, b) != 0)
+      return false;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(2 * ARRAY_SIZE(files) + 1);
+
+  for (unsigned i = 0; i < ARRAY_SIZE(files); ++i) {
+    ok1(CompareNarrow(files[i]));
+    ok1(CompareWide(files[i]));
+  }
+
+  /* empty and missing files can't be mapped */
+  MappedLineReaderA missing(_T("test/data/does_not_exist.txt"));
+  ok1(missing.error());
+
+  return exit_status();
+}
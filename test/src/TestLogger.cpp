@@ -21,6 +21,8 @@
 */
 
 #include "IGC/IGCWriter.hpp"
+#include "IGC/IGCRecovery.hpp"
+#include "IO/TextWriter.hpp"
 #include "OS/FileUtil.hpp"
 #include "NMEA/Info.hpp"
 #include "IO/FileLineReader.hpp"
@@ -85,9 +87,98 @@ static const char *const expect[] = {
   NULL
 };
 
+static const char *const recovered_expect[] = {
+  "AXCSFOO",
+  "HFDTE040910",
+  "B1122385103117N00742367EA004900048700000",
+  "LXCSRECOVERED AFTER CRASH",
+  NULL
+};
+
+static void
+TestRecovery()
+{
+  const TCHAR *path = _T("output/test/crash.igc");
+  const TCHAR *partial_path = _T("output/test/crash.igc.part");
+  File::Delete(path);
+
+  {
+    /* a file which was interrupted in the middle of a line */
+    TextWriter writer(partial_path);
+    writer.writeln("AXCSFOO");
+    writer.writeln("HFDTE040910");
+    writer.writeln("B1122385103117N00742367EA004900048700000");
+    writer.write("B11224351031");
+  }
+
+  ok1(!IGCRecoverFile(_T("output/test/crash.igc")));
+  ok1(IGCRecoverFile(partial_path));
+  ok1(!File::Exists(partial_path));
+  CheckTextFile(path, recovered_expect);
+}
+
+/**
+ * Write more records than the queue of #IGCWriterThread holds,
+ * without giving the thread a chance to catch up.
+ */
+static void
+TestManyRecords()
+{
+  const TCHAR *path = _T("output/test/many.igc");
+  File::Delete(path);
+
+  static const unsigned n = IGCWriterThread::QUEUE_SIZE * 4;
+
+  {
+    IGCWriter writer(path, false);
+
+    IGCFix fix;
+    fix.location = GeoPoint(Angle::Degrees(fixed(7.7)),
+                            Angle::Degrees(fixed(51.05)));
+    fix.gps_valid = true;
+    fix.gps_altitude = 487;
+    fix.pressure_altitude = 490;
+
+    for (unsigned i = 0; i < n; ++i) {
+      fix.time = BrokenTime(10 + i / 3600, (i / 60) % 60, i % 60);
+      writer.LogPoint(fix, 5, 7);
+    }
+
+    ok1(writer.Flush());
+
+    /* until Finish(), the file has a different name */
+    ok1(File::Exists(_T("output/test/many.igc.part")));
+    ok1(!File::Exists(path));
+
+    writer.Finish();
+    writer.Sign();
+  }
+
+  ok1(!File::Exists(_T("output/test/many.igc.part")));
+
+  FileLineReaderA reader(path);
+  ok1(!reader.error());
+
+  unsigned n_records = 0;
+  const char *line;
+  while ((line = reader.read()) != NULL)
+    if (*line == 'B')
+      ++n_records;
+
+  ok1(n_records == n);
+
+  GRecord grecord;
+  grecord.Initialize();
+  grecord.SetFileName(path);
+  ok1(grecord.VerifyGRecordInFile());
+}
+
 int main(int argc, char **argv)
 {
-  plan_tests(51);
+  plan_tests(71);
+
+  TestRecovery();
+  TestManyRecords();
 
   const TCHAR *path = _T("output/test/test.igc");
   File::Delete(path);
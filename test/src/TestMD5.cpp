@@ -0,0 +1,211 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Logger/MD5.hpp"
+#include "Logger/LoggerGRecord.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+#include <string.h>
+
+static const uint32_t keys[MD5x4::LANES][4] = {
+  { 0x1C80A301, 0x9EB30b89, 0x39CB2Afe, 0x0D0FEA76 },
+  { 0x48327203, 0x3948ebea, 0x9a9b9c9e, 0xb3bed89a },
+  { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 },
+  { 0xc8e899e8, 0x9321c28a, 0x438eba12, 0x8cbe0aee },
+};
+
+static bool
+CheckDigest(const char *data, const char *expected)
+{
+  MD5 md5;
+  md5.InitKey();
+  md5.Append(data, strlen(data));
+  md5.Finalize();
+
+  char digest[MD5::DIGEST_LENGTH * 2 + 1];
+  md5.GetDigest(digest);
+  return strcmp(digest, expected) == 0;
+}
+
+static void
+TestKnownDigests()
+{
+  ok1(CheckDigest("", "d41d8cd98f00b204e9800998ecf8427e"));
+  ok1(CheckDigest("abc", "900150983cd24fb0d6963f7d28e17f72"));
+  ok1(CheckDigest("The quick brown fox jumps over the lazy dog",
+                  "9e107d9d372bb6826bd81d3542a419d6"));
+  ok1(CheckDigest("12345678901234567890123456789012345678901234567890"
+                  "123456789012345678901234567890",
+                  "57edf4a22be3c955ac49da2e2107b67a"));
+}
+
+static void
+TestFilter()
+{
+  bool equal = true;
+  for (unsigned i = 0; i < 256; ++i) {
+    const char ch = (char)i;
+    char dest;
+    const size_t n = MD5::FilterIGCChars(&ch, 1, &dest);
+    if (n != (MD5::IsValidIGCChar(ch) ? 1u : 0u) ||
+        (n > 0 && dest != ch))
+      equal = false;
+  }
+
+  ok1(equal);
+
+  static const char src[] = "B1234*56$78,9!0\\A^~\r\n\tZ";
+  char dest[sizeof(src)];
+  const size_t n = MD5::FilterIGCChars(src, strlen(src), dest);
+  ok1(n == 13);
+  ok1(memcmp(dest, "B1234567890AZ", n) == 0);
+}
+
+/**
+ * Compare the bulk MD5::Append() and MD5x4 with feeding four MD5
+ * objects byte by byte, for all message lengths around the block
+ * boundaries.
+ */
+static void
+TestLanes()
+{
+  char data[300];
+  for (unsigned i = 0; i < ARRAY_SIZE(data); ++i)
+    data[i] = (char)(i * 37 + 11);
+
+  bool bulk_equal = true, lanes_equal = true;
+
+  for (unsigned length = 0; length <= ARRAY_SIZE(data); ++length) {
+    MD5x4 lanes;
+    for (unsigned l = 0; l < MD5x4::LANES; ++l)
+      lanes.InitKey(l, keys[l][0], keys[l][1], keys[l][2], keys[l][3]);
+
+    /* feed in odd-sized pieces */
+    for (unsigned i = 0; i < length; i += 7)
+      lanes.Append(data + i, std::min(7u, length - i));
+    lanes.Finalize();
+
+    for (unsigned l = 0; l < MD5x4::LANES; ++l) {
+      MD5 single, bulk;
+      single.InitKey(keys[l][0], keys[l][1], keys[l][2], keys[l][3]);
+      bulk.InitKey(keys[l][0], keys[l][1], keys[l][2], keys[l][3]);
+
+      for (unsigned i = 0; i < length; ++i)
+        single.Append((uint8_t)data[i]);
+
+      bulk.Append(data, 3 < length ? 3 : length);
+      if (length > 3)
+        bulk.Append(data + 3, length - 3);
+
+      single.Finalize();
+      bulk.Finalize();
+
+      char expected[MD5::DIGEST_LENGTH * 2 + 1];
+      char digest[MD5::DIGEST_LENGTH * 2 + 1];
+      single.GetDigest(expected);
+
+      bulk.GetDigest(digest);
+      if (strcmp(digest, expected) != 0)
+        bulk_equal = false;
+
+      lanes.GetDigest(l, digest);
+      if (strcmp(digest, expected) != 0)
+        lanes_equal = false;
+    }
+  }
+
+  ok1(bulk_equal);
+  ok1(lanes_equal);
+}
+
+/**
+ * Calculate the G record digest of a file the way #GRecord did
+ * before #MD5x4: with four independent MD5 objects, fed one
+ * character at a time.
+ */
+static bool
+LegacyDigest(const char *path, char *output)
+{
+  MD5 md5[MD5x4::LANES];
+  for (unsigned l = 0; l < MD5x4::LANES; ++l)
+    md5[l].InitKey(keys[l][0], keys[l][1], keys[l][2], keys[l][3]);
+
+  FileLineReaderA reader(path);
+  if (reader.error())
+    return false;
+
+  const char *line;
+  while ((line = reader.read()) != NULL) {
+    if (line[0] == 'G' ||
+        (line[0] == 'H' && (line[1] == 'O' || line[1] == 'P')) ||
+        (line[0] == 'L' && memcmp(line + 1, XCSOAR_IGC_CODE, 3) != 0))
+      continue;
+
+    for (unsigned l = 0; l < MD5x4::LANES; ++l)
+      md5[l].AppendString((const unsigned char *)line, true);
+  }
+
+  for (unsigned l = 0; l < MD5x4::LANES; ++l) {
+    md5[l].Finalize();
+    md5[l].GetDigest(output + l * 32);
+  }
+
+  return true;
+}
+
+static void
+TestGRecord(const char *path)
+{
+  char expected[GRecord::DIGEST_LENGTH * 2 + 1];
+  ok1(LegacyDigest(path, expected));
+
+  GRecord grecord;
+  grecord.Initialize();
+  grecord.SetFileName(path);
+  ok1(grecord.LoadFileToBuffer());
+  grecord.FinalizeBuffer();
+
+  char digest[GRecord::DIGEST_LENGTH * 2 + 1];
+  grecord.GetDigest(digest);
+  ok1(strcmp(digest, expected) == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(4 + 3 + 2 + 4 * 3);
+
+  TestKnownDigests();
+  TestFilter();
+  TestLanes();
+
+  TestGRecord("test/data/0asljd01.igc");
+  TestGRecord("test/data/9crx3101.igc");
+  TestGRecord("test/data/01lz1hq1.igc");
+  TestGRecord("test/data/apf-bug554.igc");
+
+  return exit_status();
+}
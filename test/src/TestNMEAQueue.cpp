@@ -0,0 +1,415 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * A stress test for the lock-free device input path: a
+ * #FaultInjectionPort feeds a fast NMEA stream from its receive
+ * thread (like FeedNMEA, but without pausing between fixes, and with
+ * fragmented chunks and garbage) to a #DeviceReceiver, which parses
+ * it into its private #NMEAInfo and submits copies through a
+ * #SPSCQueue.  A "merge thread" applies them under a mutex, like
+ * DeviceBlackboard::Merge() does.  It verifies that the states arrive
+ * in order, and measures the latency between receiving a GPS fix and
+ * applying it.
+ */
+
+#include "Thread/SPSCQueue.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Trigger.hpp"
+#include "Device/Receiver.hpp"
+#include "Device/Parser.hpp"
+#include "FaultInjectionPort.hpp"
+#include "NMEA/Info.hpp"
+#include "NMEA/Checksum.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
+#include "TestUtil.hpp"
+#include "Compiler.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/** the number of GPS fixes sent by the port */
+static const unsigned FIXES = 20000;
+
+/** the time of day of the first fix [s] */
+static const unsigned FIRST_TIME = 36000;
+
+/** the number of FLARM targets reported with each fix */
+static const unsigned TARGETS = 8;
+
+typedef SPSCQueue<NMEAInfo, 4> Queue;
+
+static Queue queue;
+static Trigger merge_trigger;
+
+/** the moment each fix was received by the port [us] */
+static uint64_t received_us[FIXES];
+
+static void
+AppendSentence(char *&p, const char *format, ...)
+  gcc_printf(2, 3);
+
+static void
+AppendSentence(char *&p, const char *format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+  vsprintf(p, format, ap);
+  va_end(ap);
+
+  AppendNMEAChecksum(p);
+  p += strlen(p);
+  *p++ = '\r';
+  *p++ = '\n';
+  *p = 0;
+}
+
+/**
+ * Generate one second of a FLARM's output: GPRMC, GPGGA, PFLAU and
+ * a PFLAA for each target.
+ */
+static size_t
+GenerateChunk(char *buffer, unsigned fix)
+{
+  const unsigned t = FIRST_TIME + fix;
+  const unsigned hour = t / 3600, minute = (t / 60) % 60, second = t % 60;
+
+  char *p = buffer;
+  AppendSentence(p, "$GPRMC,%02u%02u%02u,A,5103.5403,N,00741.5742,E,"
+                 "055.3,022.4,230610,000.3,W",
+                 hour, minute, second);
+  AppendSentence(p, "$GPGGA,%02u%02u%02u,5103.5403,N,00741.5742,E,"
+                 "1,08,0.9,545.4,M,46.9,M,,",
+                 hour, minute, second);
+  AppendSentence(p, "$PFLAU,%u,1,2,1,0,,0,,", TARGETS);
+
+  for (unsigned i = 0; i < TARGETS; ++i)
+    AppendSentence(p, "$PFLAA,0,%u,-150,10,2,DDA8%02X,123,13,24,1.4,1",
+                   100 + i * 10 + fix % 10, i);
+
+  return p - buffer;
+}
+
+/**
+ * Parses with #NMEAParser and submits to the #Queue, like
+ * #DeviceDescriptor does with the #DeviceBlackboard.
+ */
+class QueueHandler : public DeviceReceiver::Handler {
+  NMEAParser parser;
+
+public:
+  unsigned sentences, failed_submissions;
+
+  QueueHandler():sentences(0), failed_submissions(0) {}
+
+  /* virtual methods from class DeviceReceiver::Handler */
+  virtual bool ParseReceivedLine(const char *line, NMEAInfo &state) {
+    ++sentences;
+    if (!parser.ParseLine(line, state))
+      return false;
+
+    state.alive.Update(state.clock);
+    return true;
+  }
+
+  virtual bool SubmitReceivedState(const NMEAInfo &state) {
+    const bool submitted = queue.Push(state);
+    if (!submitted)
+      ++failed_submissions;
+
+    merge_trigger.Signal();
+    return submitted;
+  }
+};
+
+/**
+ * A port whose receive thread delivers #FIXES seconds of FLARM
+ * output as fast as possible.  Some chunks are split into small
+ * fragments, and some are preceded by binary garbage and a sentence
+ * with a bad checksum.
+ */
+class FeedPort : public FaultInjectionPort, private Thread {
+  DeviceReceiver &receiver;
+
+public:
+  unsigned chunks, garbage_lines;
+
+  FeedPort(DeviceReceiver &_receiver)
+    :FaultInjectionPort(_receiver), receiver(_receiver),
+     chunks(0), garbage_lines(0) {}
+
+  bool StartRxThread() {
+    return Thread::Start();
+  }
+
+  /**
+   * Wait until all data has been delivered.
+   */
+  void Wait() {
+    Thread::Join();
+  }
+
+private:
+  void Deliver(const char *data, size_t length, unsigned fragment_size) {
+    while (length > 0) {
+      const size_t n = std::min(length, (size_t)fragment_size);
+      handler.DataReceived(data, n);
+      data += n;
+      length -= n;
+    }
+  }
+
+protected:
+  virtual void Run() {
+    static const char garbage[] = "\x80\x00\xff\x13";
+
+    char buffer[4096];
+
+    for (unsigned fix = 0; fix < FIXES; ++fix) {
+      char *p = buffer;
+      if (fix % 7 == 3) {
+        memcpy(p, garbage, sizeof(garbage) - 1);
+        p += sizeof(garbage) - 1;
+        p += sprintf(p, "$GPRMC,%u,A,5103.5403,N*00\r\n", fix);
+        ++garbage_lines;
+      }
+
+      const size_t length = (p - buffer) + GenerateChunk(p, fix);
+
+      received_us[fix] = MonotonicClockUS();
+      Deliver(buffer, length, fix % 5 == 1 ? 17 : length);
+      ++chunks;
+    }
+
+    /* a real device would submit again with its next chunk; here,
+       retry until the MergeThread has made room */
+    while (receiver.IsSubmitPending()) {
+      receiver.Submit();
+      Sleep(1);
+    }
+  }
+};
+
+/**
+ * Models the MergeThread and DeviceBlackboard::Merge().
+ */
+class MergeThread : public Thread {
+  Mutex mutex;
+  NMEAInfo merged;
+
+public:
+  unsigned applied, merges;
+  bool in_order;
+  unsigned last_time;
+  unsigned traffic;
+  uint64_t total_latency_us, max_latency_us;
+
+  MergeThread()
+    :applied(0), merges(0), in_order(true), last_time(0), traffic(0),
+     total_latency_us(0), max_latency_us(0) {
+    merged.Reset();
+  }
+
+protected:
+  virtual void Run() {
+    do {
+      merge_trigger.Wait();
+      merge_trigger.Reset();
+
+      ScopeLock protect(mutex);
+      ++merges;
+
+      const NMEAInfo *state;
+      while ((state = queue.Peek()) != NULL) {
+        merged = *state;
+        queue.Shift();
+
+        /* a fix which arrives in fragments may be submitted more
+           than once; measure the latency of its first submission */
+        const unsigned time = (unsigned)merged.time;
+        if (time == last_time)
+          continue;
+
+        if (time < last_time || time < FIRST_TIME ||
+            time >= FIRST_TIME + FIXES) {
+          /* keep draining the queue, or the port would wait
+             forever */
+          in_order = false;
+          continue;
+        }
+
+        last_time = time;
+        ++applied;
+
+        const uint64_t latency = MonotonicClockUS() -
+          received_us[time - FIRST_TIME];
+        total_latency_us += latency;
+        if (latency > max_latency_us)
+          max_latency_us = latency;
+      }
+
+      traffic = merged.flarm.traffic.GetActiveTrafficCount();
+    } while (last_time < FIRST_TIME + FIXES - 1);
+  }
+};
+
+static void
+TestQueue()
+{
+  SPSCQueue<unsigned, 4> q;
+  ok1(q.IsEmpty());
+  ok1(q.Peek() == NULL);
+
+  ok1(q.Push(1));
+  ok1(q.Push(2));
+  ok1(q.Push(3));
+  ok1(!q.Push(4));
+
+  ok1(*q.Peek() == 1);
+  q.Shift();
+  ok1(*q.Peek() == 2);
+  q.Shift();
+
+  /* wrap around */
+  ok1(q.Push(4));
+  ok1(q.Push(5));
+  ok1(!q.Push(6));
+
+  ok1(*q.Peek() == 3);
+  q.Clear();
+  ok1(q.IsEmpty());
+  ok1(q.Push(6));
+  ok1(*q.Peek() == 6);
+}
+
+static void
+TestStress()
+{
+  MergeThread merge;
+  merge.Start();
+
+  const uint64_t start_us = MonotonicClockUS();
+
+  QueueHandler handler;
+  DeviceReceiver receiver(handler);
+  FeedPort port(receiver);
+  port.StartRxThread();
+  port.Wait();
+  merge.Join();
+
+  const double seconds = (MonotonicClockUS() - start_us) / 1000000.;
+
+  ok1(port.chunks == FIXES);
+  ok1(merge.in_order);
+  ok1(merge.last_time == FIRST_TIME + FIXES - 1);
+  ok1(merge.traffic == TARGETS);
+  ok1(handler.sentences == FIXES * (3 + TARGETS) + port.garbage_lines);
+  ok1(queue.IsEmpty());
+
+  printf("# %u sentences in %.2f s (%.0f/s)\n",
+         handler.sentences, seconds, handler.sentences / seconds);
+  printf("# %u of %u fixes applied in %u merges, "
+         "%u submissions postponed\n",
+         merge.applied, FIXES, merge.merges, handler.failed_submissions);
+  printf("# fix latency: average %.1f us, maximum %.1f us\n",
+         merge.applied > 0 ? (double)merge.total_latency_us / merge.applied : 0.,
+         (double)merge.max_latency_us);
+}
+
+/**
+ * Parses with a fake clock (one second per sentence), and inspects
+ * each submitted state.
+ */
+class ShortLivedHandler : public DeviceReceiver::Handler {
+  NMEAParser parser;
+
+public:
+  fixed clock;
+  FlarmId id;
+  unsigned found, max_count;
+
+  ShortLivedHandler():found(0), max_count(0) {}
+
+  /* virtual methods from class DeviceReceiver::Handler */
+  virtual bool ParseReceivedLine(const char *line, NMEAInfo &state) {
+    state.clock = clock;
+    return parser.ParseLine(line, state);
+  }
+
+  virtual bool SubmitReceivedState(const NMEAInfo &state) {
+    if (state.flarm.traffic.FindTraffic(id) != NULL)
+      ++found;
+
+    const unsigned count = state.flarm.traffic.GetActiveTrafficCount();
+    if (count > max_count)
+      max_count = count;
+
+    return true;
+  }
+};
+
+/**
+ * Feed more FLARM targets than #TrafficList can hold, each of which
+ * is seen only once, through #DeviceReceiver.  The submitted states
+ * are never merged, so it is only the Expire() call in
+ * DeviceReceiver::Submit() which makes room for new targets.
+ */
+static void
+TestShortLivedTargets()
+{
+  static const unsigned N = 3 * TrafficList::MAX_COUNT;
+
+  ShortLivedHandler handler;
+  DeviceReceiver receiver(handler);
+
+  for (unsigned i = 0; i < N; ++i) {
+    char buffer[256], *p = buffer;
+    AppendSentence(p, "$PFLAA,0,100,-150,10,2,%06X,123,13,24,1.4,1",
+                   0x100000 + i);
+
+    char id_buffer[16];
+    sprintf(id_buffer, "%06X", 0x100000 + i);
+    handler.id = FlarmId::Parse(id_buffer, NULL);
+    handler.clock = fixed(1 + i);
+
+    receiver.DataReceived(buffer, p - buffer);
+  }
+
+  ok1(!receiver.IsSubmitPending());
+  ok1(handler.found == N);
+  ok1(handler.max_count < 10);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(24);
+
+  TestQueue();
+  TestStress();
+  TestShortLivedTargets();
+
+  return exit_status();
+}
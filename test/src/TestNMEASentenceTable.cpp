@@ -0,0 +1,118 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "NMEA/SentenceTable.hpp"
+#include "NMEA/Checksum.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+enum {
+  RMC = 1,
+  GGA,
+  PFLAU,
+  LK8EX1,
+  CAI_W,
+};
+
+static const NMEASentenceTable::Entry entries[] = {
+  { "RMC", RMC },
+  { "GGA", GGA },
+  { "PFLAU", PFLAU },
+  { "$LK8EX1", LK8EX1 },
+  { "!w", CAI_W },
+  { NULL, 0 },
+};
+
+static unsigned
+Find(const NMEASentenceTable &table, const char *address)
+{
+  return table.Find(address, strlen(address));
+}
+
+static void
+TestTable()
+{
+  const NMEASentenceTable table(entries);
+
+  ok1(Find(table, "RMC") == RMC);
+  ok1(Find(table, "GGA") == GGA);
+  ok1(Find(table, "PFLAU") == PFLAU);
+  ok1(Find(table, "$LK8EX1") == LK8EX1);
+  ok1(Find(table, "!w") == CAI_W);
+
+  /* the length is significant */
+  ok1(table.Find("RMCX", 3) == RMC);
+  ok1(Find(table, "RMCX") == 0);
+  ok1(Find(table, "RM") == 0);
+  ok1(Find(table, "PFLA") == 0);
+
+  ok1(Find(table, "") == 0);
+  ok1(Find(table, "!W") == 0);
+  ok1(Find(table, "$LK8EX1X2") == 0);
+}
+
+/**
+ * The byte-wise reference implementation.
+ */
+static unsigned char
+SimpleChecksum(const char *p, unsigned length)
+{
+  unsigned char checksum = 0;
+  for (unsigned i = *p == '$' ? 1 : 0; i < length; ++i)
+    checksum ^= p[i];
+  return checksum;
+}
+
+static void
+TestChecksum()
+{
+  const char *sentence =
+    "$PFLAA,0,1206,574,21,2,DDAED5,196,,32,1.0,1";
+
+  bool equal = true;
+  for (unsigned length = 0; length <= strlen(sentence); ++length)
+    if (NMEAChecksum(sentence, length) != SimpleChecksum(sentence, length))
+      equal = false;
+  ok1(equal);
+
+  /* misaligned start */
+  ok1(NMEAChecksum(sentence + 3, 20) == SimpleChecksum(sentence + 3, 20));
+
+  ok1(VerifyNMEAChecksum("$PFLAA,0,1206,574,21,2,DDAED5,196,,32,1.0,1*10"));
+  ok1(!VerifyNMEAChecksum("$PFLAA,0,1206,574,21,2,DDAED5,196,,32,1.0,1*11"));
+  ok1(!VerifyNMEAChecksum("$PFLAA,0,1206,574,21,2,DDAED5,196,,32,1.0,1"));
+  ok1(!VerifyNMEAChecksum("$PFLAA,0,1206,574,21,2,DDAED5,196,,32,1.0,1*"));
+  ok1(!VerifyNMEAChecksum(""));
+  ok1(VerifyNMEAChecksum("*0"));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(20);
+
+  TestTable();
+  TestChecksum();
+
+  return exit_status();
+}
@@ -0,0 +1,179 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Profiler.hpp"
+#include "Thread/Thread.hpp"
+#include "TestUtil.hpp"
+
+static void
+TestDisabled()
+{
+  Profiler::Reset();
+  Profiler::SetEnabled(false);
+
+  {
+    ScopeProfile profile(Profiler::CALCULATION_TICK);
+  }
+
+  ok1(Profiler::Get(Profiler::CALCULATION_TICK).count == 0);
+
+  Profiler::SetEnabled(true);
+
+  {
+    ScopeProfile profile(Profiler::CALCULATION_TICK);
+  }
+
+  ok1(Profiler::Get(Profiler::CALCULATION_TICK).count == 1);
+}
+
+static void
+TestHistogram()
+{
+  Profiler::Reset();
+
+  Profiler::Add(Profiler::MAP_RENDER, 0);
+  Profiler::Add(Profiler::MAP_RENDER, 1);
+  Profiler::Add(Profiler::MAP_RENDER, 3);
+  Profiler::Add(Profiler::MAP_RENDER, 1000);
+  Profiler::Add(Profiler::MAP_RENDER, 10000000);
+
+  const Profiler::Result result = Profiler::Get(Profiler::MAP_RENDER);
+  ok1(result.count == 5);
+  ok1(result.total_us == 10001004);
+  ok1(result.max_us == 10000000);
+  ok1(result.GetAverageUS() == 2000200);
+  ok1(result.histogram[0] == 1);
+  ok1(result.histogram[1] == 1);
+  ok1(result.histogram[2] == 1);
+  ok1(result.histogram[10] == 1);
+  ok1(result.histogram[Profiler::N_BUCKETS - 1] == 1);
+
+  ok1(result.GetPercentileUS(50) == 4);
+  ok1(result.GetPercentileUS(80) == 1024);
+  ok1(result.GetPercentileUS(100) == 10000000);
+
+  /* other points are not affected */
+  ok1(Profiler::Get(Profiler::RENDER_TERRAIN).count == 0);
+}
+
+static void
+TestHistory()
+{
+  Profiler::Reset();
+
+  unsigned history[Profiler::HISTORY_SIZE];
+  ok1(Profiler::GetHistory(Profiler::DEVICE_PARSE, history,
+                           Profiler::HISTORY_SIZE) == 0);
+
+  Profiler::Add(Profiler::DEVICE_PARSE, 7);
+  Profiler::Add(Profiler::DEVICE_PARSE, 8);
+  ok1(Profiler::GetHistory(Profiler::DEVICE_PARSE, history,
+                           Profiler::HISTORY_SIZE) == 2);
+  ok1(history[0] == 7);
+  ok1(history[1] == 8);
+
+  for (unsigned i = 0; i < 100; ++i)
+    Profiler::Add(Profiler::DEVICE_PARSE, i);
+
+  ok1(Profiler::GetHistory(Profiler::DEVICE_PARSE, history,
+                           Profiler::HISTORY_SIZE) == Profiler::HISTORY_SIZE);
+  ok1(history[0] == 100 - Profiler::HISTORY_SIZE);
+  ok1(history[Profiler::HISTORY_SIZE - 1] == 99);
+
+  /* only the most recent ones if the buffer is small */
+  ok1(Profiler::GetHistory(Profiler::DEVICE_PARSE, history, 3) == 3);
+  ok1(history[0] == 97);
+  ok1(history[2] == 99);
+}
+
+static const unsigned N_THREADS = 4;
+static const unsigned N_ITERATIONS = 100000;
+
+class AddThread : public Thread {
+public:
+  virtual void Run() {
+    for (unsigned i = 0; i < N_ITERATIONS; ++i)
+      Profiler::Add(Profiler::STAGE_TASK, 2);
+  }
+};
+
+static void
+TestThreads()
+{
+  Profiler::Reset();
+
+  AddThread threads[N_THREADS];
+  for (unsigned i = 0; i < N_THREADS; ++i)
+    threads[i].Start();
+
+  for (unsigned i = 0; i < N_THREADS; ++i)
+    threads[i].Join();
+
+  /* each thread has its own counters, so no update gets lost */
+  const Profiler::Result result = Profiler::Get(Profiler::STAGE_TASK);
+  ok1(result.count == N_THREADS * N_ITERATIONS);
+  ok1(result.total_us == 2 * N_THREADS * N_ITERATIONS);
+  ok1(result.histogram[2] == N_THREADS * N_ITERATIONS);
+
+  Profiler::Reset();
+  ok1(Profiler::Get(Profiler::STAGE_TASK).count == 0);
+}
+
+static void
+TestDroppedThreads()
+{
+  Profiler::Reset();
+
+  /* together with the threads above, these are more threads than
+     there are counter slots */
+  static const unsigned N_MORE_THREADS = 8;
+  AddThread threads[N_MORE_THREADS];
+  for (unsigned i = 0; i < N_MORE_THREADS; ++i) {
+    threads[i].Start();
+    threads[i].Join();
+  }
+
+  /* no update is counted twice, and the dropped ones are reported */
+  const Profiler::Result result = Profiler::Get(Profiler::STAGE_TASK);
+  ok1(Profiler::GetDropped() > 0);
+  ok1(result.count < N_MORE_THREADS * N_ITERATIONS);
+  ok1(result.count + Profiler::GetDropped() ==
+      N_MORE_THREADS * N_ITERATIONS);
+  ok1(result.total_us == 2 * result.count);
+
+  Profiler::Reset();
+  ok1(Profiler::GetDropped() == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(34);
+
+  TestDisabled();
+  TestHistogram();
+  TestHistory();
+  TestThreads();
+  TestDroppedThreads();
+
+  return exit_status();
+}
@@ -45,12 +45,73 @@ test_simple()
                                     Angle::Degrees(fixed_zero)), 0, 0);
 }
 
+/**
+ * Verify that the batch GeoToScreen() returns exactly the same
+ * result as the single point version.
+ */
+static void
+TestBatch(const Projection &prj, const GeoPoint *points, unsigned n)
+{
+  RasterPoint batch[n];
+  prj.GeoToScreen(points, batch, n);
+
+  bool equal = true;
+  for (unsigned i = 0; i < n; ++i) {
+    const RasterPoint single = prj.GeoToScreen(points[i]);
+    if (single.x != batch[i].x || single.y != batch[i].y)
+      equal = false;
+  }
+
+  ok1(equal);
+}
+
+static void
+test_batch()
+{
+  static const unsigned N = 64;
+  GeoPoint points[N];
+
+  Projection prj;
+  prj.SetScreenOrigin(320, 240);
+  prj.SetScale(fixed(0.01));
+  prj.SetScreenAngle(Angle::Degrees(fixed(33)));
+
+  /* a grid around the screen origin */
+  prj.SetGeoLocation(GeoPoint(Angle::Degrees(fixed(7.7)),
+                              Angle::Degrees(fixed(51.05))));
+  for (unsigned i = 0; i < N; ++i)
+    points[i] = GeoPoint(Angle::Degrees(fixed(7.5 + (i % 8) * 0.05)),
+                         Angle::Degrees(fixed(50.85 + (i / 8) * 0.05)));
+  TestBatch(prj, points, N);
+
+  /* southern hemisphere */
+  prj.SetGeoLocation(GeoPoint(Angle::Degrees(fixed(-70.2)),
+                              Angle::Degrees(fixed(-33.4))));
+  for (unsigned i = 0; i < N; ++i)
+    points[i] = GeoPoint(Angle::Degrees(fixed(-70.4 + (i % 8) * 0.05)),
+                         Angle::Degrees(fixed(-33.6 + (i / 8) * 0.05)));
+  TestBatch(prj, points, N);
+
+  /* crossing the date line */
+  prj.SetGeoLocation(GeoPoint(Angle::Degrees(fixed(179.9)),
+                              Angle::Degrees(fixed(-40))));
+  for (unsigned i = 0; i < N; ++i)
+    points[i] = GeoPoint(Angle::Degrees(fixed(179.8 + (i % 8) * 0.05))
+                         .AsDelta(),
+                         Angle::Degrees(fixed(-40.2 + (i / 8) * 0.05)));
+  TestBatch(prj, points, N);
+
+  /* empty input */
+  TestBatch(prj, points, 0);
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(4);
+  plan_tests(8);
 
   test_simple();
+  test_batch();
 
   return exit_status();
 }
@@ -0,0 +1,348 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/QuadTree.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <stdlib.h>
+
+struct Item {
+  int x, y;
+  unsigned id;
+
+  Item(int _x, int _y, unsigned _id):x(_x), y(_y), id(_id) {}
+};
+
+struct ItemAccessor {
+  gcc_pure
+  int GetX(const Item &item) const {
+    return item.x;
+  }
+
+  gcc_pure
+  int GetY(const Item &item) const {
+    return item.y;
+  }
+};
+
+typedef QuadTree<Item, ItemAccessor> ItemTree;
+typedef std::vector<Item> ItemVector;
+
+struct IsEven {
+  bool operator()(const Item &item) const {
+    return item.id % 2 == 0;
+  }
+};
+
+struct IdSum {
+  unsigned count, sum;
+
+  IdSum():count(0), sum(0) {}
+
+  void operator()(const Item &item) {
+    ++count;
+    sum += item.id;
+  }
+};
+
+gcc_const
+static unsigned
+SquareDistance(const Item &item, int x, int y)
+{
+  return ItemTree::Square(item.x - x) + ItemTree::Square(item.y - y);
+}
+
+/**
+ * Find the smallest square distance within the range with a linear
+ * search.
+ *
+ * @return ItemTree::max_distance() if there is no match
+ */
+template<class P>
+static unsigned
+BruteForceNearest(const ItemVector &items, int x, int y, unsigned range,
+                  const P &predicate)
+{
+  const unsigned square_range = ItemTree::SquareRange(range);
+  unsigned nearest = ItemTree::max_distance();
+  bool found = false;
+
+  for (auto i = items.begin(), end = items.end(); i != end; ++i) {
+    const unsigned d = SquareDistance(*i, x, y);
+    if (d <= square_range && (!found || d < nearest) && predicate(*i)) {
+      nearest = d;
+      found = true;
+    }
+  }
+
+  return nearest;
+}
+
+static IdSum
+BruteForceRange(const ItemVector &items, int x, int y, unsigned range)
+{
+  const unsigned square_range = ItemTree::SquareRange(range);
+  IdSum result;
+
+  for (auto i = items.begin(), end = items.end(); i != end; ++i)
+    if (SquareDistance(*i, x, y) <= square_range)
+      result(*i);
+
+  return result;
+}
+
+struct AlwaysTrue {
+  bool operator()(const Item &item) const {
+    return true;
+  }
+};
+
+/**
+ * Compare one nearest search with a brute force search.
+ */
+template<class P>
+static bool
+CheckNearest(const ItemTree &tree, const ItemVector &items,
+             int x, int y, unsigned range, const P &predicate)
+{
+  const unsigned expected = BruteForceNearest(items, x, y, range, predicate);
+  const auto result =
+    tree.FindNearestIf(ItemTree::Point(x, y), range, predicate);
+
+  if (result.first == tree.end())
+    return expected == ItemTree::max_distance();
+
+  return predicate(*result.first) &&
+    result.second == expected &&
+    SquareDistance(*result.first, x, y) == expected;
+}
+
+static bool
+CheckRange(const ItemTree &tree, const ItemVector &items,
+           int x, int y, unsigned range)
+{
+  const IdSum expected = BruteForceRange(items, x, y, range);
+
+  IdSum result;
+  tree.VisitWithinRange(ItemTree::Point(x, y), range, result);
+
+  return result.count == expected.count && result.sum == expected.sum;
+}
+
+/**
+ * Run random queries, and compare all of them with a brute force
+ * search.
+ *
+ * @return the number of mismatches
+ */
+static unsigned
+CheckRandomQueries(const ItemTree &tree, const ItemVector &items,
+                   unsigned n)
+{
+  static const unsigned ranges[] = {
+    0, 1, 50, 500, 2000, 20000, 100000, ItemTree::max_distance(),
+  };
+
+  unsigned errors = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    /* include locations outside of the tree's bounds */
+    const int x = rand() % 14000 - 2000;
+    const int y = rand() % 14000 - 2000;
+    const unsigned range = ranges[i % ARRAY_SIZE(ranges)];
+
+    if (!CheckNearest(tree, items, x, y, range, AlwaysTrue()))
+      ++errors;
+
+    if (!CheckNearest(tree, items, x, y, range, IsEven()))
+      ++errors;
+
+    if (!CheckRange(tree, items, x, y, range))
+      ++errors;
+  }
+
+  /* the items themselves */
+  for (unsigned i = 0; i < items.size(); i += 17) {
+    const Item &item = items[i];
+    if (!CheckNearest(tree, items, item.x, item.y, 0, AlwaysTrue()) ||
+        !CheckRange(tree, items, item.x, item.y, 0))
+      ++errors;
+  }
+
+  return errors;
+}
+
+static void
+AddRandomItems(ItemTree &tree, ItemVector &items, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    const Item item(rand() % 10000, rand() % 10000, items.size());
+    items.push_back(item);
+    tree.Add(item);
+  }
+}
+
+/**
+ * Add many items at the same few positions.  Their buckets cannot
+ * be split, so they end up in long leaf lists.
+ */
+static void
+AddClusters(ItemTree &tree, ItemVector &items)
+{
+  for (unsigned i = 0; i < 100; ++i) {
+    const Item a(5000, 5000, items.size());
+    items.push_back(a);
+    tree.Add(a);
+
+    const Item b(5001, 5000, items.size());
+    items.push_back(b);
+    tree.Add(b);
+
+    const Item c(0, 9999, items.size());
+    items.push_back(c);
+    tree.Add(c);
+  }
+}
+
+static void
+TestRandom()
+{
+  ItemTree tree;
+  ItemVector items;
+
+  AddRandomItems(tree, items, 2000);
+  AddClusters(tree, items);
+  ok1(tree.size() == items.size());
+
+  /* a flat tree: everything is in the root bucket */
+  ok1(tree.IsFlat());
+  ok1(CheckRandomQueries(tree, items, 300) == 0);
+
+  tree.Optimise();
+  ok1(!tree.IsFlat());
+  ok1(tree.size() == items.size());
+  ok1(CheckRandomQueries(tree, items, 3000) == 0);
+
+  /* add more items inside the bounds; they are inserted into the
+     existing buckets, which get split */
+  AddRandomItems(tree, items, 1000);
+  ok1(!tree.IsFlat());
+  ok1(tree.size() == items.size());
+  ok1(CheckRandomQueries(tree, items, 1000) == 0);
+}
+
+static void
+TestSmall()
+{
+  /* fewer items than the split threshold: the root is the only
+     bucket */
+  ItemTree tree;
+  ItemVector items;
+
+  AddRandomItems(tree, items, 5);
+  tree.Optimise();
+  ok1(tree.IsFlat());
+  ok1(CheckRandomQueries(tree, items, 200) == 0);
+
+  ItemTree empty;
+  empty.Optimise();
+  ok1(empty.FindNearest(ItemTree::Point(0, 0),
+                        ItemTree::max_distance()).first == empty.end());
+
+  IdSum sum;
+  empty.VisitWithinRange(ItemTree::Point(0, 0), 1000, sum);
+  ok1(sum.count == 0);
+}
+
+static void
+TestBoundary()
+{
+  /* a grid with 100 units between the points */
+  ItemTree tree;
+  ItemVector items;
+  for (int y = 0; y < 4000; y += 100) {
+    for (int x = 0; x < 4000; x += 100) {
+      const Item item(x, y, items.size());
+      items.push_back(item);
+      tree.Add(item);
+    }
+  }
+
+  tree.Optimise();
+
+  /* 3-4-5 triangle: the nearest point is exactly 5 units away */
+  const ItemTree::Point location(1203, 1704);
+
+  auto result = tree.FindNearest(location, 5);
+  ok1(result.first != tree.end());
+  ok1(result.first->x == 1200 && result.first->y == 1700);
+  ok1(result.second == 25);
+
+  ok1(tree.FindNearest(location, 4).first == tree.end());
+
+  IdSum sum;
+  tree.VisitWithinRange(location, 5, sum);
+  ok1(sum.count == 1);
+
+  sum = IdSum();
+  tree.VisitWithinRange(location, 4, sum);
+  ok1(sum.count == 0);
+
+  /* the four grid points around the middle of a cell are equally
+     far away */
+  const ItemTree::Point middle(1250, 1750);
+  const unsigned diagonal = 71; /* sqrt(50^2 + 50^2) = 70.7 */
+
+  result = tree.FindNearest(middle, diagonal);
+  ok1(result.first != tree.end());
+  ok1(result.second == 2 * 50 * 50);
+
+  sum = IdSum();
+  tree.VisitWithinRange(middle, diagonal, sum);
+  ok1(sum.count == 4);
+
+  sum = IdSum();
+  tree.VisitWithinRange(middle, 70, sum);
+  ok1(sum.count == 0);
+
+  /* points on the edges of the bounds, and queries across them */
+  ok1(CheckNearest(tree, items, -5, -5, 10, AlwaysTrue()));
+  ok1(CheckNearest(tree, items, 3907, 3907, 10, AlwaysTrue()));
+  ok1(CheckRange(tree, items, 3900, 3900, 100));
+  ok1(CheckRange(tree, items, 0, 0, 100));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(27);
+
+  srand(42);
+
+  TestRandom();
+  TestSmall();
+  TestBoundary();
+
+  return exit_status();
+}
@@ -0,0 +1,142 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Thread/SeqLock.hpp"
+#include "Thread/Thread.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * A value which is consistent only if all elements are equal.
+ */
+struct Payload {
+  unsigned values[1024];
+
+  void Fill(unsigned value) {
+    for (unsigned i = 0; i < 1024; ++i)
+      values[i] = value;
+  }
+
+  bool IsConsistent() const {
+    for (unsigned i = 1; i < 1024; ++i)
+      if (values[i] != values[0])
+        return false;
+
+    return true;
+  }
+};
+
+static SeqLocked<Payload> shared;
+
+static const unsigned WRITES = 20000;
+
+class WriterThread : public Thread {
+  Payload payload;
+
+protected:
+  virtual void Run() {
+    for (unsigned i = 1; i <= WRITES; ++i) {
+      payload.Fill(i);
+      shared.Write(payload);
+    }
+  }
+};
+
+class ReaderThread : public Thread {
+  Payload payload;
+
+public:
+  bool consistent, monotonic;
+  unsigned reads;
+
+  ReaderThread():consistent(true), monotonic(true), reads(0) {}
+
+protected:
+  virtual void Run() {
+    unsigned last = 0;
+
+    do {
+      shared.Read(payload);
+      ++reads;
+
+      if (!payload.IsConsistent())
+        consistent = false;
+
+      /* there is only one writer, and it counts upwards */
+      if (payload.values[0] < last)
+        monotonic = false;
+
+      last = payload.values[0];
+    } while (last < WRITES);
+  }
+};
+
+static void
+TestSingleThread()
+{
+  Payload payload;
+  payload.Fill(42);
+
+  SeqLocked<Payload> value;
+  value.Write(payload);
+
+  Payload result;
+  ok1(value.Read(result) == 0);
+  ok1(result.IsConsistent());
+  ok1(result.values[0] == 42);
+}
+
+static void
+TestConcurrent()
+{
+  Payload payload;
+  payload.Fill(0);
+  shared.Write(payload);
+
+  ReaderThread readers[3];
+  for (unsigned i = 0; i < 3; ++i)
+    readers[i].Start();
+
+  WriterThread writer;
+  writer.Start();
+  writer.Join();
+
+  bool consistent = true, monotonic = true;
+  for (unsigned i = 0; i < 3; ++i) {
+    readers[i].Join();
+    consistent = consistent && readers[i].consistent;
+    monotonic = monotonic && readers[i].monotonic;
+  }
+
+  ok1(consistent);
+  ok1(monotonic);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(5);
+
+  TestSingleThread();
+  TestConcurrent();
+
+  return exit_status();
+}
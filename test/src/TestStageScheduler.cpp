@@ -0,0 +1,164 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Computer/StageScheduler.hpp"
+#include "OS/Clock.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+static void
+BusyWait(unsigned us)
+{
+  const uint64_t start = MonotonicClockUS();
+  while (MonotonicClockUS() - start < us) {}
+}
+
+/**
+ * Records the order of the executed stages, and optionally burns
+ * some CPU time in them.
+ */
+class RecordingHandler : public StageScheduler::Handler {
+  StageScheduler &scheduler;
+
+public:
+  std::vector<unsigned> executed;
+
+  /** the duration of each stage [us] */
+  unsigned durations[StageScheduler::MAX_STAGES];
+
+  /** run this stage from within stage #outer */
+  unsigned outer, inner;
+
+  RecordingHandler(StageScheduler &_scheduler)
+    :scheduler(_scheduler), outer(unsigned(-1)), inner(unsigned(-1)) {
+    for (unsigned i = 0; i < StageScheduler::MAX_STAGES; ++i)
+      durations[i] = 0;
+  }
+
+  virtual void RunStage(unsigned stage) {
+    executed.push_back(stage);
+    BusyWait(durations[stage]);
+
+    if (stage == outer)
+      scheduler.RunStage(*this, inner);
+  }
+};
+
+static void
+TestPriority()
+{
+  StageScheduler scheduler;
+  ok1(scheduler.Add(_T("fix"), 0, 1000) == 0);
+  ok1(scheduler.Add(_T("a"), 10000, 1000) == 1);
+  ok1(scheduler.Add(_T("b"), 10000, 1000) == 2);
+  ok1(scheduler.size() == 3);
+
+  /* periodic stages are due right after they have been added */
+  ok1(scheduler.IsDue());
+
+  RecordingHandler handler(scheduler);
+  ok1(!scheduler.Run(handler, 1000000));
+  ok1(handler.executed.size() == 2 &&
+      handler.executed[0] == 1 && handler.executed[1] == 2);
+
+  /* now nothing is due for 10 seconds */
+  ok1(!scheduler.IsDue());
+  handler.executed.clear();
+  scheduler.Run(handler, 1000000);
+  ok1(handler.executed.empty());
+
+  /* "force" ignores the period, but not the non-periodic stage */
+  scheduler.Run(handler, 0, true);
+  ok1(handler.executed.size() == 2 &&
+      handler.executed[0] == 1 && handler.executed[1] == 2);
+
+  scheduler.RunStage(handler, 0);
+  ok1(handler.executed.size() == 3 && handler.executed[2] == 0);
+  ok1(scheduler.GetStatistics(0).count == 1);
+  ok1(scheduler.GetStatistics(1).count == 2);
+}
+
+static void
+TestBudget()
+{
+  StageScheduler scheduler;
+  scheduler.Add(_T("slow"), 1, 1000);
+  scheduler.Add(_T("fast"), 1, 1000);
+
+  RecordingHandler handler(scheduler);
+  handler.durations[0] = 2000;
+
+  /* the first stage always runs, the second one does not fit into
+     the remaining budget */
+  ok1(scheduler.Run(handler, 1500));
+  ok1(handler.executed.size() == 1 && handler.executed[0] == 0);
+
+  const StageScheduler::Statistics slow = scheduler.GetStatistics(0);
+  ok1(slow.count == 1);
+  ok1(slow.overruns == 1);
+  ok1(slow.max_us >= 2000);
+
+  const StageScheduler::Statistics fast = scheduler.GetStatistics(1);
+  ok1(fast.count == 0);
+  ok1(fast.deferred == 1);
+
+  scheduler.ResetStatistics();
+  ok1(scheduler.GetStatistics(0).count == 0);
+  ok1(scheduler.GetStatistics(1).deferred == 0);
+}
+
+static void
+TestNested()
+{
+  StageScheduler scheduler;
+  scheduler.Add(_T("outer"), 0, 100000);
+  scheduler.Add(_T("inner"), 0, 100000);
+
+  RecordingHandler handler(scheduler);
+  handler.outer = 0;
+  handler.inner = 1;
+  handler.durations[0] = 1000;
+  handler.durations[1] = 5000;
+
+  scheduler.RunStage(handler, 0);
+  ok1(handler.executed.size() == 2);
+
+  /* the inner stage's time is not accounted to the outer one */
+  const StageScheduler::Statistics outer = scheduler.GetStatistics(0);
+  const StageScheduler::Statistics inner = scheduler.GetStatistics(1);
+  ok1(outer.count == 1 && inner.count == 1);
+  ok1(inner.total_us >= 5000);
+  ok1(outer.total_us >= 1000 && outer.total_us < inner.total_us);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(26);
+
+  TestPriority();
+  TestBudget();
+  TestNested();
+
+  return exit_status();
+}
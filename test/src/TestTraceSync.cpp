@@ -0,0 +1,119 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Checks that Trace::SyncPoints() keeps a filtered copy of the trace
+ * identical to the one obtained by Trace::GetPoints(), like the snail
+ * trail renderer uses it.
+ */
+
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Vector.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "TestUtil.hpp"
+
+static bool
+IsEqual(const TracePointVector &a, const TracePointVector &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (a[i].GetTime() != b[i].GetTime() ||
+        !(a[i].get_location() == b[i].get_location()))
+      return false;
+
+  return true;
+}
+
+static void
+TestSync(const char *path, unsigned max_size, fixed resolution)
+{
+  FileLineReaderA reader(path);
+  if (reader.error()) {
+    skip(4, 0, "Failed to open IGC file");
+    return;
+  }
+
+  Trace trace(60, Trace::null_time, max_size);
+
+  TracePointVector synced, reference;
+  Serial modify_serial;
+  bool valid = false;
+  unsigned n_reload = 0, n_sync = 0, n_mismatch = 0;
+
+  char *line;
+  while ((line = reader.read()) != NULL) {
+    IGCFix fix;
+    if (!IGCParseFix(line, fix) || !fix.gps_valid)
+      continue;
+
+    AircraftState state;
+    state.Reset();
+    state.location = fix.location;
+    state.altitude = fixed(fix.gps_altitude);
+    state.altitude_agl = state.altitude;
+    state.ground_speed = fixed(30);
+    state.track = Angle::Zero();
+    state.time = fixed(fix.time.GetSecondOfDay());
+    state.netto_vario = fixed_zero;
+    trace.push_back(state);
+
+    const GeoPoint &location = trace.front().get_location();
+
+    if (valid && !synced.empty() &&
+        trace.GetModifySerial() == modify_serial) {
+      trace.SyncPoints(synced, location, resolution);
+      ++n_sync;
+
+      reference.clear();
+      trace.GetPoints(reference, 0, location, resolution);
+      if (!IsEqual(synced, reference))
+        ++n_mismatch;
+    } else {
+      synced.clear();
+      trace.GetPoints(synced, 0, location, resolution);
+      modify_serial = trace.GetModifySerial();
+      valid = true;
+      ++n_reload;
+    }
+  }
+
+  ok1(n_reload > 0);
+  ok1(n_sync > 0);
+  ok1(n_sync > n_reload);
+  ok1(n_mismatch == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(8);
+
+  TestSync("test/data/01lz1hq1.igc", 1024, fixed(50));
+  TestSync("test/data/01lz1hq1.igc", 256, fixed(500));
+
+  return exit_status();
+}
@@ -0,0 +1,489 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Tests #TrafficStore (incremental expiry, id index and spatial grid)
+ * with a few hundred synthetic targets (more than #TrafficList can
+ * hold), fed as PFLAA sentences through #FLARMEmulator and the FLARM
+ * driver's parser.  The queries are compared with a brute force
+ * search over the positions of the synthetic targets.
+ */
+
+#include "FLARMEmulator.hpp"
+#include "FLARM/List.hpp"
+#include "FLARM/TrafficStore.hpp"
+#include "Device/Driver/FLARM/StaticParser.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+
+/**
+ * A port which passes all data written to it to a handler, to
+ * connect an emulator directly to a parser.
+ */
+class LoopbackPort : public NullPort {
+public:
+  LoopbackPort(Port::Handler &_handler):NullPort(_handler) {}
+
+  virtual size_t Write(const void *data, size_t length) {
+    handler.DataReceived(data, length);
+    return length;
+  }
+};
+
+/**
+ * Receives the PFLAA sentences and stores them in a #TrafficStore
+ * and a #TrafficList, like NMEAParser does.
+ */
+class TrafficReceiver : public PortLineSplitter {
+public:
+  TrafficStore store;
+  TrafficList traffic;
+  fixed clock;
+  unsigned n_received, n_dropped;
+
+  TrafficReceiver():clock(fixed_one), n_received(0), n_dropped(0) {
+    store.Clear();
+    traffic.Clear();
+  }
+
+protected:
+  virtual void LineReceived(const char *_line) {
+    if (!VerifyNMEAChecksum(_line))
+      return;
+
+    NMEAInputLine line(_line);
+    char cmd[32];
+    line.Read(cmd, ARRAY_SIZE(cmd));
+
+    if (strcmp(cmd, "$PFLAA") == 0) {
+      FlarmTraffic target;
+      if (!ParsePFLAA(line, target))
+        return;
+
+      ++n_received;
+      if (!store.Update(target, clock))
+        ++n_dropped;
+
+      traffic.Update(target, clock);
+    }
+  }
+};
+
+/**
+ * A synthetic target flying circles at a fixed distance from us.
+ */
+struct SyntheticTarget {
+  uint32_t id;
+  unsigned start, end;
+  int center_north, center_east, radius;
+  unsigned phase;
+
+  /**
+   * The last time this target was sent, or 0 if never.
+   */
+  unsigned last_sent;
+
+  bool IsActive(unsigned t) const {
+    return t >= start && t < end;
+  }
+
+  int GetNorth(unsigned t) const {
+    return center_north + (int)(radius * cos((t + phase) / 20.));
+  }
+
+  int GetEast(unsigned t) const {
+    return center_east + (int)(radius * sin((t + phase) / 20.));
+  }
+
+  /**
+   * Is this target expected in the store at the specified time?
+   * Targets stay two seconds after their last sentence.
+   */
+  bool IsKnown(unsigned t) const {
+    return last_sent > 0 && last_sent + 2 >= t;
+  }
+
+  /**
+   * The squared distance between the last sent position and the
+   * specified point.
+   */
+  long GetSquareDistance(int north, int east) const {
+    const long dn = GetNorth(last_sent) - north;
+    const long de = GetEast(last_sent) - east;
+    return dn * dn + de * de;
+  }
+};
+
+static FlarmId
+ToFlarmId(uint32_t id)
+{
+  char buffer[16];
+  sprintf(buffer, "%06X", (unsigned)id);
+  return FlarmId::Parse(buffer, NULL);
+}
+
+static void
+TestAllocate()
+{
+  TrafficStore store;
+  store.Clear();
+
+  bool found = true;
+  for (unsigned i = 0; i < TrafficStore::MAX_COUNT; ++i) {
+    FlarmTraffic *traffic = store.AllocateTraffic(ToFlarmId(0x100000 + i * 7));
+    if (traffic == NULL) {
+      found = false;
+      break;
+    }
+
+    traffic->Clear();
+    traffic->valid.Update(fixed_one);
+  }
+
+  ok1(found);
+  ok1(store.GetActiveTrafficCount() == TrafficStore::MAX_COUNT);
+  ok1(store.AllocateTraffic(ToFlarmId(0xABCDEF)) == NULL);
+
+  for (unsigned i = 0; i < TrafficStore::MAX_COUNT; ++i) {
+    const FlarmTraffic *traffic =
+      store.FindTraffic(ToFlarmId(0x100000 + i * 7));
+    if (traffic == NULL || !(traffic->id == ToFlarmId(0x100000 + i * 7)))
+      found = false;
+  }
+
+  ok1(found);
+  ok1(store.FindTraffic(ToFlarmId(0x100001)) == NULL);
+
+  /* nothing expires within the first two seconds */
+  store.Expire(fixed_two);
+  ok1(store.GetActiveTrafficCount() == TrafficStore::MAX_COUNT);
+
+  store.Expire(fixed(4));
+  ok1(store.IsEmpty());
+  ok1(store.FindTraffic(ToFlarmId(0x100000)) == NULL);
+}
+
+static FlarmTraffic
+MakeTarget(uint32_t id, int north, int east)
+{
+  FlarmTraffic traffic;
+  traffic.Clear();
+  traffic.id = ToFlarmId(id);
+  traffic.relative_north = fixed(north);
+  traffic.relative_east = fixed(east);
+  return traffic;
+}
+
+/**
+ * Check that a full #TrafficList keeps the nearest targets.
+ */
+static void
+TestSmallList()
+{
+  TrafficList list;
+  list.Clear();
+
+  bool added = true;
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i)
+    if (!list.Update(MakeTarget(0x200000 + i, 1000 + i * 100, 0), fixed_one))
+      added = false;
+
+  ok1(added);
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+
+  /* farther away than all others: rejected */
+  ok1(!list.Update(MakeTarget(0x300000, 0, 20000), fixed_one));
+  ok1(list.FindTraffic(ToFlarmId(0x300000)) == NULL);
+
+  /* nearer: replaces the farthest one */
+  ok1(list.Update(MakeTarget(0x300001, 0, 500), fixed_one));
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+  ok1(list.FindTraffic(ToFlarmId(0x300001)) != NULL);
+  ok1(list.FindTraffic(ToFlarmId(0x200000 + TrafficList::MAX_COUNT - 1)) == NULL);
+  ok1(list.FindTraffic(ToFlarmId(0x200000)) != NULL);
+
+  /* a known target is always updated */
+  ok1(list.Update(MakeTarget(0x200000, 0, 30000), fixed_two));
+  ok1(equals(list.FindTraffic(ToFlarmId(0x200000))->relative_east, 30000));
+}
+
+/**
+ * Compare the id index with a linear search, and the stored
+ * positions with the ones which were sent.
+ */
+static bool
+CheckIdIndex(const TrafficStore &store, const SyntheticTarget *targets,
+             unsigned n_targets, unsigned t)
+{
+  for (unsigned i = 0; i < n_targets; ++i) {
+    const SyntheticTarget &target = targets[i];
+    const FlarmId id = ToFlarmId(target.id);
+
+    const FlarmTraffic *linear = NULL;
+    for (auto it = store.list.begin(), end = store.list.end();
+         it != end; ++it)
+      if (it->id == id)
+        linear = it;
+
+    if (store.FindTraffic(id) != linear)
+      return false;
+
+    if (target.IsKnown(t) != (linear != NULL))
+      return false;
+
+    if (linear != NULL &&
+        (!equals(linear->relative_north, target.GetNorth(target.last_sent)) ||
+         !equals(linear->relative_east, target.GetEast(target.last_sent))))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Collects the ids of the targets passed to it by
+ * TrafficStore::VisitWithinRange().
+ */
+struct IdCollector {
+  TrivialArray<FlarmId, TrafficStore::MAX_COUNT> ids;
+  bool overflow;
+
+  IdCollector():overflow(false) {
+    ids.clear();
+  }
+
+  void operator()(const FlarmTraffic &traffic) {
+    if (ids.full())
+      overflow = true;
+    else
+      ids.append(traffic.id);
+  }
+
+  gcc_pure
+  bool Contains(FlarmId id) const {
+    for (auto it = ids.begin(), end = ids.end(); it != end; ++it)
+      if (*it == id)
+        return true;
+
+    return false;
+  }
+};
+
+/**
+ * Run a range query and a nearest query and compare them with a
+ * brute force search over the synthetic targets.
+ */
+static bool
+CheckQuery(const TrafficStore &store, const SyntheticTarget *targets,
+           unsigned n_targets, unsigned t, int north, int east, int range)
+{
+  IdCollector collector;
+  store.VisitWithinRange(fixed(north), fixed(east), fixed(range), collector);
+  if (collector.overflow)
+    return false;
+
+  const long square_range = (long)range * range;
+  unsigned n_within = 0;
+  long nearest_distance = -1;
+  for (unsigned i = 0; i < n_targets; ++i) {
+    const SyntheticTarget &target = targets[i];
+    if (!target.IsKnown(t))
+      continue;
+
+    const long d = target.GetSquareDistance(north, east);
+    const bool within = d <= square_range;
+    if (within != collector.Contains(ToFlarmId(target.id)))
+      return false;
+
+    if (within) {
+      ++n_within;
+      if (nearest_distance < 0 || d < nearest_distance)
+        nearest_distance = d;
+    }
+  }
+
+  if (collector.ids.size() != n_within)
+    return false;
+
+  const FlarmTraffic *nearest =
+    store.FindNearest(fixed(north), fixed(east), fixed(range));
+  if ((nearest == NULL) != (nearest_distance < 0))
+    return false;
+
+  if (nearest != NULL) {
+    const long dn = (long)nearest->relative_north - north;
+    const long de = (long)nearest->relative_east - east;
+    if (dn * dn + de * de != nearest_distance)
+      return false;
+  }
+
+  return true;
+}
+
+static bool
+CheckQueries(const TrafficStore &store, const SyntheticTarget *targets,
+             unsigned n_targets, unsigned t)
+{
+  /* random positions, some of them outside the grid */
+  for (unsigned i = 0; i < 20; ++i)
+    if (!CheckQuery(store, targets, n_targets, t,
+                    rand() % 30000 - 15000, rand() % 30000 - 15000,
+                    rand() % 12000))
+      return false;
+
+  /* around each known target, with the range ending exactly at that
+     target (3-4-5 triangle) or just before it */
+  for (unsigned i = 0; i < n_targets; ++i) {
+    const SyntheticTarget &target = targets[i];
+    if (!target.IsKnown(t) || i % 7 != 0)
+      continue;
+
+    const int north = target.GetNorth(target.last_sent) + 300 * (1 + i % 5);
+    const int east = target.GetEast(target.last_sent) + 400 * (1 + i % 5);
+    const int range = 500 * (1 + i % 5);
+
+    if (!CheckQuery(store, targets, n_targets, t, north, east, range) ||
+        !CheckQuery(store, targets, n_targets, t, north, east, range - 1))
+      return false;
+
+    IdCollector collector;
+    store.VisitWithinRange(fixed(north), fixed(east), fixed(range),
+                           collector);
+    if (!collector.Contains(ToFlarmId(target.id)))
+      return false;
+  }
+
+  /* a query covering the whole grid and beyond */
+  return CheckQuery(store, targets, n_targets, t, 0, 0, 20000);
+}
+
+static void
+TestStress()
+{
+  static const unsigned N_TARGETS = 600, DURATION = 300;
+
+  srand(42);
+
+  static SyntheticTarget targets[N_TARGETS];
+  for (unsigned i = 0; i < N_TARGETS; ++i) {
+    SyntheticTarget &t = targets[i];
+    t.id = 0xD00000 + i * 13;
+    t.start = 1 + rand() % DURATION;
+    t.end = t.start + 10 + rand() % 120;
+    t.center_north = rand() % 24000 - 12000;
+    t.center_east = rand() % 24000 - 12000;
+    t.radius = 100 + rand() % 400;
+    t.phase = rand() % 100;
+    t.last_sent = 0;
+  }
+
+  TrafficReceiver receiver;
+  LoopbackPort port(receiver);
+  NullOperationEnvironment env;
+
+  FLARMEmulator emulator;
+  emulator.port = &port;
+  emulator.env = &env;
+
+  bool sent_ok = true, count_ok = true, index_ok = true, queries_ok = true;
+  bool list_ok = true;
+  unsigned max_active = 0, n_sent = 0;
+
+  for (unsigned t = 1; t <= DURATION; ++t) {
+    receiver.clock = fixed(t);
+
+    unsigned active = 0;
+    for (unsigned i = 0; i < N_TARGETS; ++i) {
+      SyntheticTarget &target = targets[i];
+      if (!target.IsActive(t))
+        continue;
+
+      ++active;
+      if (!emulator.SendPFLAA(0, target.GetNorth(t), target.GetEast(t),
+                              (int)(i % 200) - 100, target.id,
+                              (t * 3) % 360, 3, 25, 1.5, 1))
+        sent_ok = false;
+
+      target.last_sent = t;
+      ++n_sent;
+    }
+
+    max_active = std::max(max_active, active);
+
+    TrafficStore &store = receiver.store;
+    store.Expire(fixed(t));
+    receiver.traffic.Expire(fixed(t));
+
+    unsigned expected = 0;
+    for (unsigned i = 0; i < N_TARGETS; ++i)
+      if (targets[i].IsKnown(t))
+        ++expected;
+
+    if (store.GetActiveTrafficCount() != expected)
+      count_ok = false;
+
+    if (!CheckIdIndex(store, targets, N_TARGETS, t))
+      index_ok = false;
+
+    /* the small list holds a subset of the store */
+    const TrafficList &list = receiver.traffic;
+    for (auto it = list.list.begin(), end = list.list.end(); it != end; ++it)
+      if (store.FindTraffic(it->id) == NULL)
+        list_ok = false;
+
+    if (t % 10 == 0) {
+      /* the fallback without grid first, then with the grid */
+      if (!CheckQueries(store, targets, N_TARGETS, t))
+        queries_ok = false;
+
+      store.UpdateSpatialIndex();
+      if (!CheckQueries(store, targets, N_TARGETS, t))
+        queries_ok = false;
+    }
+  }
+
+  ok1(sent_ok);
+  ok1(receiver.n_received == n_sent);
+  ok1(receiver.n_dropped == 0);
+  /* more than the small list can hold, but all fit into the store */
+  ok1(max_active > TrafficList::MAX_COUNT);
+  ok1(max_active <= TrafficStore::MAX_COUNT);
+  ok1(count_ok);
+  ok1(index_ok);
+  ok1(queries_ok);
+  ok1(list_ok);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(8 + 11 + 9);
+
+  TestAllocate();
+  TestSmallList();
+  TestStress();
+
+  return exit_status();
+}
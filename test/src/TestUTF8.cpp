@@ -0,0 +1,70 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2012 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/UTF8.hpp"
+#include "TestUtil.hpp"
+
+int main(int argc, char **argv)
+{
+  plan_tests(18);
+
+  // Test NextUTF8()
+
+  const char *p = "";
+  ok1(NextUTF8(p) == 0);
+  ok1(*p == 0);
+
+  p = "a\xc3\xa4\xe2\x82\xac\xf0\x9d\x84\x9e";
+  ok1(NextUTF8(p) == 'a');
+  ok1(NextUTF8(p) == 0xe4);
+  ok1(NextUTF8(p) == 0x20ac);
+  ok1(NextUTF8(p) == 0x1d11e);
+  ok1(NextUTF8(p) == 0);
+  ok1(NextUTF8(p) == 0);
+
+  /* a lone continuation byte */
+  p = "\x80z";
+  ok1(NextUTF8(p) == 0xfffd);
+  ok1(NextUTF8(p) == 'z');
+  ok1(NextUTF8(p) == 0);
+
+  /* a truncated sequence */
+  p = "\xe2\x82z";
+  ok1(NextUTF8(p) == 0xfffd);
+  ok1(NextUTF8(p) == 'z');
+  ok1(NextUTF8(p) == 0);
+
+  /* truncated at the end of the string */
+  p = "\xc3";
+  ok1(NextUTF8(p) == 0xfffd);
+  ok1(NextUTF8(p) == 0);
+
+  /* Latin1ToUTF8() round trip */
+  char buffer[4];
+  *Latin1ToUTF8(0xe4, buffer) = 0;
+  p = buffer;
+  ok1(NextUTF8(p) == 0xe4);
+  ok1(*p == 0);
+
+  return exit_status();
+}